@@ -15,11 +15,13 @@
 #include "Record.h"
 #include "Stats.h"
 #include "Recommender.h"
+#include "Bandit.h"
+#include "SpacedReview.h"
 #include "KnowledgeGraph.h"
+#include "CoError.h"
 #include "Report.h"
 #include "Utils.h"
 #include <iostream>
-#include <random>
 #include <algorithm>
 
 /**
@@ -40,6 +42,8 @@ void showMenu() {
     std::cout << "6. 知识点复习路径推荐\n";
     std::cout << "7. 导出学习报告\n";
     std::cout << "8. 切换用户\n";
+    std::cout << "9. 间隔复习（到期题目）\n";
+    std::cout << "10. 探索推荐（Thompson 采样）\n";
     std::cout << "0. 退出\n";
     std::cout << "请选择：";
 }
@@ -51,11 +55,11 @@ void showMenu() {
  *
  * 流程说明：
  * 1. 检查题库是否为空
- * 2. 使用 srand/rand 生成随机索引
+ * 2. 从会话随机流 RandomPurpose::Practice 抽取随机索引
  * 3. 调用 doQuestion() 执行答题逻辑（包含判分、记录、错题管理）
  * 4. 答题结束后暂停，等待用户按回车返回菜单
  *
- * @note 使用 time(nullptr) 作为随机种子，每次运行时随机性不同
+ * @note 随机流由会话种子派生（见 Utils.h），以同一 --seed 启动可重放抽到的题目
  * @see doQuestion() 答题核心函数（Question 模块）
  */
 void randomPractice() {
@@ -65,9 +69,8 @@ void randomPractice() {
         return;
     }
 
-    // 使用全局 RNG 生成随机索引
-    std::uniform_int_distribution<size_t> dist(0, g_questions.size() - 1);
-    size_t idx = dist(globalRng());
+    // 从本模式的会话随机流抽取随机索引
+    size_t idx = (size_t)sessionStream(RandomPurpose::Practice).below(g_questions.size());
     const Question& q = g_questions[idx];
 
     doQuestion(q);
@@ -83,13 +86,14 @@ void randomPractice() {
  *
  * 流程说明：
  * 1. 检查错题集 g_wrongQuestions（unordered_set）是否为空
- * 2. 将错题 ID 复制到 vector，因为 unordered_set 不支持随机访问
- * 3. 使用 srand/rand 随机选择一个错题 ID
+ * 2. 将错题 ID 复制到 vector 并排序：unordered_set 不支持随机访问，遍历顺序也随实现与插入历史变化
+ * 3. 从会话随机流 RandomPurpose::WrongBook 随机选择一个错题 ID
  * 4. 通过 g_questionById 映射查找对应的题目对象
  * 5. 调用 doQuestion() 执行答题逻辑
  *    - 如果答对，doQuestion 内部会自动将该题从错题集移除
  *    - 如果答错，该题继续保留在错题集中
- * 6. 答题结束后暂停，等待用户按回车返回菜单
+ * 6. 答错时列出共错题（答错这道题的同学也常答错的题，见 CoError.h），可输入 y 接着练习第一道
+ * 7. 答题结束后暂停，等待用户按回车返回菜单
  *
  * 交互说明：
  * - 错题集为空时提示用户先去做题
@@ -107,16 +111,17 @@ void wrongBookMode() {
         return;
     }
 
-    // 把错题号从 unordered_set 拷贝到 vector，便于随机访问
+    // 把错题号从 unordered_set 拷贝到 vector，便于随机访问；
+    // 排序后同一错题集、同一随机流总是抽到同一道题（与哈希表的遍历顺序无关）
     std::vector<int> ids;
     ids.reserve(g_wrongQuestions.size());
     for (int id : g_wrongQuestions) {
         ids.push_back(id);
     }
+    std::sort(ids.begin(), ids.end());
 
-    // 使用全局 RNG 随机选择一道错题
-    std::uniform_int_distribution<size_t> dist(0, ids.size() - 1);
-    size_t randomIdx = dist(globalRng());
+    // 从本模式的会话随机流随机选择一道错题
+    size_t randomIdx = (size_t)sessionStream(RandomPurpose::WrongBook).below(ids.size());
     int qid = ids[randomIdx];
 
     // 通过 ID 查找题目对象
@@ -138,6 +143,20 @@ void wrongBookMode() {
     std::cout << "【错题本练习】\n";
     doQuestion(g_questions[qIdx]);
 
+    // 答错：同一误区常牵连的题目趁热练一道
+    if (!g_records.empty() && !g_records.back().correct) {
+        int related = printRelatedMisses(g_questions[qIdx], 3);
+        auto itRelated = g_questionById.find(related);
+        if (itRelated != g_questionById.end() && itRelated->second < g_questions.size()) {
+            std::cout << "输入 y 接着练习题号 " << related << "，直接回车返回：";
+            std::string line;
+            if (std::getline(std::cin, line) && (line == "y" || line == "Y")) {
+                std::cout << "\n【共错题练习】\n";
+                doQuestion(g_questions[itRelated->second]);
+            }
+        }
+    }
+
     // 答题结束后暂停，等待用户按回车返回菜单
     pauseForUser();
 }
@@ -150,9 +169,9 @@ void wrongBookMode() {
  * 流程说明：
  * 1. 检查题库是否为空
  * 2. 让用户输入考试题目数量 N，范围限制为 [1, 题库总数]
- * 3. 使用 shuffle + 截取策略抽取 N 道互不重复的题目：
+ * 3. 使用部分洗牌 + 截取策略抽取 N 道互不重复的题目：
  *    - 创建包含所有题目索引的 vector
- *    - 使用 std::shuffle + mt19937 随机打乱索引顺序（Fisher-Yates 算法）
+ *    - 以会话随机流 RandomPurpose::Exam 做部分 Fisher-Yates，只确定前 N 个位置
  *    - 截取前 N 个索引作为本次考试题目
  * 4. 记录考试开始前的 g_records 大小（prevSize），用于后续统计本次考试数据
  * 5. 顺序出题，每道题调用 doQuestion() 进行答题和记录
@@ -163,10 +182,10 @@ void wrongBookMode() {
  * 8. 答题结束后暂停，等待用户按回车返回菜单
  *
  * 抽题去重策略分析：
- * - 算法：Fisher-Yates shuffle + 截取前 N 个元素
- * - 时间复杂度：O(M)，M 为题库总数（shuffle 的复杂度）
+ * - 算法：部分 Fisher-Yates（RandomStream::shuffleFirst）+ 截取前 N 个元素
+ * - 时间复杂度：O(M)，M 为题库总数（建立索引数组）；洗牌本身只做 N 次交换
  * - 空间复杂度：O(M)，需要存储全部题目索引
- * - 正确性保证：shuffle 保证每个排列等概率，截取前 N 个等价于无放回随机抽取
+ * - 正确性保证：前 N 个位置依次从剩余元素中均匀抽取，等价于无放回随机抽取
  * - 优点：实现简单、逻辑清晰、完全随机且无重复
  * - 适用场景：题库规模在万级别以内性能良好
  * - 可优化方向：如果 N << M，可使用 Reservoir Sampling 降低空间复杂度到 O(N)
@@ -177,7 +196,8 @@ void wrongBookMode() {
  * - 系统自动记录每道题的作答时间（由 doQuestion 内部处理）
  * - 考试报告提供整体和知识点两个维度的统计分析
  *
- * @note 使用 std::random_device 和 std::mt19937 生成高质量随机数，避免简单随机数的偏差
+ * @note 抽题只用 RandomStream 自身的整数抽取，不经过实现相关的 std::shuffle：
+ *       以同一 --seed 启动，在任何平台上都得到同一份试卷
  * @see doQuestion() 答题核心函数（Question 模块）
  * @see g_records 全局做题记录
  * @see g_questionById 全局题目 ID 映射表
@@ -214,8 +234,8 @@ void examMode() {
         indices.push_back(i);
     }
 
-    // 使用全局 mt19937 进行洗牌（Fisher-Yates 算法）
-    std::shuffle(indices.begin(), indices.end(), globalRng());
+    // 部分 Fisher-Yates：只洗前 N 个位置
+    sessionStream(RandomPurpose::Exam).shuffleFirst(indices, (size_t)N);
 
     // 取前 N 个索引作为本次考试题目（时间复杂度 O(N)）
     std::vector<int> selectedIndices(indices.begin(), indices.begin() + N);
@@ -390,6 +410,8 @@ void switchUser() {
  *    - choice 6：recommendReviewPath()（知识点复习路径推荐，KnowledgeGraph 模块）
  *    - choice 7：exportLearningReport()（导出学习报告，Report 模块）
  *    - choice 8：switchUser()（切换用户）
+ *    - choice 9：spacedReviewMode()（间隔复习，SpacedReview 模块）
+ *    - choice 10：banditRecommendMode()（探索推荐，Bandit 模块）
  *    - 其他：提示无效选项，调用 pauseForUser() 等待用户确认
  * 5. 功能执行完毕后，用户按回车键返回，进入下一次循环（此时清屏）
  *
@@ -417,6 +439,8 @@ void switchUser() {
  * @see randomPractice() 随机刷题
  * @see wrongBookMode() 错题本练习
  * @see aiRecommendMode() AI 智能推荐（Recommender 模块）
+ * @see spacedReviewMode() 间隔复习（SpacedReview 模块）
+ * @see banditRecommendMode() 探索推荐（Bandit 模块）
  * @see showStatistics() 统计查看（Stats 模块）
  * @see examMode() 模拟考试
  * @see recommendReviewPath() 知识图谱推荐（KnowledgeGraph 模块）
@@ -432,7 +456,7 @@ void runMenuLoop() {
         showMenu();
         int choice;
         // 使用健壮输入函数读取菜单选项
-        if (!readIntSafely("", choice, 0, 8, false)) {
+        if (!readIntSafely("", choice, 0, 10, false)) {
             // 如果读取失败，继续循环
             continue;
         }
@@ -455,6 +479,10 @@ void runMenuLoop() {
             exportLearningReport(); // 导出学习报告（Report 模块）
         } else if (choice == 8) {
             switchUser();
+        } else if (choice == 9) {
+            spacedReviewMode();     // 间隔复习（SpacedReview 模块）
+        } else if (choice == 10) {
+            banditRecommendMode();  // 探索推荐（Bandit 模块）
         } else {
             std::cout << "无效选项，请重新输入。\n";
             pauseForUser();
@@ -29,6 +29,8 @@
  * - 6. 知识点复习路径推荐：调用 recommendReviewPath()（KnowledgeGraph 模块）
  * - 7. 导出学习报告：调用 exportLearningReport()（Report 模块）
  * - 8. 切换用户：调用 switchUser()
+ * - 9. 间隔复习（到期题目）：调用 spacedReviewMode()（SpacedReview 模块）
+ * - 10. 探索推荐（Thompson 采样）：调用 banditRecommendMode()（Bandit 模块）
  * - 0. 退出程序
  *
  * @note 本函数只负责显示，不处理用户输入（输入处理在 runMenuLoop 中）
@@ -40,7 +42,7 @@ void showMenu();
  *
  * 流程：
  * 1. 检查题库是否为空（g_questions）
- * 2. 使用 rand() 随机选择一道题目
+ * 2. 从会话随机流（RandomPurpose::Practice）随机选择一道题目
  * 3. 调用 doQuestion() 进行答题（Question 模块）
  * 4. 答题结束后调用 pauseForUser() 等待用户确认
  *
@@ -59,8 +61,8 @@ void randomPractice();
  *
  * 流程：
  * 1. 检查错题集是否为空（g_wrongQuestions）
- * 2. 将错题 ID 从 unordered_set 复制到 vector 便于随机访问
- * 3. 使用 rand() 随机选择一道错题
+ * 2. 将错题 ID 从 unordered_set 复制到 vector 并排序，便于随机访问
+ * 3. 从会话随机流（RandomPurpose::WrongBook）随机选择一道错题
  * 4. 通过 g_questionById 映射查找题目内容
  * 5. 调用 doQuestion() 进行答题
  * 6. 答题结束后调用 pauseForUser() 等待用户确认
@@ -81,9 +83,9 @@ void wrongBookMode();
  * 流程：
  * 1. 提示题库总数，让用户输入考试题目数量 N
  * 2. 范围限制：N ∈ [1, 题库总数]
- * 3. 使用 shuffle + 截取策略抽取 N 道互不重复的题目：
+ * 3. 使用部分洗牌 + 截取策略抽取 N 道互不重复的题目：
  *    - 将所有题目索引放入 vector
- *    - 使用 std::shuffle 和 mt19937 随机打乱
+ *    - 以会话随机流（RandomPurpose::Exam）做部分 Fisher-Yates，只打乱前 N 个位置
  *    - 取前 N 个索引作为考试题目
  * 4. 记录考试开始前的做题记录数（prevSize）
  * 5. 顺序出题，每道题调用 doQuestion()
@@ -94,7 +96,7 @@ void wrongBookMode();
  * 8. 调用 pauseForUser() 等待用户确认
  *
  * 抽题去重策略分析：
- * - 方法：Fisher-Yates shuffle + 截取前 N 个
+ * - 方法：部分 Fisher-Yates shuffle + 截取前 N 个
  * - 时间复杂度：O(M)，M 为题库总数
  * - 空间复杂度：O(M)，需要存储全部索引
  * - 优点：实现简单，保证完全随机且无重复
@@ -106,7 +108,7 @@ void wrongBookMode();
  * - 系统记录每道题作答时间（由 doQuestion 内部处理）
  * - 考试结束后提供详细统计报告
  *
- * @note 本模式使用 std::random_device 和 std::mt19937 生成高质量随机数
+ * @note 随机流由会话种子派生（见 Utils.h 的 sessionStream），以同一 --seed 启动可重放同一份试卷
  * @see doQuestion() 答题核心逻辑
  * @see g_records 全局做题记录
  */
@@ -153,6 +155,8 @@ void switchUser();
  *    - choice 6：recommendReviewPath()（知识图谱，KnowledgeGraph 模块）
  *    - choice 7：exportLearningReport()（导出报告，Report 模块）
  *    - choice 8：switchUser()（切换用户）
+ *    - choice 9：spacedReviewMode()（间隔复习，SpacedReview 模块）
+ *    - choice 10：banditRecommendMode()（探索推荐，Bandit 模块）
  *    - 其他：提示无效选项，调用 pauseForUser() 等待用户确认
  * 5. 功能执行完毕后，用户按回车键返回，进入下一次循环（此时清屏）
  *
@@ -0,0 +1,203 @@
+/**
+ * @file Bandit.cpp
+ * @brief 探索式推荐模块实现
+ *
+ * 实现要点：
+ * 1. **均匀数**：counter_ 递增后经 splitmix64（Utils.h）混合，取高 53 位映射到 (0, 1]；
+ *    refill() 一次填满 kBlock 个，各元素互不依赖
+ * 2. **Gamma**：小整数形状参数累乘均匀数后取一次对数；否则 Marsaglia-Tsang，
+ *    正态数由 Box-Muller 成对生成，多出的一个留作下次使用
+ * 3. **Top-K**：作答过的题目整理为参数列后成批抽样，流式插入 TopK；
+ *    未作答题目只生成最大的 K 个顺序统计量，再随机挑选对应的题目
+ */
+
+#include "Bandit.h"
+#include "Question.h"
+#include "Record.h"
+#include "Stats.h"
+#include "TopK.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <unordered_set>
+
+namespace {
+
+/// [0, n) 上的均匀整数（n < 2^53）
+size_t uniformIndex(BetaSampler& sampler, size_t n) {
+    size_t idx = (size_t)((1.0 - sampler.uniform()) * (double)n);
+    return idx < n ? idx : n - 1;
+}
+
+} // namespace
+
+BetaSampler::BetaSampler(uint64_t seed) : key_(splitmix64(seed)) {}
+
+void BetaSampler::refill() {
+    const double kScale = 1.0 / 9007199254740992.0;   // 2^-53
+    uint64_t base = counter_;
+    for (size_t i = 0; i < kBlock; ++i) {
+        uint64_t bits = splitmix64(key_ ^ (base + i));
+        buf_[i] = (double)((bits >> 11) + 1) * kScale;   // (0, 1]
+    }
+    counter_ += kBlock;
+    next_ = 0;
+}
+
+double BetaSampler::normal() {
+    if (hasSpare_) {
+        hasSpare_ = false;
+        return spare_;
+    }
+    const double kTwoPi = 6.283185307179586;
+    double r = std::sqrt(-2.0 * std::log(uniform()));
+    double t = kTwoPi * uniform();
+    spare_ = r * std::sin(t);
+    hasSpare_ = true;
+    return r * std::cos(t);
+}
+
+double BetaSampler::gamma(int32_t shape) {
+    if (shape <= kSmallGammaShape) {
+        double product = 1.0;
+        for (int32_t i = 0; i < shape; ++i) product *= uniform();
+        return -std::log(product);
+    }
+
+    // Marsaglia-Tsang：d = shape - 1/3，c = 1 / sqrt(9d)
+    double d = (double)shape - 1.0 / 3.0;
+    double c = 1.0 / std::sqrt(9.0 * d);
+    while (true) {
+        double x = normal();
+        double v = 1.0 + c * x;
+        if (v <= 0.0) continue;
+        v = v * v * v;
+        double u = uniform();
+        if (u < 1.0 - 0.0331 * x * x * x * x) return d * v;
+        if (std::log(u) < 0.5 * x * x + d * (1.0 - v + std::log(v))) return d * v;
+    }
+}
+
+void BetaSampler::sample(const int32_t* alpha, const int32_t* beta, size_t n, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        double x = gamma(alpha[i]);
+        double y = gamma(beta[i]);
+        out[i] = x / (x + y);
+    }
+}
+
+std::vector<RecommendItem> thompsonTopK(size_t K, BetaSampler& sampler) {
+    size_t n = g_questions.size();
+    bool haveStats = g_questionStats.size() == n;
+    TopK<RecommendItem, RecommendItemBetter> top(K);
+    if (K == 0 || n == 0) return top.takeSorted();
+
+    // 1. 作答过的题目：整理参数列后成批抽样（复用静态缓冲区）
+    static std::vector<int32_t> seen;
+    static std::vector<int32_t> alpha;
+    static std::vector<int32_t> beta;
+    static std::vector<double> theta;
+    seen.clear();
+    alpha.clear();
+    beta.clear();
+    if (haveStats) {
+        for (size_t i = 0; i < n; ++i) {
+            int attempts = g_questionStats.totalAttempts[i];
+            if (attempts == 0) continue;
+            int correct = g_questionStats.correctAttempts[i];
+            seen.push_back((int32_t)i);
+            alpha.push_back(attempts - correct + 1);
+            beta.push_back(correct + 1);
+        }
+    }
+    theta.resize(seen.size());
+    sampler.sample(alpha.data(), beta.data(), seen.size(), theta.data());
+    for (size_t j = 0; j < seen.size(); ++j) {
+        if (top.full() && !top.empty() && theta[j] < top.worst().score) continue;
+        top.push({g_questions[seen[j]].id, theta[j], theta[j]});
+    }
+
+    // 2. 未作答题目：只生成最大的 k 个顺序统计量
+    size_t m = n - seen.size();
+    size_t k = std::min(K, m);
+    if (k > 0) {
+        std::vector<int> picked;
+        picked.reserve(k);
+        auto unseen = [&](size_t i) { return !haveStats || g_questionStats.totalAttempts[i] == 0; };
+        if (m * 4 >= n) {
+            // 未作答题目占多数：随机下标拒绝采样，期望每次 n / m <= 4 次
+            std::unordered_set<int> chosen;
+            while (picked.size() < k) {
+                size_t i = uniformIndex(sampler, n);
+                if (unseen(i) && chosen.insert((int)i).second) picked.push_back((int)i);
+            }
+        } else {
+            // 未作答题目较少：列出后做部分 Fisher-Yates
+            std::vector<int> pool;
+            pool.reserve(m);
+            for (size_t i = 0; i < n; ++i) {
+                if (unseen(i)) pool.push_back((int)i);
+            }
+            for (size_t j = 0; j < k; ++j) {
+                std::swap(pool[j], pool[j + uniformIndex(sampler, m - j)]);
+                picked.push_back(pool[j]);
+            }
+        }
+
+        // U(m) = V^(1/m)，U(m-j) = U(m-j+1) × V^(1/(m-j))
+        double u = 1.0;
+        for (size_t j = 0; j < k; ++j) {
+            u *= std::exp(std::log(sampler.uniform()) / (double)(m - j));
+            if (top.full() && !top.empty() && u < top.worst().score) break;   // 之后只会更小
+            top.push({g_questions[picked[j]].id, u, u});
+        }
+    }
+    return top.takeSorted();
+}
+
+/**
+ * @brief 探索推荐模式主函数（实现）
+ *
+ * 采样器在首次进入时取会话随机流 RandomPurpose::Bandit 的一个数作为种子，之后在整个会话中延续同一序列；
+ * 以同一 --seed 启动时抽样结果可以重放。
+ */
+void banditRecommendMode() {
+    if (g_questions.empty()) {
+        std::cout << "题库为空，无法推荐。\n";
+        pauseForUser();
+        return;
+    }
+    if (g_questionStats.size() != g_questions.size()) {
+        buildQuestionStats();
+    }
+
+    static BetaSampler sampler(sessionStream(RandomPurpose::Bandit)());
+    const size_t K = 5;
+    std::vector<RecommendItem> picked = thompsonTopK(K, sampler);
+
+    std::cout << "【探索推荐模式】按每道题\"答错概率\"的后验分布随机抽样，本次抽中 " << picked.size() << " 道题。\n";
+    std::cout << "做错多的题目更常被抽中，作答少的题目也有机会出现；每次进入的结果都不同。\n\n";
+
+    for (size_t i = 0; i < picked.size(); ++i) {
+        auto itQ = g_questionById.find(picked[i].questionId);
+        if (itQ == g_questionById.end()) continue;
+        size_t qIdx = itQ->second;
+
+        int attempts = qIdx < g_questionStats.size() ? g_questionStats.totalAttempts[qIdx] : 0;
+        std::cout << "-----------------------------\n";
+        std::cout << "第 " << (i + 1) << " 道探索题（";
+        if (attempts == 0) {
+            std::cout << "从未作答";
+        } else {
+            std::cout << "已作答 " << attempts << " 次，答对 " << g_questionStats.correctAttempts[qIdx] << " 次";
+        }
+        std::cout << "）：\n";
+
+        doQuestion(g_questions[qIdx]);
+        std::cout << "\n";
+    }
+
+    std::cout << "本轮探索推荐结束。\n";
+    pauseForUser();
+}
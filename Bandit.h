@@ -0,0 +1,105 @@
+/**
+ * @file Bandit.h
+ * @brief 探索式推荐模块 - 基于 Beta 后验的 Thompson 采样
+ *
+ * 【模块职责】
+ * AI 推荐的评分是确定的：统计不变时每次都推荐同样的 5 道题，学生反复看到相同题目，
+ * 其余题目的掌握情况也一直得不到新的作答数据。本模块把"这道题会不会做错"看作一个多臂老虎机：
+ * - 每道题的答错概率 θ 服从后验 Beta(答错次数 + 1, 答对次数 + 1)（均匀先验），直接取自 QuestionStat 的计数
+ * - 每次推荐为每道题抽取一个 θ，取抽样值最大的 K 道（Thompson 采样）
+ * 做错多的题目大概率排在前面，作答少的题目后验宽，也有机会被抽中，探索与利用自动平衡。
+ *
+ * 【大题库的快速采样】
+ * - 作答过的题目：成批调用 BetaSampler::sample()（见下）
+ * - 从未作答的 m 道题后验相同（均为 Beta(1,1)，即 [0,1] 均匀分布），它们中最大的 K 个抽样值
+ *   可以直接按顺序统计量生成：U(m) = V^(1/m)，U(m-1) = U(m) × V^(1/(m-1))，……；
+ *   再随机挑选 K 道未作答题目依次对应。与逐题抽样的联合分布完全相同，代价 O(K) 而非 O(m)
+ * 单次推荐 O(N + T + K log K)，其中 O(N) 只是扫描作答次数列，T 为作答过的题目数。
+ *
+ * 【BetaSampler】
+ * Beta(a, b) = X / (X + Y)，X ~ Gamma(a)，Y ~ Gamma(b)：
+ * - 均匀数成批生成：计数器经 splitmix64 混合得到，每次填满一个缓冲区（循环无依赖，可向量化）
+ * - 形状参数不超过 kSmallGammaShape 的整数 Gamma：-log(k 个均匀数之积)，只需一次对数
+ * - 更大的形状参数：Marsaglia-Tsang 方法（一个正态数 + 一个均匀数，接受率约 98%）
+ * 种子取自会话随机流（Utils.h 的 sessionStream(RandomPurpose::Bandit)）：同一会话种子得到同样的抽样序列。
+ *
+ * 【与其他模块依赖】
+ * - Stats.h：读取 g_questionStats 的作答 / 答对次数列
+ * - App.cpp：主菜单"10. 探索推荐（Thompson 采样）"调用 banditRecommendMode()
+ * - Bench.cpp：--bench-bandit 核对抽样分布并对比逐题抽样的耗时
+ */
+
+#pragma once
+
+#include "Recommender.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// 不超过该值的整数形状参数按"均匀数之积"生成 Gamma（16 个 53 位均匀数之积不会下溢）
+constexpr int32_t kSmallGammaShape = 16;
+
+/**
+ * @class BetaSampler
+ * @brief 成批生成 Beta / Gamma 随机数
+ */
+class BetaSampler {
+public:
+    /**
+     * @brief 以给定种子构造
+     * @param seed 64 位种子（相同种子得到相同的抽样序列）
+     */
+    explicit BetaSampler(uint64_t seed);
+
+    /**
+     * @brief 成批抽样 out[i] ~ Beta(alpha[i], beta[i])
+     * @param alpha 第一个形状参数（>= 1）
+     * @param beta 第二个形状参数（>= 1）
+     * @param n 抽样个数
+     * @param out 输出缓冲区（长度 n）
+     * @complexity O(n + Σ min(形状参数, kSmallGammaShape))
+     */
+    void sample(const int32_t* alpha, const int32_t* beta, size_t n, double* out);
+
+    /// 抽取一个 Gamma(shape, 1) 随机数（shape >= 1）
+    double gamma(int32_t shape);
+
+    /// 抽取一个 (0, 1] 上的均匀随机数
+    double uniform() {
+        if (next_ == kBlock) refill();
+        return buf_[next_++];
+    }
+
+private:
+    static constexpr size_t kBlock = 256;   ///< 均匀数缓冲区大小
+
+    void refill();
+    double normal();
+
+    uint64_t key_;
+    uint64_t counter_ = 0;
+    double buf_[kBlock];
+    size_t next_ = kBlock;
+    bool hasSpare_ = false;
+    double spare_ = 0.0;
+};
+
+/**
+ * @brief Thompson 采样选出 K 道题
+ *
+ * 每道题抽取答错概率 θ ~ Beta(答错 + 1, 答对 + 1)，返回抽样值最大的 K 道
+ * （RecommendItem::score 与 baseScore 均为抽样值）。
+ *
+ * @param K 推荐数量（题库不足 K 道时返回全部）
+ * @param sampler 随机数来源
+ * @return 按抽样值从高到低排列的推荐项
+ * @complexity O(N + T + K log K)，见文件说明
+ */
+std::vector<RecommendItem> thompsonTopK(size_t K, BetaSampler& sampler);
+
+/**
+ * @brief 探索推荐模式主函数
+ *
+ * 以 Thompson 采样选出 5 道题逐题作答；同一会话内多次进入使用同一个采样器，每次结果不同。
+ */
+void banditRecommendMode();
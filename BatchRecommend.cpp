@@ -0,0 +1,277 @@
+/**
+ * @file BatchRecommend.cpp
+ * @brief 批量推荐模块实现
+ *
+ * 实现要点：
+ * 1. **共享预处理**（调用线程，一次）：刷新知识点依赖图；为每道题计算"未作答"评分，
+ *    按补强分组（知识点 ID + 1，无知识点为 0）分桶，组内按 (评分降序, 题号升序) 排序
+ * 2. **流式聚合**（每个用户一个任务）：逐行解析记录文件，按题目下标累加到线程私有的稀疏统计；
+ *    slotOf 把题目下标映射到本用户的槽位，任务结束时只复位被触及的项，不随题库大小清零
+ * 3. **候选集**：作答过的题目逐题评分；未作答题目的评分与用户无关，每组取前 K 道未作答的即可——
+ *    同组题目的补强分相同，组内顺序与 RecommendItemBetter 一致，组内第 K 道之后的题不可能进入 Top-K
+ * 4. **潜因子模型**：加载了模型时未作答题目的评分因人而异，改为以本用户的统计折叠用户行
+ *    （LatentFactorModel::predictUser，作答过的题目按下标升序，与交互式折叠相同），逐题修正后全部参与候选，
+ *    单个用户为 O(N × kMfDim)；未加载模型时仍走共享的分组捷径
+ * 5. **遗忘模型**：加载了模型时作答过的题目以本用户的作答次数求半衰期（HalfLifeModel::halfLifeDays 的计数版本），
+ *    再加上与交互式推荐相同的 halfLifeTimeAdjustment
+ * 6. **调度**：用户按文件名顺序编号交给 parallelFor；记录数相差悬殊时由线程池的区间窃取自动均衡
+ */
+
+#include "BatchRecommend.h"
+#include "HalfLifeRegression.h"
+#include "KnowledgeMastery.h"
+#include "MatrixFactorization.h"
+#include "Question.h"
+#include "RollingStats.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include "TopK.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const char kRecordPrefix[] = "records_";
+const char kRecordSuffix[] = ".csv";
+
+/// 题目所属的补强分组（与 Recommender.cpp 相同）：知识点 ID + 1，无知识点或 ID 越界为 0
+int groupOf(const Question& q) {
+    return (q.knowledgeId >= 0 && (size_t)q.knowledgeId < g_knowledgeNames.size()) ? q.knowledgeId + 1 : 0;
+}
+
+/**
+ * @brief 所有用户共享的只读数据
+ */
+struct BatchShared {
+    const ScoringProfile* profile = nullptr;
+    long long now = 0;
+    long long today = 0;
+    size_t K = 0;
+    bool latent = false;                       ///< 是否加载了潜因子模型（未作答评分按用户修正）
+    bool halfLife = false;                     ///< 是否加载了遗忘模型（已作答评分按用户修正）
+    std::vector<int> group;                    ///< 题目下标 -> 补强分组
+    std::vector<double> unseenScore;           ///< 题目下标 -> 未作答时的逐题评分
+    std::vector<std::vector<int>> byGroup;     ///< 分组 -> 题目下标（评分降序、题号升序）
+};
+
+/**
+ * @brief 线程私有的单用户工作区（在同一线程的多个用户之间复用）
+ */
+struct UserScratch {
+    std::vector<int> slotOf;                   ///< 题目下标 -> 槽位（-1 表示本用户未作答）
+    std::vector<int> touched;                  ///< 槽位 -> 题目下标
+    std::vector<QuestionStat> stats;           ///< 槽位 -> 统计
+    std::vector<RollingWindow> windows;        ///< 槽位 -> 近 30 天窗口
+    std::vector<int64_t> attempts;             ///< 知识点 -> 作答次数
+    std::vector<int64_t> correct;              ///< 知识点 -> 答对次数
+    std::vector<double> own;
+    std::vector<double> inherited;
+    std::vector<int32_t> foldItems;            ///< 潜因子折叠：作答过的题目下标（升序）
+    std::vector<uint32_t> foldAttempts;
+    std::vector<uint32_t> foldCorrect;
+    std::vector<float> predicted;              ///< 题目下标 -> 本用户的预测答对率
+    std::string line;
+};
+
+/**
+ * @brief 为一个用户计算 Top-K 推荐
+ */
+void recommendForUser(const BatchShared& shared, const std::filesystem::path& file, UserRecommendation& out) {
+    thread_local UserScratch s;
+    size_t n = g_questions.size();
+    size_t kCount = g_knowledgeNames.size();
+    if (s.slotOf.size() != n) s.slotOf.assign(n, -1);
+    s.attempts.assign(kCount, 0);
+    s.correct.assign(kCount, 0);
+    s.touched.clear();
+
+    out.userId = userIdFromRecordFile(file);
+    out.records = 0;
+    out.items.clear();
+
+    // 1. 流式聚合
+    std::ifstream fin(file);
+    out.ok = fin.is_open();
+    if (!out.ok) return;
+    Record r;
+    while (std::getline(fin, s.line)) {
+        if (s.line.empty() || !parseRecordLine(s.line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end() || itQ->second >= n) continue;
+        size_t q = itQ->second;
+
+        int slot = s.slotOf[q];
+        if (slot < 0) {
+            slot = (int)s.touched.size();
+            s.slotOf[q] = slot;
+            s.touched.push_back((int)q);
+            if (s.stats.size() <= (size_t)slot) {
+                s.stats.emplace_back();
+                s.windows.emplace_back();
+            }
+            s.stats[slot] = QuestionStat();
+            s.windows[slot] = RollingWindow();
+        }
+        QuestionStat& st = s.stats[slot];
+        st.totalAttempts++;
+        if (r.correct) st.correctAttempts++;
+        st.totalTime += r.usedSeconds;
+        if (r.timestamp > st.lastTimestamp) st.lastTimestamp = r.timestamp;
+        s.windows[slot].add(dayIndexOf(r.timestamp), r.correct, r.usedSeconds);
+
+        int kid = g_questions[q].knowledgeId;
+        if (kid >= 0 && (size_t)kid < kCount) {
+            ++s.attempts[kid];
+            if (r.correct) ++s.correct[kid];
+        }
+        ++out.records;
+    }
+
+    // 2. 前置补强（按本用户的知识点作答次数传播）
+    g_knowledgeMastery.propagate(s.attempts, s.correct, s.own, s.inherited);
+    auto boostOf = [&](int g) {
+        return g == 0 ? 0.0 : shared.profile->weights.prereqWeight * s.inherited[g - 1];
+    };
+
+    // 3. 候选：作答过的题目 + 每组前 K 道未作答题目（加载了潜因子模型时为全部未作答题目）
+    TopK<RecommendItem, RecommendItemBetter> top(shared.K);
+    auto offer = [&](int q, double base) {
+        double total = base + boostOf(shared.group[q]);
+        if (top.full() && !top.empty() && total < top.worst().score) return;
+        top.push({g_questions[q].id, total, base});
+    };
+    for (size_t slot = 0; slot < s.touched.size(); ++slot) {
+        int q = s.touched[slot];
+        QuestionStat& st = s.stats[slot];
+        const WindowTotals& recent = s.windows[slot].query(7, shared.today);
+        st.recentAttempts = recent.attempts;
+        st.recentCorrect = recent.correct;
+        double base = shared.profile->scoreOne(g_questions[q], st, shared.now);
+        if (shared.halfLife) {
+            float halfLife = g_halfLifeModel.halfLifeDays((size_t)q, st.totalAttempts, st.correctAttempts);
+            base += halfLifeTimeAdjustment(*shared.profile, st.lastTimestamp, halfLife, shared.now);
+        }
+        offer(q, base);
+    }
+    s.predicted.clear();
+    if (shared.latent) {
+        // 潜因子：以本用户的统计折叠用户行（作答过的题目按下标升序，与交互式折叠相同）
+        s.foldItems.assign(s.touched.begin(), s.touched.end());
+        std::sort(s.foldItems.begin(), s.foldItems.end());
+        s.foldAttempts.resize(s.foldItems.size());
+        s.foldCorrect.resize(s.foldItems.size());
+        for (size_t k = 0; k < s.foldItems.size(); ++k) {
+            const QuestionStat& st = s.stats[s.slotOf[s.foldItems[k]]];
+            s.foldAttempts[k] = (uint32_t)st.totalAttempts;
+            s.foldCorrect[k] = (uint32_t)st.correctAttempts;
+        }
+        g_latentFactors.predictUser(s.foldItems.data(), s.foldAttempts.data(), s.foldCorrect.data(),
+                                    s.foldItems.size(), s.predicted);
+    }
+    if (!s.predicted.empty()) {
+        // 未作答评分因人而异：逐题修正（与 applyLatentFactors 相同）后全部参与候选
+        for (size_t q = 0; q < n; ++q) {
+            if (s.slotOf[q] >= 0) continue;
+            double base = shared.unseenScore[q];
+            if (s.predicted[q] >= 0.0f) base -= shared.profile->weights.errorWeight * s.predicted[q];
+            offer((int)q, base);
+        }
+    } else {
+        for (const std::vector<int>& members : shared.byGroup) {
+            size_t taken = 0;
+            for (size_t j = 0; j < members.size() && taken < shared.K; ++j) {
+                int q = members[j];
+                if (s.slotOf[q] >= 0) continue;
+                offer(q, shared.unseenScore[q]);
+                ++taken;
+            }
+        }
+    }
+    out.items = top.takeSorted();
+
+    // 4. 只复位本用户触及的题目
+    for (int q : s.touched) s.slotOf[q] = -1;
+}
+
+} // namespace
+
+std::string userIdFromRecordFile(const std::filesystem::path& file) {
+    std::string name = file.filename().string();
+    size_t prefix = sizeof(kRecordPrefix) - 1;
+    size_t suffix = sizeof(kRecordSuffix) - 1;
+    if (name.size() < prefix + suffix) return name;
+    return name.substr(prefix, name.size() - prefix - suffix);
+}
+
+std::vector<std::filesystem::path> listUserRecordFiles(const std::filesystem::path& dir) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) return files;
+
+    size_t prefix = sizeof(kRecordPrefix) - 1;
+    size_t suffix = sizeof(kRecordSuffix) - 1;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix + suffix) continue;   // 用户 ID 不能为空
+        if (name.compare(0, prefix, kRecordPrefix) != 0) continue;
+        if (name.compare(name.size() - suffix, suffix, kRecordSuffix) != 0) continue;
+        files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<UserRecommendation> batchRecommend(const std::vector<std::filesystem::path>& files, size_t K,
+                                               long long now, ThreadPool& pool) {
+    std::vector<UserRecommendation> results(files.size());
+    if (files.empty()) return results;
+
+    // 共享预处理：未作答评分按分组排序
+    BatchShared shared;
+    shared.profile = &activeScoringProfile();
+    shared.now = now;
+    shared.today = dayIndexOf(now);
+    shared.K = K;
+    shared.latent = g_latentFactors.loaded();
+    shared.halfLife = g_halfLifeModel.loaded();
+    g_knowledgeMastery.refresh();
+
+    size_t n = g_questions.size();
+    shared.group.resize(n);
+    shared.unseenScore.resize(n);
+    shared.byGroup.assign(g_knowledgeNames.size() + 1, std::vector<int>());
+    for (size_t q = 0; q < n; ++q) {
+        shared.group[q] = groupOf(g_questions[q]);
+        shared.unseenScore[q] = shared.profile->scoreOne(g_questions[q], QuestionStat(), now);
+        shared.byGroup[shared.group[q]].push_back((int)q);
+    }
+    for (std::vector<int>& members : shared.byGroup) {
+        std::sort(members.begin(), members.end(), [&](int a, int b) {
+            if (shared.unseenScore[a] != shared.unseenScore[b]) return shared.unseenScore[a] > shared.unseenScore[b];
+            return g_questions[a].id < g_questions[b].id;
+        });
+    }
+
+    pool.parallelFor(files.size(), [&](size_t u) { recommendForUser(shared, files[u], results[u]); });
+    return results;
+}
+
+bool writeBatchRecommendations(const std::string& filename, const std::vector<UserRecommendation>& results,
+                               size_t K, long long now) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入批量推荐文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz batch recommendations v1\n";
+    fout << "# profile=" << activeScoringProfile().name << ",k=" << K << ",at=" << now << "\n";
+    for (const UserRecommendation& u : results) {
+        if (!u.ok) continue;
+        fout << u.userId;
+        for (const RecommendItem& item : u.items) fout << ',' << item.questionId;
+        fout << '\n';
+    }
+    return (bool)fout;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file BatchRecommend.h
+ * @brief 批量推荐模块 - 无交互地为全部用户预先计算推荐题目
+ *
+ * 【模块职责】
+ * 为 data 目录下每个 records_<用户ID>.csv 计算"明天的 Top-K 推荐"，写入一个紧凑的结果文件，
+ * 供每晚定时任务提前推送，无需逐个登录交互式菜单。
+ *
+ * 【为什么不复用交互式路径】
+ * 交互式推荐依赖当前用户的全局状态（g_records、g_questionStats、滚动窗口、推荐索引），
+ * 一次只能有一个用户，且每个用户都要 O(N) 重建。批量路径改为：
+ * - 流式聚合：逐行解析记录文件，直接累加到线程私有的稀疏统计（只含作答过的题目），不保存记录本身
+ * - 未作答题目的逐题评分与用户无关，按知识点分组、组内按评分预先排好序（所有用户共享，只读）；
+ *   每个用户只需为作答过的题目评分，再从各组取前 K 道未作答题目作为候选
+ * - 加载了潜因子模型时未作答题目的评分因人而异：以该用户的统计折叠用户行，全部未作答题目逐题修正后参与候选
+ * - 加载了遗忘模型时作答过的题目按该用户的作答次数求半衰期，时间间隔维度同样改用回忆概率
+ * - 前置补强按该用户自己的知识点作答次数计算（KnowledgeMastery::propagate）
+ * - 用户之间相互独立，交给线程池的区间窃取调度（记录数相差悬殊的用户自动均衡）
+ * 单个用户 O(R + T log K + G × K)，R 为记录数，T 为作答过的题目数，G 为知识点数，与题库大小无关；
+ * 加载了潜因子模型时为 O(R + N × kMfDim)，N 为题库大小。
+ *
+ * 【一致性】
+ * 逐题评分使用当前评分配置的 scoreOne，近 7 天窗口使用同一个 RollingWindow，
+ * 潜因子修正与 applyLatentFactors 相同（用户行由同一个 solveMfUserRow 折叠），
+ * 遗忘模型修正与交互式推荐共用 halfLifeTimeAdjustment，
+ * 排序规则为 RecommendItemBetter，因此结果与该用户登录后 recommendTopK(K, now) 完全一致
+ * （前提是加载了相同的潜因子模型与遗忘模型；--bench-batch 在加载与不加载模型时分别核对）。
+ *
+ * 【输出格式】
+ * @code
+ * # DS_AI_Quiz batch recommendations v1
+ * # profile=<配置名>,k=<K>,at=<评估时间戳>
+ * <用户ID>,<题号1>,<题号2>,...,<题号K>
+ * @endcode
+ * 每个用户一行，按用户 ID 排序；题号按推荐顺序排列。
+ */
+
+#pragma once
+
+#include "Recommender.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @struct UserRecommendation
+ * @brief 一个用户的批量推荐结果
+ */
+struct UserRecommendation {
+    std::string userId;                  ///< 用户 ID（由文件名 records_<用户ID>.csv 得到）
+    size_t records = 0;                  ///< 读取的有效记录数（题号在题库中）
+    bool ok = false;                     ///< 记录文件是否成功打开
+    std::vector<RecommendItem> items;    ///< 推荐结果（按推荐顺序）
+};
+
+/**
+ * @brief 列出目录下全部用户记录文件（records_*.csv），按文件名排序
+ * @param dir 数据目录（通常为 getDataDir()）
+ * @return 文件路径列表；目录不存在时为空
+ */
+std::vector<std::filesystem::path> listUserRecordFiles(const std::filesystem::path& dir);
+
+/**
+ * @brief 由记录文件名得到用户 ID（records_<用户ID>.csv -> <用户ID>）
+ */
+std::string userIdFromRecordFile(const std::filesystem::path& file);
+
+/**
+ * @brief 为一组用户并行计算 Top-K 推荐
+ *
+ * 使用当前题库、知识点依赖图、潜因子模型 g_latentFactors、遗忘模型 g_halfLifeModel 与评分配置 activeScoringProfile()。
+ * 不读取也不修改当前登录用户的全局记录与统计。
+ *
+ * @param files 用户记录文件（每个文件一个用户）
+ * @param K 每个用户的推荐数量
+ * @param now 评估时间戳（秒），近 7 天窗口与时间间隔均以此为准
+ * @param pool 执行并行任务的线程池（每个用户一个任务，区间窃取调度）
+ * @return 与 files 一一对应的结果
+ * @complexity 预处理 O(N log N)；每个用户 O(R + T log K + G × K)，加载了潜因子模型时 O(R + N × kMfDim)
+ */
+std::vector<UserRecommendation> batchRecommend(const std::vector<std::filesystem::path>& files, size_t K,
+                                               long long now, ThreadPool& pool);
+
+/**
+ * @brief 把批量推荐结果写入一个文件（格式见文件说明）
+ * @param filename 输出文件路径
+ * @param results batchRecommend() 的结果（未能打开记录文件的用户不输出）
+ * @param K 每个用户的推荐数量
+ * @param now 评估时间戳
+ * @return true 写出成功；false 文件无法打开
+ */
+bool writeBatchRecommendations(const std::string& filename, const std::vector<UserRecommendation>& results,
+                               size_t K, long long now);
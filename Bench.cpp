@@ -0,0 +1,2100 @@
+/**
+ * @file Bench.cpp
+ * @brief 基准与一致性核对程序实现
+ *
+ * 实现要点：
+ * 1. **子命令表**：argv[1] 与子命令名逐一比较，未知子命令输出用法并返回 1；
+ *    各基准在分派前共用题库加载（知识点名称、题号 -> 下标），与用户程序的子命令相同
+ * 2. **内核微基准**：固定种子生成合成列式记录，分别以标量与 AVX2 内核运行，
+ *    取 5 次中的最快一次换算吞吐量，并核对两者结果一致
+ * 3. **推荐评分基准**：合成稠密统计列，每个评分配置在各指令集下的批量评分与
+ *    该配置的逐题评分核对，并输出吞吐量
+ * 4. **并行统计基准**：合成记录直接写入 g_recordColumns，以 1, 2, 4, ... 个线程
+ *    分别运行 buildQuestionStatsParallel()，输出耗时与加速比，并核对各线程数结果一致
+ * 5. **推荐选择基准**：合成百万级推荐项，对比全量大根堆（O(N log N)）与 TopK 小根堆
+ *    （O(N log K)）选出前 K 项的耗时；再以合成题库对比全量评分与增量推荐索引，
+ *    并核对各方式选出的题号与顺序一致、增量查询在时间预算内；最后模拟反复进出菜单，输出推荐结果缓存的命中率
+ * 6. **间隔复习基准**：合成题库与作答记录，逐日对比日历队列取到期题目与扫描全部题目的到期日，
+ *    并核对两者得到的到期集合一致
+ * 7. **批量推荐基准**：在临时目录合成长尾分布的用户记录，对比 1 线程与全部核心的吞吐量，
+ *    并抽样与交互式推荐逐项核对
+ * 8. **Thompson 采样基准**：先核对 Beta 抽样的均值 / 方差与小题库上的 Top-1 选中频率，
+ *    再在百万级合成题库上对比逐题抽样与成批抽样 + 顺序统计量的耗时
+ * 9. **回放评估基准**：合成带"薄弱知识点"的作答模型，对比 1 线程与全部核心的吞吐量并核对结果一致
+ * 10. **BKT 拟合基准**：按已知参数合成作答序列，核对拟合结果与真实参数的差距以及单线程 / 多线程结果一致
+ * 11. **IRT 校准基准**：在内存中按已知参数合成作答矩阵，核对参数恢复与单线程 / 多线程结果一致
+ * 12. **共错题基准**：按"同组误区"合成错题本，核对单线程 / 多线程结果一致与邻居的同组比例
+ * 13. **潜因子模型基准**：按已知低秩模型合成作答，核对标量 / 向量、单线程 / 多线程结果一致，
+ *    并在留出集上与题目答对率对比 AUC
+ * 14. **遗忘模型基准**：按已知的半衰期模型合成作答，核对单线程 / 多线程结果一致，
+ *    并在留出用户上与 7 天线性时间项对比回忆预测的 AUC
+ * 15. **知识点依赖图基准**：合成十万级知识点的课程体系，对比按名称邻接表与编译后 CSR + 位图的
+ *    复习路径查询并逐项核对；再核对植入的循环依赖，并在百万级单链上运行迭代 DFS 与 Tarjan（参照实现仍为递归，只用于短路径）
+ */
+
+#include "Bench.h"
+#include "Cli.h"
+#include "Bandit.h"
+#include "BatchRecommend.h"
+#include "CoError.h"
+#include "HalfLifeRegression.h"
+#include "IrtCalibration.h"
+#include "Question.h"
+#include "Recommender.h"
+#include "RecommendTrace.h"
+#include "Stats.h"
+#include "Kernels.h"
+#include "KnowledgeGraph.h"
+#include "KnowledgeMastery.h"
+#include "KnowledgeTracing.h"
+#include "MatrixFactorization.h"
+#include "Record.h"
+#include "ReplayEval.h"
+#include "RollingStats.h"
+#include "SpacedReview.h"
+#include "ThreadPool.h"
+#include "TopK.h"
+#include "Utils.h"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <thread>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+/// 输出基准程序用法
+void printBenchUsage() {
+    std::cout << "用法：\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-kernels [记录数]       聚合内核微基准（默认 1000 万条，标量 vs AVX2）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-scores [题目数]        推荐评分内核基准（默认 100 万题，标量 vs AVX2 vs AVX-512）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-stats [记录数]         并行统计重建基准（默认 1000 万条，1 线程到全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-recommend [题目数]     推荐基准（默认 100 万题，全量堆 vs TopK vs 增量索引）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-review [题目数]        间隔复习调度基准（默认 100 万题，日历队列 vs 全量扫描）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-batch [用户数]         批量推荐基准（默认 1 万名用户，1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-bandit [题目数]        Thompson 采样基准（默认 100 万题，分布核对 + 逐题抽样 vs 成批抽样）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-replay [用户数]        回放评估基准（默认 1 万名用户，1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-bkt [用户数]           BKT 拟合基准（默认 5000 名合成用户，参数恢复 + 1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-irt [用户数] [题目数]  IRT 校准基准（默认 10 万用户 × 10 万题，参数恢复 + 1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-co-error [用户数] [题目数]  共错题统计基准（默认 10 万用户 × 10 万题，1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-mf [用户数] [题目数]   潜因子模型基准（默认 2 万用户 × 2 万题，各指令集 vs 标量、1 线程 vs 全部核心）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-hlr [用户数]           遗忘模型基准（默认 5000 名合成用户，1 线程 vs 全部核心 + 留出用户的回忆预测）\n";
+    std::cout << "  DS_AI_Quiz_Bench --bench-graph [知识点数]       知识点依赖图基准（默认 10 万个知识点，按名称邻接表 vs CSR + 位图，环检测与百万级单链）\n";
+    std::cout << "  DS_AI_Quiz_Bench --help                 显示本帮助\n";
+    std::cout << "\n各子命令发现不一致时返回 1，可直接用于持续集成（ctest）。\n";
+    printGlobalOptions();
+}
+
+/**
+ * @brief 子命令 --bench-kernels：聚合内核微基准
+ *
+ * 合成数据：知识点数取题库实际知识点数，约 1% 的记录为非法知识点 ID，
+ * 正误各半，用时 1-300 秒。
+ */
+int runBenchKernels(const std::vector<std::string>& args) {
+    size_t n = 10000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "记录数无效：" << args[0] << "\n";
+        return 1;
+    }
+    size_t knowledgeCount = g_knowledgeNames.empty() ? 10 : g_knowledgeNames.size();
+
+    std::vector<int32_t> knowledgeId(n);
+    std::vector<uint8_t> correct(n);
+    std::vector<int32_t> seconds(n);
+    std::mt19937 rng(20240601);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = rng();
+        knowledgeId[i] = (r % 100 == 0) ? -1 : (int32_t)((r >> 8) % knowledgeCount);
+        correct[i] = (uint8_t)((r >> 20) & 1);
+        seconds[i] = 1 + (int32_t)((r >> 21) % 300);
+    }
+
+    // 运行 5 次取最快一次，返回吞吐量（百万条/秒）
+    auto measure = [n](auto&& fn) {
+        double best = 1e100;
+        for (int rep = 0; rep < 5; ++rep) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+        }
+        return n / best / 1e6;
+    };
+
+    struct Result {
+        double countRate, sumRate, histRate;
+        int64_t correctSum, secondsSum;
+        KnowledgeHistogram hist;
+    };
+    auto runAll = [&](KernelIsa isa, Result& res) {
+        setKernelIsa(isa);
+        res.countRate = measure([&] { res.correctSum = kernelCountCorrect(correct.data(), n); });
+        res.sumRate = measure([&] { res.secondsSum = kernelSumSeconds(seconds.data(), n); });
+        res.histRate = measure([&] {
+            kernelKnowledgeHistogram(knowledgeId.data(), correct.data(), seconds.data(), n, knowledgeCount, res.hist);
+        });
+    };
+
+    KernelIsa best = detectKernelIsa();
+    std::cout << "===== 聚合内核微基准 =====\n";
+    std::cout << "记录数: " << n << "  知识点数: " << knowledgeCount
+         << "  CPU 支持: " << kernelIsaName(best) << "\n\n";
+
+    Result scalar;
+    runAll(KernelIsa::Scalar, scalar);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[scalar] 答对计数: " << scalar.countRate << " M/s"
+         << "  用时求和: " << scalar.sumRate << " M/s"
+         << "  知识点直方图: " << scalar.histRate << " M/s\n";
+
+    if (best != KernelIsa::Scalar) {
+        // AVX-512 级别下归约与直方图沿用 AVX2 实现，这里统一以 AVX2 对比
+        Result avx2;
+        runAll(KernelIsa::Avx2, avx2);
+        std::cout << "[avx2]   答对计数: " << avx2.countRate << " M/s"
+             << "  用时求和: " << avx2.sumRate << " M/s"
+             << "  知识点直方图: " << avx2.histRate << " M/s\n";
+        std::cout << "[加速比] 答对计数: " << avx2.countRate / scalar.countRate << "x"
+             << "  用时求和: " << avx2.sumRate / scalar.sumRate << "x"
+             << "  知识点直方图: " << avx2.histRate / scalar.histRate << "x\n";
+
+        bool same = avx2.correctSum == scalar.correctSum && avx2.secondsSum == scalar.secondsSum &&
+                    avx2.hist.total == scalar.hist.total && avx2.hist.correct == scalar.hist.correct &&
+                    avx2.hist.seconds == scalar.hist.seconds;
+        std::cout << "结果一致性: " << (same ? "一致" : "不一致！") << "\n";
+        if (!same) return 1;
+    } else {
+        std::cout << "当前 CPU 不支持 AVX2，仅运行标量实现。\n";
+    }
+    setKernelIsa(best);
+    return 0;
+}
+
+/**
+ * @brief 子命令 --bench-scores：批量推荐评分内核基准
+ *
+ * 合成统计列：约 40% 的题目从未作答，作答过的题目最近作答时间分布在最近 30 天
+ * （少量为未来时间，模拟时钟偏差），难度含少量越界值以覆盖截断分支。
+ * 对每个评分配置（scoringProfiles()）、每种指令集运行 5 次取最快一次，
+ * 并与该配置的逐题评分 scoreOne（编译期专门化）逐题核对。
+ */
+int runBenchScores(const std::vector<std::string>& args) {
+    size_t n = 1000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "题目数无效：" << args[0] << "\n";
+        return 1;
+    }
+
+    std::vector<int32_t> attempts(n), correct(n), recentAttempts(n), recentCorrect(n), difficulty(n);
+    std::vector<long long> lastTimestamp(n);
+    std::mt19937 rng(20240601);
+    long long now = (long long)std::time(nullptr);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = rng();
+        attempts[i] = (r % 10 < 4) ? 0 : 1 + (int32_t)((r >> 4) % 20);
+        correct[i] = attempts[i] == 0 ? 0 : (int32_t)((r >> 9) % (attempts[i] + 1));
+        recentAttempts[i] = attempts[i] == 0 ? 0 : (int32_t)((r >> 14) % (attempts[i] + 1));
+        recentCorrect[i] = recentAttempts[i] == 0 ? 0 : (int32_t)((r >> 19) % (recentAttempts[i] + 1));
+        difficulty[i] = (r >> 24) % 50 == 0 ? (int32_t)((r >> 30) * 7) : 1 + (int32_t)((r >> 24) % 5);
+        if (attempts[i] > 0) {
+            long long back = (long long)(rng() % (30LL * 86400));
+            lastTimestamp[i] = (r >> 29) == 0 ? now + back % 3600 : now - back;
+        }
+    }
+    RecommendScoreColumns cols{attempts.data(), correct.data(), recentAttempts.data(), recentCorrect.data(),
+                               lastTimestamp.data(), difficulty.data(), n};
+
+    KernelIsa best = detectKernelIsa();
+    std::cout << "===== 推荐评分内核基准 =====\n";
+    std::cout << "题目数: " << n << "  CPU 支持: " << kernelIsaName(best)
+         << "  当前配置: " << activeScoringProfile().name << "\n";
+
+    std::vector<KernelIsa> isas = {KernelIsa::Scalar};
+    if (best != KernelIsa::Scalar) isas.push_back(KernelIsa::Avx2);
+    if (best == KernelIsa::Avx512) isas.push_back(KernelIsa::Avx512);
+
+    // 5 次取最快一次，返回吞吐量（M/s）
+    auto timeRate = [&](auto&& run) {
+        double bestSec = 1e100;
+        for (int rep = 0; rep < 5; ++rep) {
+            auto t0 = std::chrono::steady_clock::now();
+            run();
+            auto t1 = std::chrono::steady_clock::now();
+            bestSec = std::min(bestSec, std::chrono::duration<double>(t1 - t0).count());
+        }
+        return n / bestSec / 1e6;
+    };
+
+    std::vector<double> expected(n);
+    std::vector<double> out(n);
+    bool allMatch = true;
+    for (const ScoringProfile& profile : scoringProfiles()) {
+        // 参照：逐题调用该配置的 scoreOne
+        Question q;
+        for (size_t i = 0; i < n; ++i) {
+            QuestionStat st;
+            st.totalAttempts = attempts[i];
+            st.correctAttempts = correct[i];
+            st.lastTimestamp = lastTimestamp[i];
+            st.recentAttempts = recentAttempts[i];
+            st.recentCorrect = recentCorrect[i];
+            q.difficulty = difficulty[i];
+            expected[i] = profile.scoreOne(q, st, now);
+        }
+
+        std::cout << "\n[" << profile.name << " " << profile.label << "]\n";
+        double scalarRate = 0.0;
+        for (KernelIsa isa : isas) {
+            setKernelIsa(isa);
+            double rate = timeRate([&] { profile.scoreBatch(cols, now, out.data()); });
+            if (isa == KernelIsa::Scalar) scalarRate = rate;
+
+            size_t exact = 0;
+            double maxDiff = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                double d = std::fabs(out[i] - expected[i]);
+                if (d == 0.0) ++exact;
+                maxDiff = std::max(maxDiff, d);
+            }
+            bool match = maxDiff <= 1e-12;
+            allMatch = allMatch && match;
+
+            std::cout << std::fixed << std::setprecision(1)
+                 << "  [" << kernelIsaName(isa) << "] " << rate << " M/s"
+                 << "  加速比: " << std::setprecision(2) << rate / scalarRate << "x"
+                 << "  逐位相同: " << exact << "/" << n
+                 << "  最大误差: " << std::scientific << std::setprecision(1) << maxDiff
+                 << std::defaultfloat << "\n";
+        }
+    }
+
+    std::cout << "结果一致性（与各配置的逐题评分相比，容差 1e-12）: " << (allMatch ? "一致" : "不一致！") << "\n";
+    setKernelIsa(best);
+    return allMatch ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-stats：并行统计重建基准
+ *
+ * 合成数据：题目均匀取自题库，时间戳分布在最近 60 天，正误各半，用时 1-300 秒。
+ * 每个线程数运行 3 次取最快一次。
+ */
+int runBenchStats(const std::vector<std::string>& args) {
+    size_t n = 10000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "记录数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (g_questions.empty()) return 1;
+
+    // 合成列式记录（只填 g_recordColumns，并行路径只读取列式数据）
+    clearUserRecords();
+    RecordColumns& cols = g_recordColumns;
+    cols.questionIndex.resize(n);
+    cols.knowledgeId.resize(n);
+    cols.correct.resize(n);
+    cols.usedSeconds.resize(n);
+    cols.timestamp.resize(n);
+    std::mt19937_64 rng(20240601);
+    long long now = (long long)std::time(nullptr);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t r = rng();
+        size_t q = (size_t)(r % g_questions.size());
+        cols.questionIndex[i] = (int32_t)q;
+        cols.knowledgeId[i] = g_questions[q].knowledgeId;
+        cols.correct[i] = (uint8_t)((r >> 20) & 1);
+        cols.usedSeconds[i] = 1 + (int32_t)((r >> 21) % 300);
+        cols.timestamp[i] = now - (long long)((r >> 32) % (60LL * 86400));
+    }
+
+    size_t maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "===== 并行统计重建基准 =====\n";
+    std::cout << "记录数: " << n << "  题目数: " << g_questions.size()
+         << "  可用核心: " << maxThreads << "\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    double baseSeconds = 0.0;
+    long long refAttempts = -1;
+    long long refTime = -1;
+    int refWindow30 = -1;
+    bool consistent = true;
+    long long today = dayIndexOf(now);
+    for (size_t t : threadCounts) {
+        ThreadPool pool(t);
+        double best = 1e100;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto t0 = std::chrono::steady_clock::now();
+            buildQuestionStatsParallel(pool);
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+        }
+        if (baseSeconds == 0.0) baseSeconds = best;
+
+        // 结果核对：总作答次数、总用时、近 30 天总体作答数
+        long long attempts = 0;
+        long long totalTime = 0;
+        for (size_t q = 0; q < g_questionStats.size(); ++q) {
+            attempts += g_questionStats.totalAttempts[q];
+            totalTime += g_questionStats.totalTime[q];
+        }
+        int window30 = g_overallWindow.query(30, today).attempts;
+        if (refAttempts < 0) {
+            refAttempts = attempts;
+            refTime = totalTime;
+            refWindow30 = window30;
+        } else if (attempts != refAttempts || totalTime != refTime || window30 != refWindow30) {
+            consistent = false;
+        }
+
+        std::cout << "[" << t << " 线程] 耗时: " << best << " 秒"
+             << "  吞吐: " << std::setprecision(1) << n / best / 1e6 << " M/s"
+             << "  加速比: " << std::setprecision(2) << baseSeconds / best << "x\n"
+             << std::setprecision(3);
+    }
+    std::cout << "结果一致性: " << (consistent ? "一致" : "不一致！") << "\n";
+    return consistent ? 0 : 1;
+}
+
+/**
+ * @brief 以 n 道合成题目替换当前题库，并清空记录、重置统计表
+ *
+ * 题目只填评分与调度用到的字段（题号、难度、知识点），难度与知识点循环取自真实题库。
+ */
+void installSyntheticBank(size_t n) {
+    std::vector<Question> base = g_questions;
+    g_questions.clear();
+    g_questions.reserve(n);
+    g_questionById.clear();
+    for (size_t i = 0; i < n; ++i) {
+        const Question& b = base[i % base.size()];
+        Question q;
+        q.id = (int)i + 1;
+        q.answer = 0;
+        q.difficulty = b.difficulty;
+        q.knowledgeId = b.knowledgeId;
+        g_questions.push_back(q);
+        g_questionById[q.id] = i;
+    }
+    clearUserRecords();
+    buildQuestionStats();   // 无记录：按 n 道题重置统计表
+}
+
+/**
+ * @brief 子命令 --bench-recommend：推荐 Top-K 选择基准
+ *
+ * 合成数据：分数取 computeRecommendScore 的取值范围 [0, 1.2]，量化到 0.001，
+ * 使大量题目同分，用于同时检验同分时按题号决胜的确定性。K = 5，运行 5 次取最快一次。
+ *
+ * 第二部分以同样规模的合成题库（近一年 10 万条历史记录）对比每次推荐的耗时：
+ * 全量评分 recommendTopK() 与增量索引 g_recommendIndex.topK()，
+ * 并模拟 200 次作答，每次作答后核对两者的推荐结果完全一致。
+ * 两者都包含前置补强阶段（加载 data/knowledge_graph.txt），同时统计每次作答后重算的知识点数。
+ * 之后加载一组合成的遗忘模型权重再模拟 200 次，输出按预计到期日分桶后的活跃题目数并同样逐次核对。
+ * 两轮都检查增量查询的时间预算：平均与 95 分位耗时须小于 1 ms，超出时返回失败。
+ *
+ * 第三部分模拟反复进出 AI 推荐菜单 2000 次（其间每 100 次作答一题），
+ * 输出推荐结果缓存的命中 / 未命中 / 失效次数与平均耗时，并核对作答后的结果与索引一致。
+ *
+ * 第四部分在真实题库规模（120 道）上模拟一名某个知识点明显薄弱的学生，
+ * 对比按分数取前 K 与 MMR 多样化选择的知识点数、难度跨度与耗时，并核对 λ = 1 时 MMR 退化为按分数取前 K。
+ */
+int runBenchRecommend(const std::vector<std::string>& args) {
+    size_t n = 1000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "题目数无效：" << args[0] << "\n";
+        return 1;
+    }
+    const size_t K = 5;
+
+    std::vector<RecommendItem> items(n);
+    std::mt19937 rng(20240601);
+    for (size_t i = 0; i < n; ++i) {
+        items[i].questionId = (int)i + 1;
+        items[i].score = (rng() % 1201) / 1000.0;
+    }
+    std::shuffle(items.begin(), items.end(), rng);   // 题号顺序与扫描顺序无关
+
+    auto measure = [](auto&& fn) {
+        double best = 1e100;
+        for (int rep = 0; rep < 5; ++rep) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+        }
+        return best * 1e3;
+    };
+
+    // 全量大根堆：全部 N 项入堆（逐个上浮），再弹出 K 次
+    RecommendItemBetter better;
+    auto heapLess = [&](const RecommendItem& a, const RecommendItem& b) { return better(b, a); };
+    std::vector<int> heapIds;
+    double heapMs = measure([&] {
+        std::vector<RecommendItem> heap;
+        for (const RecommendItem& item : items) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), heapLess);
+        }
+        heapIds.clear();
+        while (!heap.empty() && heapIds.size() < K) {
+            heapIds.push_back(heap.front().questionId);
+            std::pop_heap(heap.begin(), heap.end(), heapLess);
+            heap.pop_back();
+        }
+    });
+
+    // TopK 小根堆：流式保留 K 项
+    std::vector<int> topIds;
+    double topMs = measure([&] {
+        TopK<RecommendItem, RecommendItemBetter> top(K);
+        for (const RecommendItem& item : items) top.push(item);
+        topIds.clear();
+        for (const RecommendItem& item : top.takeSorted()) topIds.push_back(item.questionId);
+    });
+
+    std::cout << "===== 推荐 Top-K 选择基准 =====\n";
+    std::cout << "题目数: " << n << "  K: " << K << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[全量大根堆] 耗时: " << heapMs << " ms\n";
+    std::cout << "[TopK 小根堆] 耗时: " << topMs << " ms"
+         << "  加速比: " << heapMs / topMs << "x\n";
+
+    bool same = heapIds == topIds;
+    std::cout << "推荐题号: ";
+    for (int id : topIds) std::cout << id << " ";
+    std::cout << "\n结果一致性: " << (same ? "一致" : "不一致！") << "\n";
+    if (!same) return 1;
+
+    // ---- 第二部分：增量推荐索引 vs 全量评分 ----
+    // 合成题库：n 道题，近一年内 10 万条历史记录
+    loadKnowledgeGraphFromFile((getDataDir() / "knowledge_graph.txt").string());
+    installSyntheticBank(n);
+    g_knowledgeMastery.refresh();   // 以空记录构建知识点掌握度
+
+    long long now = (long long)std::time(nullptr);
+    auto answer = [&](long long ts) {
+        Record r;
+        r.questionId = (int)(rng() % n) + 1;
+        r.correct = (rng() & 1) != 0;
+        r.usedSeconds = 1 + (int)(rng() % 300);
+        r.timestamp = ts;
+        applyRecordToStats(r);
+        markRecommendDirty(r.questionId);
+        applyRecordToMastery(r);
+    };
+    std::vector<long long> history(100000);
+    for (auto& ts : history) ts = now - (long long)(rng() % (365LL * 86400));
+    std::sort(history.begin(), history.end());
+    for (long long ts : history) answer(ts);
+
+    double fullMs = measure([&] { recommendTopK(K, now); });
+
+    g_recommendIndex.invalidate();
+    auto t0 = std::chrono::steady_clock::now();
+    g_recommendIndex.topK(K, now);
+    double buildMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1e3;
+
+    // 模拟 200 次"作答 -> 再次推荐"，每次间隔 30 分钟（跨越多天，覆盖桶到期），逐次与全量评分核对
+    // 增量查询的时间预算：平均与 95 分位都须在 1 ms 以内（与题库大小无关）
+    const int kRounds = 200;
+    const double kQueryBudgetMs = 1.0;
+    struct IndexRun {
+        double sumMs = 0.0;
+        double maxMs = 0.0;
+        std::vector<double> samples;
+        size_t recomputed = 0;
+        bool same = true;
+
+        double avgMs() const { return samples.empty() ? 0.0 : sumMs / samples.size(); }
+        double p95Ms() const {
+            if (samples.empty()) return 0.0;
+            std::vector<double> sorted = samples;
+            size_t k = sorted.size() * 95 / 100;
+            std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+            return sorted[k];
+        }
+    };
+    auto indexRounds = [&]() {
+        IndexRun run;
+        for (int round = 0; round < kRounds; ++round) {
+            now += 1800;
+            answer(now);
+            auto q0 = std::chrono::steady_clock::now();
+            std::vector<RecommendItem> got = g_recommendIndex.topK(K, now);
+            double ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - q0).count() * 1e3;
+            run.sumMs += ms;
+            run.maxMs = std::max(run.maxMs, ms);
+            run.samples.push_back(ms);
+            run.recomputed += g_knowledgeMastery.lastRecomputed();
+
+            std::vector<RecommendItem> ref = recommendTopK(K, now);
+            for (size_t j = 0; j < ref.size(); ++j) {
+                if (got.size() != ref.size() || got[j].questionId != ref[j].questionId || got[j].score != ref[j].score) {
+                    run.same = false;
+                }
+            }
+        }
+        return run;
+    };
+    IndexRun linear = indexRounds();
+    size_t linearLive = g_recommendIndex.liveCount();
+
+    // 加载遗忘模型（合成权重：答对延长、答错缩短半衰期，多为数天到数周）后重复一遍：
+    // 活跃题目按各自的预计到期日移出，与只按评分配置的活跃窗口相比不应大幅增加
+    HalfLifeParams hlr;
+    hlr.bias = 1.5;
+    hlr.correct = 2.0;
+    hlr.wrong = -1.0;
+    std::filesystem::path hlrPath = std::filesystem::temp_directory_path() / "ds_ai_quiz_bench_half_life.txt";
+    bool hlrLoaded = saveHalfLifeParams(hlrPath.string(), hlr) && loadHalfLifeParamsFromFile(hlrPath.string());
+    std::error_code removeError;
+    std::filesystem::remove(hlrPath, removeError);
+    IndexRun forgetting;
+    size_t forgettingLive = 0;
+    size_t profileWindow = 0;
+    size_t answeredYear = 0;
+    if (hlrLoaded) {
+        g_recommendIndex.topK(K, now);   // 整体重建
+        forgetting = indexRounds();
+        forgettingLive = g_recommendIndex.liveCount();
+        // 同一时刻的对照：只按评分配置的活跃窗口，以及按半衰期上限的固定窗口
+        long long today = dayIndexOf(now);
+        for (size_t i = 0; i < g_questionStats.size(); ++i) {
+            long long last = g_questionStats.lastTimestamp[i];
+            if (last <= 0) continue;
+            if (dayIndexOf(last) + activeScoringProfile().settleDays > today) ++profileWindow;
+            if (last > now - (long long)(kHlrMaxHalfLifeDays + 1) * 86400) ++answeredYear;
+        }
+        // 卸载遗忘模型，后续部分按原评分进行
+        g_halfLifeModel = HalfLifeModel();
+        g_recommendIndex.invalidate();
+        g_recommendCache.invalidate();
+    }
+
+    std::cout << "\n===== 增量推荐索引 =====\n";
+    std::cout << "题目数: " << n << "  历史记录: " << history.size()
+         << "  活跃题目（评分尚未稳定）: " << linearLive << "\n\n";
+    std::cout << "[全量评分 + TopK] 每次推荐: " << fullMs << " ms\n";
+    std::cout << "[增量索引] 首次构建: " << buildMs << " ms"
+         << "  之后每次推荐: 平均 " << std::setprecision(3) << linear.avgMs()
+         << " ms  95 分位 " << linear.p95Ms() << " ms  最长 " << linear.maxMs << " ms\n";
+    std::cout << "[前置补强] 依赖图节点: " << g_knowledgeMastery.nodeCount()
+         << "  每次作答后平均重算: " << std::setprecision(2) << (double)linear.recomputed / kRounds << " 个知识点\n";
+    if (hlrLoaded) {
+        std::cout << "[增量索引 + 遗忘模型] 活跃题目: " << forgettingLive << "（同一时刻只按评分配置为 " << profileWindow
+             << "，按半衰期上限的固定窗口为 " << answeredYear << "）  每次推荐: 平均 " << std::setprecision(3) << forgetting.avgMs() << " ms  95 分位 "
+             << forgetting.p95Ms() << " ms  最长 " << forgetting.maxMs << " ms\n";
+    }
+    auto withinBudget = [&](const IndexRun& run) {
+        return run.avgMs() < kQueryBudgetMs && run.p95Ms() < kQueryBudgetMs;
+    };
+    bool indexFast = withinBudget(linear) && (!hlrLoaded || withinBudget(forgetting));
+    std::cout << "时间预算（平均与 95 分位 < " << kQueryBudgetMs << " ms）: " << (indexFast ? "满足" : "超出！") << "\n";
+    bool indexSame = linear.same && (!hlrLoaded || forgetting.same);
+    std::cout << "结果一致性（" << kRounds << " 次作答后逐次核对" << (hlrLoaded ? "，含遗忘模型" : "") << "）: "
+         << (indexSame ? "一致" : "不一致！") << "\n";
+
+    // ---- 第三部分：推荐结果缓存 ----
+    // 模拟反复进出 AI 推荐菜单（每次间隔 1 秒，不作答），每 100 次作答一题
+    const int kVisits = 2000;
+    g_recommendCache.invalidate();
+    g_recommendCache.resetCounters();
+    double cachedMs = 0.0;
+    bool cacheSame = true;
+    for (int visit = 0; visit < kVisits; ++visit) {
+        now += 1;
+        if (visit % 100 == 99) answer(now);
+        auto c0 = std::chrono::steady_clock::now();
+        std::vector<RecommendItem> got = g_recommendCache.topK(K, now);
+        cachedMs += std::chrono::duration<double>(std::chrono::steady_clock::now() - c0).count() * 1e3;
+
+        // 作答后的首次查询必须未命中，且与索引的精确结果一致
+        if (visit % 100 == 99) {
+            std::vector<RecommendItem> ref = g_recommendIndex.topK(K, now);
+            if (got.size() != ref.size()) cacheSame = false;
+            for (size_t j = 0; cacheSame && j < ref.size(); ++j) {
+                if (got[j].questionId != ref[j].questionId || got[j].score != ref[j].score) cacheSame = false;
+            }
+        }
+    }
+
+    std::cout << "\n===== 推荐结果缓存 =====\n";
+    std::cout << "进入菜单: " << kVisits << " 次  其间作答: " << kVisits / 100 << " 次  时间桶: "
+         << kRecommendCacheBucketSeconds << " 秒\n";
+    std::cout << "命中: " << g_recommendCache.hits() << "  未命中: " << g_recommendCache.misses()
+         << "  显式失效: " << g_recommendCache.invalidations()
+         << "  每次进入平均: " << std::setprecision(4) << cachedMs / kVisits << " ms\n";
+    std::cout << "结果一致性（作答后首次查询 vs 增量索引）: " << (cacheSame ? "一致" : "不一致！") << "\n";
+
+    // ---- 第四部分：多样化选择（MMR） ----
+    // 合成题库中大量题目同分，前若干道几乎都来自同一知识点；改用与真实题库相同的前 120 道题，
+    // 模拟一名某个知识点明显薄弱的学生（该知识点答对率 30%，其余 80%）
+    installSyntheticBank(std::min<size_t>(n, 120));
+    int weakKnowledge = g_questions[0].knowledgeId;
+    for (int i = 0; i < 600; ++i) {
+        const Question& q = g_questions[rng() % g_questions.size()];
+        Record r;
+        r.questionId = q.id;
+        r.correct = rng() % 10 < (q.knowledgeId == weakKnowledge ? 3u : 8u);
+        r.usedSeconds = 1 + (int)(rng() % 300);
+        r.timestamp = now - (long long)(rng() % (30LL * 86400));
+        applyRecordToStats(r);
+        applyRecordToMastery(r);
+    }
+    size_t poolSize = K * kDiversityPoolFactor;
+    std::vector<RecommendItem> plain = recommendTopK(K, now);
+    std::vector<RecommendItem> pool = recommendTopK(poolSize, now);
+    const int kMmrRounds = 1000;
+    std::vector<RecommendItem> diverse;
+    auto m0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kMmrRounds; ++i) diverse = diversifyTopK(pool, K, kDiversityLambda);
+    double mmrMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - m0).count() * 1e3 / kMmrRounds;
+
+    // λ = 1 时不考虑相似度，应与按分数取前 K 完全相同
+    std::vector<RecommendItem> pure = diversifyTopK(pool, K, 1.0);
+    bool mmrSame = pure.size() == plain.size();
+    for (size_t j = 0; mmrSame && j < plain.size(); ++j) mmrSame = pure[j].questionId == plain[j].questionId;
+
+    auto describe = [](const std::vector<RecommendItem>& items) {
+        std::vector<int> kids;
+        int lo = 5, hi = 1;
+        for (const RecommendItem& item : items) {
+            const Question& q = g_questions[g_questionById[item.questionId]];
+            kids.push_back(q.knowledgeId);
+            lo = std::min(lo, q.difficulty);
+            hi = std::max(hi, q.difficulty);
+        }
+        std::sort(kids.begin(), kids.end());
+        size_t distinct = std::unique(kids.begin(), kids.end()) - kids.begin();
+        std::cout << "知识点 " << distinct << " 个  难度 " << lo << "~" << hi << "  最低分 " << std::setprecision(4)
+             << (items.empty() ? 0.0 : items.back().score) << "\n";
+    };
+    std::cout << std::defaultfloat;
+    std::cout << "\n===== 多样化选择（MMR，" << g_questions.size() << " 道题，候选池 " << poolSize << " 道，λ = "
+         << kDiversityLambda << "） =====\n";
+    std::cout << "[按分数] ";
+    describe(plain);
+    std::cout << "[MMR] ";
+    describe(diverse);
+    std::cout << "MMR 阶段每次: " << std::setprecision(4) << mmrMs << " ms\n";
+    std::cout << "结果一致性（λ = 1 vs 按分数）: " << (mmrSame ? "一致" : "不一致！") << "\n";
+    return indexSame && indexFast && cacheSame && mmrSame ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-review：间隔复习日历队列基准
+ *
+ * 合成题库 n 道题，模拟一名按时复习的学习者：每天复习全部到期题目，另新做 2000 道随机题目。
+ * 先模拟 120 天积累复习计划，再模拟 60 天，每天对比两种方式回答一次复习会话的查询
+ * （到期题数 + 逾期最久的 10 道）：
+ * - 日历队列：dueCount() + dueNow(today, 10)
+ * - 全量扫描：遍历全部题目的到期日，再部分排序取前 10 道
+ * 并逐日核对两者的到期集合与前 10 道完全一致。
+ */
+int runBenchReview(const std::vector<std::string>& args) {
+    size_t n = 1000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "题目数无效：" << args[0] << "\n";
+        return 1;
+    }
+
+    installSyntheticBank(n);
+    std::mt19937 rng(20240601);
+    long long now = (long long)std::time(nullptr) - 180LL * 86400;
+    g_reviewScheduler.dueCount(dayIndexOf(now));   // 以空记录构建调度器
+
+    auto answer = [&](size_t qIdx, long long ts) {
+        Record r;
+        r.questionId = g_questions[qIdx].id;
+        r.correct = rng() % 4 != 0;
+        r.usedSeconds = 1 + (int)(rng() % 60);
+        r.timestamp = ts;
+        applyRecordToSchedule(r);
+    };
+    // 一天的学习：复习全部到期题目，再新做 2000 道随机题目
+    auto study = [&](long long today) {
+        std::vector<int> due = g_reviewScheduler.dueNow(today, n);
+        for (int q : due) answer((size_t)q, now);
+        for (int i = 0; i < 2000; ++i) answer(rng() % n, now);
+    };
+
+    const int kWarmupDays = 120;
+    const int kDays = 60;
+    const size_t kSession = 10;
+    for (int day = 0; day < kWarmupDays; ++day) {
+        now += 86400;
+        study(dayIndexOf(now));
+    }
+
+    double queueMs = 0.0;
+    double scanMs = 0.0;
+    size_t dueSum = 0;
+    bool same = true;
+    auto earlier = [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) { return a < b; };
+    for (int day = 0; day < kDays; ++day) {
+        now += 86400;
+        long long today = dayIndexOf(now);
+
+        auto t0 = std::chrono::steady_clock::now();
+        size_t dueTotal = g_reviewScheduler.dueCount(today);
+        std::vector<int> top = g_reviewScheduler.dueNow(today, kSession);
+        auto t1 = std::chrono::steady_clock::now();
+        std::vector<std::pair<long long, int>> scanned;
+        for (size_t q = 0; q < n; ++q) {
+            long long d = g_reviewScheduler.dueDay(q);
+            if (d != ReviewScheduler::kNotScheduled && d <= today) scanned.push_back({d, (int)q});
+        }
+        size_t k = std::min(kSession, scanned.size());
+        std::partial_sort(scanned.begin(), scanned.begin() + k, scanned.end(), earlier);
+        auto t2 = std::chrono::steady_clock::now();
+        queueMs += std::chrono::duration<double>(t1 - t0).count() * 1e3;
+        scanMs += std::chrono::duration<double>(t2 - t1).count() * 1e3;
+        dueSum += dueTotal;
+
+        if (dueTotal != scanned.size() || top.size() != k) same = false;
+        for (size_t i = 0; i < top.size() && i < k; ++i) {
+            if (top[i] != scanned[i].second) same = false;
+        }
+        std::vector<int> all = g_reviewScheduler.dueNow(today, n);
+        std::sort(all.begin(), all.end());
+        std::vector<int> scannedIds;
+        for (const auto& e : scanned) scannedIds.push_back(e.second);
+        std::sort(scannedIds.begin(), scannedIds.end());
+        if (all != scannedIds) same = false;
+
+        study(today);
+    }
+
+    std::cout << "===== 间隔复习调度基准 =====\n";
+    std::cout << "题目数: " << n << "  已排期: " << g_reviewScheduler.scheduledCount()
+         << "  模拟天数: " << kDays << "  平均每天到期: " << dueSum / kDays << " 道\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[全量扫描到期日] 每次会话查询: " << scanMs / kDays << " ms\n";
+    std::cout << "[日历队列] 每次会话查询: " << queueMs / kDays << " ms"
+         << "  加速比: " << std::setprecision(1) << scanMs / queueMs << "x\n";
+    std::cout << std::defaultfloat;
+    std::cout << "结果一致性（逐日核对到期集合与前 " << kSession << " 道）: " << (same ? "一致" : "不一致！") << "\n";
+    return same ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-batch：批量推荐吞吐量基准
+ *
+ * 合成题库 1 万道题，在临时目录生成 users 个用户记录文件（近 90 天），记录数呈长尾分布
+ * （多数几十条，少数上万条），以检验区间窃取对负载不均的处理。
+ * 分别以 1 个线程与全局线程池运行 batchRecommend()，输出吞吐量、加速比与窃取次数；
+ * 再抽取 20 名用户（含记录最多的一名）逐一走交互式路径（loadRecordsFromFile + recommendTopK），
+ * 核对推荐题号与分数完全一致；随后以这批用户训练并加载潜因子模型、再加载合成权重的遗忘模型，
+ * 每加载一个模型都重新批量推荐计时，并核对抽样用户的完整排序。结束后卸载模型、删除临时目录。
+ */
+int runBenchBatch(const std::vector<std::string>& args) {
+    size_t users = 10000;
+    if (!args.empty() && !parseCount(args[0], users)) {
+        std::cout << "用户数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    const size_t n = 10000;
+    const size_t K = 20;
+
+    loadKnowledgeGraphFromFile((getDataDir() / "knowledge_graph.txt").string());
+    installSyntheticBank(n);
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "ds_ai_quiz_bench_batch";
+    std::filesystem::remove_all(dir, ec);
+    if (!std::filesystem::create_directories(dir, ec)) {
+        std::cout << "无法创建临时目录：" << dir.string() << "\n";
+        return 1;
+    }
+
+    // 长尾记录数：20 / u^0.8（u 为 (0,1] 均匀分布），上限 2 万条
+    std::mt19937 rng(20240601);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    long long now = (long long)std::time(nullptr) + 86400;
+    size_t totalRecords = 0;
+    size_t heaviest = 0;
+    size_t heaviestCount = 0;
+    for (size_t u = 0; u < users; ++u) {
+        double x = 1.0 - unit(rng);
+        size_t count = std::min((size_t)20000, (size_t)(20.0 / std::pow(x, 0.8)));
+        if (count > heaviestCount) {
+            heaviestCount = count;
+            heaviest = u;
+        }
+        totalRecords += count;
+
+        std::vector<long long> stamps(count);
+        for (auto& ts : stamps) ts = now - 86400 - (long long)(rng() % (90LL * 86400));
+        std::sort(stamps.begin(), stamps.end());
+        std::string name = "records_u" + std::to_string(100000 + u) + ".csv";
+        std::ofstream fout(dir / name);
+        // 每个用户偏重题库中的一小段，使其作答集中在部分题目上
+        size_t focus = rng() % n;
+        for (long long ts : stamps) {
+            size_t q = (rng() % 4 == 0) ? rng() % n : (focus + rng() % 500) % n;
+            fout << g_questions[q].id << ',' << (rng() % 3 != 0 ? 1 : 0) << ',' << 1 + rng() % 300 << ',' << ts << '\n';
+        }
+    }
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    auto timed = [&](ThreadPool& pool, std::vector<UserRecommendation>& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = batchRecommend(files, K, now, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    std::vector<UserRecommendation> serial;
+    std::vector<UserRecommendation> parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+
+    bool same = serial.size() == parallel.size();
+    for (size_t u = 0; same && u < serial.size(); ++u) {
+        if (serial[u].items.size() != parallel[u].items.size()) same = false;
+        for (size_t j = 0; same && j < serial[u].items.size(); ++j) {
+            if (serial[u].items[j].questionId != parallel[u].items[j].questionId ||
+                serial[u].items[j].score != parallel[u].items[j].score) {
+                same = false;
+            }
+        }
+    }
+
+    // 抽样与交互式路径核对（加载记录时的提示信息不输出）
+    const size_t kSamples = 20;
+    std::vector<size_t> samples;
+    for (size_t i = 0; i < kSamples && i < files.size(); ++i) samples.push_back(i * files.size() / kSamples);
+    samples.push_back(heaviest);
+    std::vector<std::filesystem::path> sampleFiles;
+    for (size_t u : samples) sampleFiles.push_back(files[u]);
+    // results[i] 为 sampleFiles[i] 的前 k 道推荐
+    auto matchesInteractive = [&](const std::vector<UserRecommendation>& results, size_t k) {
+        bool match = results.size() == sampleFiles.size();
+        for (size_t i = 0; match && i < sampleFiles.size(); ++i) {
+            std::streambuf* saved = std::cout.rdbuf(nullptr);
+            loadRecordsFromFile(sampleFiles[i].string());
+            std::cout.rdbuf(saved);
+            std::vector<RecommendItem> ref = recommendTopK(k, now);
+            const std::vector<RecommendItem>& got = results[i].items;
+            if (got.size() != ref.size()) match = false;
+            for (size_t j = 0; match && j < ref.size(); ++j) {
+                if (got[j].questionId != ref[j].questionId || got[j].score != ref[j].score) match = false;
+            }
+        }
+        return match;
+    };
+    std::vector<UserRecommendation> sampled;
+    for (size_t u : samples) sampled.push_back(parallel[u]);
+    bool plainMatch = matchesInteractive(sampled, K);
+    // 加载模型后核对抽样用户的完整排序（K = 题库大小）：作答过的题目很少进入前 K 道，只比前 K 道覆盖不到其修正
+    auto fullRankingMatches = [&]() {
+        return matchesInteractive(batchRecommend(sampleFiles, n, now, globalThreadPool()), n);
+    };
+
+    // 加载潜因子模型（由这批用户训练）后再核对一遍：未作答题目的评分按各用户折叠出的用户行修正
+    bool latentLoaded = false;
+    bool latentMatch = true;
+    double latentSeconds = 0.0;
+    {
+        IrtResponses data = loadIrtResponses(files, globalThreadPool());
+        MfFit fit = fitMatrixFactorization(data, 3, globalThreadPool());
+        std::filesystem::path mfPath = dir / "latent_factors.txt";
+        std::streambuf* saved = std::cout.rdbuf(nullptr);
+        latentLoaded = saveLatentFactors(mfPath.string(), fit) && loadLatentFactorsFromFile(mfPath.string());
+        std::cout.rdbuf(saved);
+    }
+    if (latentLoaded) {
+        std::vector<UserRecommendation> latent;
+        latentSeconds = timed(globalThreadPool(), latent);
+        latentMatch = fullRankingMatches();
+    }
+
+    // 再加载遗忘模型（合成权重：答对延长、答错缩短半衰期）核对一遍：已作答题目的时间间隔维度按各用户的半衰期修正
+    HalfLifeParams hlr;
+    hlr.bias = 1.5;
+    hlr.correct = 2.0;
+    hlr.wrong = -1.0;
+    hlr.difficulty[4] = -0.5;
+    std::filesystem::path hlrPath = dir / "half_life.txt";
+    std::streambuf* savedOut = std::cout.rdbuf(nullptr);
+    bool hlrLoaded = saveHalfLifeParams(hlrPath.string(), hlr) && loadHalfLifeParamsFromFile(hlrPath.string());
+    std::cout.rdbuf(savedOut);
+    bool hlrMatch = true;
+    double hlrSeconds = 0.0;
+    if (hlrLoaded) {
+        std::vector<UserRecommendation> forgetting;
+        hlrSeconds = timed(globalThreadPool(), forgetting);
+        hlrMatch = fullRankingMatches();
+    }
+
+    // 卸载两个模型
+    g_latentFactors = LatentFactorModel();
+    g_halfLifeModel = HalfLifeModel();
+    g_recommendIndex.invalidate();
+    g_recommendCache.invalidate();
+    clearUserRecords();
+    std::filesystem::remove_all(dir, ec);
+
+    std::cout << "===== 批量推荐基准 =====\n";
+    std::cout << "用户数: " << users << "  记录总数: " << totalRecords << "  最多一名用户: " << heaviestCount
+         << " 条  题目数: " << n << "  K = " << K << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒  吞吐: " << std::setprecision(0)
+         << users / serialSeconds << " 用户/秒\n" << std::setprecision(2);
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  吞吐: "
+         << std::setprecision(0) << users / parallelSeconds << " 用户/秒  加速比: " << std::setprecision(2)
+         << serialSeconds / parallelSeconds << "x  窃取次数: " << globalThreadPool().lastSteals() << "\n";
+    std::cout << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    std::cout << "结果一致性（抽样 " << samples.size() << " 名用户 vs 交互式推荐）: "
+         << (plainMatch ? "一致" : "不一致！") << "\n";
+    if (latentLoaded) {
+        std::cout << "[潜因子模型] 耗时: " << std::fixed << std::setprecision(2) << latentSeconds << " 秒"
+             << std::defaultfloat << "  结果一致性（抽样用户完整排序 vs 交互式推荐）: " << (latentMatch ? "一致" : "不一致！") << "\n";
+    } else {
+        std::cout << "[潜因子模型] 未能加载，跳过核对！\n";
+    }
+    if (hlrLoaded) {
+        std::cout << "[潜因子 + 遗忘模型] 耗时: " << std::fixed << std::setprecision(2) << hlrSeconds << " 秒"
+             << std::defaultfloat << "  结果一致性（抽样用户完整排序 vs 交互式推荐）: " << (hlrMatch ? "一致" : "不一致！") << "\n";
+    } else {
+        std::cout << "[遗忘模型] 未能加载，跳过核对！\n";
+    }
+    return same && plainMatch && latentLoaded && latentMatch && hlrLoaded && hlrMatch ? 0 : 1;
+}
+
+/**
+ * @brief 逐题抽样的 Thompson 采样参照实现（std::gamma_distribution，为每道题各抽一次）
+ */
+std::vector<RecommendItem> thompsonTopKNaive(size_t K, std::mt19937_64& rng) {
+    TopK<RecommendItem, RecommendItemBetter> top(K);
+    for (size_t i = 0; i < g_questions.size(); ++i) {
+        int attempts = g_questionStats.totalAttempts[i];
+        int correct = g_questionStats.correctAttempts[i];
+        std::gamma_distribution<double> gx(attempts - correct + 1);
+        std::gamma_distribution<double> gy(correct + 1);
+        double x = gx(rng);
+        double y = gy(rng);
+        double theta = x / (x + y);
+        top.push({g_questions[i].id, theta, theta});
+    }
+    return top.takeSorted();
+}
+
+/**
+ * @brief 子命令 --bench-bandit：Thompson 采样基准
+ *
+ * 第一部分核对抽样分布：
+ * - BetaSampler 对若干 (a, b) 各抽 20 万次，均值与方差和解析值比较
+ * - 60 道题的小题库（20 道有不同作答记录），thompsonTopK 与逐题抽样各做 2 万次 Top-1，
+ *   比较每道题被选中的频率（未作答题目的顺序统计量捷径是否与逐题抽样同分布）
+ * 第二部分以 n 道合成题目（10 万条作答记录）对比每次 Top-5 的耗时：
+ * 逐题抽样（std::gamma_distribution）与 thompsonTopK（成批抽样 + 顺序统计量）。
+ */
+int runBenchBandit(const std::vector<std::string>& args) {
+    size_t n = 1000000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "题目数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (n == 0) n = 1;
+
+    // ---- 第一部分：分布核对 ----
+    BetaSampler sampler(20240601);
+    const int kDraws = 200000;
+    const int32_t shapes[][2] = {{1, 1}, {2, 5}, {11, 3}, {40, 60}, {3, 120}};
+    bool momentsOk = true;
+    std::cout << "===== Thompson 采样基准 =====\n";
+    std::cout << std::fixed << std::setprecision(4);
+    for (const auto& s : shapes) {
+        std::vector<int32_t> a(kDraws, s[0]);
+        std::vector<int32_t> b(kDraws, s[1]);
+        std::vector<double> out(kDraws);
+        sampler.sample(a.data(), b.data(), kDraws, out.data());
+        double mean = 0.0;
+        for (double v : out) mean += v;
+        mean /= kDraws;
+        double var = 0.0;
+        for (double v : out) var += (v - mean) * (v - mean);
+        var /= kDraws;
+        double ab = (double)s[0] + s[1];
+        double wantMean = s[0] / ab;
+        double wantVar = s[0] * (double)s[1] / (ab * ab * (ab + 1.0));
+        // 均值容差取 5 个标准误，方差容差取相对 3%
+        bool ok = std::fabs(mean - wantMean) < 5.0 * std::sqrt(wantVar / kDraws) &&
+                  std::fabs(var - wantVar) < 0.03 * wantVar;
+        momentsOk = momentsOk && ok;
+        std::cout << "Beta(" << s[0] << ", " << s[1] << ")  均值 " << mean << " / " << wantMean
+             << "  方差 " << var << " / " << wantVar << (ok ? "" : "  不符！") << "\n";
+    }
+
+    const size_t kSmall = 60;
+    installSyntheticBank(kSmall);
+    std::mt19937_64 rng(20240601);
+    for (size_t q = 0; q < 20; ++q) {
+        for (size_t t = 0; t <= q % 7; ++t) {
+            Record r;
+            r.questionId = g_questions[q].id;
+            r.correct = (q + t) % 3 == 0;
+            r.usedSeconds = 10;
+            r.timestamp = 1700000000;
+            applyRecordToStats(r);
+        }
+    }
+    const int kTrials = 20000;
+    std::vector<int> fast(kSmall + 1, 0);
+    std::vector<int> naive(kSmall + 1, 0);
+    for (int t = 0; t < kTrials; ++t) {
+        ++fast[thompsonTopK(1, sampler)[0].questionId];
+        ++naive[thompsonTopKNaive(1, rng)[0].questionId];
+    }
+    double worstGap = 0.0;
+    for (size_t id = 1; id <= kSmall; ++id) {
+        worstGap = std::max(worstGap, std::fabs(fast[id] - naive[id]) / (double)kTrials);
+    }
+    // 两组频率之差的标准差不超过 sqrt(2 × 0.25 / 2 万) ≈ 0.005
+    bool topOk = worstGap < 0.02;
+    std::cout << "Top-1 选中频率（" << kSmall << " 道题，各 " << kTrials << " 次）最大差异: " << worstGap
+         << (topOk ? "" : "  不符！") << "\n\n";
+
+    // ---- 第二部分：大题库耗时 ----
+    installSyntheticBank(n);
+    long long now = (long long)std::time(nullptr);
+    for (int i = 0; i < 100000; ++i) {
+        Record r;
+        r.questionId = (int)(rng() % n) + 1;
+        r.correct = rng() % 3 != 0;
+        r.usedSeconds = 1 + (int)(rng() % 300);
+        r.timestamp = now - (long long)(rng() % (365LL * 86400));
+        applyRecordToStats(r);
+    }
+    size_t seen = 0;
+    for (size_t q = 0; q < n; ++q) seen += g_questionStats.totalAttempts[q] > 0;
+
+    const size_t K = 5;
+    const int kNaiveRounds = 3;
+    const int kFastRounds = 50;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kNaiveRounds; ++i) thompsonTopKNaive(K, rng);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFastRounds; ++i) thompsonTopK(K, sampler);
+    auto t2 = std::chrono::steady_clock::now();
+    double naiveMs = std::chrono::duration<double>(t1 - t0).count() * 1e3 / kNaiveRounds;
+    double fastMs = std::chrono::duration<double>(t2 - t1).count() * 1e3 / kFastRounds;
+
+    std::cout << "题目数: " << n << "  作答过: " << seen << "  K = " << K << "\n";
+    std::cout << std::setprecision(3);
+    std::cout << "[逐题抽样] 每次推荐: " << naiveMs << " ms\n";
+    std::cout << "[成批抽样 + 顺序统计量] 每次推荐: " << fastMs << " ms"
+         << "  加速比: " << std::setprecision(1) << naiveMs / fastMs << "x\n";
+    std::cout << std::defaultfloat;
+    std::cout << "分布核对: " << (momentsOk && topOk ? "一致" : "不一致！") << "\n";
+    return momentsOk && topOk ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-replay：回放评估吞吐量基准
+ *
+ * 合成题库 2000 道题，在临时目录生成 users 个用户近 60 天的记录：每个用户有一个薄弱知识点，
+ * 答错概率 = 0.08 + 0.05 × (难度 - 1)，薄弱知识点再加 0.4；练习的题目一半取自本用户常练的 60 道题，
+ * 一半取自之前做错过的题目（模拟错题重练），使历史记录对之后的答错有预测作用。
+ * 分别以 1 个线程与全局线程池运行 replayEvaluate()，输出结果表、耗时与加速比，并核对两次结果完全一致。
+ * 结束后删除临时目录。
+ */
+int runBenchReplay(const std::vector<std::string>& args) {
+    size_t users = 10000;
+    if (!args.empty() && !parseCount(args[0], users)) {
+        std::cout << "用户数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    const size_t n = 2000;
+    const size_t K = 5;
+
+    loadKnowledgeGraphFromFile((getDataDir() / "knowledge_graph.txt").string());
+    installSyntheticBank(n);
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "ds_ai_quiz_bench_replay";
+    std::filesystem::remove_all(dir, ec);
+    if (!std::filesystem::create_directories(dir, ec)) {
+        std::cout << "无法创建临时目录：" << dir.string() << "\n";
+        return 1;
+    }
+
+    std::mt19937 rng(20240715);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    long long start = (long long)std::time(nullptr) - 60LL * 86400;
+    size_t kCount = std::max<size_t>(g_knowledgeNames.size(), 1);
+    for (size_t u = 0; u < users; ++u) {
+        int weak = (int)(rng() % kCount);
+        size_t focus = rng() % n;
+        std::vector<size_t> mistakes;
+        std::ofstream fout(dir / ("records_u" + std::to_string(100000 + u) + ".csv"));
+        for (int day = 0; day < 60; ++day) {
+            if (rng() % 3 == 0) continue;   // 约三分之一的天不练习
+            long long ts = start + day * 86400LL + 8 * 3600 + (long long)(rng() % (12 * 3600));
+            size_t count = 5 + rng() % 16;
+            for (size_t j = 0; j < count; ++j) {
+                size_t q = (!mistakes.empty() && rng() % 2 == 0) ? mistakes[rng() % mistakes.size()]
+                                                                 : (focus + rng() % 60) % n;
+                const Question& question = g_questions[q];
+                double pWrong = 0.08 + 0.05 * (question.difficulty - 1) + (question.knowledgeId == weak ? 0.4 : 0.0);
+                bool correct = unit(rng) >= pWrong;
+                if (!correct) mistakes.push_back(q);
+                ts += 20 + (long long)(rng() % 120);
+                fout << question.id << ',' << (correct ? 1 : 0) << ',' << 10 + rng() % 120 << ',' << ts << '\n';
+            }
+        }
+    }
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    auto timed = [&](ThreadPool& pool, ReplaySummary& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = replayEvaluate(files, K, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    ReplaySummary serial;
+    ReplaySummary parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+    std::filesystem::remove_all(dir, ec);
+
+    bool same = serial.records == parallel.records && serial.days == parallel.days &&
+                serial.slots == parallel.slots && serial.expectedHits == parallel.expectedHits &&
+                serial.policies.size() == parallel.policies.size();
+    for (size_t p = 0; same && p < serial.policies.size(); ++p) {
+        same = serial.policies[p].auc == parallel.policies[p].auc && serial.policies[p].hits == parallel.policies[p].hits;
+    }
+
+    std::cout << "===== 回放评估基准 =====\n";
+    printReplaySummary(parallel, K);
+    std::cout << "\n" << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒  吞吐: " << std::setprecision(0)
+              << serial.records / serialSeconds << " 条记录/秒\n" << std::setprecision(2);
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  吞吐: "
+              << std::setprecision(0) << parallel.records / parallelSeconds << " 条记录/秒  加速比: "
+              << std::setprecision(2) << serialSeconds / parallelSeconds << "x\n";
+    std::cout << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-bkt：BKT 拟合基准
+ *
+ * 为每个知识点设定一组已知参数，在临时目录按 BKT 的生成过程合成 users 个用户的记录
+ * （每人 20 ~ 200 条，每条随机选一个知识点，按当前状态以 guess / slip 决定正误，再以 learn 概率学会）。
+ * 分别以 1 个线程与全局线程池拟合，输出各知识点的估计值与真实参数的最大偏差、耗时与加速比，
+ * 并核对两次拟合结果完全一致。结束后删除临时目录。
+ */
+int runBenchBkt(const std::vector<std::string>& args) {
+    size_t users = 5000;
+    if (!args.empty() && !parseCount(args[0], users)) {
+        std::cout << "用户数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+
+    size_t K = g_knowledgeNames.size();
+    std::vector<std::vector<int>> questionsOf(K);
+    for (const Question& q : g_questions) {
+        if (q.knowledgeId >= 0 && (size_t)q.knowledgeId < K) questionsOf[q.knowledgeId].push_back(q.id);
+    }
+    std::vector<int> kids;
+    for (size_t k = 0; k < K; ++k) {
+        if (!questionsOf[k].empty()) kids.push_back((int)k);
+    }
+    if (kids.empty()) {
+        std::cout << "题库中没有知识点。\n";
+        return 1;
+    }
+
+    // 已知参数：各知识点取不同的组合
+    std::vector<BktParams> truth(K);
+    for (size_t k = 0; k < K; ++k) {
+        truth[k].prior = 0.10 + 0.05 * (double)(k % 5);
+        truth[k].learn = 0.05 + 0.03 * (double)(k % 4);
+        truth[k].guess = 0.10 + 0.03 * (double)(k % 5);
+        truth[k].slip = 0.05 + 0.02 * (double)(k % 4);
+    }
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "ds_ai_quiz_bench_bkt";
+    std::filesystem::remove_all(dir, ec);
+    if (!std::filesystem::create_directories(dir, ec)) {
+        std::cout << "无法创建临时目录：" << dir.string() << "\n";
+        return 1;
+    }
+    std::mt19937 rng(20240820);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    long long start = (long long)std::time(nullptr) - 90LL * 86400;
+    size_t totalRecords = 0;
+    for (size_t u = 0; u < users; ++u) {
+        std::vector<signed char> learned(K, -1);   // -1：尚未接触该知识点
+        size_t count = 20 + rng() % 181;
+        totalRecords += count;
+        long long ts = start;
+        std::ofstream fout(dir / ("records_u" + std::to_string(100000 + u) + ".csv"));
+        for (size_t j = 0; j < count; ++j) {
+            int k = kids[rng() % kids.size()];
+            const BktParams& p = truth[k];
+            if (learned[k] < 0) learned[k] = unit(rng) < p.prior ? 1 : 0;
+            bool correct = learned[k] ? unit(rng) >= p.slip : unit(rng) < p.guess;
+            if (!learned[k] && unit(rng) < p.learn) learned[k] = 1;
+            ts += 30 + (long long)(rng() % 3600);
+            fout << questionsOf[k][rng() % questionsOf[k].size()] << ',' << (correct ? 1 : 0) << ','
+                 << 10 + rng() % 120 << ',' << ts << '\n';
+        }
+    }
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    auto timed = [&](ThreadPool& pool, TracingFit& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = fitTracingParams(files, kBktFitIterations, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    TracingFit serial;
+    TracingFit parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+    std::filesystem::remove_all(dir, ec);
+
+    bool same = serial.iterations == parallel.iterations && serial.logLikelihood == parallel.logLikelihood;
+    for (size_t k = 0; same && k < K; ++k) {
+        const BktParams& a = serial.params[k];
+        const BktParams& b = parallel.params[k];
+        same = a.prior == b.prior && a.learn == b.learn && a.guess == b.guess && a.slip == b.slip;
+    }
+    const double kTolerance = 0.05;
+    double worst = 0.0;
+    for (int k : kids) {
+        const BktParams& p = parallel.params[k];
+        const BktParams& t = truth[k];
+        worst = std::max(worst, std::max(std::max(std::fabs(p.prior - t.prior), std::fabs(p.learn - t.learn)),
+                                         std::max(std::fabs(p.guess - t.guess), std::fabs(p.slip - t.slip))));
+    }
+
+    std::cout << "===== BKT 拟合基准 =====\n";
+    std::cout << "用户数: " << users << "  记录总数: " << totalRecords << "  知识点: " << kids.size()
+              << "  迭代: " << parallel.iterations << (parallel.converged ? "（已收敛）" : "（达到最大轮数）") << "\n\n";
+    printTracingParams(parallel, &truth);
+    std::cout << "\n" << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒\n";
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  加速比: "
+              << serialSeconds / parallelSeconds << "x\n";
+    std::cout << std::setprecision(3) << "参数恢复（最大偏差 " << worst << "，容差 " << kTolerance << "）: "
+              << (worst <= kTolerance ? "通过" : "未通过！") << "\n" << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same && worst <= kTolerance ? 0 : 1;
+}
+
+/// 皮尔逊相关系数（样本不足或方差为 0 时为 0）
+double pearson(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = x.size();
+    if (n < 2) return 0.0;
+    double mx = 0.0;
+    double my = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxy = 0.0;
+    double sxx = 0.0;
+    double syy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+        syy += (y[i] - my) * (y[i] - my);
+    }
+    return sxx > 0.0 && syy > 0.0 ? sxy / std::sqrt(sxx * syy) : 0.0;
+}
+
+/**
+ * @brief 子命令 --bench-irt：IRT 校准基准
+ *
+ * 按已知的 2PL 参数（θ ~ N(0, 1)，b ~ N(0, 1)，a ~ U(0.5, 2)）直接在内存中合成稀疏作答矩阵：
+ * users 个用户各随机作答 100 次，分布在 items 道题上（同题多次作答合并）。
+ * 分别以 1 个线程与全局线程池拟合 2PL，输出耗时、加速比与参数恢复情况
+ * （作答次数达到门槛的题目上 b、a 估计值与真实值的相关系数、难度等级一致率），
+ * 并核对两次拟合结果完全一致。记录文件的读取由 --calibrate-irt 覆盖，这里只衡量拟合本身。
+ */
+int runBenchIrt(const std::vector<std::string>& args) {
+    size_t users = 100000;
+    size_t items = 100000;
+    if ((args.size() > 0 && !parseCount(args[0], users)) || (args.size() > 1 && !parseCount(args[1], items))) {
+        std::cout << "参数无效：用户数与题目数须为正整数。\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    if (items == 0) items = 1;
+    const size_t kAnswersPerUser = 100;
+
+    std::mt19937 rng(20240901);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> trueAbility(users);
+    std::vector<double> trueDifficulty(items);
+    std::vector<double> trueDiscrimination(items);
+    for (double& v : trueAbility) v = normal(rng);
+    for (double& v : trueDifficulty) v = normal(rng);
+    for (double& v : trueDiscrimination) v = 0.5 + 1.5 * unit(rng);
+
+    IrtResponses data;
+    data.itemCount = items;
+    data.userStart.assign(users + 1, 0);
+    std::vector<int32_t> picks(kAnswersPerUser);
+    for (size_t u = 0; u < users; ++u) {
+        for (int32_t& j : picks) j = (int32_t)(rng() % items);
+        std::sort(picks.begin(), picks.end());
+        for (int32_t j : picks) {
+            double p = 1.0 / (1.0 + std::exp(-trueDiscrimination[j] * (trueAbility[u] - trueDifficulty[j])));
+            bool correct = unit(rng) < p;
+            if (data.userItem.size() > data.userStart[u] && data.userItem.back() == j) {
+                ++data.userAttempts.back();
+                data.userCorrect.back() += correct ? 1 : 0;
+            } else {
+                data.userItem.push_back(j);
+                data.userAttempts.push_back(1);
+                data.userCorrect.push_back(correct ? 1 : 0);
+            }
+        }
+        data.userStart[u + 1] = data.userItem.size();
+    }
+    data.buildItemIndex();
+
+    auto timed = [&](ThreadPool& pool, IrtFit& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = fitIrt(data, IrtModel::TwoPL, kIrtFitIterations, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    IrtFit serial;
+    IrtFit parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+
+    bool same = serial.iterations == parallel.iterations && serial.logLikelihood == parallel.logLikelihood &&
+                serial.ability == parallel.ability && serial.difficulty == parallel.difficulty &&
+                serial.discrimination == parallel.discrimination;
+
+    std::vector<double> estB, realB, estA, realA;
+    size_t sameLevel = 0;
+    for (size_t j = 0; j < items; ++j) {
+        if (parallel.responses[j] < kIrtMinResponses) continue;
+        estB.push_back(parallel.difficulty[j]);
+        realB.push_back(trueDifficulty[j]);
+        estA.push_back(parallel.discrimination[j]);
+        realA.push_back(trueDiscrimination[j]);
+        if (difficultyLevelOf(parallel.difficulty[j]) == difficultyLevelOf(trueDifficulty[j])) ++sameLevel;
+    }
+    double corrB = pearson(estB, realB);
+    double corrA = pearson(estA, realA);
+    const double kMinCorrelationB = 0.9;
+
+    std::cout << "===== IRT 校准基准（2pl）=====\n";
+    std::cout << "用户数: " << users << "  题目数: " << items << "  用户-题目对: " << data.entries()
+              << "  迭代: " << parallel.iterations << (parallel.converged ? "（已收敛）" : "（达到最大轮数）") << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒\n";
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  加速比: "
+              << serialSeconds / parallelSeconds << "x\n";
+    std::cout << std::setprecision(3) << "参数恢复（作答次数不少于 " << kIrtMinResponses << " 的 " << estB.size()
+              << " 道题）: 难度 b 相关系数 " << corrB << "，区分度 a 相关系数 " << corrA << "，难度等级一致 "
+              << std::setprecision(1) << (estB.empty() ? 0.0 : 100.0 * sameLevel / estB.size()) << "%\n";
+    std::cout << std::setprecision(2) << "难度恢复（b 相关系数不低于 " << kMinCorrelationB << "）: "
+              << (corrB >= kMinCorrelationB ? "通过" : "未通过！") << "\n" << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same && corrB >= kMinCorrelationB ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-co-error：共错题统计基准
+ *
+ * 直接在内存中合成错题本：题目每 50 道为一组"同一误区"，每个用户有 3 个薄弱组，
+ * 组内每道题以 30% 的概率答错，另随机答错 10 道。分别以 1 个线程与全局线程池构建，
+ * 输出耗时、加速比，核对两次结果完全一致，并统计前 10 个邻居与本题同组的比例与随机查询的耗时。
+ */
+int runBenchCoError(const std::vector<std::string>& args) {
+    size_t users = 100000;
+    size_t items = 100000;
+    if ((args.size() > 0 && !parseCount(args[0], users)) || (args.size() > 1 && !parseCount(args[1], items))) {
+        std::cout << "参数无效：用户数与题目数须为正整数。\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    const size_t kGroupSize = 50;
+    const size_t kWeakGroups = 3;
+    const size_t kNoise = 10;
+    if (items < kGroupSize) items = kGroupSize;
+    size_t groups = items / kGroupSize;
+
+    std::mt19937 rng(20240915);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    WrongSets sets;
+    sets.itemCount = items;
+    sets.start.assign(users + 1, 0);
+    std::vector<int32_t> wrong;
+    for (size_t u = 0; u < users; ++u) {
+        wrong.clear();
+        for (size_t g = 0; g < kWeakGroups; ++g) {
+            size_t group = rng() % groups;
+            for (size_t k = 0; k < kGroupSize; ++k) {
+                if (unit(rng) < 0.3) wrong.push_back((int32_t)(group * kGroupSize + k));
+            }
+        }
+        for (size_t k = 0; k < kNoise; ++k) wrong.push_back((int32_t)(rng() % items));
+        std::sort(wrong.begin(), wrong.end());
+        wrong.erase(std::unique(wrong.begin(), wrong.end()), wrong.end());
+        sets.items.insert(sets.items.end(), wrong.begin(), wrong.end());
+        sets.start[u + 1] = sets.items.size();
+    }
+
+    auto timed = [&](ThreadPool& pool, CoErrorTable& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = buildCoErrorTable(sets, kCoErrorTopN, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    CoErrorTable serial;
+    CoErrorTable parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+    bool same = serial == parallel;
+
+    // 前 10 个邻居与本题同组的比例（组外题目只在噪声中出现）
+    size_t checked = 0;
+    size_t sameGroup = 0;
+    for (size_t i = 0; i < groups * kGroupSize; ++i) {
+        size_t count = 0;
+        const CoErrorNeighbor* nb = parallel.neighborsOf(i, count);
+        for (size_t k = 0; k < count && k < 10; ++k) {
+            ++checked;
+            if ((size_t)nb[k].question / kGroupSize == i / kGroupSize) ++sameGroup;
+        }
+    }
+
+    // 随机查询
+    const size_t kLookups = 1000000;
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < kLookups; ++r) {
+        size_t count = 0;
+        const CoErrorNeighbor* nb = parallel.neighborsOf(rng() % items, count);
+        for (size_t k = 0; k < count; ++k) sink += nb[k].together;
+    }
+    double lookupNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kLookups;
+
+    std::cout << "===== 共错题统计基准 =====\n";
+    std::cout << "用户数: " << users << "  题目数: " << items << "  错题本总题数: " << sets.items.size()
+              << "  共错题项: " << parallel.entries() << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒\n";
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  加速比: "
+              << serialSeconds / parallelSeconds << "x\n";
+    std::cout << std::setprecision(1) << "前 10 个邻居与本题同组: " << (checked ? 100.0 * sameGroup / checked : 0.0)
+              << "%（" << checked << " 项）\n";
+    std::cout << "随机查询（遍历全部邻居）: " << lookupNs << " ns/次（校验和 " << sink % 1000 << "）\n"
+              << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same ? 0 : 1;
+}
+
+/**
+ * @brief 以预测答对概率对观测排序的 AUC（"答对"为正例，并列按平均秩；没有正例或负例时为 0.5）
+ */
+double aucCorrect(const std::vector<float>& predicted, const std::vector<unsigned char>& correct) {
+    size_t n = predicted.size();
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return predicted[a] < predicted[b]; });
+    double rankSum = 0.0;
+    size_t positives = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && predicted[order[j]] == predicted[order[i]]) ++j;
+        double rank = (i + 1 + j) / 2.0;   // 并列项的平均秩（秩从 1 开始）
+        for (size_t k = i; k < j; ++k) {
+            if (correct[order[k]]) {
+                rankSum += rank;
+                ++positives;
+            }
+        }
+        i = j;
+    }
+    size_t negatives = n - positives;
+    if (positives == 0 || negatives == 0) return 0.5;
+    return (rankSum - positives * (positives + 1) / 2.0) / ((double)positives * negatives);
+}
+
+/**
+ * @brief 子命令 --bench-mf：潜因子模型基准
+ *
+ * 按已知的低秩模型直接在内存中合成作答：用户技能 s_u 与题目载荷 a_j 为 4 维，
+ * P(答对) = σ(s_u · a_j + g_u - b_j)。每个用户随机作答 100 次（同题合并）用于训练，
+ * 另取 10 道没做过的题各作答一次作为留出集。
+ * 1. 训练：单线程依次使用 CPU 支持的每个指令集，再以当前指令集在全局线程池上训练，输出耗时并核对结果完全一致
+ * 2. 预测：留出集上的 AUC 与 Brier 分数，对照"题目训练集答对率"与 unseenBonus 常数（所有未做题目同分，AUC 0.5）
+ * 3. 打分：为一个用户给全部题目打分（kernelDotRowsF32）的吞吐量，标量 vs 当前指令集
+ */
+int runBenchMf(const std::vector<std::string>& args) {
+    size_t users = 20000;
+    size_t items = 20000;
+    if ((args.size() > 0 && !parseCount(args[0], users)) || (args.size() > 1 && !parseCount(args[1], items))) {
+        std::cout << "参数无效：用户数与题目数须为正整数。\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    if (items == 0) items = 1;
+    const size_t kAnswersPerUser = 100;
+    const size_t kHeldOutPerUser = 10;
+    const size_t kSkills = 4;
+
+    std::mt19937 rng(20240920);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> skill(users * kSkills);
+    std::vector<double> general(users);
+    std::vector<double> loading(items * kSkills);
+    std::vector<double> difficulty(items);
+    for (double& v : skill) v = normal(rng);
+    for (double& v : general) v = 0.5 * normal(rng);
+    for (double& v : loading) v = 0.7 * normal(rng);
+    for (double& v : difficulty) v = normal(rng);
+    auto answer = [&](size_t u, size_t j) {
+        double x = general[u] - difficulty[j];
+        for (size_t k = 0; k < kSkills; ++k) x += skill[u * kSkills + k] * loading[j * kSkills + k];
+        return unit(rng) < 1.0 / (1.0 + std::exp(-x));
+    };
+
+    IrtResponses data;
+    data.itemCount = items;
+    data.userStart.assign(users + 1, 0);
+    std::vector<uint32_t> heldUser;
+    std::vector<uint32_t> heldItem;
+    std::vector<unsigned char> heldCorrect;
+    std::vector<int32_t> picks(kAnswersPerUser);
+    for (size_t u = 0; u < users; ++u) {
+        for (int32_t& j : picks) j = (int32_t)(rng() % items);
+        std::sort(picks.begin(), picks.end());
+        for (int32_t j : picks) {
+            bool correct = answer(u, (size_t)j);
+            if (data.userItem.size() > data.userStart[u] && data.userItem.back() == j) {
+                ++data.userAttempts.back();
+                data.userCorrect.back() += correct ? 1 : 0;
+            } else {
+                data.userItem.push_back(j);
+                data.userAttempts.push_back(1);
+                data.userCorrect.push_back(correct ? 1 : 0);
+            }
+        }
+        data.userStart[u + 1] = data.userItem.size();
+        for (size_t h = 0; h < kHeldOutPerUser; ++h) {
+            int32_t j = (int32_t)(rng() % items);
+            if (std::binary_search(picks.begin(), picks.end(), j)) continue;   // 只留出没做过的题
+            heldUser.push_back((uint32_t)u);
+            heldItem.push_back((uint32_t)j);
+            heldCorrect.push_back(answer(u, (size_t)j) ? 1 : 0);
+        }
+    }
+    data.buildItemIndex();
+
+    // 1. 训练耗时与一致性
+    KernelIsa best = activeKernelIsa();
+    auto timed = [&](KernelIsa isa, ThreadPool& pool, MfFit& out) {
+        setKernelIsa(isa);
+        auto t0 = std::chrono::steady_clock::now();
+        out = fitMatrixFactorization(data, kMfIterations, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    auto sameFit = [](const MfFit& a, const MfFit& b) {
+        return a.userFactors == b.userFactors && a.itemFactors == b.itemFactors && a.rmse == b.rmse;
+    };
+    // 单线程依次使用 CPU 支持的每个指令集，再以当前指令集在全局线程池上训练
+    std::vector<KernelIsa> isas = {KernelIsa::Scalar};
+    if (best != KernelIsa::Scalar) isas.push_back(KernelIsa::Avx2);
+    if (best == KernelIsa::Avx512) isas.push_back(KernelIsa::Avx512);
+    ThreadPool single(1);
+    std::vector<double> isaSeconds;
+    MfFit scalarFit;
+    bool same = true;
+    for (KernelIsa isa : isas) {
+        MfFit fit;
+        isaSeconds.push_back(timed(isa, single, fit));
+        if (isa == KernelIsa::Scalar) {
+            scalarFit = std::move(fit);
+        } else {
+            same = same && sameFit(scalarFit, fit);
+        }
+    }
+    MfFit parallelFit;
+    double parallelSeconds = timed(best, globalThreadPool(), parallelFit);
+    same = same && sameFit(scalarFit, parallelFit);
+
+    // 2. 留出集：潜因子预测 vs 题目训练集答对率
+    std::vector<float> mfScore(heldItem.size());
+    std::vector<float> itemScore(heldItem.size());
+    double mfBrier = 0.0;
+    double itemBrier = 0.0;
+    for (size_t h = 0; h < heldItem.size(); ++h) {
+        size_t j = heldItem[h];
+        uint64_t n = 0;
+        uint64_t k = 0;
+        for (size_t e = data.itemStart[j]; e < data.itemStart[j + 1]; ++e) {
+            n += data.itemAttempts[e];
+            k += data.itemCorrect[e];
+        }
+        mfScore[h] = parallelFit.predict(heldUser[h], j);
+        itemScore[h] = (float)((k + parallelFit.mean) / (n + 1.0));   // 以 μ 平滑的题目答对率
+        double y = heldCorrect[h];
+        mfBrier += (mfScore[h] - y) * (mfScore[h] - y);
+        itemBrier += (itemScore[h] - y) * (itemScore[h] - y);
+    }
+    double held = std::max<size_t>(heldItem.size(), 1);
+    double mfAuc = aucCorrect(mfScore, heldCorrect);
+    double itemAuc = aucCorrect(itemScore, heldCorrect);
+
+    // 3. 为一个用户给全部题目打分的吞吐量（取 5 次中最快一次）
+    std::vector<float> scores(items);
+    auto scoreRate = [&](KernelIsa isa) {
+        setKernelIsa(isa);
+        double fastest = 1e100;
+        for (int rep = 0; rep < 5; ++rep) {
+            auto t0 = std::chrono::steady_clock::now();
+            kernelDotRowsF32(parallelFit.itemFactors.data(), items, kMfDim, parallelFit.userFactors.data(),
+                             scores.data());
+            fastest = std::min(fastest, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        }
+        return items / fastest / 1e6;
+    };
+    double scalarRate = scoreRate(KernelIsa::Scalar);
+    std::vector<float> scalarScores = scores;
+    double simdRate = scoreRate(best);
+    same = same && scalarScores == scores;
+    setKernelIsa(best);
+
+    std::cout << "===== 潜因子模型基准（ALS，" << kMfFactors << " 维，" << kMfIterations << " 轮）=====\n";
+    std::cout << "用户数: " << users << "  题目数: " << items << "  用户-题目对: " << data.entries()
+              << "  留出作答: " << heldItem.size() << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t k = 0; k < isas.size(); ++k) {
+        std::cout << "[" << kernelIsaName(isas[k]) << ", 1 线程] 训练耗时: " << isaSeconds[k] << " 秒";
+        if (k > 0) std::cout << "  加速比: " << isaSeconds[0] / isaSeconds[k] << "x";
+        std::cout << "\n";
+    }
+    std::cout << "[" << kernelIsaName(best) << ", " << globalThreadPool().size() << " 线程] 训练耗时: "
+              << parallelSeconds << " 秒  加速比: " << isaSeconds[0] / parallelSeconds << "x\n";
+    std::cout << std::setprecision(4) << "训练误差（加权 RMSE）: " << parallelFit.rmse << "\n";
+    std::cout << "留出集预测答对（AUC / Brier）:\n";
+    std::cout << "  潜因子模型          " << mfAuc << " / " << mfBrier / held << "\n";
+    std::cout << "  题目答对率          " << itemAuc << " / " << itemBrier / held << "\n";
+    std::cout << "  unseenBonus 常数    0.5000（所有未做题目同分）\n";
+    std::cout << std::setprecision(1) << "全部题目打分: scalar " << scalarRate << " M 题/秒，" << kernelIsaName(best)
+              << " " << simdRate << " M 题/秒\n" << std::defaultfloat;
+    std::cout << "结果一致性（各指令集，单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same && mfAuc > itemAuc ? 0 : 1;
+}
+
+/**
+ * @brief 子命令 --bench-hlr：遗忘模型基准
+ *
+ * 以一组已知权重为"真实"的半衰期模型，在临时目录合成 users 个用户的记录：每人在 20 道题上
+ * 反复作答 20 ~ 200 次，相邻两次作答间隔 1 分钟 ~ 12 小时；同一题再次作答时以 2^(-Δ / h) 的概率答对。
+ * 分别以 1 个线程与全局线程池拟合，输出耗时与加速比并核对两次结果完全一致；
+ * 再在另外合成的 users / 5 名留出用户上，对比拟合模型与 7 天线性时间项（1 - min(Δ / 7, 1)）预测回忆的 AUC，
+ * 以及拟合的 log2 半衰期与真实值的相关系数。结束后删除临时目录。
+ */
+int runBenchHlr(const std::vector<std::string>& args) {
+    size_t users = 5000;
+    if (!args.empty() && !parseCount(args[0], users)) {
+        std::cout << "用户数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (users == 0) users = 1;
+    if (g_questions.empty()) {
+        std::cout << "题库为空。\n";
+        return 1;
+    }
+    const size_t kWorkingSet = 20;
+
+    // 真实权重：答对延长、答错缩短半衰期，难题与部分知识点忘得更快
+    HalfLifeParams truth;
+    truth.bias = -1.0;
+    truth.attempts = 0.2;
+    truth.correct = 0.9;
+    truth.wrong = -0.6;
+    for (int d = 0; d < kHlrDifficultyLevels; ++d) truth.difficulty[d] = 0.3 * (2 - d);
+    truth.knowledge.resize(g_knowledgeNames.size());
+    for (size_t k = 0; k < truth.knowledge.size(); ++k) truth.knowledge[k] = 0.25 * ((double)(k % 5) - 2.0);
+
+    // 留出用户的每次再次作答：真实与拟合的 log2 半衰期、两种预测的回忆概率与是否答对
+    struct HeldOut {
+        const HalfLifeParams* model = nullptr;
+        std::vector<double> log2True;
+        std::vector<double> log2Fitted;
+        std::vector<float> fitted;
+        std::vector<float> linear;
+        std::vector<unsigned char> recalled;
+    };
+
+    // 合成一个用户：写入记录文件（fout 非空时），或按 held->model 记下留出样本（held 非空时）
+    std::mt19937 rng(20241001);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    long long start = (long long)std::time(nullptr) - 120LL * 86400;
+    auto simulate = [&](std::ofstream* fout, HeldOut* held) {
+        std::vector<size_t> set(kWorkingSet);
+        for (size_t& q : set) q = rng() % g_questions.size();
+        std::vector<uint32_t> n(kWorkingSet, 0);
+        std::vector<uint32_t> c(kWorkingSet, 0);
+        std::vector<long long> last(kWorkingSet, 0);
+        size_t count = 20 + rng() % 181;
+        long long ts = start;
+        for (size_t j = 0; j < count; ++j) {
+            ts += 60 + (long long)(rng() % (12 * 3600));
+            size_t s = rng() % kWorkingSet;
+            const Question& q = g_questions[set[s]];
+            bool correct;
+            if (n[s] == 0) {
+                correct = unit(rng) < 0.6;
+            } else {
+                double delta = (ts - last[s]) / 86400.0;
+                double z = hlrLog2HalfLife(truth, q.difficulty, q.knowledgeId, n[s], c[s]);
+                correct = unit(rng) < hlrRecall(delta, hlrHalfLifeDays(z));
+                if (held) {
+                    double hHat = hlrHalfLifeDays(hlrLog2HalfLife(*held->model, q.difficulty, q.knowledgeId, n[s], c[s]));
+                    held->log2True.push_back(std::log2(hlrHalfLifeDays(z)));
+                    held->log2Fitted.push_back(std::log2(hHat));
+                    held->fitted.push_back((float)hlrRecall(delta, hHat));
+                    held->linear.push_back((float)(1.0 - std::min(delta / 7.0, 1.0)));
+                    held->recalled.push_back(correct ? 1 : 0);
+                }
+            }
+            ++n[s];
+            c[s] += correct ? 1 : 0;
+            last[s] = ts;
+            if (fout) *fout << q.id << ',' << (correct ? 1 : 0) << ',' << 10 + rng() % 120 << ',' << ts << '\n';
+        }
+        return count;
+    };
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "ds_ai_quiz_bench_hlr";
+    std::filesystem::remove_all(dir, ec);
+    if (!std::filesystem::create_directories(dir, ec)) {
+        std::cout << "无法创建临时目录：" << dir.string() << "\n";
+        return 1;
+    }
+    size_t totalRecords = 0;
+    for (size_t u = 0; u < users; ++u) {
+        std::ofstream fout(dir / ("records_u" + std::to_string(100000 + u) + ".csv"));
+        totalRecords += simulate(&fout, nullptr);
+    }
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    auto timed = [&](ThreadPool& pool, HalfLifeFit& out) {
+        auto t0 = std::chrono::steady_clock::now();
+        out = fitHalfLifeRegression(files, kHlrIterations, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+    HalfLifeFit serial;
+    HalfLifeFit parallel;
+    ThreadPool single(1);
+    double serialSeconds = timed(single, serial);
+    double parallelSeconds = timed(globalThreadPool(), parallel);
+    std::filesystem::remove_all(dir, ec);
+
+    const HalfLifeParams& a = serial.params;
+    const HalfLifeParams& b = parallel.params;
+    bool same = serial.loss == parallel.loss && a.bias == b.bias && a.attempts == b.attempts &&
+                a.correct == b.correct && a.wrong == b.wrong && a.knowledge == b.knowledge;
+    for (int d = 0; d < kHlrDifficultyLevels; ++d) same = same && a.difficulty[d] == b.difficulty[d];
+
+    // 留出用户
+    HeldOut held;
+    held.model = &parallel.params;
+    size_t heldUsers = std::max<size_t>(users / 5, 1);
+    for (size_t u = 0; u < heldUsers; ++u) simulate(nullptr, &held);
+    double hlrAuc = aucCorrect(held.fitted, held.recalled);
+    double linearAuc = aucCorrect(held.linear, held.recalled);
+
+    std::cout << "===== 遗忘模型基准（半衰期回归，" << kHlrIterations << " 轮）=====\n";
+    std::cout << "用户数: " << users << "  记录总数: " << totalRecords << "  样本数: " << parallel.samples << "\n\n";
+    std::cout << "拟合的特征权重（真实值：常数 " << truth.bias << "，作答 " << truth.attempts << "，答对 " << truth.correct
+              << "，答错 " << truth.wrong << "）：\n";
+    printHalfLifeParams(parallel.params);
+    std::cout << "\n" << std::fixed << std::setprecision(2);
+    std::cout << "[1 线程] 耗时: " << serialSeconds << " 秒\n";
+    std::cout << "[" << globalThreadPool().size() << " 线程] 耗时: " << parallelSeconds << " 秒  加速比: "
+              << serialSeconds / parallelSeconds << "x\n";
+    std::cout << std::setprecision(4) << "留出用户的回忆预测（" << held.recalled.size() << " 次再次作答，AUC）:\n";
+    std::cout << "  半衰期回归          " << hlrAuc << "\n";
+    std::cout << "  7 天线性时间项      " << linearAuc << "\n";
+    std::cout << "log2 半衰期与真实值的相关系数: " << pearson(held.log2True, held.log2Fitted) << "\n" << std::defaultfloat;
+    std::cout << "结果一致性（单线程 vs 多线程）: " << (same ? "一致" : "不一致！") << "\n";
+    return same && hlrAuc > linearAuc ? 0 : 1;
+}
+
+/**
+ * @brief 按名称邻接表的复习路径 DFS 参照实现（编译为 CSR 之前的做法：每步哈希字符串）
+ */
+void dfsReviewPathByName(const std::string& node, std::unordered_set<std::string>& visited,
+                         std::vector<std::string>& path) {
+    if (!visited.insert(node).second) return;
+    auto it = g_knowledgePrereq.find(node);
+    if (it != g_knowledgePrereq.end()) {
+        for (const std::string& prereq : it->second) dfsReviewPathByName(prereq, visited, path);
+    }
+    path.push_back(node);
+}
+
+/**
+ * @brief 子命令 --bench-graph：知识点依赖图基准
+ *
+ * 合成 n 个知识点的课程体系：每 64 个知识点为一章，章内每个知识点依赖本章之前的 1~3 个知识点，
+ * 约 2% 的知识点另外依赖之前某一章的一个知识点。随机选 2000 个目标知识点，
+ * 对比按名称邻接表的 DFS（unordered_set 记录访问）与编译后 CSR + 位图的 DFS，并逐项核对路径。
+ * 之后加入 16 个三元环与 1 个自依赖，核对 Tarjan 找到且只找到这些环；最后在至少 100 万个知识点的
+ * 单链上运行迭代 DFS 与 Tarjan（递归写法在这一深度会耗尽调用栈），核对路径与首尾相接后的单个大环。
+ */
+int runBenchGraph(const std::vector<std::string>& args) {
+    size_t n = 100000;
+    if (!args.empty() && !parseCount(args[0], n)) {
+        std::cout << "知识点数无效：" << args[0] << "\n";
+        return 1;
+    }
+    if (n == 0) n = 1;
+    const size_t kChapter = 64;
+    const size_t kQueries = 2000;
+    std::mt19937 rng(20241015);
+
+    std::vector<std::string> names(n);
+    for (size_t v = 0; v < n; ++v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "K%07zu", v);
+        names[v] = buf;
+    }
+    g_knowledgePrereq.clear();
+    g_allKnowledgeNodes.clear();
+    size_t edges = 0;
+    for (size_t v = 0; v < n; ++v) {
+        g_allKnowledgeNodes.insert(names[v]);
+        size_t chapterBegin = v - v % kChapter;
+        std::vector<std::string> prereqs;
+        if (v > chapterBegin) {
+            size_t k = 1 + rng() % 3;
+            for (size_t j = 0; j < k; ++j) prereqs.push_back(names[chapterBegin + rng() % (v - chapterBegin)]);
+        }
+        if (chapterBegin > 0 && rng() % 50 == 0) prereqs.push_back(names[rng() % chapterBegin]);
+        edges += prereqs.size();
+        g_knowledgePrereq[names[v]] = prereqs;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    compileKnowledgeGraph();
+    auto t1 = std::chrono::steady_clock::now();
+    double compileMs = std::chrono::duration<double>(t1 - t0).count() * 1e3;
+
+    std::vector<size_t> targets(kQueries);
+    for (size_t& t : targets) t = rng() % n;
+
+    // 参照：按名称 DFS，每次查询新建 visited 集合
+    std::vector<std::vector<std::string>> expected(kQueries);
+    t0 = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < kQueries; ++q) {
+        std::unordered_set<std::string> visited;
+        dfsReviewPathByName(names[targets[q]], visited, expected[q]);
+    }
+    t1 = std::chrono::steady_clock::now();
+    double naiveUs = std::chrono::duration<double>(t1 - t0).count() * 1e6 / kQueries;
+
+    // CSR + 位图：位图只分配一次，每次查询后按路径清除
+    std::vector<std::vector<int>> paths(kQueries);
+    NodeBitset visited;
+    visited.resize(g_knowledgeGraph.size());
+    t0 = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < kQueries; ++q) {
+        dfsReviewPath(g_knowledgeGraph.id(names[targets[q]]), visited, paths[q]);
+        visited.resetAll(paths[q]);
+    }
+    t1 = std::chrono::steady_clock::now();
+    double csrUs = std::chrono::duration<double>(t1 - t0).count() * 1e6 / kQueries;
+
+    bool same = true;
+    size_t totalLength = 0;
+    for (size_t q = 0; q < kQueries && same; ++q) {
+        totalLength += paths[q].size();
+        same = paths[q].size() == expected[q].size();
+        for (size_t i = 0; same && i < paths[q].size(); ++i) same = g_knowledgeGraph.name(paths[q][i]) == expected[q][i];
+    }
+
+    std::cout << "===== 知识点依赖图基准 =====\n";
+    std::cout << "知识点数: " << g_knowledgeGraph.size() << "  依赖边数: " << edges << "  查询数: " << kQueries
+              << "  平均路径长度: " << std::fixed << std::setprecision(1) << (double)totalLength / kQueries << "\n";
+    std::cout << std::setprecision(2);
+    std::cout << "编译（编号 + CSR 正向 / 反向边）: " << compileMs << " ms\n";
+    std::cout << "[按名称邻接表 + unordered_set] 每次查询: " << naiveUs << " 微秒\n";
+    std::cout << "[CSR + 位图] 每次查询: " << csrUs << " 微秒  加速比: " << std::setprecision(1) << naiveUs / csrUs
+              << "x\n" << std::defaultfloat;
+    std::cout << "路径核对: " << (same ? "一致" : "不一致！") << "\n";
+
+    // 环检测：植入三元环 C<i>_0 -> C<i>_1 -> C<i>_2 -> C<i>_0（各自另依赖一个课程知识点）与一个自依赖
+    const size_t kPlantedCycles = 16;
+    std::vector<std::vector<std::string>> planted;
+    for (size_t c = 0; c < kPlantedCycles; ++c) {
+        std::vector<std::string> ring(3);
+        for (size_t j = 0; j < 3; ++j) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "C%04zu_%zu", c, j);
+            ring[j] = buf;
+        }
+        for (size_t j = 0; j < 3; ++j) {
+            g_allKnowledgeNodes.insert(ring[j]);
+            g_knowledgePrereq[ring[j]] = {ring[(j + 1) % 3], names[rng() % n]};
+        }
+        planted.push_back(ring);
+    }
+    g_allKnowledgeNodes.insert("S0000");
+    g_knowledgePrereq["S0000"] = {"S0000", names[rng() % n]};
+    planted.push_back({"S0000"});
+    compileKnowledgeGraph();
+    size_t cyclicNodes = g_knowledgeGraph.size();
+    size_t cyclicEdges = g_knowledgeGraph.edges();
+
+    t0 = std::chrono::steady_clock::now();
+    std::vector<std::vector<int>> cycles = findKnowledgeCycles(g_knowledgeGraph);
+    t1 = std::chrono::steady_clock::now();
+    double tarjanMs = std::chrono::duration<double>(t1 - t0).count() * 1e3;
+    bool cyclesFound = cycles.size() == planted.size();
+    for (size_t c = 0; c < cycles.size() && cyclesFound; ++c) {
+        std::vector<std::string> members;
+        for (int v : cycles[c]) members.push_back(g_knowledgeGraph.name(v));
+        cyclesFound = members == planted[c];   // 名称排序即编号顺序，各组按最小编号排列
+    }
+
+    // 深链：K<i> 依赖 K<i-1>，路径应为整条链，首尾相接后整条链是一个环
+    size_t chain = std::max(n, (size_t)1000000);
+    g_knowledgePrereq.clear();
+    g_allKnowledgeNodes.clear();
+    std::vector<std::string> chainNames(chain);
+    for (size_t v = 0; v < chain; ++v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "K%07zu", v);
+        chainNames[v] = buf;
+        g_allKnowledgeNodes.insert(chainNames[v]);
+        if (v > 0) g_knowledgePrereq[chainNames[v]] = {chainNames[v - 1]};
+    }
+    compileKnowledgeGraph();
+    NodeBitset chainVisited;
+    chainVisited.resize(chain);
+    std::vector<int> chainPath;
+    t0 = std::chrono::steady_clock::now();
+    dfsReviewPath(g_knowledgeGraph.id(chainNames[chain - 1]), chainVisited, chainPath);
+    t1 = std::chrono::steady_clock::now();
+    double chainDfsMs = std::chrono::duration<double>(t1 - t0).count() * 1e3;
+    bool chainOk = chainPath.size() == chain;
+    for (size_t v = 0; v < chainPath.size() && chainOk; ++v) chainOk = chainPath[v] == (int)v;
+    chainOk = chainOk && findKnowledgeCycles(g_knowledgeGraph).empty();
+
+    g_knowledgePrereq[chainNames[0]] = {chainNames[chain - 1]};
+    compileKnowledgeGraph();
+    t0 = std::chrono::steady_clock::now();
+    std::vector<std::vector<int>> chainCycles = findKnowledgeCycles(g_knowledgeGraph);
+    t1 = std::chrono::steady_clock::now();
+    double chainTarjanMs = std::chrono::duration<double>(t1 - t0).count() * 1e3;
+    chainOk = chainOk && chainCycles.size() == 1 && chainCycles[0].size() == chain;
+
+    std::cout << "\n===== 循环依赖检测（Tarjan 强连通分量）=====\n" << std::fixed << std::setprecision(2);
+    std::cout << "课程体系 + " << kPlantedCycles << " 个三元环 + 1 个自依赖（" << cyclicNodes << " 个知识点，" << cyclicEdges
+              << " 条边）: " << tarjanMs << " ms  找到 " << cycles.size() << " 处  核对: " << (cyclesFound ? "一致" : "不一致！") << "\n";
+    std::cout << "单链 " << chain << " 个知识点: 迭代 DFS " << chainDfsMs << " ms，首尾相接后 Tarjan " << chainTarjanMs
+              << " ms  核对: " << (chainOk ? "一致" : "不一致！") << "\n" << std::defaultfloat;
+    return same && cyclesFound && chainOk ? 0 : 1;
+}
+
+} // namespace
+
+int runBenchCommand(int argc, char* argv[]) {
+    if (argc < 2) {
+        printBenchUsage();
+        return 1;
+    }
+    std::string cmd = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+
+    if (cmd == "--help" || cmd == "-h") {
+        printBenchUsage();
+        return 0;
+    }
+
+    // 以下基准需要题库（知识点名称、题号 -> 下标）；不读取 IRT 校准结果，核对结果只取决于随附的题库
+    std::filesystem::path questionsPath = getDataDir() / "questions.csv";
+    if (!loadQuestionsFromFile(questionsPath.string())) {
+        return 1;
+    }
+    if (cmd == "--bench-kernels") {
+        return runBenchKernels(args);
+    }
+    if (cmd == "--bench-scores") {
+        return runBenchScores(args);
+    }
+    if (cmd == "--bench-stats") {
+        return runBenchStats(args);
+    }
+    if (cmd == "--bench-recommend") {
+        return runBenchRecommend(args);
+    }
+    if (cmd == "--bench-review") {
+        return runBenchReview(args);
+    }
+    if (cmd == "--bench-batch") {
+        return runBenchBatch(args);
+    }
+    if (cmd == "--bench-bandit") {
+        return runBenchBandit(args);
+    }
+    if (cmd == "--bench-replay") {
+        return runBenchReplay(args);
+    }
+    if (cmd == "--bench-bkt") {
+        return runBenchBkt(args);
+    }
+    if (cmd == "--bench-irt") {
+        return runBenchIrt(args);
+    }
+    if (cmd == "--bench-co-error") {
+        return runBenchCoError(args);
+    }
+    if (cmd == "--bench-mf") {
+        return runBenchMf(args);
+    }
+    if (cmd == "--bench-hlr") {
+        return runBenchHlr(args);
+    }
+    if (cmd == "--bench-graph") {
+        return runBenchGraph(args);
+    }
+
+    std::cout << "未知参数：" << cmd << "\n";
+    printBenchUsage();
+    return 1;
+}
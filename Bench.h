@@ -0,0 +1,58 @@
+/**
+ * @file Bench.h
+ * @brief 基准与一致性核对程序（DS_AI_Quiz_Bench）- 子命令分发
+ *
+ * 【模块职责】
+ * 各模块的性能基准与"优化实现 vs 参照实现"的逐位一致性核对。它们只面向开发者与持续集成，
+ * 不随用户程序 DS_AI_Quiz 发布；子命令的返回值即进程退出码，发现任何不一致时返回 1，
+ * 因此以较小规模运行时可直接作为 CTest 测试（见 CMakeLists.txt）：
+ * - DS_AI_Quiz_Bench --bench-kernels [记录数]
+ *     聚合内核（Kernels.h）微基准：标量与 AVX2 的吞吐量对比，默认 1000 万条
+ * - DS_AI_Quiz_Bench --bench-scores [题目数]
+ *     每个评分配置在各指令集下的批量评分吞吐量，并与逐题评分核对，默认 100 万题
+ * - DS_AI_Quiz_Bench --bench-stats [记录数]
+ *     并行统计重建（buildQuestionStatsParallel）在 1 线程到全部核心下的耗时与加速比
+ * - DS_AI_Quiz_Bench --bench-recommend [题目数]
+ *     推荐基准：全量大根堆、TopK 小根堆与增量推荐索引的耗时对比，默认 100 万题
+ * - DS_AI_Quiz_Bench --bench-review [题目数]
+ *     间隔复习调度基准：日历队列取到期题目与全量扫描的耗时对比，并核对到期集合，默认 100 万题
+ * - DS_AI_Quiz_Bench --bench-batch [用户数]
+ *     批量推荐基准：合成长尾分布的用户记录，对比 1 线程与全部核心的吞吐量，并与交互式推荐核对，默认 1 万名用户
+ * - DS_AI_Quiz_Bench --bench-bandit [题目数]
+ *     Thompson 采样基准：核对 Beta 抽样分布，对比逐题抽样与成批抽样 + 顺序统计量的耗时，默认 100 万题
+ * - DS_AI_Quiz_Bench --bench-replay [用户数]
+ *     回放评估基准：合成带薄弱知识点的用户记录，对比 1 线程与全部核心的吞吐量并核对结果，默认 1 万名用户
+ * - DS_AI_Quiz_Bench --bench-bkt [用户数]
+ *     BKT 拟合基准：按已知参数合成作答序列，核对参数恢复与单线程 / 多线程结果一致，默认 5000 名用户
+ * - DS_AI_Quiz_Bench --bench-irt [用户数] [题目数]
+ *     IRT 校准基准：按已知参数合成稀疏作答矩阵，核对参数恢复与单线程 / 多线程结果一致，默认 10 万用户 × 10 万题
+ * - DS_AI_Quiz_Bench --bench-co-error [用户数] [题目数]
+ *     共错题统计基准：合成"同组误区"错题本，对比 1 线程与全部核心并核对结果，默认 10 万用户 × 10 万题
+ * - DS_AI_Quiz_Bench --bench-mf [用户数] [题目数]
+ *     潜因子模型基准：按已知低秩模型合成作答，对比各指令集与线程数并核对结果，在留出集上评估预测，默认 2 万用户 × 2 万题
+ * - DS_AI_Quiz_Bench --bench-hlr [用户数]
+ *     遗忘模型基准：按已知的半衰期模型合成作答，核对单线程 / 多线程结果一致，在留出用户上评估回忆预测，默认 5000 名用户
+ * - DS_AI_Quiz_Bench --bench-graph [知识点数]
+ *     知识点依赖图基准：合成课程体系，对比按名称邻接表与编译后 CSR + 位图的复习路径查询并核对结果，
+ *     核对 Tarjan 找到植入的循环依赖，并在 100 万个知识点的单链上运行迭代 DFS 与环检测，默认 10 万个知识点
+ * - DS_AI_Quiz_Bench --help
+ *     输出可用基准子命令
+ *
+ * 全局选项（--profile、--select、--seed、--trace）与用户程序相同，见 Cli.h。
+ *
+ * 【设计原则】
+ * - bench_main.cpp 先调用 applyGlobalOptions() 取出全局选项，再调用 runBenchCommand()，
+ *   返回值即进程退出码
+ * - 与用户程序共用全部业务模块（静态库 DS_AI_Quiz_Core），只多出本模块
+ */
+
+#pragma once
+
+/**
+ * @brief 解析命令行参数并执行对应基准子命令
+ *
+ * @param argc main 的参数个数
+ * @param argv main 的参数数组（argv[1] 为子命令）
+ * @return int 进程退出码：0 成功且各项核对一致；1 参数错误、执行失败或核对不一致
+ */
+int runBenchCommand(int argc, char* argv[]);
@@ -0,0 +1,682 @@
+/**
+ * @file Cli.cpp
+ * @brief 命令行（非交互）模式实现
+ *
+ * 实现要点：
+ * 1. **子命令表**：argv[1] 与子命令名逐一比较，未知子命令输出用法并返回 1；
+ *    基准与一致性核对（--bench-*）不在用户程序中，见 Bench.cpp（DS_AI_Quiz_Bench）
+ * 2. **班级用时分布**：逐个快照调用 mergeStatsSnapshot()，
+ *    合并的只是有界大小的草图，与各用户的历史长度无关
+ * 3. **批量推荐**：--batch-recommend 为 data 目录下全部用户写出推荐结果
+ * 4. **离线回放评估**：--replay-eval 以 data 目录下全部用户的历史记录评估各评分配置
+ * 5. **知识追踪参数**：--fit-bkt 以并行 EM 从全部用户的记录拟合 BKT 参数并写入 data/bkt_params.txt
+ * 6. **难度校准**：--calibrate-irt 以稀疏矩阵上的并行交替 Newton 步拟合 1PL/2PL，写入 data/question_calibration.csv
+ * 7. **共错题**：--build-co-error 读取全部用户的错题本，逐题并行统计共同答错人数并保留前 N 个邻居，
+ *    写入 data/co_error.txt
+ * 8. **潜因子模型**：--train-mf 以并行 ALS 在全部用户的答对率矩阵上训练潜因子，写入 data/latent_factors.txt
+ * 9. **遗忘模型**：--fit-hlr 以全批量 Adam 并行拟合半衰期回归，写入 data/half_life.txt
+ * 10. **共用输出**：回放评估结果、BKT 参数表与遗忘模型权重的输出函数由拟合子命令与对应基准共用（见 Cli.h）
+ * 11. **全局选项**：applyGlobalOptions() 在分派子命令前取出 --profile <配置名>、--select <方式>、
+ *    --seed <种子> 与 --trace[=<文件>]，对交互式菜单、子命令与基准程序同样生效
+ */
+
+#include "Cli.h"
+#include "BatchRecommend.h"
+#include "CoError.h"
+#include "HalfLifeRegression.h"
+#include "IrtCalibration.h"
+#include "Question.h"
+#include "Recommender.h"
+#include "RecommendTrace.h"
+#include "Stats.h"
+#include "Kernels.h"
+#include "KnowledgeGraph.h"
+#include "KnowledgeTracing.h"
+#include "MatrixFactorization.h"
+#include "ReplayEval.h"
+#include "ThreadPool.h"
+#include "TopK.h"
+#include "Utils.h"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 输出回放评估结果表（每个评分配置一行）
+ */
+void printReplaySummary(const ReplaySummary& summary, size_t K) {
+    std::cout << "用户数: " << summary.users << "  记录数: " << summary.records << "（答错 " << summary.wrongAnswers
+              << "）  用户-天数: " << summary.days << "  K = " << K << "\n\n";
+    std::cout << std::left << std::setw(12) << "评分配置" << std::right << std::setw(10) << "AUC"
+              << std::setw(14) << "Precision@K" << "\n";
+    std::cout << std::fixed << std::setprecision(4);
+    for (const PolicyEvaluation& p : summary.policies) {
+        std::cout << std::left << std::setw(12) << p.profile->name << std::right << std::setw(10) << p.auc
+                  << std::setw(14) << summary.precision(p) << "  " << p.profile->label << "\n";
+    }
+    std::cout << std::left << std::setw(12) << "random" << std::right << std::setw(10) << 0.5 << std::setw(14)
+              << summary.baseline() << "  随机排序基准\n";
+    std::cout << std::defaultfloat;
+}
+
+/**
+ * @brief 输出 BKT 参数表（每个知识点一行；truth 非空时附上与真实参数的最大偏差）
+ */
+void printTracingParams(const TracingFit& fit, const std::vector<BktParams>* truth) {
+    std::cout << std::left << std::setw(16) << "知识点" << std::right << std::setw(10) << "作答数"
+              << std::setw(9) << "prior" << std::setw(9) << "learn" << std::setw(9) << "guess" << std::setw(9) << "slip";
+    if (truth) std::cout << "    最大偏差";
+    std::cout << "\n" << std::fixed << std::setprecision(3);
+    for (size_t k = 0; k < fit.params.size(); ++k) {
+        const BktParams& p = fit.params[k];
+        std::cout << std::left << std::setw(16) << g_knowledgeNames[k] << std::right << std::setw(10)
+                  << fit.observations[k] << std::setw(9) << p.prior << std::setw(9) << p.learn << std::setw(9)
+                  << p.guess << std::setw(9) << p.slip;
+        if (truth) {
+            const BktParams& t = (*truth)[k];
+            double gap = std::max(std::max(std::fabs(p.prior - t.prior), std::fabs(p.learn - t.learn)),
+                                  std::max(std::fabs(p.guess - t.guess), std::fabs(p.slip - t.slip)));
+            std::cout << std::setw(12) << gap;
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat;
+}
+
+/**
+ * @brief 输出半衰期回归的权重（每个特征一行）
+ */
+void printHalfLifeParams(const HalfLifeParams& p) {
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << std::left << std::setw(20) << "常数项" << std::right << std::setw(10) << p.bias << "\n";
+    std::cout << std::left << std::setw(20) << "√(1 + 作答次数)" << std::right << std::setw(10) << p.attempts << "\n";
+    std::cout << std::left << std::setw(20) << "√(1 + 答对次数)" << std::right << std::setw(10) << p.correct << "\n";
+    std::cout << std::left << std::setw(20) << "√(1 + 答错次数)" << std::right << std::setw(10) << p.wrong << "\n";
+    for (int d = 0; d < kHlrDifficultyLevels; ++d) {
+        std::cout << std::left << std::setw(20) << ("难度 " + std::to_string(d + 1)) << std::right << std::setw(10)
+                  << p.difficulty[d] << "\n";
+    }
+    for (size_t k = 0; k < p.knowledge.size() && k < g_knowledgeNames.size(); ++k) {
+        std::cout << std::left << std::setw(20) << g_knowledgeNames[k] << std::right << std::setw(10) << p.knowledge[k]
+                  << "\n";
+    }
+    std::cout << std::defaultfloat;
+}
+
+namespace {
+
+/// 输出命令行用法
+void printUsage() {
+    std::cout << "用法：\n";
+    std::cout << "  DS_AI_Quiz                              进入交互式菜单\n";
+    std::cout << "  DS_AI_Quiz --cohort-times [快照...]     合并统计快照，输出班级用时分布\n";
+    std::cout << "                                          （未指定快照时合并 data/stats_*.snapshot）\n";
+    std::cout << "  DS_AI_Quiz --batch-recommend [K] [输出]   为全部用户预先计算明天的推荐（默认每人 20 道，\n";
+    std::cout << "                                          写入 data/batch_recommendations.csv）\n";
+    std::cout << "  DS_AI_Quiz --replay-eval [K] [目录]       按时间回放历史记录，评估各评分配置预测答错的能力\n";
+    std::cout << "                                          （默认 K = 5、目录 data，输出 AUC 与 Precision@K）\n";
+    std::cout << "  DS_AI_Quiz --fit-bkt [目录]               以 EM 拟合各知识点的 BKT 参数（默认目录 data），\n";
+    std::cout << "                                          写入 data/bkt_params.txt\n";
+    std::cout << "  DS_AI_Quiz --calibrate-irt [1pl|2pl] [目录]  以 IRT 模型校准题目难度与区分度（默认 2pl、目录 data），\n";
+    std::cout << "                                          写入 data/question_calibration.csv\n";
+    std::cout << "  DS_AI_Quiz --build-co-error [N] [目录]    统计全部用户错题本中的共错题（每题默认 " << kCoErrorTopN << " 道），\n";
+    std::cout << "                                          写入 data/co_error.txt\n";
+    std::cout << "  DS_AI_Quiz --train-mf [目录]              以 ALS 训练用户 × 题目答对率的潜因子模型（默认目录 data），\n";
+    std::cout << "                                          写入 data/latent_factors.txt\n";
+    std::cout << "  DS_AI_Quiz --fit-hlr [目录]               以半衰期回归拟合遗忘模型（默认目录 data），\n";
+    std::cout << "                                          写入 data/half_life.txt\n";
+    std::cout << "  DS_AI_Quiz --help                       显示本帮助\n";
+    std::cout << "\n基准与一致性核对（--bench-*）由 DS_AI_Quiz_Bench 提供，见 DS_AI_Quiz_Bench --help。\n";
+    printGlobalOptions();
+}
+
+} // namespace
+
+void printGlobalOptions() {
+    std::cout << "\n全局选项（可与以上任一形式组合）：\n";
+    std::cout << "  --profile <配置名>                      选择推荐评分配置（默认 balanced）：\n";
+    for (const ScoringProfile& p : scoringProfiles()) {
+        std::cout << "      " << std::left << std::setw(12) << p.name << std::right << p.label
+                  << "  错误率 " << p.weights.errorWeight << " / 时间间隔 " << p.weights.timeWeight
+                  << " / 难度 " << p.weights.difficultyWeight << "，时间基准 " << p.weights.horizonDays << " 天"
+                  << "，前置补强 " << p.weights.prereqWeight << "\n";
+    }
+    std::cout << "  --select <方式>                         选择推荐题目的选择方式（默认 heap）：\n";
+    std::cout << "      heap        按分数取前 K 道\n";
+    std::cout << "      mmr         从前 " << kDiversityPoolFactor << "K 道中以最大边际相关性挑选，兼顾知识点与难度的多样性"
+              << "（λ = " << kDiversityLambda << "）\n";
+    std::cout << "  --seed <种子>                           指定会话随机种子（十进制或 0x 十六进制），重放随机刷题、\n";
+    std::cout << "                                          错题本、考试与探索推荐的抽取（种子见 data/session_log.csv）\n";
+    std::cout << "  --trace[=<文件>]                        AI 推荐时把各阶段耗时与每道推荐题的评分分项追加为 JSON Lines\n";
+    std::cout << "                                          （默认 data/recommend_trace.jsonl"
+              << (kRecommendTraceCompiled ? "" : "；本程序编译时未启用") << "）\n";
+}
+
+namespace {
+
+/**
+ * @brief 子命令 --cohort-times：合并统计快照并输出用时分布
+ *
+ * 输出两部分：
+ * 1. 各知识点的样本数、中位用时、P95 用时
+ * 2. 中位用时最长的 10 道题（至少 5 个样本）
+ */
+int runCohortTimes(const std::vector<std::string>& files) {
+    std::vector<std::string> paths = files;
+    if (paths.empty()) {
+        // 默认合并 data 目录下全部快照（按文件名排序，保证输出稳定）
+        std::filesystem::path dataDir = getDataDir();
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dataDir, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("stats_", 0) == 0 && entry.path().extension() == ".snapshot") {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+    if (paths.empty()) {
+        std::cout << "没有找到统计快照（导出学习报告时会写出 data/stats_<用户>.snapshot）。\n";
+        return 1;
+    }
+
+    CohortTimeSketches cohort;
+    for (const auto& path : paths) {
+        if (!mergeStatsSnapshot(path, cohort)) {
+            std::cout << "警告：无法读取快照 " << path << "，已跳过。\n";
+        }
+    }
+    if (cohort.users == 0) return 1;
+
+    std::cout << "===== 班级用时分布（" << cohort.users << " 份快照） =====\n";
+
+    // 知识点按名称排序输出
+    std::vector<std::string> names;
+    for (const auto& p : cohort.byKnowledge) names.push_back(p.first);
+    std::sort(names.begin(), names.end());
+    for (const auto& name : names) {
+        const QuantileSketch& sk = cohort.byKnowledge.at(name);
+        std::cout << "[知识点] " << name
+             << "  样本: " << sk.count()
+             << "  中位用时: " << sk.quantile(0.5) << " 秒"
+             << "  P95 用时: " << sk.quantile(0.95) << " 秒\n";
+    }
+
+    // 中位用时最长的题目：中位数降序，相同则题号升序
+    const uint64_t kMinSamples = 5;
+    const size_t kTop = 10;
+    TopK<std::pair<int, int>, ScoreIdBetter> slowTop(kTop);   // (中位用时, 题号)
+    for (const auto& p : cohort.byQuestion) {
+        if (p.second.count() < kMinSamples) continue;
+        slowTop.push({p.second.quantile(0.5), p.first});
+    }
+    std::vector<std::pair<int, int>> slow = slowTop.takeSorted();
+    size_t top = slow.size();
+
+    std::cout << "\n===== 中位用时最长的题目（样本 >= " << kMinSamples << "） =====\n";
+    for (size_t i = 0; i < top; ++i) {
+        int qid = slow[i].second;
+        const QuantileSketch& sk = cohort.byQuestion.at(qid);
+        std::cout << "[题号 " << qid << "]";
+        auto itQ = g_questionById.find(qid);
+        if (itQ != g_questionById.end()) {
+            std::cout << " " << g_questions[itQ->second].knowledge;
+        }
+        std::cout << "  样本: " << sk.count()
+             << "  中位用时: " << slow[i].first << " 秒"
+             << "  P95 用时: " << sk.quantile(0.95) << " 秒\n";
+    }
+    if (top == 0) std::cout << "（暂无样本足够的题目）\n";
+    return 0;
+}
+
+/**
+ * @brief 子命令 --batch-recommend：为 data 目录下全部用户预先计算明天的推荐题目
+ *
+ * 评估时间取当前时间加一天；加载知识点依赖图、潜因子模型与遗忘模型（与交互式启动相同）后调用 batchRecommend()（全局线程池），
+ * 结果写入一个文件（格式见 BatchRecommend.h），并输出用户数、记录数与耗时。
+ */
+int runBatchRecommend(const std::vector<std::string>& args) {
+    size_t K = 20;
+    if (!args.empty() && !parseCount(args[0], K)) {
+        std::cout << "推荐数量无效：" << args[0] << "（须为非负整数）\n";
+        return 1;
+    }
+    K = std::min(K, g_questions.size());   // 题库不足 K 道时推荐全部
+    std::string output = args.size() > 1 ? args[1] : (getDataDir() / "batch_recommendations.csv").string();
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(getDataDir());
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（data/records_<用户>.csv）。\n";
+        return 1;
+    }
+    loadKnowledgeGraphFromFile((getDataDir() / "knowledge_graph.txt").string());
+    loadLatentFactorsFromFile((getDataDir() / "latent_factors.txt").string());
+    loadHalfLifeParamsFromFile((getDataDir() / "half_life.txt").string());
+
+    long long now = (long long)std::time(nullptr) + 86400;   // 明天
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<UserRecommendation> results = batchRecommend(files, K, now, globalThreadPool());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!writeBatchRecommendations(output, results, K, now)) return 1;
+
+    size_t users = 0;
+    size_t records = 0;
+    for (const UserRecommendation& u : results) {
+        if (!u.ok) {
+            std::cout << "警告：无法读取 " << u.userId << " 的记录文件，已跳过。\n";
+            continue;
+        }
+        ++users;
+        records += u.records;
+    }
+    std::cout << "批量推荐完成：" << users << " 名用户，" << records << " 条记录，每人 " << K << " 道，"
+              << "评分配置 " << activeScoringProfile().name << "，耗时 " << std::fixed << std::setprecision(2)
+              << seconds << " 秒（" << globalThreadPool().size() << " 线程）。\n" << std::defaultfloat;
+    std::cout << "结果已写入：" << output << "\n";
+    return 0;
+}
+
+/**
+ * @brief 子命令 --replay-eval：回放目录下全部用户的历史记录，评估各评分配置
+ *
+ * 加载知识点依赖图后调用 replayEvaluate()（全局线程池），输出各评分配置的 AUC 与 Precision@K。
+ */
+int runReplayEval(const std::vector<std::string>& args) {
+    size_t K = 5;
+    if (!args.empty() && !parseCount(args[0], K)) {
+        std::cout << "K 无效：" << args[0] << "（须为正整数）\n";
+        return 1;
+    }
+    K = std::max<size_t>(1, std::min(K, g_questions.size()));
+    std::filesystem::path dir = args.size() > 1 ? std::filesystem::path(args[1]) : getDataDir();
+
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+    loadKnowledgeGraphFromFile((getDataDir() / "knowledge_graph.txt").string());
+
+    auto t0 = std::chrono::steady_clock::now();
+    ReplaySummary summary = replayEvaluate(files, K, globalThreadPool());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "===== 离线回放评估 =====\n";
+    printReplaySummary(summary, K);
+    std::cout << "\n耗时 " << std::fixed << std::setprecision(2) << seconds << " 秒（" << globalThreadPool().size()
+              << " 线程）。\n" << std::defaultfloat;
+    return 0;
+}
+
+/**
+ * @brief 子命令 --fit-bkt：从目录下全部用户的记录拟合 BKT 参数，写入 data/bkt_params.txt
+ */
+int runFitBkt(const std::vector<std::string>& args) {
+    std::filesystem::path dir = args.empty() ? getDataDir() : std::filesystem::path(args[0]);
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    TracingFit fit = fitTracingParams(files, kBktFitIterations, globalThreadPool());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (fit.records == 0) {
+        std::cout << "没有可用于拟合的记录。\n";
+        return 1;
+    }
+
+    std::cout << "===== BKT 参数拟合 =====\n";
+    std::cout << "用户数: " << fit.users << "  记录数: " << fit.records << "  迭代: " << fit.iterations
+              << (fit.converged ? "（已收敛）" : "（达到最大轮数）") << "  对数似然: " << std::fixed
+              << std::setprecision(2) << fit.logLikelihood << std::defaultfloat << "\n\n";
+    printTracingParams(fit, nullptr);
+    std::cout << "（作答数少于 " << kBktMinObservations << " 的知识点保留默认参数）\n";
+
+    std::string output = (getDataDir() / "bkt_params.txt").string();
+    if (!saveTracingParamsToFile(output, fit.params)) return 1;
+    std::cout << "\n耗时 " << std::fixed << std::setprecision(2) << seconds << " 秒（" << globalThreadPool().size()
+              << " 线程），参数已写入：" << output << "\n" << std::defaultfloat;
+    return 0;
+}
+
+/**
+ * @brief 子命令 --calibrate-irt：从目录下全部用户的记录拟合 IRT 模型，写入 data/question_calibration.csv
+ *
+ * 参数：[1pl|2pl]（默认 2pl）[目录]（默认 data）。输出各难度等级的题目数（标注 vs 校准）
+ * 与标注难度相差 2 级及以上的题目，写出后立即加载到当前题库。
+ */
+int runCalibrateIrt(const std::vector<std::string>& args) {
+    IrtModel model = IrtModel::TwoPL;
+    size_t next = 0;
+    if (next < args.size() && parseIrtModel(args[next], model)) ++next;
+    std::filesystem::path dir = next < args.size() ? std::filesystem::path(args[next]) : getDataDir();
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    IrtResponses data = loadIrtResponses(files, globalThreadPool());
+    auto t1 = std::chrono::steady_clock::now();
+    if (data.entries() == 0) {
+        std::cout << "没有可用于校准的记录。\n";
+        return 1;
+    }
+    IrtFit fit = fitIrt(data, model, kIrtFitIterations, globalThreadPool());
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "===== 题目难度校准（" << irtModelName(model) << "）=====\n";
+    std::cout << "用户数: " << data.users() << "  用户-题目对: " << data.entries() << "  迭代: " << fit.iterations
+              << (fit.converged ? "（已收敛）" : "（达到最大轮数）") << "  对数似然: " << std::fixed
+              << std::setprecision(2) << fit.logLikelihood << std::defaultfloat << "\n\n";
+
+    // 各难度等级的题目数：标注 vs 校准（只统计作答数达到门槛的题目）
+    size_t labeled[6] = {};
+    size_t calibrated[6] = {};
+    std::vector<size_t> disagree;
+    for (size_t j = 0; j < g_questions.size(); ++j) {
+        if (fit.responses[j] < kIrtMinResponses) continue;
+        int label = g_questions[j].labeledDifficulty;
+        int level = difficultyLevelOf(fit.difficulty[j]);
+        if (label >= 1 && label <= 5) ++labeled[label];
+        ++calibrated[level];
+        if (std::abs(level - label) >= 2) disagree.push_back(j);
+    }
+    std::cout << "难度等级      标注    校准\n";
+    for (int level = 1; level <= 5; ++level) {
+        std::cout << "    " << level << std::setw(14) << labeled[level] << std::setw(8) << calibrated[level] << "\n";
+    }
+    std::cout << "（作答次数不少于 " << kIrtMinResponses << " 的题目）\n";
+
+    std::sort(disagree.begin(), disagree.end(), [&](size_t a, size_t b) {
+        if (fit.responses[a] != fit.responses[b]) return fit.responses[a] > fit.responses[b];
+        return g_questions[a].id < g_questions[b].id;
+    });
+    if (!disagree.empty()) {
+        std::cout << "\n与标注相差 2 级及以上的题目 " << disagree.size() << " 道"
+                  << (disagree.size() > 10 ? "（按作答次数列出前 10 道）" : "") << "：\n";
+        std::cout << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < disagree.size() && i < 10; ++i) {
+            size_t j = disagree[i];
+            const Question& q = g_questions[j];
+            std::cout << "  题号 " << std::setw(6) << q.id << "  标注 " << q.labeledDifficulty << " -> 校准 "
+                      << difficultyLevelOf(fit.difficulty[j]) << "  b = " << std::setw(5) << fit.difficulty[j]
+                      << "  a = " << fit.discrimination[j] << "  作答 " << fit.responses[j] << "\n";
+        }
+        std::cout << std::defaultfloat;
+    }
+
+    std::string output = (getDataDir() / "question_calibration.csv").string();
+    if (!saveIrtCalibration(output, fit)) return 1;
+    std::cout << "\n读取 " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double>(t1 - t0).count() << " 秒，拟合 "
+              << std::chrono::duration<double>(t2 - t1).count() << " 秒（" << globalThreadPool().size()
+              << " 线程），校准结果已写入：" << output << "\n" << std::defaultfloat;
+    loadIrtCalibrationFromFile(output);
+    return 0;
+}
+
+/**
+ * @brief 子命令 --build-co-error：从目录下全部用户的错题本统计共错题，写入 data/co_error.txt
+ *
+ * 参数：[每题邻居数]（默认 kCoErrorTopN）[目录]（默认 data）。输出共错题最多的几道题作为抽查。
+ */
+int runBuildCoError(const std::vector<std::string>& args) {
+    size_t topN = kCoErrorTopN;
+    size_t next = 0;
+    // 以数字或符号开头的第一个参数视为邻居数，否则视为目录
+    if (next < args.size() && !args[next].empty() &&
+        (std::isdigit((unsigned char)args[next][0]) || args[next][0] == '-' || args[next][0] == '+')) {
+        if (!parseCount(args[next], topN)) {
+            std::cout << "邻居数无效：" << args[next] << "（须为正整数）\n";
+            return 1;
+        }
+        ++next;
+    }
+    topN = std::max<size_t>(1, std::min(topN, g_questions.size()));
+    std::filesystem::path dir = next < args.size() ? std::filesystem::path(args[next]) : getDataDir();
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    WrongSets sets = loadWrongSets(files, globalThreadPool());
+    auto t1 = std::chrono::steady_clock::now();
+    CoErrorTable table = buildCoErrorTable(sets, topN, globalThreadPool());
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "===== 共错题统计 =====\n";
+    std::cout << "用户数: " << files.size() << "（参与统计 " << table.users() << "）  错题本总题数: " << sets.items.size()
+              << "  共错题项: " << table.entries() << "（每题最多 " << topN << " 道）\n";
+
+    // 抽查：答错人数最多的 5 道题及其前 3 道共错题
+    std::vector<size_t> order;
+    for (size_t i = 0; i < table.itemCount(); ++i) {
+        size_t count = 0;
+        table.neighborsOf(i, count);
+        if (count > 0) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (table.misses(a) != table.misses(b)) return table.misses(a) > table.misses(b);
+        return a < b;
+    });
+    for (size_t r = 0; r < order.size() && r < 5; ++r) {
+        size_t i = order[r];
+        size_t count = 0;
+        const CoErrorNeighbor* nb = table.neighborsOf(i, count);
+        std::cout << "  题号 " << std::setw(6) << g_questions[i].id << "（答错 " << table.misses(i) << " 人） ->";
+        for (size_t k = 0; k < count && k < 3; ++k) {
+            std::cout << "  " << g_questions[nb[k].question].id << "（" << nb[k].together << " 人，"
+                      << std::fixed << std::setprecision(2) << nb[k].similarity << std::defaultfloat << "）";
+        }
+        std::cout << "\n";
+    }
+
+    std::string output = (getDataDir() / "co_error.txt").string();
+    if (!saveCoErrorToFile(output, table)) return 1;
+    std::cout << "\n读取 " << std::fixed << std::setprecision(2) << std::chrono::duration<double>(t1 - t0).count()
+              << " 秒，统计 " << std::chrono::duration<double>(t2 - t1).count() << " 秒（" << globalThreadPool().size()
+              << " 线程），已写入：" << output << "\n" << std::defaultfloat;
+    return 0;
+}
+
+/**
+ * @brief 子命令 --train-mf：从目录下全部用户的记录训练潜因子模型，写入 data/latent_factors.txt
+ *
+ * 参数：[目录]（默认 data）。输出训练误差，并与"只用全体答对率"的误差对比。
+ */
+int runTrainMf(const std::vector<std::string>& args) {
+    std::filesystem::path dir = args.empty() ? getDataDir() : std::filesystem::path(args[0]);
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    IrtResponses data = loadIrtResponses(files, globalThreadPool());
+    auto t1 = std::chrono::steady_clock::now();
+    if (data.entries() == 0) {
+        std::cout << "没有可用于训练的记录。\n";
+        return 1;
+    }
+    MfFit fit = fitMatrixFactorization(data, kMfIterations, globalThreadPool());
+    auto t2 = std::chrono::steady_clock::now();
+
+    // 对照：所有预测都取 μ 时的加权均方根误差
+    double error = 0.0;
+    double weight = 0.0;
+    for (size_t e = 0; e < data.entries(); ++e) {
+        double n = data.userAttempts[e];
+        double diff = data.userCorrect[e] / n - fit.mean;
+        error += n * diff * diff;
+        weight += n;
+    }
+    size_t modeled = 0;
+    for (uint32_t r : fit.responses) modeled += r > 0 ? 1 : 0;
+
+    std::cout << "===== 潜因子模型训练（ALS，" << kMfFactors << " 维）=====\n";
+    std::cout << "用户数: " << data.users() << "  用户-题目对: " << data.entries() << "  有作答的题目: " << modeled
+              << "  迭代: " << fit.iterations << "\n";
+    std::cout << std::fixed << std::setprecision(4) << "全体答对率 μ = " << fit.mean << "\n";
+    std::cout << "训练误差（按作答次数加权的 RMSE）: " << fit.rmse << "（只用 μ 时 " << std::sqrt(error / weight)
+              << "）\n";
+
+    std::string output = (getDataDir() / "latent_factors.txt").string();
+    if (!saveLatentFactors(output, fit)) return 1;
+    std::cout << std::setprecision(2) << "\n读取 " << std::chrono::duration<double>(t1 - t0).count() << " 秒，训练 "
+              << std::chrono::duration<double>(t2 - t1).count() << " 秒（" << globalThreadPool().size() << " 线程，"
+              << kernelIsaName(activeKernelIsa()) << "），已写入：" << output << "\n" << std::defaultfloat;
+    return 0;
+}
+
+/**
+ * @brief 子命令 --fit-hlr：从目录下全部用户的记录拟合半衰期回归，写入 data/half_life.txt
+ */
+int runFitHlr(const std::vector<std::string>& args) {
+    std::filesystem::path dir = args.empty() ? getDataDir() : std::filesystem::path(args[0]);
+    std::vector<std::filesystem::path> files = listUserRecordFiles(dir);
+    if (files.empty()) {
+        std::cout << "没有找到用户记录文件（" << dir.string() << "/records_<用户>.csv）。\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    HalfLifeFit fit = fitHalfLifeRegression(files, kHlrIterations, globalThreadPool());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (fit.samples == 0) {
+        std::cout << "没有可用于拟合的样本（需要同一道题的重复作答）。\n";
+        return 1;
+    }
+
+    std::cout << "===== 遗忘模型拟合（半衰期回归）=====\n";
+    std::cout << "用户数: " << fit.users << "  记录数: " << fit.records << "  样本数: " << fit.samples
+              << "  迭代: " << fit.iterations << "  平均损失: " << std::fixed << std::setprecision(4) << fit.loss
+              << std::defaultfloat << "\n\n";
+    std::cout << "log2 半衰期（天）的特征权重：\n";
+    printHalfLifeParams(fit.params);
+
+    std::string output = (getDataDir() / "half_life.txt").string();
+    if (!saveHalfLifeParams(output, fit.params)) return 1;
+    std::cout << "\n耗时 " << std::fixed << std::setprecision(2) << seconds << " 秒（" << globalThreadPool().size()
+              << " 线程），权重已写入：" << output << "\n" << std::defaultfloat;
+    return 0;
+}
+
+} // namespace
+
+bool applyGlobalOptions(int& argc, char* argv[]) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string name;
+        // --trace 的文件名可省略，只接受 --trace=<文件> 形式，避免吞掉子命令的参数
+        if (arg == "--trace" || arg.rfind("--trace=", 0) == 0) {
+            if (!enableRecommendTrace(arg == "--trace" ? std::string() : arg.substr(8))) return false;
+            continue;
+        }
+        if (arg == "--profile" || arg == "--select" || arg == "--seed") {
+            if (i + 1 >= argc) {
+                std::cout << arg << (arg == "--profile" ? " 缺少配置名。\n"
+                                     : arg == "--select" ? " 缺少选择方式。\n" : " 缺少种子。\n");
+                printGlobalOptions();
+                return false;
+            }
+            name = argv[++i];
+        } else if (arg.rfind("--profile=", 0) == 0) {
+            name = arg.substr(10);
+            arg = "--profile";
+        } else if (arg.rfind("--select=", 0) == 0) {
+            name = arg.substr(9);
+            arg = "--select";
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            name = arg.substr(7);
+            arg = "--seed";
+        } else {
+            argv[kept++] = argv[i];
+            continue;
+        }
+        if (arg == "--profile" && !selectScoringProfile(name)) {
+            std::cout << "未知评分配置：" << name << "\n";
+            printGlobalOptions();
+            return false;
+        }
+        if (arg == "--select" && !selectTopKSelection(name)) {
+            std::cout << "未知选择方式：" << name << "\n";
+            printGlobalOptions();
+            return false;
+        }
+        if (arg == "--seed") {
+            uint64_t seed = 0;
+            if (!parseSeed(name, seed)) {
+                std::cout << "无效的种子：" << name << "（应为十进制或 0x 开头的十六进制 64 位整数）\n";
+                printGlobalOptions();
+                return false;
+            }
+            setSessionSeed(seed);
+        }
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+    return true;
+}
+
+int runCommandLine(int argc, char* argv[]) {
+    std::string cmd = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+
+    if (cmd == "--help" || cmd == "-h") {
+        printUsage();
+        return 0;
+    }
+
+    // 以下子命令需要题库（知识点名称、题号 -> 下标）
+    std::filesystem::path questionsPath = getDataDir() / "questions.csv";
+    if (!loadQuestionsFromFile(questionsPath.string())) {
+        return 1;
+    }
+    // 校准后的难度对批量推荐、回放评估等子命令同样生效
+    loadIrtCalibrationFromFile((getDataDir() / "question_calibration.csv").string());
+
+    if (cmd == "--cohort-times") {
+        return runCohortTimes(args);
+    }
+    if (cmd == "--batch-recommend") {
+        return runBatchRecommend(args);
+    }
+    if (cmd == "--replay-eval") {
+        return runReplayEval(args);
+    }
+    if (cmd == "--fit-bkt") {
+        return runFitBkt(args);
+    }
+    if (cmd == "--calibrate-irt") {
+        return runCalibrateIrt(args);
+    }
+    if (cmd == "--build-co-error") {
+        return runBuildCoError(args);
+    }
+    if (cmd == "--train-mf") {
+        return runTrainMf(args);
+    }
+    if (cmd == "--fit-hlr") {
+        return runFitHlr(args);
+    }
+
+    std::cout << "未知参数：" << cmd << "\n";
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file Cli.h
+ * @brief 命令行（非交互）模式 - 子命令分发
+ *
+ * 【模块职责】
+ * 交互式菜单面向单个学生；教师、助教或脚本需要的批量/汇总功能
+ * 通过命令行参数调用，不进入登录与菜单流程：
+ * - DS_AI_Quiz --cohort-times [快照文件...]
+ *     合并多个用户的统计快照（data/stats_<userId>.snapshot），输出班级用时分布；
+ *     未给出文件时合并 data 目录下全部快照
+ * - DS_AI_Quiz --batch-recommend [K] [输出文件]
+ *     为 data 目录下全部用户预先计算明天的 Top-K 推荐（默认 K = 20），写入一个结果文件
+ *     （默认 data/batch_recommendations.csv），供每晚定时任务调用
+ * - DS_AI_Quiz --replay-eval [K] [目录]
+ *     按时间回放目录（默认 data）下全部用户的历史记录，输出各评分配置预测答错的 AUC 与 Precision@K（默认 K = 5）
+ * - DS_AI_Quiz --fit-bkt [目录]
+ *     以并行 EM 从目录（默认 data）下全部用户的记录拟合各知识点的 BKT 参数，写入 data/bkt_params.txt
+ * - DS_AI_Quiz --calibrate-irt [1pl|2pl] [目录]
+ *     以 IRT 模型从目录（默认 data）下全部用户的记录校准题目难度与区分度，写入 data/question_calibration.csv
+ * - DS_AI_Quiz --build-co-error [N] [目录]
+ *     从目录（默认 data）下全部用户的错题本统计每道题的前 N 道共错题（默认 20），写入 data/co_error.txt
+ * - DS_AI_Quiz --train-mf [目录]
+ *     以并行 ALS 在目录（默认 data）下全部用户的答对率矩阵上训练潜因子模型，写入 data/latent_factors.txt
+ * - DS_AI_Quiz --fit-hlr [目录]
+ *     以半衰期回归从目录（默认 data）下全部用户的记录拟合遗忘模型，写入 data/half_life.txt
+ * - DS_AI_Quiz --help
+ *     输出可用子命令与评分配置
+ *
+ * 基准与一致性核对（--bench-kernels、--bench-recommend 等）不随用户程序发布，
+ * 由单独的 DS_AI_Quiz_Bench 提供（见 Bench.h），并作为 CTest 测试运行。
+ *
+ * 全局选项 --profile <配置名>（或 --profile=<配置名>）可与以上任一形式组合，也可单独使用
+ * 后进入交互式菜单，选择本次会话的推荐评分配置（balanced / weakness / review / challenge）。
+ * 全局选项 --select <方式>（或 --select=<方式>）选择推荐题目的选择方式：heap（按分数，默认）
+ * 或 mmr（在前 K × kDiversityPoolFactor 道中以最大边际相关性兼顾知识点与难度的多样性）。
+ * 全局选项 --seed <种子>（或 --seed=<种子>）指定会话随机种子（十进制或 0x 开头的十六进制）：
+ * 随机刷题、错题本、模拟考试与探索推荐的抽取都由该种子派生，登录时写入 data/session_log.csv 的种子
+ * 以此重放即可复现同一份试卷。
+ * 全局选项 --trace（或 --trace=<文件>）开启推荐追踪：每次 AI 推荐把各阶段耗时与每道推荐题的评分分项
+ * 追加为一行 JSON（默认 data/recommend_trace.jsonl，见 RecommendTrace.h）。
+ *
+ * 【设计原则】
+ * - main() 先调用 applyGlobalOptions() 取出全局选项，剩余 argc > 1 时调用 runCommandLine()，
+ *   返回值即进程退出码
+ * - 输出为纯文本，便于重定向到文件或被脚本解析
+ */
+
+#pragma once
+
+#include "HalfLifeRegression.h"
+#include "KnowledgeTracing.h"
+#include "ReplayEval.h"
+#include <cstddef>
+#include <vector>
+
+/// BKT 拟合的最大迭代轮数（--fit-bkt 与 BKT 拟合基准共用）
+constexpr size_t kBktFitIterations = 200;
+
+/// IRT 校准的最大迭代轮数（--calibrate-irt 与 IRT 校准基准共用）
+constexpr size_t kIrtFitIterations = 100;
+
+/**
+ * @brief 取出并应用全局选项（--profile <配置名>、--select <方式>、--seed <种子> 与 --trace[=<文件>]）
+ *
+ * 识别到的选项从 argv 中移除，argc 随之减小，剩余参数保持原顺序。
+ *
+ * @param argc main 的参数个数（输出为移除全局选项后的个数）
+ * @param argv main 的参数数组（原地压缩）
+ * @return true 成功；false 选项缺少参数、配置名 / 选择方式不存在、种子格式错误或追踪文件无法打开
+ */
+bool applyGlobalOptions(int& argc, char* argv[]);
+
+/**
+ * @brief 解析命令行参数并执行对应子命令
+ *
+ * @param argc main 的参数个数
+ * @param argv main 的参数数组（argv[1] 为子命令）
+ * @return int 进程退出码：0 成功；1 参数错误或执行失败
+ */
+int runCommandLine(int argc, char* argv[]);
+
+/**
+ * @brief 输出全局选项的用法（评分配置列表、选择方式、种子与追踪）
+ *
+ * 用户程序与基准程序的 --help 共用；全局选项解析失败时也只输出这一部分。
+ */
+void printGlobalOptions();
+
+/**
+ * @brief 输出回放评估结果表（每个评分配置一行），供 --replay-eval 与回放评估基准共用
+ * @param summary 回放评估结果
+ * @param K 推荐数量
+ */
+void printReplaySummary(const ReplaySummary& summary, size_t K);
+
+/**
+ * @brief 输出 BKT 参数表（每个知识点一行），供 --fit-bkt 与 BKT 拟合基准共用
+ * @param fit 拟合结果
+ * @param truth 真实参数（非空时附上与真实参数的最大偏差）
+ */
+void printTracingParams(const TracingFit& fit, const std::vector<BktParams>* truth);
+
+/**
+ * @brief 输出半衰期回归的权重（每个特征一行），供 --fit-hlr 与遗忘模型基准共用
+ * @param p 半衰期回归参数
+ */
+void printHalfLifeParams(const HalfLifeParams& p);
@@ -0,0 +1,290 @@
+/**
+ * @file CoError.cpp
+ * @brief 共错题模块实现
+ *
+ * 实现要点：
+ * 1. **错题本**：每个用户一个任务，记录编码为 (题目下标, 时间戳, 文件中的行号, 是否答对)，
+ *    排序后每道题的最后一项即最后一次作答；各用户的错题本按编号顺序拼接为 CSR
+ * 2. **转置**：计数排序得到"题目 -> 答错过它的用户"，同时得到各题的答错人数
+ * 3. **逐题计数**：线程私有的 counts（长度为题目数）与 touched 列表，遍历完后只复位 touched 中的项，
+ *    每道题的代价与它的共错题对数成正比，与题库大小无关
+ * 4. **选择**：共同答错人数达到 kCoErrorMinSupport 的候选以 TopK 保留前 N 项，
+ *    比较规则为相似度降序、共同答错人数降序、题目下标升序（严格全序，与插入顺序无关）
+ * 5. **合并**：各题结果先写入各自的行，最后按题目下标顺序拼接为 CSR
+ * 6. **加载**：先读入全部行得到各题的答错人数，再由两端的答错人数算出相似度（float），
+ *    与构建时的计算方式一致
+ */
+
+#include "CoError.h"
+#include "Question.h"
+#include "Record.h"
+#include "ThreadPool.h"
+#include "TopK.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <tuple>
+
+CoErrorTable g_coError;
+
+namespace {
+
+/// 每个并行任务处理的题目数
+const size_t kCoErrorBlock = 64;
+
+/// 共错题的排序：相似度高者优先，其次共同答错人数多者，再次题目下标小者
+struct CoErrorBetter {
+    bool operator()(const CoErrorNeighbor& a, const CoErrorNeighbor& b) const {
+        if (a.similarity != b.similarity) return a.similarity > b.similarity;
+        if (a.together != b.together) return a.together > b.together;
+        return a.question < b.question;
+    }
+};
+
+float cosineOf(uint32_t together, uint32_t missesA, uint32_t missesB) {
+    return (float)(together / std::sqrt((double)missesA * (double)missesB));
+}
+
+/**
+ * @brief 读取一个用户的记录，得到按题目下标升序的错题本
+ */
+void readWrongSet(const std::filesystem::path& file, std::vector<int32_t>& out) {
+    std::ifstream fin(file);
+    if (!fin.is_open()) return;
+
+    // (题目下标, 时间戳, 行号, 是否答对)：排序后每道题的最后一项即最后一次作答
+    std::vector<std::tuple<int32_t, long long, size_t, bool>> rows;
+    std::string line;
+    Record r;
+    while (std::getline(fin, line)) {
+        if (line.empty() || !parseRecordLine(line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end() || itQ->second >= g_questions.size()) continue;
+        rows.emplace_back((int32_t)itQ->second, r.timestamp, rows.size(), r.correct);
+    }
+    std::sort(rows.begin(), rows.end());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        bool last = i + 1 == rows.size() || std::get<0>(rows[i + 1]) != std::get<0>(rows[i]);
+        if (last && !std::get<3>(rows[i])) out.push_back(std::get<0>(rows[i]));
+    }
+}
+
+/**
+ * @brief 线程私有的逐题计数工作区（在同一线程的多道题之间复用）
+ */
+struct CoErrorScratch {
+    std::vector<uint32_t> counts;   ///< 题目下标 -> 与当前题目共同答错的人数
+    std::vector<int32_t> touched;   ///< counts 中非零的题目
+};
+
+} // namespace
+
+const CoErrorNeighbor* CoErrorTable::neighborsOf(size_t qIdx, size_t& count) const {
+    if (qIdx + 1 >= start_.size()) {
+        count = 0;
+        return nullptr;
+    }
+    count = start_[qIdx + 1] - start_[qIdx];
+    return neighbors_.data() + start_[qIdx];
+}
+
+bool CoErrorTable::operator==(const CoErrorTable& o) const {
+    if (users_ != o.users_ || misses_ != o.misses_ || start_ != o.start_ || neighbors_.size() != o.neighbors_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < neighbors_.size(); ++i) {
+        const CoErrorNeighbor& a = neighbors_[i];
+        const CoErrorNeighbor& b = o.neighbors_[i];
+        if (a.question != b.question || a.together != b.together || a.similarity != b.similarity) return false;
+    }
+    return true;
+}
+
+WrongSets loadWrongSets(const std::vector<std::filesystem::path>& files, ThreadPool& pool) {
+    std::vector<std::vector<int32_t>> rows(files.size());
+    pool.parallelFor(files.size(), [&](size_t u) { readWrongSet(files[u], rows[u]); });
+
+    WrongSets sets;
+    sets.itemCount = g_questions.size();
+    sets.start.assign(files.size() + 1, 0);
+    for (size_t u = 0; u < rows.size(); ++u) sets.start[u + 1] = sets.start[u] + rows[u].size();
+    sets.items.reserve(sets.start.back());
+    for (std::vector<int32_t>& row : rows) {
+        sets.items.insert(sets.items.end(), row.begin(), row.end());
+        std::vector<int32_t>().swap(row);   // 及早释放
+    }
+    return sets;
+}
+
+CoErrorTable buildCoErrorTable(const WrongSets& sets, size_t topN, ThreadPool& pool) {
+    size_t n = sets.itemCount;
+    CoErrorTable table;
+    table.misses_.assign(n, 0);
+
+    // 1. 转置：题目 -> 答错过它的用户（跳过错题本过大的用户）
+    std::vector<size_t> colStart(n + 1, 0);
+    for (size_t u = 0; u < sets.users(); ++u) {
+        size_t size = sets.start[u + 1] - sets.start[u];
+        if (size == 0 || size > kCoErrorMaxWrongPerUser) continue;
+        ++table.users_;
+        for (size_t e = sets.start[u]; e < sets.start[u + 1]; ++e) ++colStart[sets.items[e] + 1];
+    }
+    for (size_t j = 0; j < n; ++j) {
+        table.misses_[j] = (uint32_t)colStart[j + 1];
+        colStart[j + 1] += colStart[j];
+    }
+    std::vector<int32_t> colUser(colStart[n]);
+    std::vector<size_t> next(colStart.begin(), colStart.end() - 1);
+    for (size_t u = 0; u < sets.users(); ++u) {
+        size_t size = sets.start[u + 1] - sets.start[u];
+        if (size == 0 || size > kCoErrorMaxWrongPerUser) continue;
+        for (size_t e = sets.start[u]; e < sets.start[u + 1]; ++e) colUser[next[sets.items[e]]++] = (int32_t)u;
+    }
+
+    // 2. 逐题计数并选出前 topN 个邻居（每道题只写自己的行）
+    std::vector<std::vector<CoErrorNeighbor>> rows(n);
+    size_t blocks = (n + kCoErrorBlock - 1) / kCoErrorBlock;
+    pool.parallelFor(blocks, [&](size_t b) {
+        thread_local CoErrorScratch s;
+        if (s.counts.size() != n) s.counts.assign(n, 0);
+        TopK<CoErrorNeighbor, CoErrorBetter> top(topN);
+        for (size_t i = b * kCoErrorBlock; i < std::min(n, (b + 1) * kCoErrorBlock); ++i) {
+            s.touched.clear();
+            for (size_t c = colStart[i]; c < colStart[i + 1]; ++c) {
+                int32_t u = colUser[c];
+                for (size_t e = sets.start[u]; e < sets.start[u + 1]; ++e) {
+                    int32_t j = sets.items[e];
+                    if ((size_t)j == i) continue;
+                    if (s.counts[j]++ == 0) s.touched.push_back(j);
+                }
+            }
+            for (int32_t j : s.touched) {
+                uint32_t together = s.counts[j];
+                s.counts[j] = 0;
+                if (together < kCoErrorMinSupport) continue;
+                top.push(CoErrorNeighbor{j, together, cosineOf(together, table.misses_[i], table.misses_[j])});
+            }
+            rows[i] = top.takeSorted();
+        }
+    });
+
+    // 3. 按题目下标顺序拼接
+    table.start_.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) table.start_[i + 1] = table.start_[i] + rows[i].size();
+    table.neighbors_.reserve(table.start_[n]);
+    for (std::vector<CoErrorNeighbor>& row : rows) {
+        table.neighbors_.insert(table.neighbors_.end(), row.begin(), row.end());
+        std::vector<CoErrorNeighbor>().swap(row);
+    }
+    return table;
+}
+
+bool saveCoErrorToFile(const std::string& filename, const CoErrorTable& table) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入共错题文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz co-error neighbors v1\n";
+    fout << "# users=" << table.users() << "\n";
+    fout << "# 题号,答错人数,邻居题号:共同答错人数,...\n";
+    for (size_t i = 0; i < table.itemCount() && i < g_questions.size(); ++i) {
+        size_t count = 0;
+        const CoErrorNeighbor* nb = table.neighborsOf(i, count);
+        if (count == 0) continue;
+        fout << g_questions[i].id << ',' << table.misses(i);
+        for (size_t k = 0; k < count; ++k) fout << ',' << g_questions[nb[k].question].id << ':' << nb[k].together;
+        fout << '\n';
+    }
+    return (bool)fout;
+}
+
+bool loadCoErrorFromFile(const std::string& filename) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    // 1. 读入全部行（题目下标, 邻居题号:人数...），同时得到各题的答错人数
+    size_t n = g_questions.size();
+    CoErrorTable table;
+    table.misses_.assign(n, 0);
+    std::vector<std::pair<size_t, std::vector<std::pair<int, uint32_t>>>> rows;
+    std::string line;
+    std::string field;
+    while (std::getline(fin, line)) {
+        if (line.rfind("# users=", 0) == 0) {
+            table.users_ = (size_t)std::strtoull(line.c_str() + 8, nullptr, 10);
+            continue;
+        }
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::vector<std::pair<int, uint32_t>> list;
+        int id = 0;
+        unsigned long misses = 0;
+        bool ok = true;
+        try {
+            ok = (bool)std::getline(ss, field, ',');
+            if (ok) id = std::stoi(field);
+            ok = ok && (bool)std::getline(ss, field, ',');
+            if (ok) misses = std::stoul(field);
+            while (ok && std::getline(ss, field, ',')) {
+                size_t colon = field.find(':');
+                if (colon == std::string::npos) {
+                    ok = false;
+                    break;
+                }
+                list.emplace_back(std::stoi(field.substr(0, colon)), (uint32_t)std::stoul(field.substr(colon + 1)));
+            }
+        } catch (...) {
+            ok = false;
+        }
+        auto itQ = g_questionById.find(id);
+        if (!ok || itQ == g_questionById.end() || itQ->second >= n) continue;
+        table.misses_[itQ->second] = (uint32_t)misses;
+        rows.emplace_back(itQ->second, std::move(list));
+    }
+
+    // 2. 组装 CSR，相似度由两端的答错人数算出
+    std::vector<std::vector<CoErrorNeighbor>> byItem(n);
+    for (auto& row : rows) {
+        size_t i = row.first;
+        byItem[i].clear();
+        for (const std::pair<int, uint32_t>& p : row.second) {
+            auto itQ = g_questionById.find(p.first);
+            if (itQ == g_questionById.end() || itQ->second >= n || itQ->second == i) continue;
+            size_t j = itQ->second;
+            if (p.second == 0 || table.misses_[i] == 0 || table.misses_[j] == 0) continue;
+            byItem[i].push_back(CoErrorNeighbor{(int32_t)j, p.second, cosineOf(p.second, table.misses_[i], table.misses_[j])});
+        }
+    }
+    table.start_.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) table.start_[i + 1] = table.start_[i] + byItem[i].size();
+    table.neighbors_.reserve(table.start_[n]);
+    for (const std::vector<CoErrorNeighbor>& row : byItem) {
+        table.neighbors_.insert(table.neighbors_.end(), row.begin(), row.end());
+    }
+    g_coError = std::move(table);
+    return true;
+}
+
+int printRelatedMisses(const Question& q, size_t limit) {
+    auto itQ = g_questionById.find(q.id);
+    if (itQ == g_questionById.end()) return -1;
+    size_t count = 0;
+    const CoErrorNeighbor* nb = g_coError.neighborsOf(itQ->second, count);
+    count = std::min(count, limit);
+    if (count == 0) return -1;
+
+    uint32_t misses = g_coError.misses(itQ->second);
+    std::cout << "答错这道题的 " << misses << " 位同学也常答错：\n";
+    for (size_t k = 0; k < count; ++k) {
+        const Question& other = g_questions[nb[k].question];
+        std::cout << "  题号 " << other.id << "（" << other.knowledge << "）  " << nb[k].together << " 人同时答错（"
+                  << std::fixed << std::setprecision(0) << 100.0 * nb[k].together / misses << "%）\n"
+                  << std::defaultfloat;
+    }
+    return g_questions[nb[0].question].id;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file CoError.h
+ * @brief 共错题模块 - "答错这道题的同学也常答错哪些题"（题目-题目协同过滤）
+ *
+ * 【模块职责】
+ * 同一个误区往往让学生连带答错好几道题：把"栈的先进后出"记反的学生，出栈序列题和括号匹配题会一起错。
+ * 这种关联来自全体学生的错题本，题目文本与知识点标注里看不出来。本模块统计每对题目同时出现在
+ * 同一学生错题本中的人数（共同答错人数），为每道题保留相似度最高的 kCoErrorTopN 道"共错题"：
+ * - 相似度取余弦：共同答错人数 / sqrt(答错 i 的人数 × 答错 j 的人数)，冷门题与热门错题之间不被热门题淹没
+ * - 共同答错人数少于 kCoErrorMinSupport 的题对不保留（偶然同错）
+ * - 错题本大于 kCoErrorMaxWrongPerUser 道的用户不参与统计：几乎全错的用户不提供关联信息，
+ *   而代价与错题数的平方成正比
+ * 错题本与交互模式相同：每道题最后一次作答答错即在错题本中。
+ *
+ * 【构建】
+ * 用户的错题本按 CSR 存放，转置得到"题目 -> 答错过它的用户"。每道题一个独立的计算：
+ * 遍历答错它的用户的错题本，在线程私有的稠密计数数组上累加共同答错人数（只复位被触及的项），
+ * 再用 TopK 选出前 kCoErrorTopN 项。各题互不依赖，按块交给线程池；结果与线程数无关。
+ * 总代价 O(Σ 用户错题数²)。
+ *
+ * 【持久化】
+ * data/co_error.txt：每道有共错题的题目一行"题号,答错人数,邻居题号:共同答错人数,..."，邻居按相似度排列。
+ * 只存整数，相似度在加载时由两端的答错人数重新算出；题号不在当前题库中的项在加载时跳过。
+ *
+ * 【查询】
+ * neighborsOf(题目下标) 直接返回该题在 CSR 中的一段，O(1) 定位，遍历 O(N)（N 为邻居数）。
+ *
+ * 【与其他模块依赖】
+ * - Record.h：parseRecordLine() 逐行解析记录文件；g_records 最后一条判断刚才是否答错
+ * - TopK.h：每道题保留前 N 个邻居
+ * - App.cpp：错题本练习答错后列出共错题，并可接着练习第一道
+ * - Recommender.cpp：AI 推荐练习答错后列出共错题
+ * - main.cpp：启动时加载 data/co_error.txt
+ * - Cli.cpp：--build-co-error 构建并写出；Bench.cpp：--bench-co-error 合成数据基准
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+struct Question;
+
+/// 每道题保留的共错题数
+constexpr size_t kCoErrorTopN = 20;
+
+/// 题对至少有这么多人共同答错才保留
+constexpr uint32_t kCoErrorMinSupport = 2;
+
+/// 错题本超过该题数的用户不参与统计
+constexpr size_t kCoErrorMaxWrongPerUser = 2000;
+
+/**
+ * @struct WrongSets
+ * @brief 全体用户的错题本（CSR：第 u 个用户为 items[start[u], start[u + 1])，题目下标升序）
+ */
+struct WrongSets {
+    size_t itemCount = 0;          ///< 题目数（题目下标即 g_questions 下标）
+    std::vector<size_t> start;     ///< 行起点（长度为用户数 + 1）
+    std::vector<int32_t> items;    ///< 题目下标
+
+    /// 用户数
+    size_t users() const { return start.empty() ? 0 : start.size() - 1; }
+};
+
+/**
+ * @brief 读取一组用户记录文件，得到各用户的错题本（每个文件一个用户，读取并行）
+ *
+ * 记录按时间戳稳定排序，每道题最后一次作答答错即在错题本中；题号不在当前题库中的记录忽略。
+ *
+ * @param files 用户记录文件
+ * @param pool 执行并行任务的线程池
+ * @return 错题本（用户编号即 files 下标）
+ */
+WrongSets loadWrongSets(const std::vector<std::filesystem::path>& files, ThreadPool& pool);
+
+/**
+ * @struct CoErrorNeighbor
+ * @brief 一道共错题
+ */
+struct CoErrorNeighbor {
+    int32_t question = 0;      ///< 题目下标
+    uint32_t together = 0;     ///< 共同答错人数
+    float similarity = 0.0f;   ///< 余弦相似度
+};
+
+/**
+ * @class CoErrorTable
+ * @brief 每道题的共错题列表（CSR，按相似度降序、共同答错人数降序、题目下标升序）
+ */
+class CoErrorTable {
+public:
+    /// 题目数（0 表示未构建 / 未加载）
+    size_t itemCount() const { return misses_.size(); }
+
+    /// 参与统计的用户数
+    size_t users() const { return users_; }
+
+    /// 全部邻居项数
+    size_t entries() const { return neighbors_.size(); }
+
+    /// 答错该题的人数（下标越界为 0）
+    uint32_t misses(size_t qIdx) const { return qIdx < misses_.size() ? misses_[qIdx] : 0; }
+
+    /**
+     * @brief 某道题的共错题
+     * @param qIdx 题目下标
+     * @param count 输出：邻居数（下标越界为 0）
+     * @return 第一个邻居（count 为 0 时不可解引用）
+     * @complexity O(1)
+     */
+    const CoErrorNeighbor* neighborsOf(size_t qIdx, size_t& count) const;
+
+    /// 两个表完全相同（基准核对单线程 / 多线程结果）
+    bool operator==(const CoErrorTable& o) const;
+
+private:
+    friend CoErrorTable buildCoErrorTable(const WrongSets& sets, size_t topN, ThreadPool& pool);
+    friend bool loadCoErrorFromFile(const std::string& filename);
+
+    size_t users_ = 0;
+    std::vector<uint32_t> misses_;            ///< 题目下标 -> 答错人数
+    std::vector<size_t> start_;               ///< 题目 j 的邻居为 neighbors_[start_[j], start_[j + 1])
+    std::vector<CoErrorNeighbor> neighbors_;
+};
+
+/**
+ * @brief 全局共错题表（启动时从 data/co_error.txt 加载；文件不存在时为空）
+ */
+extern CoErrorTable g_coError;
+
+/**
+ * @brief 由错题本构建共错题表
+ * @param sets 全体用户的错题本
+ * @param topN 每道题保留的邻居数
+ * @param pool 执行并行任务的线程池
+ * @return 共错题表（与线程数无关）
+ * @complexity O(Σ 用户错题数² + M log N)，M 为共同答错的题对数
+ */
+CoErrorTable buildCoErrorTable(const WrongSets& sets, size_t topN, ThreadPool& pool);
+
+/**
+ * @brief 把共错题表写入文件（格式见文件头说明）
+ * @param filename 输出文件路径（通常为 data/co_error.txt）
+ * @param table 共错题表（题目下标与当前 g_questions 对应）
+ * @return true 写出成功；false 文件无法打开
+ */
+bool saveCoErrorToFile(const std::string& filename, const CoErrorTable& table);
+
+/**
+ * @brief 从文件加载共错题表到 g_coError（格式错误的行、题库中不存在的题号跳过）
+ * @param filename 文件路径
+ * @return true 加载成功；false 文件无法打开（g_coError 不变）
+ */
+bool loadCoErrorFromFile(const std::string& filename);
+
+/**
+ * @brief 列出答错某道题的同学也常答错的题目
+ * @param q 刚答错的题目
+ * @param limit 最多列出的题数
+ * @return 列出的第一道共错题的题号；没有共错题时不输出，返回 -1
+ */
+int printRelatedMisses(const Question& q, size_t limit);
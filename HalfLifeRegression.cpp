@@ -0,0 +1,399 @@
+/**
+ * @file HalfLifeRegression.cpp
+ * @brief 遗忘模型实现
+ *
+ * 实现要点：
+ * 1. **样本**：每个用户的记录按时间戳稳定排序后重放，按题目维护 (作答次数, 答对次数, 上次作答时间)；
+ *    同一题的第二次及以后、且与上次作答不在同一秒的作答记为一个样本
+ * 2. **梯度**：设 z = θ · x，ĥ = 2^z（截断），p̂ = 2^(-Δ / ĥ)，则
+ *    ∂(p̂ - p)² / ∂z = 2 (p̂ - p) · p̂ · (ln 2)² · Δ / ĥ，∂α(z - log2 h)² / ∂z = 2α (z - log2 h)；
+ *    x 只有 6 个非零项（常数、三个计数、难度、知识点），计数特征与观测半衰期在读取时算好，每个样本 O(1)
+ * 3. **分块**：用户按 kHlrBlockUsers 个一块，每块一个任务累加梯度与损失，块结果按编号顺序合并，结果与线程数无关
+ * 4. **Adam**：全批量梯度，学习率 kAdamRate，β1 = 0.9，β2 = 0.999，权重初值全为 0（半衰期 1 天）
+ * 5. **评分**：特征行与权重行均为 kHlrDim 个单精度数；静态项（常数 + 难度 + 知识点）按双精度相加后取单精度，
+ *    全量（kernelDotRowsF32）与逐题（kernelDotF32）使用同一份特征行，结果逐位相同
+ */
+
+#include "HalfLifeRegression.h"
+#include "Kernels.h"
+#include "Question.h"
+#include "Record.h"
+#include "Recommender.h"
+#include "RollingStats.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+HalfLifeModel g_halfLifeModel;
+
+namespace {
+
+/// 每个特征向量中的固定特征：常数、三个计数、难度 1~5（其后为各知识点）
+const size_t kFixedFeatures = 4 + kHlrDifficultyLevels;
+
+/// Adam 学习率
+const double kAdamRate = 0.05;
+
+const double kLn2 = 0.69314718055994530942;
+
+/// 难度截断到 1~5 后的下标 0~4
+int difficultySlot(int difficulty) {
+    return std::min(std::max(difficulty, 1), kHlrDifficultyLevels) - 1;
+}
+
+/**
+ * @brief 一个样本：同一题再次作答时的特征与结果（与权重无关的量在读取时算好）
+ */
+struct HlrSample {
+    double xn;             ///< √(1 + 此前作答次数)
+    double xc;             ///< √(1 + 此前答对次数)
+    double xw;             ///< √(1 + 此前答错次数)
+    double deltaDays;      ///< 距该题上次作答的天数
+    double observed;       ///< 观测回忆（截断后的是否答对）
+    double log2Observed;   ///< 观测半衰期的 log2（截断后）
+    int32_t difficulty;    ///< 难度特征的下标
+    int32_t knowledge;     ///< 知识点特征的下标（无知识点为 -1）
+};
+
+/**
+ * @brief 一个用户的样本
+ */
+struct UserSamples {
+    bool ok = false;
+    size_t records = 0;
+    std::vector<HlrSample> samples;
+};
+
+/**
+ * @brief 读取一个用户的记录并按时间重放为样本
+ */
+void readSamples(const std::filesystem::path& file, UserSamples& out) {
+    std::ifstream fin(file);
+    out.ok = fin.is_open();
+    if (!out.ok) return;
+
+    struct Row {
+        long long timestamp;
+        int32_t question;
+        bool correct;
+    };
+    std::vector<Row> rows;
+    std::string line;
+    Record r;
+    while (std::getline(fin, line)) {
+        if (line.empty() || !parseRecordLine(line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end()) continue;
+        rows.push_back({r.timestamp, (int32_t)itQ->second, r.correct});
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.timestamp < b.timestamp; });
+    out.records = rows.size();
+
+    struct History {
+        uint32_t attempts = 0;
+        uint32_t correct = 0;
+        long long last = 0;
+    };
+    const double log2Floor = std::log2(kHlrMinRecall);
+    const double log2Ceil = std::log2(1.0 - kHlrMinRecall);
+    size_t K = g_knowledgeNames.size();
+    std::unordered_map<int32_t, History> history;
+    for (const Row& row : rows) {
+        History& h = history[row.question];
+        if (h.attempts > 0 && row.timestamp > h.last) {
+            const Question& q = g_questions[row.question];
+            HlrSample s;
+            s.xn = std::sqrt(1.0 + h.attempts);
+            s.xc = std::sqrt(1.0 + h.correct);
+            s.xw = std::sqrt(1.0 + (h.attempts - h.correct));
+            s.deltaDays = (row.timestamp - h.last) / 86400.0;
+            s.observed = row.correct ? 1.0 - kHlrMinRecall : kHlrMinRecall;
+            // 观测半衰期 h = -Δ / log2 p，截断到 [kHlrMinHalfLifeDays, kHlrMaxHalfLifeDays]
+            double log2P = row.correct ? log2Ceil : log2Floor;
+            s.log2Observed = std::log2(hlrHalfLifeDays(std::log2(-s.deltaDays / log2P)));
+            s.difficulty = 4 + difficultySlot(q.difficulty);
+            s.knowledge = (q.knowledgeId >= 0 && (size_t)q.knowledgeId < K) ? (int32_t)(kFixedFeatures + q.knowledgeId) : -1;
+            out.samples.push_back(s);
+        }
+        ++h.attempts;
+        h.correct += row.correct ? 1 : 0;
+        h.last = row.timestamp;
+    }
+}
+
+/// 权重向量（常数、三个计数、难度、知识点）-> HalfLifeParams
+HalfLifeParams unpack(const std::vector<double>& theta) {
+    HalfLifeParams p;
+    p.bias = theta[0];
+    p.attempts = theta[1];
+    p.correct = theta[2];
+    p.wrong = theta[3];
+    for (int d = 0; d < kHlrDifficultyLevels; ++d) p.difficulty[d] = theta[4 + d];
+    p.knowledge.assign(theta.begin() + kFixedFeatures, theta.end());
+    return p;
+}
+
+/**
+ * @brief 一块用户的梯度与损失（grad 末项为损失之和）
+ */
+void gradientBlock(const std::vector<UserSamples>& users, size_t begin, size_t end, const std::vector<double>& theta,
+                   std::vector<double>& grad) {
+    size_t D = theta.size();
+    grad.assign(D + 1, 0.0);
+    for (size_t u = begin; u < end; ++u) {
+        for (const HlrSample& s : users[u].samples) {
+            double z = theta[0] + theta[1] * s.xn + theta[2] * s.xc + theta[3] * s.xw + theta[s.difficulty] +
+                       (s.knowledge >= 0 ? theta[s.knowledge] : 0.0);
+            double h = hlrHalfLifeDays(z);
+            double predicted = hlrRecall(s.deltaDays, h);
+
+            double residual = predicted - s.observed;
+            double gap = z - s.log2Observed;
+            double dz = 2.0 * residual * predicted * kLn2 * kLn2 * s.deltaDays / h + 2.0 * kHlrAlpha * gap;
+            grad[0] += dz;
+            grad[1] += dz * s.xn;
+            grad[2] += dz * s.xc;
+            grad[3] += dz * s.xw;
+            grad[s.difficulty] += dz;
+            if (s.knowledge >= 0) grad[s.knowledge] += dz;
+            grad[D] += residual * residual + kHlrAlpha * gap * gap;
+        }
+    }
+}
+
+} // namespace
+
+double hlrLog2HalfLife(const HalfLifeParams& p, int difficulty, int knowledgeId, double attempts, double correct) {
+    double z = p.bias + p.attempts * std::sqrt(1.0 + attempts) + p.correct * std::sqrt(1.0 + correct) +
+               p.wrong * std::sqrt(1.0 + (attempts - correct)) + p.difficulty[difficultySlot(difficulty)];
+    if (knowledgeId >= 0 && (size_t)knowledgeId < p.knowledge.size()) z += p.knowledge[knowledgeId];
+    return z;
+}
+
+double hlrHalfLifeDays(double log2HalfLife) {
+    return std::min(std::max(std::exp2(log2HalfLife), kHlrMinHalfLifeDays), kHlrMaxHalfLifeDays);
+}
+
+double hlrRecall(double deltaDays, double halfLifeDays) {
+    return std::exp2(-std::max(deltaDays, 0.0) / halfLifeDays);
+}
+
+double hlrTimeScore(double deltaDays, double halfLifeDays) {
+    return std::min(2.0 * (1.0 - hlrRecall(deltaDays, halfLifeDays)), 1.0);
+}
+
+// ============================================================
+// 拟合
+// ============================================================
+
+HalfLifeFit fitHalfLifeRegression(const std::vector<std::filesystem::path>& files, size_t iterations,
+                                  ThreadPool& pool) {
+    size_t K = g_knowledgeNames.size();
+    size_t D = kFixedFeatures + K;
+    std::vector<double> theta(D, 0.0);
+    HalfLifeFit fit;
+    fit.params = unpack(theta);
+    if (files.empty()) return fit;
+
+    // 1. 读取（每个用户一个任务）
+    std::vector<UserSamples> users(files.size());
+    pool.parallelFor(files.size(), [&](size_t u) { readSamples(files[u], users[u]); });
+    for (const UserSamples& u : users) {
+        if (!u.ok) continue;
+        ++fit.users;
+        fit.records += u.records;
+        fit.samples += u.samples.size();
+    }
+    if (fit.samples == 0) return fit;
+
+    // 2. 全批量 Adam（分块方式与线程数无关，块结果按编号顺序合并）
+    size_t blocks = (users.size() + kHlrBlockUsers - 1) / kHlrBlockUsers;
+    std::vector<std::vector<double>> partial(blocks);
+    std::vector<double> m(D, 0.0);
+    std::vector<double> v(D, 0.0);
+    const double beta1 = 0.9;
+    const double beta2 = 0.999;
+    double power1 = 1.0;
+    double power2 = 1.0;
+    for (size_t iter = 0; iter < iterations; ++iter) {
+        pool.parallelFor(blocks, [&](size_t b) {
+            gradientBlock(users, b * kHlrBlockUsers, std::min(users.size(), (b + 1) * kHlrBlockUsers), theta,
+                          partial[b]);
+        });
+        std::vector<double> grad(D + 1, 0.0);
+        for (const std::vector<double>& block : partial) {
+            for (size_t f = 0; f <= D; ++f) grad[f] += block[f];
+        }
+        double loss = grad[D] / (double)fit.samples;
+        power1 *= beta1;
+        power2 *= beta2;
+        for (size_t f = 0; f < D; ++f) {
+            double g = grad[f] / (double)fit.samples + 2.0 * kHlrLambda * theta[f];
+            loss += kHlrLambda * theta[f] * theta[f];
+            m[f] = beta1 * m[f] + (1.0 - beta1) * g;
+            v[f] = beta2 * v[f] + (1.0 - beta2) * g * g;
+            theta[f] -= kAdamRate * (m[f] / (1.0 - power1)) / (std::sqrt(v[f] / (1.0 - power2)) + 1e-8);
+        }
+        fit.iterations = iter + 1;
+        fit.loss = loss;
+    }
+    fit.params = unpack(theta);
+    return fit;
+}
+
+// ============================================================
+// 权重文件
+// ============================================================
+
+bool saveHalfLifeParams(const std::string& filename, const HalfLifeParams& params) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入遗忘模型文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz half-life regression v1\n";
+    fout << "# log2 半衰期（天）= 各特征权重之和；特征,权重\n";
+    fout << std::setprecision(9);
+    fout << "bias," << params.bias << '\n';
+    fout << "attempts," << params.attempts << '\n';
+    fout << "correct," << params.correct << '\n';
+    fout << "wrong," << params.wrong << '\n';
+    for (int d = 0; d < kHlrDifficultyLevels; ++d) fout << "difficulty" << d + 1 << ',' << params.difficulty[d] << '\n';
+    for (size_t k = 0; k < params.knowledge.size() && k < g_knowledgeNames.size(); ++k) {
+        fout << "knowledge:" << g_knowledgeNames[k] << ',' << params.knowledge[k] << '\n';
+    }
+    return (bool)fout;
+}
+
+bool loadHalfLifeParamsFromFile(const std::string& filename) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    std::unordered_map<std::string, size_t> knowledgeIndex;
+    for (size_t k = 0; k < g_knowledgeNames.size(); ++k) knowledgeIndex[g_knowledgeNames[k]] = k;
+
+    HalfLifeParams p;
+    p.knowledge.assign(g_knowledgeNames.size(), 0.0);
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(fin, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t comma = line.rfind(',');
+        if (comma == std::string::npos) continue;
+        std::string name = line.substr(0, comma);
+        double w;
+        try {
+            w = std::stod(line.substr(comma + 1));
+        } catch (...) {
+            continue;
+        }
+        if (!std::isfinite(w)) continue;
+        double* slot = nullptr;
+        if (name == "bias") {
+            slot = &p.bias;
+        } else if (name == "attempts") {
+            slot = &p.attempts;
+        } else if (name == "correct") {
+            slot = &p.correct;
+        } else if (name == "wrong") {
+            slot = &p.wrong;
+        } else if (name.size() == 11 && name.rfind("difficulty", 0) == 0 && name[10] >= '1' &&
+                   name[10] < '1' + kHlrDifficultyLevels) {
+            slot = &p.difficulty[name[10] - '1'];
+        } else if (name.rfind("knowledge:", 0) == 0) {
+            auto it = knowledgeIndex.find(name.substr(10));
+            if (it != knowledgeIndex.end()) slot = &p.knowledge[it->second];
+        }
+        if (!slot) continue;
+        *slot = w;
+        ++applied;
+    }
+
+    HalfLifeModel& model = g_halfLifeModel;
+    model.params_ = std::move(p);
+    model.weights_[0] = 1.0f;
+    model.weights_[1] = (float)model.params_.attempts;
+    model.weights_[2] = (float)model.params_.correct;
+    model.weights_[3] = (float)model.params_.wrong;
+    for (size_t f = 4; f < kHlrDim; ++f) model.weights_[f] = 0.0f;
+    model.loaded_ = true;
+    model.built_ = false;
+
+    // 已作答题目的时间间隔维度随之变化：推荐索引整体重建，缓存的推荐结果作废
+    g_recommendIndex.invalidate();
+    g_recommendCache.invalidate();
+    std::cout << "遗忘模型已加载（" << applied << " 个特征权重）。\n";
+    return true;
+}
+
+// ============================================================
+// HalfLifeModel
+// ============================================================
+
+void HalfLifeModel::featureRow(size_t qIdx, double attempts, double correct, float* row) const {
+    const Question& q = g_questions[qIdx];
+    double fixed = params_.bias + params_.difficulty[difficultySlot(q.difficulty)];
+    if (q.knowledgeId >= 0 && (size_t)q.knowledgeId < params_.knowledge.size()) fixed += params_.knowledge[q.knowledgeId];
+    row[0] = (float)fixed;
+    row[1] = (float)std::sqrt(1.0 + attempts);
+    row[2] = (float)std::sqrt(1.0 + correct);
+    row[3] = (float)std::sqrt(1.0 + (attempts - correct));
+    for (size_t f = 4; f < kHlrDim; ++f) row[f] = 0.0f;
+}
+
+float HalfLifeModel::halfLifeDays(size_t qIdx) const {
+    if (qIdx >= g_questionStats.size()) return halfLifeDays(qIdx, 0, 0);
+    return halfLifeDays(qIdx, g_questionStats.totalAttempts[qIdx], g_questionStats.correctAttempts[qIdx]);
+}
+
+float HalfLifeModel::halfLifeDays(size_t qIdx, int attempts, int correct) const {
+    if (!loaded_ || qIdx >= g_questions.size()) return 0.0f;
+    float row[kHlrDim];
+    featureRow(qIdx, attempts, correct, row);
+    return (float)hlrHalfLifeDays(kernelDotF32(row, weights_, kHlrDim));
+}
+
+const std::vector<float>& HalfLifeModel::halfLives() {
+    size_t n = g_questions.size();
+    if (!loaded_) {
+        halfLives_.clear();
+        return halfLives_;
+    }
+    if (built_ && epoch_ == g_questionStats.epoch && version_ == g_questionStats.version && halfLives_.size() == n) {
+        return halfLives_;
+    }
+    features_.resize(n * kHlrDim);
+    for (size_t i = 0; i < n; ++i) {
+        bool counted = i < g_questionStats.size();
+        featureRow(i, counted ? g_questionStats.totalAttempts[i] : 0, counted ? g_questionStats.correctAttempts[i] : 0,
+                   features_.data() + i * kHlrDim);
+    }
+    halfLives_.resize(n);
+    kernelDotRowsF32(features_.data(), n, kHlrDim, weights_, halfLives_.data());
+    for (size_t i = 0; i < n; ++i) halfLives_[i] = (float)hlrHalfLifeDays(halfLives_[i]);
+    epoch_ = g_questionStats.epoch;
+    version_ = g_questionStats.version;
+    built_ = true;
+    return halfLives_;
+}
+
+double HalfLifeModel::recall(size_t qIdx, long long now) const {
+    if (!loaded_ || qIdx >= g_questionStats.size() || g_questionStats.lastTimestamp[qIdx] <= 0) return -1.0;
+    return hlrRecall((now - g_questionStats.lastTimestamp[qIdx]) / 86400.0, halfLifeDays(qIdx));
+}
+
+long long HalfLifeModel::dueTimestamp(size_t qIdx) const {
+    if (!loaded_ || qIdx >= g_questionStats.size() || g_questionStats.lastTimestamp[qIdx] <= 0) return 0;
+    return g_questionStats.lastTimestamp[qIdx] + std::llround(halfLifeDays(qIdx) * 86400.0);
+}
+
+long long HalfLifeModel::settleDay(size_t qIdx) const {
+    long long due = dueTimestamp(qIdx);
+    return due > 0 ? dayIndexOf(due) + 2 : LLONG_MIN;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file HalfLifeRegression.h
+ * @brief 遗忘模型 - 半衰期回归（HLR）预测每道题的回忆概率
+ *
+ * 【模块职责】
+ * 推荐评分的时间间隔维度是 min(距上次作答天数 / 7, 1)：不论题目难易、答对过几次，
+ * 都在 7 天后"遗忘"满分。半衰期回归为每个 (用户, 题目) 估计记忆半衰期 h（天）：
+ *   log2 h = θ · x，    P(回忆) = 2^(-Δ / h)
+ * Δ 为距上次作答的天数；特征 x 为：
+ * - 常数项、√(1 + 作答次数)、√(1 + 答对次数)、√(1 + 答错次数)
+ * - 难度（1~5 各一个指示特征）、知识点（每个知识点一个指示特征）
+ * 答对越多半衰期越长、答错越多越短，难题与难知识点忘得更快，权重 θ 从全部用户的记录学习。
+ *
+ * 【训练】
+ * 每个用户的记录按时间排序后重放：同一题的第二次及以后的作答是一个样本，
+ * 特征取这次作答之前的计数，Δ 为距该题上次作答的天数，观测回忆 p 为是否答对（截断到 [kHlrMinRecall, 1 - kHlrMinRecall]），
+ * 观测半衰期 h = -Δ / log2 p（截断到 [kHlrMinHalfLifeDays, kHlrMaxHalfLifeDays]）。损失为
+ *   (p̂ - p)² + kHlrAlpha × (log2 ĥ - log2 h)²   的样本平均，加 kHlrLambda × ‖θ‖²
+ * 以全批量 Adam 最小化。用户按编号每 kHlrBlockUsers 个分为一块，每块一个任务累加梯度，
+ * 块结果按编号顺序合并：拟合结果与线程数无关。
+ *
+ * 【评分】
+ * 难度与知识点的权重只与题目有关，加载时已定；当前用户每道题的特征整理为 kHlrDim 个单精度数
+ *   [静态项, √(1 + n), √(1 + c), √(1 + w), 0, 0, 0, 0]
+ * 与权重行 [1, θ_n, θ_c, θ_w, 0, 0, 0, 0] 做一次点积即得 log2 h：全量评分用 kernelDotRowsF32 一次算出全部题目，
+ * 推荐索引的活跃题目逐题用 kernelDotF32，两者逐位相同。
+ * 时间间隔维度改为 min(2 × (1 - P(回忆)), 1)：刚作答为 0，回忆概率降到一半（Δ = h，即预计到期时刻）时满分。
+ * Δ 超过半衰期后该项封顶为 1，不再随时间变化：推荐索引按每道题的预计到期日（settleDay）决定何时停止重新评分，
+ * 而不是对全部题目按半衰期上限延长活跃窗口。
+ *
+ * 【与其他模块依赖】
+ * - Record.h：parseRecordLine() 逐行解析记录文件
+ * - Kernels.h：单精度点积 / 多行点积（各指令集逐位相同）
+ * - Stats.h：当前用户的统计表（作答次数、答对次数、最近作答时间）与 epoch / version
+ * - Recommender.cpp：交互式推荐中已作答题目的时间间隔维度改用回忆概率；AI 推荐展示回忆概率与预计到期时间
+ * - main.cpp：启动时加载 data/half_life.txt
+ * - Cli.cpp：--fit-hlr 拟合并写出；Bench.cpp：--bench-hlr 合成数据基准
+ */
+
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/// 难度等级数（特征中每个等级一个指示特征）
+constexpr int kHlrDifficultyLevels = 5;
+
+/// 评分时每道题的特征行长度（单精度数，一条 AVX2 向量）
+constexpr size_t kHlrDim = 8;
+
+/// 半衰期下限（天）：15 分钟
+constexpr double kHlrMinHalfLifeDays = 15.0 / 1440.0;
+
+/// 半衰期上限（天）
+constexpr double kHlrMaxHalfLifeDays = 274.0;
+
+/// 观测回忆的截断下限（上限为 1 - kHlrMinRecall），避免 log2 p 为无穷
+constexpr double kHlrMinRecall = 1e-4;
+
+/// 半衰期误差项的权重
+constexpr double kHlrAlpha = 0.01;
+
+/// L2 正则系数
+constexpr double kHlrLambda = 1e-4;
+
+/// 默认迭代轮数（每轮一次全批量梯度）
+constexpr size_t kHlrIterations = 300;
+
+/// 并行梯度每个任务处理的用户数
+constexpr size_t kHlrBlockUsers = 64;
+
+/**
+ * @struct HalfLifeParams
+ * @brief 半衰期回归的权重 θ（log2 半衰期 = θ · x）
+ */
+struct HalfLifeParams {
+    double bias = 0.0;                            ///< 常数项
+    double attempts = 0.0;                        ///< √(1 + 作答次数) 的权重
+    double correct = 0.0;                         ///< √(1 + 答对次数) 的权重
+    double wrong = 0.0;                           ///< √(1 + 答错次数) 的权重
+    double difficulty[kHlrDifficultyLevels] = {}; ///< 难度 1~5 的权重
+    std::vector<double> knowledge;                ///< 知识点 -> 权重（按 g_knowledgeNames 下标；缺失为 0）
+};
+
+/**
+ * @brief log2 半衰期（未截断）
+ * @param p 权重
+ * @param difficulty 题目难度（越界时截断到 1~5）
+ * @param knowledgeId 知识点 ID（-1 或越界时无知识点特征）
+ * @param attempts 此前作答次数
+ * @param correct 此前答对次数
+ * @complexity O(1)
+ */
+double hlrLog2HalfLife(const HalfLifeParams& p, int difficulty, int knowledgeId, double attempts, double correct);
+
+/**
+ * @brief 由 log2 半衰期得到半衰期（天），截断到 [kHlrMinHalfLifeDays, kHlrMaxHalfLifeDays]
+ */
+double hlrHalfLifeDays(double log2HalfLife);
+
+/**
+ * @brief 回忆概率 2^(-Δ / h)
+ * @param deltaDays 距上次作答的天数（负数按 0 处理）
+ * @param halfLifeDays 半衰期（天）
+ */
+double hlrRecall(double deltaDays, double halfLifeDays);
+
+/**
+ * @brief 推荐评分的时间间隔维度：min(2 × (1 - 回忆概率), 1)
+ *
+ * 刚作答为 0，回忆概率降到一半（Δ >= h）后为 1，与原来"间隔达到时间基准即满分"的含义对应。
+ *
+ * @param deltaDays 距上次作答的天数（负数按 0 处理）
+ * @param halfLifeDays 半衰期（天）
+ */
+double hlrTimeScore(double deltaDays, double halfLifeDays);
+
+/**
+ * @struct HalfLifeFit
+ * @brief 拟合结果
+ */
+struct HalfLifeFit {
+    HalfLifeParams params;     ///< 权重（knowledge 按 g_knowledgeNames 下标）
+    size_t users = 0;          ///< 成功读取的用户数
+    size_t records = 0;        ///< 读取的记录数
+    size_t samples = 0;        ///< 样本数（同一题的第二次及以后的作答）
+    size_t iterations = 0;     ///< 迭代轮数
+    double loss = 0.0;         ///< 最后一轮的平均损失（含正则）
+};
+
+/**
+ * @brief 以全批量 Adam 从一组用户的记录拟合半衰期回归
+ * @param files 用户记录文件（每个文件一个用户）
+ * @param iterations 迭代轮数
+ * @param pool 执行并行任务的线程池
+ * @return 拟合结果（与线程数无关）
+ * @complexity 读取 O(A log A)；每轮 O(S + 特征数 × 块数)，A 为记录总数，S 为样本数
+ */
+HalfLifeFit fitHalfLifeRegression(const std::vector<std::filesystem::path>& files, size_t iterations,
+                                  ThreadPool& pool);
+
+/**
+ * @brief 把权重写入文件（每行"特征,权重"，知识点特征为"knowledge:<知识点名>"）
+ * @param filename 输出文件路径（通常为 data/half_life.txt）
+ * @param params 权重（knowledge 按 g_knowledgeNames 下标）
+ * @return true 写出成功；false 文件无法打开
+ */
+bool saveHalfLifeParams(const std::string& filename, const HalfLifeParams& params);
+
+/**
+ * @class HalfLifeModel
+ * @brief 已加载的权重与当前用户每道题的半衰期
+ */
+class HalfLifeModel {
+public:
+    /// 是否已加载模型
+    bool loaded() const { return loaded_; }
+
+    /// 已加载的权重
+    const HalfLifeParams& params() const { return params_; }
+
+    /**
+     * @brief 当前用户第 qIdx 题的半衰期（天），逐题点积（kernelDotF32）
+     * @return 未加载模型或下标越界时为 0
+     * @complexity O(kHlrDim)
+     */
+    float halfLifeDays(size_t qIdx) const;
+
+    /**
+     * @brief 任意一个用户第 qIdx 题的半衰期（天）：作答次数与答对次数由调用方给出，不读当前用户的统计
+     *
+     * 批量推荐以各用户自己的统计调用；与该用户登录后的 halfLifeDays(qIdx) / halfLives() 逐位相同。
+     *
+     * @return 未加载模型或下标越界时为 0
+     * @complexity O(kHlrDim)
+     */
+    float halfLifeDays(size_t qIdx, int attempts, int correct) const;
+
+    /**
+     * @brief 当前用户全部题目的半衰期（下标为题目下标）
+     *
+     * 统计表 epoch / version 或题库大小变化时整理特征行，以 kernelDotRowsF32 一次算出，O(N × kHlrDim)；
+     * 其余时候直接返回缓存。结果与逐题的 halfLifeDays() 逐位相同。未加载模型时返回空数组。
+     */
+    const std::vector<float>& halfLives();
+
+    /**
+     * @brief 当前用户此刻对第 qIdx 题的回忆概率
+     * @return [0, 1]；未加载模型或从未作答时为 -1
+     */
+    double recall(size_t qIdx, long long now) const;
+
+    /**
+     * @brief 预计到期时刻：回忆概率降到一半（最近作答 + 半衰期）
+     * @return 时间戳（秒）；未加载模型或从未作答时为 0
+     */
+    long long dueTimestamp(size_t qIdx) const;
+
+    /**
+     * @brief 第 qIdx 题的时间间隔维度封顶的日序号：预计到期日 + 2
+     *
+     * 从这一天起 Δ 至少比半衰期多一整天，回忆概率明确低于一半，hlrTimeScore() 恒为 1，不受舍入影响。
+     * 半衰期只随该题的作答次数变化，作答后需重新取。
+     *
+     * @return 日序号（dayIndexOf）；未加载模型或从未作答时为 LLONG_MIN
+     * @complexity O(kHlrDim)
+     */
+    long long settleDay(size_t qIdx) const;
+
+private:
+    friend bool loadHalfLifeParamsFromFile(const std::string& filename);
+
+    void featureRow(size_t qIdx, double attempts, double correct, float* row) const;
+
+    bool loaded_ = false;
+    HalfLifeParams params_;
+    float weights_[kHlrDim] = {};              ///< [1, θ_n, θ_c, θ_w, 0, 0, 0, 0]
+    bool built_ = false;
+    uint64_t epoch_ = 0;                       ///< 计算时 g_questionStats.epoch
+    uint64_t version_ = 0;                     ///< 计算时 g_questionStats.version
+    std::vector<float> features_;              ///< 题目数 × kHlrDim
+    std::vector<float> halfLives_;             ///< 题目下标 -> 半衰期（天）
+};
+
+/**
+ * @brief 全局遗忘模型（启动时从 data/half_life.txt 加载；文件不存在时未加载）
+ */
+extern HalfLifeModel g_halfLifeModel;
+
+/**
+ * @brief 从文件加载权重到 g_halfLifeModel（格式见 saveHalfLifeParams；格式错误的行、不存在的知识点跳过）
+ *
+ * 加载后推荐索引整体重建、缓存的推荐结果作废。
+ *
+ * @param filename 文件路径
+ * @return true 加载成功；false 文件无法打开（g_halfLifeModel 不变）
+ */
+bool loadHalfLifeParamsFromFile(const std::string& filename);
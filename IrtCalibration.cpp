@@ -0,0 +1,388 @@
+/**
+ * @file IrtCalibration.cpp
+ * @brief 难度校准模块实现
+ *
+ * 实现要点：
+ * 1. **读取**：每个用户一个任务，逐行 parseRecordLine() 换算为题目下标，按 (题目下标, 是否答对) 排序后
+ *    合并同题作答；各用户的行按编号顺序拼接为 CSR，再以计数排序转置为 CSC
+ * 2. **参数形式**：拟合时题目以斜率-截距形式 x = a θ + c 保存（c = -a b），结束时换回 b = -c / a。
+ *    固定 θ 时每道题是一个逻辑回归，对 (c, a) 联合凹；以 (b, a) 为变量的 Fisher 步在低区分度、
+ *    极端难度的题目上会在两点间来回跳而不收敛
+ * 3. **能力步**：θ ← θ + g / h，g = Σ a (k - n p) - θ，h = Σ n a² p(1-p) + 1（先验 N(0, 1) 贡献 -θ 与 +1）
+ * 4. **题目步**：残差 e = k - n p，权重 w = n p(1-p)，梯度 g_c = Σ e - c / σc²，g_a = Σ θ e - (a - 1) / σa²，
+ *    Hessian 的负值 H_cc = Σ w + 1 / σc²，H_aa = Σ θ² w + 1 / σa²，H_ca = Σ θ w，解 2×2 方程得到 (Δc, Δa)
+ *    （1PL 只解 Δc）。各步截断到 ±kIrtMaxStep；a 截断到 [0.2, 4]，c 截断到 ±kIrtMaxAbs × a（即 |b| ≤ kIrtMaxAbs）。
+ *    初值 θ = 0、a = 1、c 为平滑后答对与答错次数之比的对数，减少迭代轮数
+ * 5. **分块**：用户与题目各按 kIrtBlock 个一块，每块一个任务，块内最大改变量与对数似然
+ *    按块编号合并，结果与线程数无关
+ */
+
+#include "IrtCalibration.h"
+#include "Question.h"
+#include "Record.h"
+#include "Recommender.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+/// 每个并行任务处理的用户数 / 题目数
+const size_t kIrtBlock = 256;
+
+/// 截距先验 N(0, 2²) 的精度
+const double kInterceptPriorPrecision = 0.25;
+
+/// 区分度先验 N(1, 0.5²) 的精度
+const double kDiscriminationPriorPrecision = 4.0;
+
+/// 区分度的取值范围
+const double kMinDiscrimination = 0.2;
+const double kMaxDiscrimination = 4.0;
+
+double clampTo(double v, double lo, double hi) {
+    return std::min(hi, std::max(lo, v));
+}
+
+double sigmoid(double x) {
+    return 1.0 / (1.0 + std::exp(-x));
+}
+
+/// log σ(x)，x 很小时不下溢
+double logSigmoid(double x) {
+    return x >= 0.0 ? -std::log1p(std::exp(-x)) : x - std::log1p(std::exp(x));
+}
+
+/**
+ * @brief 一个用户合并后的作答（按题目下标升序）
+ */
+struct UserRow {
+    std::vector<int32_t> items;
+    std::vector<uint32_t> attempts;
+    std::vector<uint32_t> correct;
+};
+
+void readUserRow(const std::filesystem::path& file, UserRow& out) {
+    std::ifstream fin(file);
+    if (!fin.is_open()) return;
+
+    std::vector<uint32_t> codes;   // 题目下标 × 2 + 是否答对
+    std::string line;
+    Record r;
+    while (std::getline(fin, line)) {
+        if (line.empty() || !parseRecordLine(line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end() || itQ->second >= g_questions.size()) continue;
+        codes.push_back((uint32_t)itQ->second * 2 + (r.correct ? 1 : 0));
+    }
+    std::sort(codes.begin(), codes.end());
+    for (uint32_t code : codes) {
+        int32_t item = (int32_t)(code >> 1);
+        if (out.items.empty() || out.items.back() != item) {
+            out.items.push_back(item);
+            out.attempts.push_back(0);
+            out.correct.push_back(0);
+        }
+        ++out.attempts.back();
+        out.correct.back() += code & 1;
+    }
+}
+
+/**
+ * @brief 拟合过程中的参数（题目以斜率-截距形式保存：x = a θ + c，即 c = -a b）
+ */
+struct IrtState {
+    std::vector<double> ability;     ///< 用户 -> θ
+    std::vector<double> intercept;   ///< 题目 -> c
+    std::vector<double> slope;       ///< 题目 -> a
+};
+
+/// 块 [begin, end) 内各用户的能力步，返回最大改变量
+double abilityStep(const IrtResponses& data, const IrtState& st, std::vector<double>& ability, size_t begin,
+                   size_t end) {
+    double maxDelta = 0.0;
+    for (size_t u = begin; u < end; ++u) {
+        double theta = st.ability[u];
+        double g = -theta;
+        double h = 1.0;
+        for (size_t e = data.userStart[u]; e < data.userStart[u + 1]; ++e) {
+            int32_t j = data.userItem[e];
+            double a = st.slope[j];
+            double n = data.userAttempts[e];
+            double p = sigmoid(a * theta + st.intercept[j]);
+            g += a * (data.userCorrect[e] - n * p);
+            h += n * a * a * p * (1.0 - p);
+        }
+        double delta = clampTo(g / h, -kIrtMaxStep, kIrtMaxStep);
+        double next = clampTo(theta + delta, -kIrtMaxAbs, kIrtMaxAbs);
+        maxDelta = std::max(maxDelta, std::fabs(next - theta));
+        ability[u] = next;
+    }
+    return maxDelta;
+}
+
+/// 块 [begin, end) 内各题目的 (c, a) 步，返回最大改变量
+double itemStep(const IrtResponses& data, const IrtState& st, bool twoPL, std::vector<double>& intercept,
+                std::vector<double>& slope, size_t begin, size_t end) {
+    double maxDelta = 0.0;
+    for (size_t j = begin; j < end; ++j) {
+        double c = st.intercept[j];
+        double a = st.slope[j];
+        double gc = -kInterceptPriorPrecision * c;
+        double ga = -kDiscriminationPriorPrecision * (a - 1.0);
+        double icc = kInterceptPriorPrecision;
+        double iaa = kDiscriminationPriorPrecision;
+        double ica = 0.0;
+        for (size_t e = data.itemStart[j]; e < data.itemStart[j + 1]; ++e) {
+            double theta = st.ability[data.itemUser[e]];
+            double n = data.itemAttempts[e];
+            double p = sigmoid(a * theta + c);
+            double resid = data.itemCorrect[e] - n * p;
+            double w = n * p * (1.0 - p);
+            gc += resid;
+            ga += theta * resid;
+            icc += w;
+            iaa += theta * theta * w;
+            ica += theta * w;
+        }
+        double dc;
+        double da = 0.0;
+        if (twoPL) {
+            double det = icc * iaa - ica * ica;
+            dc = (iaa * gc - ica * ga) / det;
+            da = (icc * ga - ica * gc) / det;
+        } else {
+            dc = gc / icc;
+        }
+        double nextA = twoPL ? clampTo(a + clampTo(da, -kIrtMaxStep, kIrtMaxStep), kMinDiscrimination,
+                                       kMaxDiscrimination)
+                             : 1.0;
+        double nextC = clampTo(c + clampTo(dc, -kIrtMaxStep, kIrtMaxStep), -kIrtMaxAbs * nextA, kIrtMaxAbs * nextA);
+        maxDelta = std::max(maxDelta, std::max(std::fabs(nextC - c), std::fabs(nextA - a)));
+        intercept[j] = nextC;
+        slope[j] = nextA;
+    }
+    return maxDelta;
+}
+
+} // namespace
+
+bool parseIrtModel(const std::string& name, IrtModel& model) {
+    if (name == "1pl") {
+        model = IrtModel::OnePL;
+        return true;
+    }
+    if (name == "2pl") {
+        model = IrtModel::TwoPL;
+        return true;
+    }
+    return false;
+}
+
+const char* irtModelName(IrtModel model) {
+    return model == IrtModel::OnePL ? "1pl" : "2pl";
+}
+
+void IrtResponses::buildItemIndex() {
+    size_t nnz = userItem.size();
+    itemStart.assign(itemCount + 1, 0);
+    for (int32_t j : userItem) ++itemStart[j + 1];
+    for (size_t j = 0; j < itemCount; ++j) itemStart[j + 1] += itemStart[j];
+
+    itemUser.resize(nnz);
+    itemAttempts.resize(nnz);
+    itemCorrect.resize(nnz);
+    std::vector<size_t> next(itemStart.begin(), itemStart.end() - 1);
+    for (size_t u = 0; u < users(); ++u) {
+        for (size_t e = userStart[u]; e < userStart[u + 1]; ++e) {
+            size_t at = next[userItem[e]]++;
+            itemUser[at] = (int32_t)u;
+            itemAttempts[at] = userAttempts[e];
+            itemCorrect[at] = userCorrect[e];
+        }
+    }
+}
+
+IrtResponses loadIrtResponses(const std::vector<std::filesystem::path>& files, ThreadPool& pool) {
+    std::vector<UserRow> rows(files.size());
+    pool.parallelFor(files.size(), [&](size_t u) { readUserRow(files[u], rows[u]); });
+
+    IrtResponses data;
+    data.itemCount = g_questions.size();
+    data.userStart.assign(files.size() + 1, 0);
+    for (size_t u = 0; u < rows.size(); ++u) data.userStart[u + 1] = data.userStart[u] + rows[u].items.size();
+    size_t nnz = data.userStart.back();
+    data.userItem.reserve(nnz);
+    data.userAttempts.reserve(nnz);
+    data.userCorrect.reserve(nnz);
+    for (UserRow& row : rows) {
+        data.userItem.insert(data.userItem.end(), row.items.begin(), row.items.end());
+        data.userAttempts.insert(data.userAttempts.end(), row.attempts.begin(), row.attempts.end());
+        data.userCorrect.insert(data.userCorrect.end(), row.correct.begin(), row.correct.end());
+        row = UserRow();   // 及早释放
+    }
+    data.buildItemIndex();
+    return data;
+}
+
+IrtFit fitIrt(const IrtResponses& data, IrtModel model, size_t maxIterations, ThreadPool& pool) {
+    size_t users = data.users();
+    size_t items = data.itemCount;
+    bool twoPL = model == IrtModel::TwoPL;
+    IrtFit fit;
+    fit.model = model;
+    fit.responses.assign(items, 0);
+
+    // 初值：θ = 0，a = 1，c = log((答对 + 0.5) / (答错 + 0.5))
+    IrtState st;
+    st.ability.assign(users, 0.0);
+    st.intercept.assign(items, 0.0);
+    st.slope.assign(items, 1.0);
+    for (size_t j = 0; j < items; ++j) {
+        uint64_t n = 0;
+        uint64_t k = 0;
+        for (size_t e = data.itemStart[j]; e < data.itemStart[j + 1]; ++e) {
+            n += data.itemAttempts[e];
+            k += data.itemCorrect[e];
+        }
+        fit.responses[j] = (uint32_t)std::min<uint64_t>(n, UINT32_MAX);
+        if (n > 0) st.intercept[j] = clampTo(std::log((k + 0.5) / (n - k + 0.5)), -kIrtMaxAbs, kIrtMaxAbs);
+    }
+
+    size_t userBlocks = (users + kIrtBlock - 1) / kIrtBlock;
+    size_t itemBlocks = (items + kIrtBlock - 1) / kIrtBlock;
+    std::vector<double> blockDelta(std::max(userBlocks, itemBlocks));
+    std::vector<double> ability(users);
+    std::vector<double> intercept(items);
+    std::vector<double> slope(items);
+
+    for (size_t iter = 0; iter < maxIterations; ++iter) {
+        // 能力步：只读上一轮的题目参数
+        pool.parallelFor(userBlocks, [&](size_t b) {
+            blockDelta[b] = abilityStep(data, st, ability, b * kIrtBlock, std::min(users, (b + 1) * kIrtBlock));
+        });
+        double maxDelta = 0.0;
+        for (size_t b = 0; b < userBlocks; ++b) maxDelta = std::max(maxDelta, blockDelta[b]);
+        st.ability.swap(ability);
+
+        // 题目步：只读刚更新的能力
+        pool.parallelFor(itemBlocks, [&](size_t b) {
+            blockDelta[b] = itemStep(data, st, twoPL, intercept, slope, b * kIrtBlock,
+                                     std::min(items, (b + 1) * kIrtBlock));
+        });
+        for (size_t b = 0; b < itemBlocks; ++b) maxDelta = std::max(maxDelta, blockDelta[b]);
+        st.intercept.swap(intercept);
+        st.slope.swap(slope);
+
+        fit.iterations = iter + 1;
+        if (maxDelta < kIrtTolerance) {
+            fit.converged = true;
+            break;
+        }
+    }
+
+    // 对数似然：按用户块求和后按块编号合并
+    std::vector<double> blockLogLik(userBlocks, 0.0);
+    pool.parallelFor(userBlocks, [&](size_t b) {
+        double sum = 0.0;
+        for (size_t u = b * kIrtBlock; u < std::min(users, (b + 1) * kIrtBlock); ++u) {
+            for (size_t e = data.userStart[u]; e < data.userStart[u + 1]; ++e) {
+                int32_t j = data.userItem[e];
+                double x = st.slope[j] * st.ability[u] + st.intercept[j];
+                double k = data.userCorrect[e];
+                sum += k * logSigmoid(x) + (data.userAttempts[e] - k) * logSigmoid(-x);
+            }
+        }
+        blockLogLik[b] = sum;
+    });
+    for (double v : blockLogLik) fit.logLikelihood += v;
+
+    // 换回 (b, a)
+    fit.ability.swap(st.ability);
+    fit.discrimination.swap(st.slope);
+    fit.difficulty.resize(items);
+    for (size_t j = 0; j < items; ++j) fit.difficulty[j] = -st.intercept[j] / fit.discrimination[j];
+    return fit;
+}
+
+int difficultyLevelOf(double b) {
+    if (b < -1.5) return 1;
+    if (b < -0.5) return 2;
+    if (b < 0.5) return 3;
+    if (b < 1.5) return 4;
+    return 5;
+}
+
+bool saveIrtCalibration(const std::string& filename, const IrtFit& fit) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入校准文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz question calibration v1\n";
+    fout << "# model=" << irtModelName(fit.model) << "\n";
+    fout << "# 题号,难度b,区分度a,作答次数\n";
+    fout << std::setprecision(6);
+    for (size_t j = 0; j < fit.responses.size() && j < g_questions.size(); ++j) {
+        if (fit.responses[j] == 0) continue;
+        fout << g_questions[j].id << ',' << fit.difficulty[j] << ',' << fit.discrimination[j] << ','
+             << fit.responses[j] << '\n';
+    }
+    return (bool)fout;
+}
+
+bool loadIrtCalibrationFromFile(const std::string& filename) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    // 先恢复标注难度，重复加载时不残留上一次的校准
+    for (Question& q : g_questions) {
+        if (!q.calibrated) continue;
+        q.difficulty = q.labeledDifficulty;
+        q.calibrated = false;
+        q.irtDifficulty = 0.0;
+        q.irtDiscrimination = 1.0;
+    }
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(fin, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::string field[4];
+        bool ok = true;
+        for (int i = 0; ok && i < 4; ++i) ok = (bool)std::getline(ss, field[i], ',');
+        if (!ok) continue;
+        int id;
+        double b;
+        double a;
+        unsigned long long responses;
+        try {
+            id = std::stoi(field[0]);
+            b = std::stod(field[1]);
+            a = std::stod(field[2]);
+            responses = std::stoull(field[3]);
+        } catch (...) {
+            continue;
+        }
+        if (!std::isfinite(b) || !std::isfinite(a) || a <= 0.0 || responses < kIrtMinResponses) continue;
+        auto itQ = g_questionById.find(id);
+        if (itQ == g_questionById.end() || itQ->second >= g_questions.size()) continue;
+        Question& q = g_questions[itQ->second];
+        q.calibrated = true;
+        q.irtDifficulty = b;
+        q.irtDiscrimination = a;
+        q.difficulty = difficultyLevelOf(b);
+        ++applied;
+    }
+
+    // 难度已变化：推荐索引整体重建，缓存的推荐结果作废
+    g_recommendIndex.invalidate();
+    g_recommendCache.invalidate();
+    std::cout << "题目难度校准已加载，" << applied << " 道题使用校准难度。\n";
+    return true;
+}
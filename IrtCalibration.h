@@ -0,0 +1,171 @@
+/**
+ * @file IrtCalibration.h
+ * @brief 难度校准模块 - 以项目反应理论（IRT）从全体用户的作答估计题目难度与区分度
+ *
+ * 【模块职责】
+ * Question::difficulty 是出题时手工标注的 1~5 级，常与实际通过率不符：标"5"的题人人都对，
+ * 标"2"的题却错一大片。本模块用全部用户的记录拟合 IRT 模型：
+ * - 2PL：P(用户 i 答对题目 j) = σ(a_j (θ_i - b_j))，θ 为用户能力，b 为题目难度，a 为区分度
+ * - 1PL（Rasch）：a_j 固定为 1
+ * 能力先验 θ ~ N(0, 1)，因此 b 与 θ 同一尺度：b = 0 表示中等能力的用户有一半把握。
+ * 校准结果写入旁路文件 data/question_calibration.csv；启动时加载，作答数足够的题目
+ * 按 difficultyLevelOf(b) 换算为 1~5 级覆盖 Question::difficulty，
+ * computeRecommendScore 与各评分内核的难度维度随之使用校准后的难度，题库文件本身不改动。
+ *
+ * 【稀疏矩阵】
+ * 用户 × 题目矩阵极其稀疏（10 万 × 10 万，每人通常只做过几百道）。同一用户对同一题的多次作答
+ * 合并为一项 (作答次数, 答对次数)，按用户存为 CSR；再以计数排序转置为按题目的 CSC。
+ *
+ * 【拟合】
+ * 带高斯先验的联合最大后验估计，交替进行：
+ * - 固定题目参数，每个用户的 θ 做一步 Newton（只读该用户的 CSR 行）
+ * - 固定 θ，每道题做一步 Newton（只读该题的 CSC 列）。题目参数在拟合时取斜率-截距形式 a θ + c，
+ *   这样每道题就是一个对 (c, a) 联合凹的逻辑回归，不会像直接更新 (b, a) 那样在低区分度的题目上振荡
+ * 每一步内各用户 / 各题目互不依赖，按块交给线程池；每个值只由一个任务写入、只读取上半步的结果，
+ * 因此结果与线程数无关。单步改变量截断到 kIrtMaxStep，全部参数的最大改变量小于 kIrtTolerance 时收敛。
+ * 每轮 O(nnz)，nnz 为非零项数；10 万用户 × 10 万题、每人 100 次作答（约 1000 万项）约 20 轮收敛，单线程约 10 秒。
+ *
+ * 【与其他模块依赖】
+ * - Question.h：按题号换算题目下标；加载校准结果时写回 Question::difficulty 与 IRT 参数
+ * - Record.h：parseRecordLine() 逐行解析记录文件
+ * - main.cpp / Cli.cpp：启动时加载校准文件；--calibrate-irt 拟合并写出；Bench.cpp：--bench-irt 合成数据基准
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/// 作答数不少于该值的题目才用校准结果覆盖难度等级
+constexpr uint32_t kIrtMinResponses = 20;
+
+/// 单步参数改变量的上限
+constexpr double kIrtMaxStep = 1.0;
+
+/// 收敛阈值：一轮中全部参数的最大改变量
+constexpr double kIrtTolerance = 1e-3;
+
+/// 能力与难度的取值范围 [-kIrtMaxAbs, kIrtMaxAbs]
+constexpr double kIrtMaxAbs = 6.0;
+
+/**
+ * @brief IRT 模型
+ */
+enum class IrtModel {
+    OnePL,   ///< 只估计难度（区分度固定为 1）
+    TwoPL,   ///< 估计难度与区分度
+};
+
+/**
+ * @brief 按名称选择模型
+ * @param name "1pl" 或 "2pl"
+ * @param model 输出
+ * @return true 名称有效
+ */
+bool parseIrtModel(const std::string& name, IrtModel& model);
+
+/// 模型名称（"1pl" / "2pl"）
+const char* irtModelName(IrtModel model);
+
+/**
+ * @struct IrtResponses
+ * @brief 稀疏作答矩阵（按用户 CSR + 按题目 CSC）
+ */
+struct IrtResponses {
+    size_t itemCount = 0;                 ///< 题目数（列数，题目下标即 g_questions 下标）
+
+    // ---- 按用户（CSR）：第 u 行为 [userStart[u], userStart[u + 1]) ----
+    std::vector<size_t> userStart;        ///< 行起点（长度为用户数 + 1）
+    std::vector<int32_t> userItem;        ///< 题目下标（行内升序）
+    std::vector<uint32_t> userAttempts;   ///< 作答次数
+    std::vector<uint32_t> userCorrect;    ///< 答对次数
+
+    // ---- 按题目（CSC）：第 j 列为 [itemStart[j], itemStart[j + 1]) ----
+    std::vector<size_t> itemStart;        ///< 列起点（长度为题目数 + 1）
+    std::vector<int32_t> itemUser;        ///< 用户编号（列内升序）
+    std::vector<uint32_t> itemAttempts;   ///< 作答次数
+    std::vector<uint32_t> itemCorrect;    ///< 答对次数
+
+    /// 用户数
+    size_t users() const { return userStart.empty() ? 0 : userStart.size() - 1; }
+
+    /// 非零项数（用户-题目对）
+    size_t entries() const { return userItem.size(); }
+
+    /**
+     * @brief 由 CSR 生成 CSC（计数排序，列内按用户编号升序）
+     * @complexity O(nnz + 题目数)
+     */
+    void buildItemIndex();
+};
+
+/**
+ * @brief 读取一组用户记录文件，组装稀疏作答矩阵（每个文件一个用户，读取并行）
+ *
+ * 题号不在当前题库中的记录忽略；同一用户同一题的多次作答合并。
+ *
+ * @param files 用户记录文件
+ * @param pool 执行并行任务的线程池
+ * @return 作答矩阵（用户编号即 files 下标，未能打开的文件为空行）
+ */
+IrtResponses loadIrtResponses(const std::vector<std::filesystem::path>& files, ThreadPool& pool);
+
+/**
+ * @struct IrtFit
+ * @brief 拟合结果
+ */
+struct IrtFit {
+    IrtModel model = IrtModel::TwoPL;
+    std::vector<double> ability;          ///< 用户 -> θ
+    std::vector<double> difficulty;       ///< 题目 -> b
+    std::vector<double> discrimination;   ///< 题目 -> a（1PL 为 1）
+    std::vector<uint32_t> responses;      ///< 题目 -> 作答次数
+    size_t iterations = 0;                ///< 实际迭代轮数
+    bool converged = false;               ///< 是否在达到最大轮数前收敛
+    double logLikelihood = 0.0;           ///< 最终参数下的对数似然（不含先验）
+};
+
+/**
+ * @brief 拟合 IRT 模型
+ * @param data 稀疏作答矩阵（需已 buildItemIndex()）
+ * @param model 1PL 或 2PL
+ * @param maxIterations 最大迭代轮数（每轮更新一次能力、一次题目参数）
+ * @param pool 执行并行任务的线程池
+ * @return 拟合结果（与线程数无关）
+ * @complexity 每轮 O(nnz)
+ */
+IrtFit fitIrt(const IrtResponses& data, IrtModel model, size_t maxIterations, ThreadPool& pool);
+
+/**
+ * @brief IRT 难度 b 换算为 1~5 级
+ *
+ * 以 ±0.5、±1.5 为界：b < -1.5 为 1 级，-1.5 ~ -0.5 为 2 级，…，b >= 1.5 为 5 级。
+ */
+int difficultyLevelOf(double b);
+
+/**
+ * @brief 把校准结果写入旁路文件（只写有作答的题目）
+ *
+ * 格式：# 开头的注释行，之后每行"题号,难度 b,区分度 a,作答次数"。
+ *
+ * @param filename 输出文件路径（通常为 data/question_calibration.csv）
+ * @param fit 拟合结果（题目下标与当前 g_questions 对应）
+ * @return true 写出成功；false 文件无法打开
+ */
+bool saveIrtCalibration(const std::string& filename, const IrtFit& fit);
+
+/**
+ * @brief 加载校准文件并应用到当前题库
+ *
+ * 作答次数不少于 kIrtMinResponses 的题目：记下 IRT 参数，并以 difficultyLevelOf(b) 覆盖 difficulty。
+ * 题号不在题库中或格式错误的行跳过。应用后推荐结果缓存作废。
+ *
+ * @param filename 校准文件路径
+ * @return true 文件存在并已加载；false 文件无法打开（题库不变）
+ */
+bool loadIrtCalibrationFromFile(const std::string& filename);
@@ -0,0 +1,660 @@
+/**
+ * @file Kernels.cpp
+ * @brief 聚合计算内核实现（标量 + AVX2 + AVX-512，运行时派发）
+ *
+ * 实现要点：
+ * 1. **编译方式**：AVX2 / AVX-512 函数通过 DSQ_TARGET_AVX2 / DSQ_TARGET_AVX512 单独开启指令集
+ *    （GCC/Clang 为 target 属性，MSVC 无需额外开关），
+ *    整个程序仍按基线指令集编译，可在不支持 AVX2 的机器上运行
+ * 2. **答对计数**：_mm256_sad_epu8 一次把 32 个字节横向求和为 4 个 64 位部分和
+ * 3. **用时求和**：每次 8 个 int32 扩展为 int64 后累加，避免长历史溢出
+ * 4. **分组直方图**：按 2048 条分块，块内先把三列压缩为 16 位（L1 常驻），
+ *    再对每个知识点做一次"比较 + 掩码累加"扫描，每条指令处理 16 条记录
+ *    （作答数与答对数打包在同一个 16 位通道里，用时用 madd 与掩码相乘求和）；
+ *    用时超出 16 位范围的块、知识点数超过 16 时退回标量实现（实测更多知识点时逐桶扫描反而慢于标量）
+ * 5. **推荐评分**：逐项对应 scoreWithPolicy() 的运算顺序，分支改写为无分支形式：
+ *    - 策略参数（ScoreWeights）在循环外广播一次
+ *    - "作答过才计算错误率"：分母取 max(次数, 1) 照常相除，再按掩码与 1.0 混合
+ *    - 时间间隔在 64 位整数域截断到 [0, horizonDays 天]（从未作答视为 horizonDays 天），
+ *      截断后的秒数可无损转为 32 位再转双精度（AVX2 没有 64 位整数转双精度指令）
+ *    - 难度与总分的上下限截断用 min/max
+ *    不使用 FMA，保证与标量实现逐位相同；AVX-512 版每次处理 8 道题，用掩码寄存器混合
+ * 6. **单精度点积**：8 个通道各自先乘后加，归并顺序固定为 (l0+l4) + (l2+l6) 与 (l1+l5) + (l3+l7)，
+ *    标量实现用 8 个累加器按同样顺序求和
+ * 7. **正规方程累加**：逐元素的先乘后加与通道宽度无关；AVX-512 版在行长为 16 时把整个矩阵留在寄存器中。
+ *    因此潜因子模型的训练与预测在各指令集下逐位相同
+ */
+
+#include "Kernels.h"
+#include <climits>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DSQ_HAVE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(DSQ_HAVE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DSQ_TARGET_AVX2 __attribute__((target("avx2")))
+#define DSQ_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512dq")))
+#else
+#define DSQ_TARGET_AVX2
+#define DSQ_TARGET_AVX512
+#endif
+
+namespace {
+
+/// AVX2 分组直方图支持的最大知识点数（更多时退回标量实现）
+constexpr size_t kSimdHistogramMaxBins = 16;
+
+/// AVX2 分组直方图每块记录数：16 个通道每通道 128 条，作答数与答对数可各占 8 位
+constexpr size_t kSimdHistogramBlock = 2048;
+
+/// 单精度点积的累加通道数（AVX2 的 8 个单精度通道；标量实现按相同的通道与归并顺序求和）
+constexpr size_t kDotLanes = 8;
+
+// ============================================================
+// 标量实现
+// ============================================================
+
+int64_t countCorrectScalar(const uint8_t* correct, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += correct[i];
+    return sum;
+}
+
+int64_t sumSecondsScalar(const int32_t* seconds, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += seconds[i];
+    return sum;
+}
+
+void knowledgeHistogramScalar(const int32_t* knowledgeId, const uint8_t* correct,
+                              const int32_t* seconds, size_t n, size_t knowledgeCount,
+                              KnowledgeHistogram& out) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t k = knowledgeId[i];
+        if (k < 0 || (size_t)k >= knowledgeCount) continue;  // 非法 ID 忽略
+        out.total[k]++;
+        out.correct[k] += correct[i];
+        out.seconds[k] += seconds[i];
+    }
+}
+
+/// 推荐评分：时间间隔的封顶秒数（从未作答或间隔超过 horizonDays 天时取该值）
+long long horizonSeconds(const ScoreWeights& w) {
+    return (long long)w.horizonDays * 86400;
+}
+
+/**
+ * @brief 第 i 道题的推荐评分（与 scoreWithPolicy 的运算逐项对应，策略参数取自 w）
+ */
+double recommendScoreAt(const RecommendScoreColumns& c, const ScoreWeights& w, size_t i, long long now) {
+    int32_t att = c.attempts[i];
+    double errorRate = 1.0;
+    if (att > 0) errorRate = (att - c.correct[i]) * 1.0 / att;
+    int32_t recent = c.recentAttempts[i];
+    if (recent > 0) {
+        double recentErrorRate = (recent - c.recentCorrect[i]) * 1.0 / recent;
+        errorRate = (1.0 - w.recentWeight) * errorRate + w.recentWeight * recentErrorRate;
+    }
+
+    double timeGapDays = (double)w.horizonDays;
+    if (c.lastTimestamp[i] > 0) {
+        double seconds = (double)(now - c.lastTimestamp[i]);
+        if (seconds < 0) seconds = 0;
+        timeGapDays = seconds / 86400.0;
+    }
+    double timeScore = timeGapDays / (double)w.horizonDays;
+    if (timeScore > 1.0) timeScore = 1.0;
+
+    double diffScore = 0.2 + (c.difficulty[i] - 1) * 0.2;
+    if (diffScore < 0.2) diffScore = 0.2;
+    if (diffScore > 1.0) diffScore = 1.0;
+
+    double unseenBonus = (att == 0 ? w.unseenBonus : 0.0);
+
+    double score = w.errorWeight * errorRate + w.timeWeight * timeScore + w.difficultyWeight * diffScore +
+                   unseenBonus;
+    if (score < 0.0) score = 0.0;
+    if (score > 2.0) score = 2.0;
+    return score;
+}
+
+void recommendScoresScalar(const RecommendScoreColumns& c, const ScoreWeights& w, long long now, double* out) {
+    for (size_t i = 0; i < c.n; ++i) out[i] = recommendScoreAt(c, w, i, now);
+}
+
+float dotScalar(const float* a, const float* b, size_t n) {
+    float lane[kDotLanes] = {};
+    size_t i = 0;
+    for (; i + kDotLanes <= n; i += kDotLanes) {
+        for (size_t j = 0; j < kDotLanes; ++j) lane[j] += a[i + j] * b[i + j];
+    }
+    // 与 AVX2 相同的归并顺序：高低 4 个通道对应相加，再按 (0 + 2) + (1 + 3) 相加
+    float s0 = lane[0] + lane[4];
+    float s1 = lane[1] + lane[5];
+    float s2 = lane[2] + lane[6];
+    float s3 = lane[3] + lane[7];
+    float sum = (s0 + s2) + (s1 + s3);
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+void dotRowsScalar(const float* rows, size_t count, size_t n, const float* v, float* out) {
+    for (size_t r = 0; r < count; ++r) out[r] = dotScalar(rows + r * n, v, n);
+}
+
+void gramAccumulateScalar(const float* rows, size_t n, const int32_t* index, const float* weight,
+                          const float* target, size_t count, float* gram, float* rhs) {
+    for (size_t e = 0; e < count; ++e) {
+        const float* z = rows + (size_t)index[e] * n;
+        for (size_t r = 0; r < n; ++r) {
+            float a = weight[e] * z[r];
+            for (size_t c = 0; c < n; ++c) gram[r * n + c] += a * z[c];
+            rhs[r] += target[e] * z[r];
+        }
+    }
+}
+
+// ============================================================
+// AVX2 实现
+// ============================================================
+
+#ifdef DSQ_HAVE_X86
+
+DSQ_TARGET_AVX2
+int64_t countCorrectAvx2(const uint8_t* correct, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(correct + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));  // 每 8 字节求和为一个 64 位数
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, acc);
+    int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) sum += correct[i];
+    return sum;
+}
+
+DSQ_TARGET_AVX2
+int64_t sumSecondsAvx2(const int32_t* seconds, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(seconds + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, _mm256_add_epi64(acc0, acc1));
+    int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) sum += seconds[i];
+    return sum;
+}
+
+DSQ_TARGET_AVX2
+void knowledgeHistogramAvx2(const int32_t* knowledgeId, const uint8_t* correct,
+                            const int32_t* seconds, size_t n, size_t knowledgeCount,
+                            KnowledgeHistogram& out) {
+    if (knowledgeCount == 0 || knowledgeCount > kSimdHistogramMaxBins) {
+        knowledgeHistogramScalar(knowledgeId, correct, seconds, n, knowledgeCount, out);
+        return;
+    }
+
+    const int kLanes = 16;
+    const int K = (int)knowledgeCount;
+    const __m256i ones16 = _mm256_set1_epi16(1);
+
+    // 本块的 16 位列（每列 4KB，三列常驻 L1）
+    // count16 = 1 | 答对 << 8：低 8 位累加作答次数，高 8 位累加答对次数
+    alignas(32) int16_t kid16[kSimdHistogramBlock];
+    alignas(32) int16_t count16[kSimdHistogramBlock];
+    alignas(32) int16_t sec16[kSimdHistogramBlock];
+
+    size_t i = 0;
+    while (i + kLanes <= n) {
+        size_t blockLen = (n - i) / kLanes * kLanes;
+        if (blockLen > kSimdHistogramBlock) blockLen = kSimdHistogramBlock;
+
+        // 1) 压缩为 16 位：packs 饱和截断，越界 ID 不会等于任何合法桶；
+        //    permute 恢复 packs 打乱的 128 位通道顺序，使三列逐元素对齐
+        __m256i secMin = _mm256_set1_epi32(INT32_MAX);
+        __m256i secMax = _mm256_set1_epi32(INT32_MIN);
+        for (size_t j = 0; j < blockLen; j += kLanes) {
+            __m256i k0 = _mm256_loadu_si256((const __m256i*)(knowledgeId + i + j));
+            __m256i k1 = _mm256_loadu_si256((const __m256i*)(knowledgeId + i + j + 8));
+            __m256i s0 = _mm256_loadu_si256((const __m256i*)(seconds + i + j));
+            __m256i s1 = _mm256_loadu_si256((const __m256i*)(seconds + i + j + 8));
+            secMin = _mm256_min_epi32(secMin, _mm256_min_epi32(s0, s1));
+            secMax = _mm256_max_epi32(secMax, _mm256_max_epi32(s0, s1));
+            _mm256_store_si256((__m256i*)(kid16 + j), _mm256_permute4x64_epi64(_mm256_packs_epi32(k0, k1), 0xD8));
+            _mm256_store_si256((__m256i*)(sec16 + j), _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), 0xD8));
+            __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(correct + i + j)));
+            _mm256_store_si256((__m256i*)(count16 + j), _mm256_or_si256(ones16, _mm256_slli_epi16(c, 8)));
+        }
+
+        // 用时超出 16 位范围的块改走标量路径（保证压缩无损）
+        alignas(32) int32_t lo[8];
+        alignas(32) int32_t hi[8];
+        _mm256_store_si256((__m256i*)lo, secMin);
+        _mm256_store_si256((__m256i*)hi, secMax);
+        bool fits = true;
+        for (int j = 0; j < 8; ++j) {
+            if (lo[j] < INT16_MIN || hi[j] > INT16_MAX) fits = false;
+        }
+        if (!fits) {
+            knowledgeHistogramScalar(knowledgeId + i, correct + i, seconds + i, blockLen, knowledgeCount, out);
+            i += blockLen;
+            continue;
+        }
+
+        // 2) 逐个知识点扫描本块：比较得到掩码，按掩码累加（累加器全程在寄存器中）
+        for (int k = 0; k < K; ++k) {
+            const __m256i bin = _mm256_set1_epi16((int16_t)k);
+            __m256i accCount = _mm256_setzero_si256();    // 每通道至多 128 条，8 位 + 8 位不溢出
+            __m256i accNegSec = _mm256_setzero_si256();   // 32 位：madd(用时, 掩码) 为负的用时两两之和
+            for (size_t j = 0; j < blockLen; j += kLanes) {
+                __m256i m = _mm256_cmpeq_epi16(_mm256_load_si256((const __m256i*)(kid16 + j)), bin);
+                accCount = _mm256_add_epi16(accCount, _mm256_and_si256(m, _mm256_load_si256((const __m256i*)(count16 + j))));
+                accNegSec = _mm256_add_epi32(accNegSec, _mm256_madd_epi16(_mm256_load_si256((const __m256i*)(sec16 + j)), m));
+            }
+
+            // 归并各通道部分和到 64 位结果
+            alignas(32) uint16_t cnt[16];
+            alignas(32) int32_t negSec[8];
+            _mm256_store_si256((__m256i*)cnt, accCount);
+            _mm256_store_si256((__m256i*)negSec, accNegSec);
+            for (int j = 0; j < 16; ++j) {
+                out.total[k] += cnt[j] & 0xFF;
+                out.correct[k] += cnt[j] >> 8;
+            }
+            for (int j = 0; j < 8; ++j) out.seconds[k] -= negSec[j];
+        }
+        i += blockLen;
+    }
+
+    // 尾部不足 16 条的记录走标量路径
+    knowledgeHistogramScalar(knowledgeId + i, correct + i, seconds + i, n - i, knowledgeCount, out);
+}
+
+DSQ_TARGET_AVX2
+void recommendScoresAvx2(const RecommendScoreColumns& c, const ScoreWeights& w, long long now, double* out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d p2 = _mm256_set1_pd(0.2);
+    const __m256d histW = _mm256_set1_pd(1.0 - w.recentWeight);
+    const __m256d recentW = _mm256_set1_pd(w.recentWeight);
+    const __m256d w1 = _mm256_set1_pd(w.errorWeight);
+    const __m256d w2 = _mm256_set1_pd(w.timeWeight);
+    const __m256d w3 = _mm256_set1_pd(w.difficultyWeight);
+    const __m256d bonus = _mm256_set1_pd(w.unseenBonus);
+    const __m256d secPerDay = _mm256_set1_pd(86400.0);
+    const __m256d horizon = _mm256_set1_pd((double)w.horizonDays);
+    const __m256i nowV = _mm256_set1_epi64x(now);
+    const __m256i zeroI = _mm256_setzero_si256();
+    const __m256i oneI = _mm256_set1_epi64x(1);
+    const __m256i cap = _mm256_set1_epi64x(horizonSeconds(w));
+    const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    size_t i = 0;
+    for (; i + 4 <= c.n; i += 4) {
+        __m256d att = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(c.attempts + i)));
+        __m256d cor = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(c.correct + i)));
+        __m256d ra = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(c.recentAttempts + i)));
+        __m256d rc = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(c.recentCorrect + i)));
+        __m256d diff = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(c.difficulty + i)));
+
+        // 维度 1：错误率（未作答为 1.0；近 7 天有作答时按 recentWeight 混入近期错误率）
+        __m256d seen = _mm256_cmp_pd(att, zero, _CMP_GT_OQ);
+        __m256d err = _mm256_div_pd(_mm256_sub_pd(att, cor), _mm256_max_pd(att, one));
+        err = _mm256_blendv_pd(one, err, seen);
+        __m256d recentSeen = _mm256_cmp_pd(ra, zero, _CMP_GT_OQ);
+        __m256d recentErr = _mm256_div_pd(_mm256_sub_pd(ra, rc), _mm256_max_pd(ra, one));
+        __m256d blended = _mm256_add_pd(_mm256_mul_pd(histW, err), _mm256_mul_pd(recentW, recentErr));
+        err = _mm256_blendv_pd(err, blended, recentSeen);
+
+        // 维度 2：时间间隔，64 位整数域截断到 [0, horizonDays 天]
+        __m256i last = _mm256_loadu_si256((const __m256i*)(c.lastTimestamp + i));
+        __m256i gap = _mm256_sub_epi64(nowV, last);
+        gap = _mm256_andnot_si256(_mm256_cmpgt_epi64(zeroI, gap), gap);
+        __m256i capped = _mm256_or_si256(_mm256_cmpgt_epi64(gap, cap), _mm256_cmpgt_epi64(oneI, last));
+        gap = _mm256_blendv_epi8(gap, cap, capped);
+        __m256d gapSec = _mm256_cvtepi32_pd(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(gap, lowHalves)));
+        __m256d timeScore = _mm256_min_pd(_mm256_div_pd(_mm256_div_pd(gapSec, secPerDay), horizon), one);
+
+        // 维度 3：难度 [1,5] -> [0.2,1.0]
+        __m256d diffScore = _mm256_add_pd(p2, _mm256_mul_pd(_mm256_sub_pd(diff, one), p2));
+        diffScore = _mm256_min_pd(_mm256_max_pd(diffScore, p2), one);
+
+        // 维度 4：未作答奖励
+        __m256d unseen = _mm256_and_pd(_mm256_cmp_pd(att, zero, _CMP_EQ_OQ), bonus);
+
+        __m256d score = _mm256_add_pd(_mm256_mul_pd(w1, err), _mm256_mul_pd(w2, timeScore));
+        score = _mm256_add_pd(score, _mm256_mul_pd(w3, diffScore));
+        score = _mm256_add_pd(score, unseen);
+        score = _mm256_min_pd(_mm256_max_pd(score, zero), two);
+        _mm256_storeu_pd(out + i, score);
+    }
+    for (; i < c.n; ++i) out[i] = recommendScoreAt(c, w, i, now);
+}
+
+/// 8 个单精度通道按 ((l0 + l4) + (l2 + l6)) + ((l1 + l5) + (l3 + l7)) 的顺序归并（与 dotScalar 一致）
+DSQ_TARGET_AVX2
+inline float horizontalSumAvx2(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    __m128 t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+}
+
+DSQ_TARGET_AVX2
+float dotAvx2(const float* a, const float* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + kDotLanes <= n; i += kDotLanes) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    float sum = horizontalSumAvx2(acc);
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+DSQ_TARGET_AVX2
+void dotRowsAvx2(const float* rows, size_t count, size_t n, const float* v, float* out) {
+    for (size_t r = 0; r < count; ++r) out[r] = dotAvx2(rows + r * n, v, n);
+}
+
+/// 行长不是 8 的倍数时退回标量实现（结果相同）
+DSQ_TARGET_AVX2
+void gramAccumulateAvx2(const float* rows, size_t n, const int32_t* index, const float* weight,
+                        const float* target, size_t count, float* gram, float* rhs) {
+    if (n % 8 != 0) {
+        gramAccumulateScalar(rows, n, index, weight, target, count, gram, rhs);
+        return;
+    }
+    for (size_t e = 0; e < count; ++e) {
+        const float* z = rows + (size_t)index[e] * n;
+        for (size_t r = 0; r < n; ++r) {
+            const __m256 a = _mm256_set1_ps(weight[e] * z[r]);
+            for (size_t c = 0; c < n; c += 8) {
+                float* g = gram + r * n + c;
+                _mm256_storeu_ps(g, _mm256_add_ps(_mm256_loadu_ps(g), _mm256_mul_ps(a, _mm256_loadu_ps(z + c))));
+            }
+        }
+        const __m256 t = _mm256_set1_ps(target[e]);
+        for (size_t c = 0; c < n; c += 8) {
+            _mm256_storeu_ps(rhs + c, _mm256_add_ps(_mm256_loadu_ps(rhs + c), _mm256_mul_ps(t, _mm256_loadu_ps(z + c))));
+        }
+    }
+}
+
+// ============================================================
+// AVX-512 实现
+// ============================================================
+
+// GCC 12 在 -Wall -O2 下对内联展开的 AVX-512 内建函数（_mm512_cvtepi32_pd、_mm512_max_pd 等）
+// 报告 "'__Y' may be used uninitialized"：头文件内部以未定义向量作为合并源，属于误报，只在本段内关闭
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+DSQ_TARGET_AVX512
+void recommendScoresAvx512(const RecommendScoreColumns& c, const ScoreWeights& w, long long now, double* out) {
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d p2 = _mm512_set1_pd(0.2);
+    const __m512d histW = _mm512_set1_pd(1.0 - w.recentWeight);
+    const __m512d recentW = _mm512_set1_pd(w.recentWeight);
+    const __m512d w1 = _mm512_set1_pd(w.errorWeight);
+    const __m512d w2 = _mm512_set1_pd(w.timeWeight);
+    const __m512d w3 = _mm512_set1_pd(w.difficultyWeight);
+    const __m512d bonus = _mm512_set1_pd(w.unseenBonus);
+    const __m512d secPerDay = _mm512_set1_pd(86400.0);
+    const __m512d horizon = _mm512_set1_pd((double)w.horizonDays);
+    const __m512i nowV = _mm512_set1_epi64(now);
+    const __m512i zeroI = _mm512_setzero_si512();
+    const __m512i cap = _mm512_set1_epi64(horizonSeconds(w));
+
+    size_t i = 0;
+    for (; i + 8 <= c.n; i += 8) {
+        __m512d att = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)(c.attempts + i)));
+        __m512d cor = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)(c.correct + i)));
+        __m512d ra = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)(c.recentAttempts + i)));
+        __m512d rc = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)(c.recentCorrect + i)));
+        __m512d diff = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)(c.difficulty + i)));
+
+        // 维度 1：错误率
+        __mmask8 seen = _mm512_cmp_pd_mask(att, zero, _CMP_GT_OQ);
+        __m512d err = _mm512_div_pd(_mm512_sub_pd(att, cor), _mm512_max_pd(att, one));
+        err = _mm512_mask_blend_pd(seen, one, err);
+        __mmask8 recentSeen = _mm512_cmp_pd_mask(ra, zero, _CMP_GT_OQ);
+        __m512d recentErr = _mm512_div_pd(_mm512_sub_pd(ra, rc), _mm512_max_pd(ra, one));
+        __m512d blended = _mm512_add_pd(_mm512_mul_pd(histW, err), _mm512_mul_pd(recentW, recentErr));
+        err = _mm512_mask_blend_pd(recentSeen, err, blended);
+
+        // 维度 2：时间间隔（AVX-512DQ 可直接把 64 位整数转为双精度）
+        __m512i last = _mm512_loadu_si512((const void*)(c.lastTimestamp + i));
+        __m512i gap = _mm512_min_epi64(_mm512_max_epi64(_mm512_sub_epi64(nowV, last), zeroI), cap);
+        gap = _mm512_mask_blend_epi64(_mm512_cmple_epi64_mask(last, zeroI), gap, cap);
+        __m512d timeScore = _mm512_min_pd(_mm512_div_pd(_mm512_div_pd(_mm512_cvtepi64_pd(gap), secPerDay), horizon), one);
+
+        // 维度 3：难度
+        __m512d diffScore = _mm512_add_pd(p2, _mm512_mul_pd(_mm512_sub_pd(diff, one), p2));
+        diffScore = _mm512_min_pd(_mm512_max_pd(diffScore, p2), one);
+
+        // 维度 4：未作答奖励
+        __m512d unseen = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(att, zero, _CMP_EQ_OQ), bonus);
+
+        __m512d score = _mm512_add_pd(_mm512_mul_pd(w1, err), _mm512_mul_pd(w2, timeScore));
+        score = _mm512_add_pd(score, _mm512_mul_pd(w3, diffScore));
+        score = _mm512_add_pd(score, unseen);
+        score = _mm512_min_pd(_mm512_max_pd(score, zero), two);
+        _mm512_storeu_pd(out + i, score);
+    }
+    for (; i < c.n; ++i) out[i] = recommendScoreAt(c, w, i, now);
+}
+
+/**
+ * 行长为 16（潜因子模型的行）时，16 × 16 矩阵的每一行正好是一个 512 位寄存器，
+ * 整个累加过程中矩阵与右端向量常驻 17 个寄存器，每个观测只读一次 z；其余行长沿用 AVX2 实现
+ */
+DSQ_TARGET_AVX512
+void gramAccumulateAvx512(const float* rows, size_t n, const int32_t* index, const float* weight,
+                          const float* target, size_t count, float* gram, float* rhs) {
+    if (n != 16) {
+        gramAccumulateAvx2(rows, n, index, weight, target, count, gram, rhs);
+        return;
+    }
+    __m512 g[16];
+    for (size_t r = 0; r < 16; ++r) g[r] = _mm512_loadu_ps(gram + r * 16);
+    __m512 h = _mm512_loadu_ps(rhs);
+    for (size_t e = 0; e < count; ++e) {
+        const float* z = rows + (size_t)index[e] * 16;
+        const __m512 zv = _mm512_loadu_ps(z);
+        const float w = weight[e];
+        for (size_t r = 0; r < 16; ++r) g[r] = _mm512_add_ps(g[r], _mm512_mul_ps(_mm512_set1_ps(w * z[r]), zv));
+        h = _mm512_add_ps(h, _mm512_mul_ps(_mm512_set1_ps(target[e]), zv));
+    }
+    for (size_t r = 0; r < 16; ++r) _mm512_storeu_ps(gram + r * 16, g[r]);
+    _mm512_storeu_ps(rhs, h);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // DSQ_HAVE_X86
+
+// ============================================================
+// 运行时派发
+// ============================================================
+
+/// 内核函数指针表
+struct KernelTable {
+    KernelIsa isa;
+    int64_t (*countCorrect)(const uint8_t*, size_t);
+    int64_t (*sumSeconds)(const int32_t*, size_t);
+    void (*knowledgeHistogram)(const int32_t*, const uint8_t*, const int32_t*, size_t, size_t,
+                               KnowledgeHistogram&);
+    void (*recommendScores)(const RecommendScoreColumns&, const ScoreWeights&, long long, double*);
+    float (*dot)(const float*, const float*, size_t);
+    void (*dotRows)(const float*, size_t, size_t, const float*, float*);
+    void (*gramAccumulate)(const float*, size_t, const int32_t*, const float*, const float*, size_t, float*,
+                           float*);
+};
+
+const KernelTable kScalarTable = {
+    KernelIsa::Scalar, countCorrectScalar, sumSecondsScalar, knowledgeHistogramScalar,
+    recommendScoresScalar, dotScalar, dotRowsScalar, gramAccumulateScalar
+};
+
+#ifdef DSQ_HAVE_X86
+const KernelTable kAvx2Table = {
+    KernelIsa::Avx2, countCorrectAvx2, sumSecondsAvx2, knowledgeHistogramAvx2,
+    recommendScoresAvx2, dotAvx2, dotRowsAvx2, gramAccumulateAvx2
+};
+
+/// AVX-512 级别：归约与直方图受内存带宽限制，沿用 AVX2 实现；推荐评分为计算密集，使用 512 位实现。
+/// 单精度点积沿用 AVX2 实现：潜因子向量只有 16 维，且 16 个通道会改变求和顺序、与标量结果不再逐位相同；
+/// 正规方程累加是逐元素运算，16 维的行正好放进一个 512 位寄存器
+const KernelTable kAvx512Table = {
+    KernelIsa::Avx512, countCorrectAvx2, sumSecondsAvx2, knowledgeHistogramAvx2,
+    recommendScoresAvx512, dotAvx2, dotRowsAvx2, gramAccumulateAvx512
+};
+#endif
+
+/// 检测 CPU 与操作系统是否支持 AVX2（含 YMM 寄存器状态保存）
+bool cpuSupportsAvx2() {
+#if defined(DSQ_HAVE_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;   // 操作系统需保存 XMM/YMM 状态
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(DSQ_HAVE_X86)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+/// 检测 CPU 与操作系统是否支持 AVX-512F 与 AVX-512DQ（含 ZMM/掩码寄存器状态保存）
+bool cpuSupportsAvx512() {
+#if defined(DSQ_HAVE_X86) && defined(_MSC_VER)
+    if (!cpuSupportsAvx2()) return false;
+    if ((_xgetbv(0) & 0xE6) != 0xE6) return false;   // 操作系统需保存 opmask/ZMM 状态
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 17)) != 0;
+#elif defined(DSQ_HAVE_X86)
+    __builtin_cpu_init();
+    return cpuSupportsAvx2() && __builtin_cpu_supports("avx512f") != 0 &&
+           __builtin_cpu_supports("avx512dq") != 0;
+#else
+    return false;
+#endif
+}
+
+/// 当前使用的函数指针表（首次调用时初始化）
+const KernelTable*& activeTable() {
+    static const KernelTable* table = nullptr;
+    if (!table) {
+#ifdef DSQ_HAVE_X86
+        if (cpuSupportsAvx512()) {
+            table = &kAvx512Table;
+        } else {
+            table = cpuSupportsAvx2() ? &kAvx2Table : &kScalarTable;
+        }
+#else
+        table = &kScalarTable;
+#endif
+    }
+    return table;
+}
+
+} // namespace
+
+KernelIsa detectKernelIsa() {
+    if (cpuSupportsAvx512()) return KernelIsa::Avx512;
+    return cpuSupportsAvx2() ? KernelIsa::Avx2 : KernelIsa::Scalar;
+}
+
+KernelIsa activeKernelIsa() {
+    return activeTable()->isa;
+}
+
+bool setKernelIsa(KernelIsa isa) {
+    if (isa == KernelIsa::Scalar) {
+        activeTable() = &kScalarTable;
+        return true;
+    }
+#ifdef DSQ_HAVE_X86
+    if (isa == KernelIsa::Avx2 && cpuSupportsAvx2()) {
+        activeTable() = &kAvx2Table;
+        return true;
+    }
+    if (isa == KernelIsa::Avx512 && cpuSupportsAvx512()) {
+        activeTable() = &kAvx512Table;
+        return true;
+    }
+#endif
+    return false;
+}
+
+const char* kernelIsaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Avx2: return "avx2";
+        case KernelIsa::Avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+int64_t kernelCountCorrect(const uint8_t* correct, size_t n) {
+    return activeTable()->countCorrect(correct, n);
+}
+
+int64_t kernelSumSeconds(const int32_t* seconds, size_t n) {
+    return activeTable()->sumSeconds(seconds, n);
+}
+
+void kernelKnowledgeHistogram(const int32_t* knowledgeId, const uint8_t* correct,
+                              const int32_t* seconds, size_t n, size_t knowledgeCount,
+                              KnowledgeHistogram& out) {
+    out.total.assign(knowledgeCount, 0);
+    out.correct.assign(knowledgeCount, 0);
+    out.seconds.assign(knowledgeCount, 0);
+    activeTable()->knowledgeHistogram(knowledgeId, correct, seconds, n, knowledgeCount, out);
+}
+
+void kernelRecommendScores(const RecommendScoreColumns& cols, const ScoreWeights& weights, long long now,
+                           double* out) {
+    activeTable()->recommendScores(cols, weights, now, out);
+}
+
+float kernelDotF32(const float* a, const float* b, size_t n) {
+    return activeTable()->dot(a, b, n);
+}
+
+void kernelDotRowsF32(const float* rows, size_t count, size_t n, const float* v, float* out) {
+    activeTable()->dotRows(rows, count, n, v, out);
+}
+
+void kernelGramAccumulateF32(const float* rows, size_t n, const int32_t* index, const float* weight,
+                             const float* target, size_t count, float* gram, float* rhs) {
+    activeTable()->gramAccumulate(rows, n, index, weight, target, count, gram, rhs);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file Kernels.h
+ * @brief 聚合计算内核 - 列式记录上的向量化归约
+ *
+ * 【模块职责】
+ * 统计与报告中最常见的三类归约：
+ * - 答对计数（count-correct）
+ * - 用时求和（sum-seconds）
+ * - 按知识点分组的直方图（作答数 / 答对数 / 用时）
+ * 原先是在 Record 结构体数组上逐条带分支的标量循环。本模块在列式数组
+ * （见 Record.h 的 RecordColumns）上提供多套实现：
+ * - Scalar：可移植的标量实现，也是结果的参照
+ * - AVX2：256 位向量实现，运行时检测 CPU 支持后自动选用
+ * - AVX-512：512 位向量实现（AVX-512F + DQ），目前只用于推荐评分，
+ *   其余内核在该级别下沿用 AVX2 实现
+ *
+ * 另外提供推荐评分的批量内核：在稠密统计列上按给定评分策略（ScoringPolicy.h）一次为全部题目
+ * 计算 scoreWithPolicy() 的结果，向量实现中所有分支与截断均为无分支的 min/max/blend。
+ * 以及潜因子模型用到的单精度点积 / 多行点积 / 正规方程累加，按固定的通道与归并顺序计算，各实现逐位相同。
+ *
+ * 【运行时派发】
+ * 首次调用时检测 CPU（GCC/Clang 使用 __builtin_cpu_supports，MSVC 使用 __cpuid + _xgetbv），
+ * 之后通过函数指针表直接调用，不再重复检测。setKernelIsa() 可强制切换（用于基准测试对比）。
+ * 非 x86 平台只编译标量实现。
+ *
+ * 【分组直方图的实现】
+ * 按 2048 条分块，块内三列压缩为 16 位后常驻 L1，再对每个知识点做一次
+ * "比较 + 掩码累加"扫描；知识点数超过 16 时退回标量实现。
+ *
+ * 【与其他模块依赖】
+ * - Record.cpp：维护列式记录 g_recordColumns
+ * - Stats.cpp / Report.cpp：总体与按知识点统计
+ * - Recommender.cpp：批量推荐评分（全量扫描、推荐索引重建）
+ * - MatrixFactorization.cpp：潜因子模型的训练（正规方程累加）与预测（点积）
+ * - Bench.cpp：--bench-kernels / --bench-scores 微基准
+ */
+
+#pragma once
+
+#include "ScoringPolicy.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 内核指令集
+ */
+enum class KernelIsa {
+    Scalar,  ///< 标量实现（所有平台可用）
+    Avx2,    ///< AVX2 实现（x86，运行时检测）
+    Avx512   ///< AVX-512F + DQ 实现（x86，运行时检测；未单独实现的内核沿用 AVX2）
+};
+
+/**
+ * @brief 检测当前 CPU 支持的最佳指令集
+ * @return KernelIsa 支持 AVX-512F/DQ 时返回 Avx512，支持 AVX2 时返回 Avx2，否则返回 Scalar
+ */
+KernelIsa detectKernelIsa();
+
+/**
+ * @brief 当前使用的指令集（首次调用时按 detectKernelIsa() 初始化）
+ */
+KernelIsa activeKernelIsa();
+
+/**
+ * @brief 强制切换内核指令集
+ * @param isa 目标指令集
+ * @return true 切换成功；false CPU 不支持该指令集（保持不变）
+ */
+bool setKernelIsa(KernelIsa isa);
+
+/**
+ * @brief 指令集名称（"scalar" / "avx2" / "avx512"）
+ */
+const char* kernelIsaName(KernelIsa isa);
+
+/**
+ * @brief 统计答对次数
+ * @param correct 正误列（每个元素为 0 或 1）
+ * @param n 记录数
+ * @return int64_t 答对次数（即各元素之和）
+ * @complexity O(n)
+ */
+int64_t kernelCountCorrect(const uint8_t* correct, size_t n);
+
+/**
+ * @brief 用时求和
+ * @param seconds 用时列（秒）
+ * @param n 记录数
+ * @return int64_t 总用时（64 位累加，不会溢出）
+ * @complexity O(n)
+ */
+int64_t kernelSumSeconds(const int32_t* seconds, size_t n);
+
+/**
+ * @struct KnowledgeHistogram
+ * @brief 按知识点分组的直方图（下标为知识点 ID）
+ */
+struct KnowledgeHistogram {
+    std::vector<int64_t> total;    ///< 作答次数
+    std::vector<int64_t> correct;  ///< 答对次数
+    std::vector<int64_t> seconds;  ///< 累计用时（秒）
+};
+
+/**
+ * @brief 按知识点分组统计作答次数、答对次数与用时
+ *
+ * @param knowledgeId 知识点 ID 列（非法 ID 被忽略）
+ * @param correct 正误列
+ * @param seconds 用时列
+ * @param n 记录数
+ * @param knowledgeCount 知识点数（直方图长度）
+ * @param out 输出直方图（会被重置为 knowledgeCount 个桶）
+ * @complexity O(n + knowledgeCount)
+ */
+void kernelKnowledgeHistogram(const int32_t* knowledgeId, const uint8_t* correct,
+                              const int32_t* seconds, size_t n, size_t knowledgeCount,
+                              KnowledgeHistogram& out);
+
+/**
+ * @struct RecommendScoreColumns
+ * @brief 批量推荐评分的输入列（均为长度 n 的数组，下标为题目下标）
+ *
+ * 前四列与 QuestionStatTable 的列类型一致，可直接传入其 data()。
+ */
+struct RecommendScoreColumns {
+    const int32_t* attempts;          ///< 总作答次数
+    const int32_t* correct;           ///< 答对次数
+    const int32_t* recentAttempts;    ///< 近 7 天作答次数
+    const int32_t* recentCorrect;     ///< 近 7 天答对次数
+    const long long* lastTimestamp;   ///< 最近作答时间戳（0 表示从未作答）
+    const int32_t* difficulty;        ///< 难度（1~5）
+    size_t n;                         ///< 题目数
+};
+
+/**
+ * @brief 按给定评分策略批量计算推荐评分（与 scoreWithPolicy 逐题计算的结果一致）
+ *
+ * 各实现按与 scoreWithPolicy() 相同的顺序执行相同的双精度运算
+ * （不使用 FMA），因此结果逐位相同；--bench-scores 会核对这一点。
+ * 策略参数每批只读取一次并广播到向量寄存器。
+ *
+ * @param cols 输入列
+ * @param weights 评分策略参数（policyWeights<Policy>()，horizonDays 不超过 kMaxHorizonDays）
+ * @param now 当前时间戳（秒）
+ * @param out 输出评分数组（长度 cols.n）
+ * @complexity O(n)
+ */
+void kernelRecommendScores(const RecommendScoreColumns& cols, const ScoreWeights& weights, long long now,
+                           double* out);
+
+/**
+ * @brief 单精度点积 Σ a[i] × b[i]
+ *
+ * 各实现的求和顺序相同：按 8 个通道分别累加（先乘后加，不使用 FMA），再以固定顺序两两归并，
+ * 最后依次加上不足 8 个的尾部，因此标量与向量实现的结果逐位相同。
+ * 用于潜因子模型（MatrixFactorization.h）的预测。
+ *
+ * @param a 向量
+ * @param b 向量
+ * @param n 长度
+ * @return 点积
+ * @complexity O(n)
+ */
+float kernelDotF32(const float* a, const float* b, size_t n);
+
+/**
+ * @brief 一个向量与多行的点积：out[r] = rows[r × n .. r × n + n) · v（每行与 kernelDotF32 结果相同）
+ * @param rows 行优先存放的 count 行，每行 n 个元素
+ * @param count 行数
+ * @param n 每行长度
+ * @param v 向量（长度 n）
+ * @param out 输出（长度 count）
+ * @complexity O(count × n)
+ */
+void kernelDotRowsF32(const float* rows, size_t count, size_t n, const float* v, float* out);
+
+/**
+ * @brief 累加加权正规方程：对每个观测 e，z = rows + index[e] × n，
+ *        gram[r × n + c] += (weight[e] × z[r]) × z[c]，rhs[r] += target[e] × z[r]
+ *
+ * 每项都是先乘后加的逐元素运算，与通道宽度无关，各实现逐位相同。
+ * 潜因子模型训练时每解一行调用一次（MatrixFactorization.cpp）。
+ *
+ * @param rows 行优先存放的行，每行 n 个元素
+ * @param n 每行长度
+ * @param index 观测对应的行号
+ * @param weight 观测权重
+ * @param target 观测的加权目标
+ * @param count 观测数
+ * @param gram 被累加的 n × n 矩阵
+ * @param rhs 被累加的 n 维向量
+ * @complexity O(count × n²)
+ */
+void kernelGramAccumulateF32(const float* rows, size_t n, const int32_t* index, const float* weight,
+                             const float* target, size_t count, float* gram, float* rhs);
@@ -4,9 +4,22 @@
  *
  * 实现知识点依赖关系的加载、存储和复习路径推荐功能。
  * 核心算法：基于 DFS 的拓扑排序，时间复杂度 O(V+E)。
+ *
+ * 实现要点：
+ * 1. **编译**：加载完成后把按名称存储的邻接表编译为 KnowledgeGraphIndex：名称排序后编号，
+ *    正向边按各知识点的前置列表顺序写入 CSR，反向边由计数排序得到（每段内后续知识点编号升序）
+ * 2. **路径查询**：DFS 只读 CSR 的整数段与 NodeBitset，名称只在入口查一次编号、在输出时取一次
+ * 3. **展示顺序**：掌握情况列表按编号（即名称）遍历后再按掌握概率稳定排序，同分知识点的顺序每次相同
+ * 4. **迭代遍历**：DFS 与 Tarjan 都以 (节点, 前置段游标) 为栈帧的显式栈模拟递归，栈在堆上，深度只受内存限制
+ * 5. **环检测**：Tarjan 每个节点入栈、出栈各一次，每条边看一次，O(V + E)；加载时报告，最多列出
+ *    kCycleReportLimit 处、每处 kCycleMemberLimit 个知识点，其余只给数量
  */
 
 #include "KnowledgeGraph.h"
+#include "KnowledgeMastery.h"
+#include "KnowledgeTracing.h"
+#include "Question.h"
+#include "Recommender.h"
 #include "Stats.h"
 #include "Utils.h"
 #include <iostream>
@@ -32,6 +45,147 @@ std::unordered_map<std::string, std::vector<std::string>> g_knowledgePrereq;
  */
 std::unordered_set<std::string> g_allKnowledgeNodes;
 
+/**
+ * @brief 编译后的知识点依赖图
+ */
+KnowledgeGraphIndex g_knowledgeGraph;
+
+/**
+ * @brief 编译依赖图
+ *
+ * 1. 名称排序后编号 0 ~ V-1（只作为前置出现的知识点也有编号）
+ * 2. 正向边：按编号顺序写出各知识点的前置列表，prereqOffset_[v] 为第 v 段起点
+ * 3. 反向边：先统计每个前置知识点的后续数得到偏移，再按编号顺序回填，段内自然升序
+ */
+void KnowledgeGraphIndex::build(const std::unordered_map<std::string, std::vector<std::string>>& prereq,
+                                const std::unordered_set<std::string>& nodes) {
+    names_.assign(nodes.begin(), nodes.end());
+    std::sort(names_.begin(), names_.end());
+    size_t V = names_.size();
+    idByName_.clear();
+    idByName_.reserve(V);
+    for (size_t v = 0; v < V; ++v) idByName_.emplace(names_[v], (int)v);
+
+    prereqOffset_.assign(V + 1, 0);
+    prereqs_.clear();
+    for (size_t v = 0; v < V; ++v) {
+        prereqOffset_[v] = (uint32_t)prereqs_.size();
+        auto it = prereq.find(names_[v]);
+        if (it == prereq.end()) continue;
+        for (const std::string& p : it->second) {
+            int pv = id(p);
+            if (pv >= 0) prereqs_.push_back(pv);
+        }
+    }
+    prereqOffset_[V] = (uint32_t)prereqs_.size();
+
+    dependentOffset_.assign(V + 1, 0);
+    for (int p : prereqs_) ++dependentOffset_[(size_t)p + 1];
+    for (size_t v = 0; v < V; ++v) dependentOffset_[v + 1] += dependentOffset_[v];
+    dependents_.assign(prereqs_.size(), 0);
+    std::vector<uint32_t> fill(dependentOffset_.begin(), dependentOffset_.end() - 1);
+    for (size_t v = 0; v < V; ++v) {
+        for (uint32_t e = prereqOffset_[v]; e < prereqOffset_[v + 1]; ++e) {
+            dependents_[fill[(size_t)prereqs_[e]]++] = (int)v;
+        }
+    }
+}
+
+void compileKnowledgeGraph() {
+    g_knowledgeGraph.build(g_knowledgePrereq, g_allKnowledgeNodes);
+}
+
+namespace {
+
+/// 加载时最多列出的循环依赖处数
+constexpr size_t kCycleReportLimit = 10;
+
+/// 每处循环依赖最多列出的知识点数
+constexpr size_t kCycleMemberLimit = 20;
+
+/// 迭代 DFS 的栈帧：节点与其前置段中下一条待看的边
+struct DfsFrame {
+    int node;
+    const int* next;
+    const int* end;
+};
+
+} // namespace
+
+/**
+ * @brief Tarjan 强连通分量（迭代实现）
+ *
+ * 1. 未编号的节点作为根压栈：index = lowlink = 计数器，同时压入分量栈
+ * 2. 栈顶还有前置边 v -> w：w 未编号则压栈；w 在分量栈上则 lowlink[v] = min(lowlink[v], index[w])
+ * 3. 栈顶前置边看完：lowlink[v] == index[v] 时弹出分量栈直到 v，得到一个分量；
+ *    v 出栈后用 lowlink[v] 更新新栈顶的 lowlink（对应递归返回）
+ */
+std::vector<std::vector<int>> findKnowledgeCycles(const KnowledgeGraphIndex& graph) {
+    size_t V = graph.size();
+    std::vector<int> index(V, -1);
+    std::vector<int> lowlink(V, 0);
+    NodeBitset onStack;
+    onStack.resize(V);
+    std::vector<int> component;              // Tarjan 分量栈
+    std::vector<DfsFrame> frames;            // 显式 DFS 调用栈
+    std::vector<std::vector<int>> cycles;
+    int counter = 0;
+
+    auto push = [&](int v) {
+        index[(size_t)v] = lowlink[(size_t)v] = counter++;
+        component.push_back(v);
+        onStack.set(v);
+        frames.push_back({v, graph.prereqBegin(v), graph.prereqEnd(v)});
+    };
+
+    for (size_t root = 0; root < V; ++root) {
+        if (index[root] >= 0) continue;
+        push((int)root);
+        while (!frames.empty()) {
+            DfsFrame& f = frames.back();
+            int v = f.node;
+            if (f.next != f.end) {
+                int w = *f.next++;
+                if (index[(size_t)w] < 0) {
+                    push(w);   // f 在此之后可能失效，本轮不再使用
+                } else if (onStack.test(w)) {
+                    lowlink[(size_t)v] = std::min(lowlink[(size_t)v], index[(size_t)w]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            if (!frames.empty()) {
+                int u = frames.back().node;
+                lowlink[(size_t)u] = std::min(lowlink[(size_t)u], lowlink[(size_t)v]);
+            }
+            if (lowlink[(size_t)v] != index[(size_t)v]) continue;
+
+            // v 是分量的根：分量栈中 v 及其上方的节点构成一个强连通分量
+            size_t begin = component.size();
+            do {
+                --begin;
+                onStack.reset(component[begin]);
+            } while (component[begin] != v);
+
+            bool cyclic = component.size() - begin > 1;
+            if (!cyclic) {
+                cyclic = std::find(graph.prereqBegin(v), graph.prereqEnd(v), v) != graph.prereqEnd(v);
+            }
+            if (cyclic) {
+                std::vector<int> members(component.begin() + (std::ptrdiff_t)begin, component.end());
+                std::sort(members.begin(), members.end());
+                cycles.push_back(std::move(members));
+            }
+            component.resize(begin);
+        }
+    }
+
+    std::sort(cycles.begin(), cycles.end(),
+              [](const std::vector<int>& a, const std::vector<int>& b) { return a.front() < b.front(); });
+    return cycles;
+}
+
 /**
  * @brief 从文件加载知识点依赖图
  *
@@ -151,6 +305,31 @@ bool loadKnowledgeGraphFromFile(const std::string& filename) {
         g_knowledgePrereq[currentKnowledge] = prereqs;
     }
 
+    // 编译为整数编号 + CSR，之后的图算法不再哈希字符串
+    compileKnowledgeGraph();
+
+    // 环检测：列出每处循环依赖的成员知识点（加载照常完成，复习路径会在环上任意断开）
+    std::vector<std::vector<int>> cycles = findKnowledgeCycles(g_knowledgeGraph);
+    if (!cycles.empty()) {
+        std::cout << "警告：知识点依赖图中存在 " << cycles.size() << " 处循环依赖，请检查 " << filename << "：\n";
+        for (size_t c = 0; c < cycles.size() && c < kCycleReportLimit; ++c) {
+            const std::vector<int>& members = cycles[c];
+            std::cout << "  " << (c + 1) << ". ";
+            for (size_t i = 0; i < members.size() && i < kCycleMemberLimit; ++i) {
+                std::cout << (i ? "、" : "") << g_knowledgeGraph.name(members[i]);
+            }
+            if (members.size() > kCycleMemberLimit) std::cout << " 等";
+            std::cout << "（" << members.size() << " 个知识点）\n";
+        }
+        if (cycles.size() > kCycleReportLimit) {
+            std::cout << "  ……另有 " << (cycles.size() - kCycleReportLimit) << " 处未列出\n";
+        }
+    }
+
+    // 依赖图已变化：知识点掌握度的拓扑序与传播结果下次查询时重建，缓存的推荐结果作废
+    g_knowledgeMastery.invalidate();
+    g_recommendCache.invalidate();
+
     // 输出加载统计信息
     std::cout << "知识点依赖图加载完成，共 " << g_allKnowledgeNodes.size() << " 个知识点。\n";
     return true;
@@ -163,10 +342,10 @@ bool loadKnowledgeGraphFromFile(const std::string& filename) {
  * 算法核心：后序遍历的 DFS 拓扑排序
  *
  * 遍历顺序（关键步骤）：
- * 1. 【防环剪枝】检查节点是否已访问，若已访问则直接返回
- * 2. 【标记访问】将当前节点标记为已访问（visited.insert）
- * 3. 【递归前置】遍历当前节点的所有前置依赖，递归调用 DFS
- * 4. 【后序加入】所有前置依赖处理完后，将当前节点加入路径末尾
+ * 1. 【防环剪枝】检查节点是否已访问（位图测试），若已访问则跳过
+ * 2. 【标记访问】将当前节点标记为已访问（visited.set），压入显式栈
+ * 3. 【深入前置】栈顶沿 CSR 前置段的游标取下一个前置，未访问则压栈（对应递归调用）
+ * 4. 【后序加入】栈顶前置段走完后出栈，将该节点加入路径末尾（对应递归返回）
  *
  * 拓扑顺序保证：
  * - 采用后序遍历（post-order traversal）方式
@@ -176,8 +355,8 @@ bool loadKnowledgeGraphFromFile(const std::string& filename) {
  *
  * visited 防环机制：
  * - visited 记录已处理的节点，避免重复访问
- * - 防止图中存在环时导致无限递归（虽然应该是 DAG）
- * - 提高效率：已访问节点不再重复处理，O(1) 判断
+ * - 图中存在环时不会无限循环（环由加载时的 findKnowledgeCycles 报告）
+ * - 提高效率：已访问节点不再重复处理，一次移位与按位与即可判断，不哈希字符串
  *
  * 示例执行流程：
  * @code
@@ -190,57 +369,62 @@ bool loadKnowledgeGraphFromFile(const std::string& filename) {
  *
  * // 执行过程：
  * // 1. 访问"图"，标记已访问
- * // 2. 递归访问"队列"
+ * // 2. 压栈"队列"
  * //    2.1. 访问"队列"，标记已访问
- * //    2.2. 递归访问"基本语法"
+ * //    2.2. 压栈"基本语法"
  * //         2.2.1. 访问"基本语法"，无前置依赖
- * //         2.2.2. 加入 path: ["基本语法"]
- * //    2.3. 加入 path: ["基本语法", "队列"]
- * // 3. 递归访问"栈"
+ * //         2.2.2. 出栈，加入 path: ["基本语法"]
+ * //    2.3. 出栈，加入 path: ["基本语法", "队列"]
+ * // 3. 压栈"栈"
  * //    3.1. 访问"栈"，标记已访问
- * //    3.2. 递归访问"基本语法"（已访问，直接返回）
+ * //    3.2. 前置"基本语法"已访问，跳过
  * //    3.3. 加入 path: ["基本语法", "队列", "栈"]
  * // 4. 加入 path: ["基本语法", "队列", "栈", "图"]
  * @endcode
  *
- * @param node 当前访问的知识点名称
- * @param visited 已访问节点集合（防环 + 去重）
- * @param path 生成的复习路径序列（按拓扑顺序排列）
+ * @param node 当前访问的知识点编号
+ * @param visited 已访问节点位图（防环 + 去重）
+ * @param path 生成的复习路径序列（知识点编号，按拓扑顺序排列）
  *
  * @note 时间复杂度：O(V + E)
  *       - 每个节点最多访问一次：O(V)
  *       - 每条边最多遍历一次：O(E)
- *       - visited 集合查询和插入：O(1)
+ *       - visited 位图测试和标记：O(1)
  * @note 空间复杂度：O(V)
- *       - visited 集合大小：O(V)
- *       - 递归栈最大深度：O(V)（最坏情况为链式依赖）
+ *       - visited 位图大小：V / 8 字节
+ *       - 显式栈最大深度：O(V)（最坏情况为链式依赖），在堆上，不占调用栈
  *       - path 数组大小：O(V)
  *
- * @warning 输入图必须是 DAG（有向无环图），否则可能栈溢出
  * @warning 调用前需要确保 visited 和 path 已初始化为空
  *
- * @see g_knowledgePrereq 依赖关系邻接表
+ * @see g_knowledgeGraph 编译后的依赖图（CSR）
  */
-void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& visited, std::vector<std::string>& path) {
+void dfsReviewPath(int node, NodeBitset& visited, std::vector<int>& path) {
     // 【防环剪枝】如果节点已访问，直接返回（避免重复处理和环路）
-    if (visited.count(node)) return;
-
-    // 【标记访问】将当前节点标记为已访问
-    visited.insert(node);
-
-    // 【递归前置】先访问所有前置知识点（保证前置依赖优先入队）
-    auto it = g_knowledgePrereq.find(node);
-    if (it != g_knowledgePrereq.end()) {
-        // 遍历当前知识点的所有前置依赖
-        for (const std::string& prereq : it->second) {
-            // 递归处理每个前置知识点
-            dfsReviewPath(prereq, visited, path);
+    if (visited.test(node)) return;
+
+    // 【标记访问】将起点标记为已访问并压栈
+    std::vector<DfsFrame> frames;
+    visited.set(node);
+    frames.push_back({node, g_knowledgeGraph.prereqBegin(node), g_knowledgeGraph.prereqEnd(node)});
+
+    while (!frames.empty()) {
+        DfsFrame& f = frames.back();
+        if (f.next != f.end) {
+            // 【深入前置】取栈顶的下一个前置知识点，未访问则标记并压栈（保证前置依赖优先入队）
+            int p = *f.next++;
+            if (!visited.test(p)) {
+                visited.set(p);
+                frames.push_back({p, g_knowledgeGraph.prereqBegin(p), g_knowledgeGraph.prereqEnd(p)});
+            }
+            continue;
         }
-    }
 
-    // 【后序加入】所有前置依赖处理完毕后，将当前节点加入路径
-    // 这是拓扑排序的关键：保证节点在其所有依赖之后
-    path.push_back(node);
+        // 【后序加入】所有前置依赖处理完毕后，将当前节点加入路径
+        // 这是拓扑排序的关键：保证节点在其所有依赖之后
+        path.push_back(f.node);
+        frames.pop_back();
+    }
 }
 
 /**
@@ -253,18 +437,19 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  * 功能流程（6 个步骤）：
  *
  * 【步骤 1】检查依赖图加载状态
- * - 若未加载（g_allKnowledgeNodes 为空），输出错误提示并返回
+ * - 若未加载（g_knowledgeGraph 为空），输出错误提示并返回
  * - 确保后续步骤有数据可用
  *
  * 【步骤 2】统计知识点掌握情况
  * - 调用 buildKnowledgeStats() 获取每个知识点的答题统计
  * - 统计数据包括：总题数、正确数、正确率
  * - 对未练习的知识点设置正确率为 0.0%
+ * - 读取知识追踪的掌握概率（KnowledgeTracing.h）；只在依赖图中出现、没有题目的知识点取默认先验
  *
  * 【步骤 3】排序并显示掌握情况
- * - 按正确率从低到高排序（薄弱知识点优先显示）
- * - 排序依据：正确率越低，越需要复习
- * - 显示格式：编号 + 知识点名 + 题数 + 正确数 + 正确率
+ * - 按掌握概率从低到高排序（薄弱知识点优先显示）
+ * - 排序依据：掌握概率同时反映近期进步与作答次数，比全部历史的正确率更能说明当前是否需要复习
+ * - 显示格式：编号 + 知识点名 + 题数 + 正确数 + 正确率 + 掌握概率
  * - 标注未练习的知识点
  *
  * 【步骤 4】用户选择目标知识点
@@ -273,7 +458,7 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  * - 非法输入直接返回
  *
  * 【步骤 5】生成复习路径（核心算法）
- * - 使用 DFS 拓扑排序生成路径
+ * - 在编译后的图上以 DFS 拓扑排序生成路径（知识点编号 + 访问位图）
  * - 路径包含目标知识点及其所有直接/间接前置依赖
  * - 保证学习顺序符合依赖关系
  *
@@ -281,9 +466,11 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  * - 按拓扑顺序显示复习路径
  * - 结合统计标注每个知识点的掌握程度：
  *   1. 未练习：题数为 0，标记"⚠ 需要学习"
- *   2. 薄弱环节：正确率 < 60% 且题数 > 0，标记"⚠ 薄弱环节"
- *   3. 掌握良好：正确率 >= 60%，无特殊标记
+ *   2. 薄弱环节：掌握概率 < kWeakMasteryProbability 且题数 > 0，标记"⚠ 薄弱环节"
+ *   3. 已掌握：掌握概率 >= kMasteredProbability，标记"✓ 已掌握"
+ *   4. 其余：无特殊标记
  * - 使用箭头 "→" 指示学习路径方向
+ * - 由反向边列出以目标知识点为前置的后续知识点，提示掌握后可以继续学习的内容
  * - 给出复习建议
  *
  * 统计标注逻辑：
@@ -291,11 +478,11 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  * if (total == 0) {
  *     // 未练习，需要从头学习
  *     标记为 "⚠ 需要学习"
- * } else if (accuracy < 60.0) {
+ * } else if (mastery < kWeakMasteryProbability) {
  *     // 练习过但掌握不好，是薄弱环节
  *     标记为 "⚠ 薄弱环节"
- * } else {
- *     // 掌握良好，无特殊标记
+ * } else if (mastery >= kMasteredProbability) {
+ *     标记为 "✓ 已掌握"
  * }
  * @endcode
  *
@@ -304,10 +491,10 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  * ========== 知识点复习路径推荐 ==========
  *
  * ===== 当前知识点掌握情况 =====
- * 1. [队列]  题数: 5  正确: 2  正确率: 40.0%
- * 2. [图]  题数: 3  正确: 1  正确率: 33.3%
- * 3. [栈]  题数: 0  正确: 0  正确率: 0.0% (未练习)
- * 4. [基本语法]  题数: 10  正确: 8  正确率: 80.0%
+ * 1. [图]  题数: 3  正确: 1  正确率: 33.3%  掌握概率: 18.2%
+ * 2. [栈]  题数: 0  正确: 0  正确率: 0.0%  掌握概率: 30.0% (未练习)
+ * 3. [队列]  题数: 5  正确: 2  正确率: 40.0%  掌握概率: 46.5%
+ * 4. [基本语法]  题数: 10  正确: 8  正确率: 80.0%  掌握概率: 97.1%
  *
  * 请输入要复习的知识点编号（1-4）：2
  *
@@ -316,10 +503,10 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  *
  * 建议按以下顺序复习：
  *
- * 1. 基本语法  [题数: 10, 正确率: 80.0%] →
- * 2. 队列  [题数: 5, 正确率: 40.0%] ⚠ 薄弱环节 →
+ * 1. 基本语法  [题数: 10, 正确率: 80.0%, 掌握概率: 97.1%] ✓ 已掌握 →
+ * 2. 队列  [题数: 5, 正确率: 40.0%, 掌握概率: 46.5%] ⚠ 薄弱环节 →
  * 3. 栈  [未练习] ⚠ 需要学习 →
- * 4. 图  [题数: 3, 正确率: 33.3%] ⚠ 薄弱环节
+ * 4. 图  [题数: 3, 正确率: 33.3%, 掌握概率: 18.2%] ⚠ 薄弱环节
  *
  * 建议：先巩固前置知识点，再学习后续内容，效果更佳！
  * @endcode
@@ -336,9 +523,9 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  *       - E: 依赖边数量
  *       - 瓶颈在排序和 DFS
  * @note 空间复杂度：O(V)
- *       - 统计数组、visited 集合、path 数组均为 O(V)
+ *       - 统计数组、path 数组均为 O(V)，visited 位图 V / 8 字节
  * @note 交互式函数，需要用户输入
- * @note 依赖 Stats 模块的 buildKnowledgeStats() 函数
+ * @note 依赖 Stats 模块的 buildKnowledgeStats() 函数与 KnowledgeTracing 模块的掌握概率
  *
  * @warning 如果知识点依赖图未加载，会提示错误并返回
  * @warning 如果用户输入无效编号，会提示错误并返回
@@ -349,7 +536,7 @@ void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& vis
  */
 void recommendReviewPath() {
     // 【步骤 1】检查依赖图是否已加载
-    if (g_allKnowledgeNodes.empty()) {
+    if (g_knowledgeGraph.size() == 0) {
         std::cout << "知识点依赖图未加载，无法提供复习路径推荐。\n";
         std::cout << "请确保 data/knowledge_graph.txt 文件存在。\n";
         pauseForUser();
@@ -366,23 +553,32 @@ void recommendReviewPath() {
     // 【步骤 3】排序并显示掌握情况
 
     // 定义临时结构体用于排序
-    // 包含知识点的统计信息：名称、总题数、正确数、正确率
+    // 包含知识点的统计信息：名称、总题数、正确数、正确率、掌握概率
     struct KnowledgeItem {
         std::string name;      // 知识点名称
         int total;             // 总答题数
         int correct;           // 正确答题数
         double accuracy;       // 正确率（百分比）
+        double mastery;        // 掌握概率（BKT，0~1）
 
         // 重载 < 运算符，用于排序
-        // 按正确率从低到高排序（掌握最弱的在前，优先推荐复习）
+        // 按掌握概率从低到高排序（掌握最弱的在前，优先推荐复习）
         bool operator<(const KnowledgeItem& other) const {
-            return accuracy < other.accuracy;
+            return mastery < other.mastery;
         }
     };
 
-    // 构建知识点统计列表
+    // 知识点的掌握概率：题库中没有该知识点时取默认先验
+    auto masteryOf = [](const std::string& kd) {
+        auto itK = g_knowledgeIdByName.find(kd);
+        return itK != g_knowledgeIdByName.end() ? knowledgeMasteryProbability(itK->second) : BktParams().prior;
+    };
+
+    // 构建知识点统计列表（按编号即名称顺序，排序稳定，同分知识点顺序固定）
     std::vector<KnowledgeItem> items;
-    for (const std::string& kd : g_allKnowledgeNodes) {
+    items.reserve(g_knowledgeGraph.size());
+    for (size_t v = 0; v < g_knowledgeGraph.size(); ++v) {
+        const std::string& kd = g_knowledgeGraph.name((int)v);
         KnowledgeItem item;
         item.name = kd;
 
@@ -397,32 +593,20 @@ void recommendReviewPath() {
             item.correct = 0;
             item.accuracy = 0.0;
         }
+        item.mastery = masteryOf(kd);
         items.push_back(item);
     }
 
-    // // 按正确率从低到高排序（O(V log V)）
-    // std::sort(items.begin(), items.end());
-
-    // --- 优化版冒泡排序 ---
-    for (size_t i = 0; i < items.size() - 1; ++i) {
-        bool swapFlag = false; // 优化：标志位，记录这一轮是否发生过交换
-        for (size_t j = 0; j < items.size() - 1 - i; ++j) {
-            // 如果后一个比前一个“小”（即正确率更低），则交换
-            if (items[j + 1] < items[j]) {
-                std::swap(items[j], items[j + 1]);
-                swapFlag = true;
-            }
-        }
-        // 如果这一轮一次交换都没发生，说明已经排好序了，直接跳出
-        if (!swapFlag) break;
-    }
+    // 按掌握概率从低到高排序（O(V log V)）；稳定排序，同分知识点保持名称顺序
+    std::stable_sort(items.begin(), items.end());
 
-        // 显示知识点掌握情况列表
+    // 显示知识点掌握情况列表
     for (size_t i = 0; i < items.size(); ++i) {
         std::cout << (i + 1) << ". [" << items[i].name << "]  "
              << "题数: " << items[i].total
              << "  正确: " << items[i].correct
-             << "  正确率: " << items[i].accuracy << "%";
+             << "  正确率: " << items[i].accuracy << "%"
+             << "  掌握概率: " << items[i].mastery * 100.0 << "%";
         // 标注未练习的知识点
         if (items[i].total == 0) {
             std::cout << " (未练习)";
@@ -456,9 +640,11 @@ void recommendReviewPath() {
     std::string targetKnowledge = items[choice - 1].name;
 
     // 【步骤 5】生成复习路径（DFS 拓扑排序，O(V+E)）
-    std::unordered_set<std::string> visited;  // 已访问节点集合
-    std::vector<std::string> path;            // 复习路径序列
-    dfsReviewPath(targetKnowledge, visited, path);
+    int target = g_knowledgeGraph.id(targetKnowledge);
+    NodeBitset visited;                       // 已访问节点位图
+    visited.resize(g_knowledgeGraph.size());
+    std::vector<int> path;                    // 复习路径序列（知识点编号）
+    dfsReviewPath(target, visited, path);
 
     // 【步骤 6】显示复习路径并标注薄弱环节
     std::cout << "\n========== 推荐复习路径 ==========\n";
@@ -474,18 +660,22 @@ void recommendReviewPath() {
 
     // 遍历路径，显示每个知识点及其掌握情况
     for (size_t i = 0; i < path.size(); ++i) {
-        const std::string& kd = path[i];
+        const std::string& kd = g_knowledgeGraph.name(path[i]);
         std::cout << (i + 1) << ". " << kd;
 
         // 显示该知识点的掌握情况和标注
         if (knowledgeStats.count(kd)) {
             // 有统计数据：显示题数和正确率
+            double mastery = masteryOf(kd);
             std::cout << "  [题数: " << knowledgeStats[kd].total
-                 << ", 正确率: " << knowledgeStats[kd].accuracy << "%]";
+                 << ", 正确率: " << knowledgeStats[kd].accuracy << "%"
+                 << ", 掌握概率: " << mastery * 100.0 << "%]";
 
-            // 标注薄弱环节：正确率 < 60% 且有答题记录
-            if (knowledgeStats[kd].accuracy < 60.0 && knowledgeStats[kd].total > 0) {
+            // 标注薄弱环节（掌握概率低且有答题记录）与已掌握的知识点
+            if (mastery < kWeakMasteryProbability && knowledgeStats[kd].total > 0) {
                 std::cout << " ⚠ 薄弱环节";
+            } else if (mastery >= kMasteredProbability) {
+                std::cout << " ✓ 已掌握";
             }
         } else {
             // 无统计数据：标注为未练习，需要学习
@@ -499,6 +689,18 @@ void recommendReviewPath() {
         std::cout << "\n";
     }
 
+    // 后续知识点（反向边）：掌握目标知识点后可以继续学习的内容
+    if (g_knowledgeGraph.dependentBegin(target) != g_knowledgeGraph.dependentEnd(target)) {
+        std::cout << "\n掌握后可以继续学习：";
+        int last = -1;
+        for (const int* d = g_knowledgeGraph.dependentBegin(target); d != g_knowledgeGraph.dependentEnd(target); ++d) {
+            if (*d == last) continue;   // 同一行重复列出的前置产生重复的反向边
+            std::cout << (last >= 0 ? "、" : "") << g_knowledgeGraph.name(*d);
+            last = *d;
+        }
+        std::cout << "\n";
+    }
+
     // 给出复习建议
     std::cout << "\n建议：先巩固前置知识点，再学习后续内容，效果更佳！\n";
     std::cout << "====================================\n";
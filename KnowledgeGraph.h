@@ -4,10 +4,27 @@
  *
  * 本模块实现知识点之间的依赖关系图，用于生成科学的复习路径推荐。
  * 采用邻接表存储有向无环图（DAG），支持拓扑排序生成学习顺序。
+ *
+ * 【编译后的图】
+ * 按名称存储的邻接表（g_knowledgePrereq）便于加载与修改，但每走一步都要哈希一次字符串。
+ * 加载完成后再编译出整数表示 g_knowledgeGraph：
+ * - 稠密编号：知识点按名称排序后编号 0 ~ V-1，同一依赖图每次得到相同的编号
+ * - CSR 正向边（知识点 -> 前置知识点，保持文件中的顺序）与反向边（前置知识点 -> 后续知识点，按编号升序）
+ * - 访问标记用位图 NodeBitset，每个节点 1 位
+ * 本模块的图算法（复习路径 DFS、后续知识点查询）都在编译后的图上运行，不再哈希字符串；
+ * 十万级节点的课程体系上单次路径查询为微秒级（DS_AI_Quiz_Bench --bench-graph）。
+ *
+ * 【循环依赖】
+ * 依赖图应为 DAG，但文件是手工维护的，环（A 依赖 B、B 又间接依赖 A）会被 DFS 的访问标记静默掩盖，
+ * 复习路径在环上任意断开。加载时以 Tarjan 算法求强连通分量，含两个以上知识点（或自依赖）的分量
+ * 即一处循环依赖，连同成员知识点一起报告。DFS 与 Tarjan 都用显式栈迭代实现，
+ * 百万级节点的长依赖链也不会耗尽调用栈，时间 O(V + E)。
  */
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -44,6 +61,106 @@ extern std::unordered_map<std::string, std::vector<std::string>> g_knowledgePrer
  */
 extern std::unordered_set<std::string> g_allKnowledgeNodes;
 
+/**
+ * @class NodeBitset
+ * @brief 节点访问标记位图（每个节点 1 位）
+ *
+ * 相比 unordered_set<std::string>：判断与标记都是一次移位与按位运算，十万个节点只占 12.5 KB。
+ * 一次路径查询访问过的节点都在结果路径中，resetAll(path) 只清除这些位，下次查询无需整体清零。
+ */
+class NodeBitset {
+public:
+    /// 调整为 n 个节点并全部清零
+    void resize(size_t n) { words_.assign((n + 63) / 64, 0); }
+
+    bool test(int v) const { return (words_[(size_t)v >> 6] >> (v & 63)) & 1u; }
+    void set(int v) { words_[(size_t)v >> 6] |= (uint64_t)1 << (v & 63); }
+    void reset(int v) { words_[(size_t)v >> 6] &= ~((uint64_t)1 << (v & 63)); }
+
+    /// 清除一组节点的标记，O(ids.size())
+    void resetAll(const std::vector<int>& ids) {
+        for (int v : ids) reset(v);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @class KnowledgeGraphIndex
+ * @brief 编译后的知识点依赖图：稠密编号 + CSR 正向 / 反向边
+ *
+ * 前置知识点 prereqs(v) 为 [prereqBegin(v), prereqEnd(v))，后续知识点 dependents(v) 同理；
+ * 两者都是一段连续的 int 数组，遍历时没有指针追逐与字符串比较。
+ */
+class KnowledgeGraphIndex {
+public:
+    /**
+     * @brief 由按名称存储的邻接表编译
+     * @param prereq 知识点 -> 前置知识点列表
+     * @param nodes 全部知识点（含只作为前置出现的知识点）
+     * @complexity O(V log V + E)
+     */
+    void build(const std::unordered_map<std::string, std::vector<std::string>>& prereq,
+               const std::unordered_set<std::string>& nodes);
+
+    /// 知识点数 V
+    size_t size() const { return names_.size(); }
+
+    /// 依赖边数 E（同一行中重复列出的前置各算一条）
+    size_t edges() const { return prereqs_.size(); }
+
+    /// 知识点编号（不存在时为 -1）
+    int id(const std::string& name) const {
+        auto it = idByName_.find(name);
+        return it == idByName_.end() ? -1 : it->second;
+    }
+
+    /// 编号对应的知识点名称
+    const std::string& name(int v) const { return names_[(size_t)v]; }
+
+    /// 知识点 v 的前置知识点（文件中的顺序）
+    const int* prereqBegin(int v) const { return prereqs_.data() + prereqOffset_[(size_t)v]; }
+    const int* prereqEnd(int v) const { return prereqs_.data() + prereqOffset_[(size_t)v + 1]; }
+
+    /// 以知识点 v 为前置的后续知识点（编号升序）
+    const int* dependentBegin(int v) const { return dependents_.data() + dependentOffset_[(size_t)v]; }
+    const int* dependentEnd(int v) const { return dependents_.data() + dependentOffset_[(size_t)v + 1]; }
+
+private:
+    std::vector<std::string> names_;                  ///< 编号 -> 名称（按名称升序）
+    std::unordered_map<std::string, int> idByName_;   ///< 名称 -> 编号（只在入口查询时使用）
+    std::vector<uint32_t> prereqOffset_;              ///< V + 1 个偏移
+    std::vector<int> prereqs_;                        ///< E 个前置知识点编号
+    std::vector<uint32_t> dependentOffset_;           ///< V + 1 个偏移
+    std::vector<int> dependents_;                     ///< E 个后续知识点编号
+};
+
+/**
+ * @brief 编译后的全局知识点依赖图（loadKnowledgeGraphFromFile 成功后重新编译）
+ */
+extern KnowledgeGraphIndex g_knowledgeGraph;
+
+/**
+ * @brief 求依赖图中的循环依赖（Tarjan 强连通分量）
+ *
+ * 强连通分量内任意两个知识点互相（间接）依赖：含两个以上知识点的分量，或前置列表含自身的单个知识点，
+ * 各是一处循环依赖。迭代实现：DFS 调用栈为 (节点, 前置段游标) 的显式数组，另有 Tarjan 的分量栈，
+ * 节点的 index / lowlink 为整数数组，是否在分量栈上用 NodeBitset。
+ *
+ * @param graph 编译后的依赖图
+ * @return 每处循环依赖的成员知识点编号（组内升序，各组按最小编号升序）；无环时为空
+ * @complexity O(V + E) 时间，O(V) 额外空间
+ */
+std::vector<std::vector<int>> findKnowledgeCycles(const KnowledgeGraphIndex& graph);
+
+/**
+ * @brief 由 g_knowledgePrereq 与 g_allKnowledgeNodes 重新编译 g_knowledgeGraph
+ *
+ * loadKnowledgeGraphFromFile() 结束时调用；直接修改按名称存储的邻接表后也需调用。
+ */
+void compileKnowledgeGraph();
+
 /**
  * @brief 从文件加载知识点依赖图
  *
@@ -71,6 +188,7 @@ extern std::unordered_set<std::string> g_allKnowledgeNodes;
  * 2. 格式错误行：跳过该行，输出行号提示，继续解析
  * 3. 空知识点名：自动跳过
  * 4. 重复定义：后面的定义会覆盖前面的定义
+ * 5. 循环依赖：加载本身不受影响，但会逐处列出环上的知识点（findKnowledgeCycles），提示修改文件
  *
  * 去重策略：
  * - g_allKnowledgeNodes 使用 unordered_set，自动保证知识点唯一性
@@ -98,14 +216,19 @@ bool loadKnowledgeGraphFromFile(const std::string& filename);
  * 保证前置知识点一定排在依赖它的知识点之前。
  *
  * 遍历顺序：
- * 1. 标记当前节点为已访问（防止重复访问和环路）
- * 2. 递归访问所有前置知识点（保证前置依赖先入队）
+ * 1. 在位图中标记当前节点为已访问（防止重复访问和环路）
+ * 2. 依次访问所有前置知识点（保证前置依赖先入队）
  * 3. 将当前节点加入路径末尾（后序遍历）
  *
+ * 迭代实现：
+ * - 显式栈的每一帧为 (节点, 前置段游标)，栈顶游标未到段尾时取下一个前置，未访问则压栈；
+ *   到段尾时节点出栈并加入路径
+ * - 结果与递归写法逐项相同，依赖链再长也只占堆上 O(深度) 的栈帧，不会栈溢出
+ *
  * 防环机制：
- * - visited 集合记录已访问节点，避免重复访问
- * - 对于已访问的节点直接返回（剪枝）
- * - 假设输入图为 DAG（有向无环图），不处理环路检测
+ * - visited 位图记录已访问节点，避免重复访问
+ * - 对于已访问的节点直接跳过（剪枝），环上的节点只访问一次，路径在环上任意断开
+ * - 环本身由加载时的 findKnowledgeCycles() 报告
  *
  * 拓扑顺序保证：
  * 采用后序遍历方式，确保：
@@ -115,25 +238,27 @@ bool loadKnowledgeGraphFromFile(const std::string& filename);
  * 示例：
  * @code
  * // 依赖关系：图 -> 队列,栈 -> 基本语法
- * dfsReviewPath("图", visited, path);
- * // 结果 path = ["基本语法", "队列", "栈", "图"]
+ * NodeBitset visited;
+ * visited.resize(g_knowledgeGraph.size());
+ * std::vector<int> path;
+ * dfsReviewPath(g_knowledgeGraph.id("图"), visited, path);
+ * // 结果 path 依次为"基本语法"、"队列"、"栈"、"图"的编号
+ * visited.resetAll(path);   // 复用位图进行下一次查询
  * @endcode
  *
- * @param node 当前访问的知识点名称
- * @param visited 已访问节点集合（引用传递，避免拷贝开销）
- * @param path 生成的复习路径序列（引用传递，收集结果）
+ * @param node 当前访问的知识点编号（g_knowledgeGraph.id()）
+ * @param visited 已访问节点位图（大小为 g_knowledgeGraph.size()）
+ * @param path 生成的复习路径序列（知识点编号，引用传递，收集结果）
  *
  * @note 时间复杂度：O(V + E)，每个节点和边最多访问一次
- * @note 空间复杂度：O(V)，递归栈深度和 visited 集合大小
- * @note 如果图中存在环，会导致无限递归（实际应用中需要保证 DAG）
+ * @note 空间复杂度：O(V)，显式栈深度；visited 位图 V / 8 字节
  *
- * @warning 输入图必须是有向无环图（DAG），否则可能栈溢出
- * @warning visited 和 path 需要在首次调用前初始化为空
+ * @warning 首次调用前 visited 需 resize(g_knowledgeGraph.size())（全部清零），path 需为空
  *
- * @see g_knowledgePrereq 依赖关系图数据源
+ * @see g_knowledgeGraph 编译后的依赖图（CSR）
  * @see recommendReviewPath 调用此函数生成复习路径
  */
-void dfsReviewPath(const std::string& node, std::unordered_set<std::string>& visited, std::vector<std::string>& path);
+void dfsReviewPath(int node, NodeBitset& visited, std::vector<int>& path);
 
 /**
  * @brief 知识点复习路径推荐（主功能入口）
@@ -0,0 +1,247 @@
+/**
+ * @file KnowledgeMastery.cpp
+ * @brief 知识点掌握度传播模块实现
+ *
+ * 实现要点：
+ * 1. **编号**：题库知识点沿用 g_knowledgeNames 的 ID；依赖图中其余知识点按 g_knowledgeGraph 的编号
+ *    （名称升序）接续编号，保证同一依赖图每次构建得到相同的编号与拓扑序
+ * 2. **依赖边**：直接遍历编译后的 g_knowledgeGraph（整数 CSR），按掌握度编号重排为本模块的 CSR；
+ *    findKnowledgeCycles() 给出的每处循环依赖内部的边丢弃（与加载时报告的环一致），其余边构成无环图
+ * 3. **拓扑序**：Kahn 算法，入度为"以该节点为前置的节点数"，没有后续知识点的节点最先出队
+ * 4. **自身薄弱度**：构建时用 kernelKnowledgeHistogram() 一次统计 g_recordColumns，之后每次作答 O(1) 更新
+ * 5. **增量传播**：脏节点的前置节点进入按拓扑序排列的小根堆，逐个重算；值发生变化才继续推入其前置节点。
+ *    节点的全部来源都排在它之前，因此出堆时来源已是最新值，每个节点每次刷新最多重算一次
+ */
+
+#include "KnowledgeMastery.h"
+#include "KnowledgeGraph.h"
+#include "Kernels.h"
+#include "Question.h"
+#include "Stats.h"
+#include <algorithm>
+
+KnowledgeMastery g_knowledgeMastery;
+
+bool KnowledgeMastery::current() const {
+    return built_ && epoch_ == g_questionStats.epoch && knowledgeCount_ == g_knowledgeNames.size();
+}
+
+namespace {
+
+/// 自身薄弱度：答错数 / (作答数 + 先验)，从未作答为 0
+double ownDeficitOf(int64_t attempts, int64_t correct) {
+    return attempts > 0 ? (double)(attempts - correct) / (double)(attempts + kMasteryPriorAttempts) : 0.0;
+}
+
+} // namespace
+
+void KnowledgeMastery::ownFromCounts(int node) {
+    own_[node] = ownDeficitOf(attempts_[node], correct_[node]);
+}
+
+/**
+ * @brief 由来源节点的当前值计算一个节点的继承薄弱度
+ */
+double KnowledgeMastery::compute(int node, const std::vector<double>& own, const std::vector<double>& inherited) const {
+    double worst = 0.0;
+    for (uint32_t i = dependentOffset_[(size_t)node]; i < dependentOffset_[(size_t)node + 1]; ++i) {
+        int d = dependents_[i];
+        worst = std::max(worst, std::max(own[d], inherited[d]));
+    }
+    return kPrereqDecay * worst;
+}
+
+/**
+ * @brief 整体重建：编号、拓扑排序、统计自身薄弱度并按拓扑序传播一遍
+ *
+ * 依赖边与环都取自编译后的 g_knowledgeGraph（整数 CSR），只在编号映射时按名称查一次题库知识点 ID。
+ */
+void KnowledgeMastery::rebuild() {
+    size_t K = g_knowledgeNames.size();
+    const KnowledgeGraphIndex& graph = g_knowledgeGraph;
+    size_t G = graph.size();
+
+    // 1. 编号：题库知识点沿用已有 ID，其余按依赖图编号（即名称顺序）接续
+    std::vector<int> nodeOf(G);
+    size_t V = K;
+    for (size_t v = 0; v < G; ++v) {
+        auto it = g_knowledgeIdByName.find(graph.name((int)v));
+        nodeOf[v] = it != g_knowledgeIdByName.end() ? it->second : (int)V++;
+    }
+
+    // 2. 循环依赖内部的边不参与传播（环由 findKnowledgeCycles 给出，与加载时报告的一致）；
+    //    去掉这些边后依赖图无环，其余边全部保留
+    std::vector<int> cycleOf(G, -1);
+    std::vector<std::vector<int>> cycles = findKnowledgeCycles(graph);
+    for (size_t c = 0; c < cycles.size(); ++c) {
+        for (int v : cycles[c]) cycleOf[(size_t)v] = (int)c;
+    }
+    auto kept = [&](int v, int p) { return cycleOf[(size_t)v] < 0 || cycleOf[(size_t)v] != cycleOf[(size_t)p]; };
+
+    // 3. CSR：prereqs_ 为传播去向，dependents_ 为传播来源（按掌握度编号）
+    prereqOffset_.assign(V + 1, 0);
+    dependentOffset_.assign(V + 1, 0);
+    for (size_t v = 0; v < G; ++v) {
+        for (const int* it = graph.prereqBegin((int)v); it != graph.prereqEnd((int)v); ++it) {
+            if (!kept((int)v, *it)) continue;
+            ++prereqOffset_[(size_t)nodeOf[v] + 1];
+            ++dependentOffset_[(size_t)nodeOf[(size_t)*it] + 1];
+        }
+    }
+    for (size_t v = 0; v < V; ++v) {
+        prereqOffset_[v + 1] += prereqOffset_[v];
+        dependentOffset_[v + 1] += dependentOffset_[v];
+    }
+    prereqs_.assign(prereqOffset_[V], 0);
+    dependents_.assign(dependentOffset_[V], 0);
+    std::vector<uint32_t> prereqFill(prereqOffset_.begin(), prereqOffset_.end() - 1);
+    std::vector<uint32_t> dependentFill(dependentOffset_.begin(), dependentOffset_.end() - 1);
+    for (size_t v = 0; v < G; ++v) {
+        int d = nodeOf[v];
+        for (const int* it = graph.prereqBegin((int)v); it != graph.prereqEnd((int)v); ++it) {
+            if (!kept((int)v, *it)) continue;
+            int p = nodeOf[(size_t)*it];
+            prereqs_[prereqFill[(size_t)d]++] = p;
+            dependents_[dependentFill[(size_t)p]++] = d;
+        }
+    }
+
+    // 4. 拓扑序（Kahn）：入度为后续知识点数，后续知识点在前；同批节点按编号出队
+    std::vector<uint32_t> indegree(V);
+    for (size_t v = 0; v < V; ++v) indegree[v] = dependentOffset_[v + 1] - dependentOffset_[v];
+    std::vector<int>& order = order_;
+    order.clear();
+    order.reserve(V);
+    for (size_t v = 0; v < V; ++v) {
+        if (indegree[v] == 0) order.push_back((int)v);
+    }
+    for (size_t head = 0; head < order.size(); ++head) {
+        int v = order[head];
+        for (uint32_t i = prereqOffset_[(size_t)v]; i < prereqOffset_[(size_t)v + 1]; ++i) {
+            if (--indegree[(size_t)prereqs_[i]] == 0) order.push_back(prereqs_[i]);
+        }
+    }
+    rank_.assign(V, -1);
+    for (size_t i = 0; i < order.size(); ++i) rank_[(size_t)order[i]] = (int)i;
+
+    // 5. 自身薄弱度
+    KnowledgeHistogram hist;
+    kernelKnowledgeHistogram(g_recordColumns.knowledgeId.data(), g_recordColumns.correct.data(),
+                             g_recordColumns.usedSeconds.data(), g_recordColumns.size(), K, hist);
+    attempts_.assign(V, 0);
+    correct_.assign(V, 0);
+    own_.assign(V, 0.0);
+    for (size_t k = 0; k < K; ++k) {
+        attempts_[k] = hist.total[k];
+        correct_[k] = hist.correct[k];
+        ownFromCounts((int)k);
+    }
+
+    // 6. 按拓扑序传播一遍
+    inherited_.assign(V, 0.0);
+    for (int v : order) inherited_[v] = compute(v, own_, inherited_);
+
+    dirty_.clear();
+    queued_.assign(V, 0);
+    lastRecomputed_ = V;
+    epoch_ = g_questionStats.epoch;
+    knowledgeCount_ = K;
+    built_ = true;
+}
+
+void KnowledgeMastery::refresh() {
+    if (!current()) {
+        rebuild();
+        return;
+    }
+    lastRecomputed_ = 0;
+    if (dirty_.empty()) return;
+
+    // 待重算节点的小根堆（按拓扑序位置）
+    auto later = [this](int a, int b) { return rank_[a] > rank_[b]; };
+    std::vector<int> heap;
+    auto push = [&](int node) {
+        for (uint32_t i = prereqOffset_[(size_t)node]; i < prereqOffset_[(size_t)node + 1]; ++i) {
+            int p = prereqs_[i];
+            if (queued_[p]) continue;
+            queued_[p] = 1;
+            heap.push_back(p);
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+    };
+    for (int k : dirty_) queued_[k] = 0;
+    for (int k : dirty_) push(k);
+    dirty_.clear();
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        int p = heap.back();
+        heap.pop_back();
+        queued_[p] = 0;
+        ++lastRecomputed_;
+
+        double value = compute(p, own_, inherited_);
+        if (value == inherited_[p]) continue;   // 未变化：下游无需重算
+        inherited_[p] = value;
+        push(p);
+    }
+}
+
+void KnowledgeMastery::propagate(const std::vector<int64_t>& attempts, const std::vector<int64_t>& correct,
+                                 std::vector<double>& own, std::vector<double>& inherited) const {
+    size_t V = rank_.size();
+    own.assign(V, 0.0);
+    inherited.assign(V, 0.0);
+    for (size_t k = 0; k < knowledgeCount_ && k < attempts.size() && k < correct.size(); ++k) {
+        own[k] = ownDeficitOf(attempts[k], correct[k]);
+    }
+    for (int v : order_) inherited[v] = compute(v, own, inherited);
+}
+
+double KnowledgeMastery::inherited(int knowledgeId) const {
+    if (knowledgeId < 0 || (size_t)knowledgeId >= inherited_.size()) return 0.0;
+    return inherited_[knowledgeId];
+}
+
+double KnowledgeMastery::ownDeficit(int knowledgeId) const {
+    if (knowledgeId < 0 || (size_t)knowledgeId >= own_.size()) return 0.0;
+    return own_[knowledgeId];
+}
+
+void KnowledgeMastery::apply(int knowledgeId, bool correct) {
+    if (!current() || knowledgeId < 0 || (size_t)knowledgeId >= knowledgeCount_) return;
+    ++attempts_[knowledgeId];
+    if (correct) ++correct_[knowledgeId];
+
+    double old = own_[knowledgeId];
+    ownFromCounts(knowledgeId);
+    if (own_[knowledgeId] != old && !queued_[knowledgeId]) {
+        queued_[knowledgeId] = 1;
+        dirty_.push_back(knowledgeId);
+    }
+}
+
+void applyRecordToMastery(const Record& r) {
+    auto itQ = g_questionById.find(r.questionId);
+    if (itQ == g_questionById.end()) return;
+    g_knowledgeMastery.apply(g_questions[itQ->second].knowledgeId, r.correct);
+}
+
+std::vector<std::string> weakPrerequisites(size_t limit, double minInherited) {
+    g_knowledgeMastery.refresh();
+    std::vector<int> ids;
+    for (size_t k = 0; k < g_knowledgeNames.size(); ++k) {
+        if (g_knowledgeMastery.inherited((int)k) >= minInherited) ids.push_back((int)k);
+    }
+    std::sort(ids.begin(), ids.end(), [](int a, int b) {
+        double ia = g_knowledgeMastery.inherited(a);
+        double ib = g_knowledgeMastery.inherited(b);
+        if (ia != ib) return ia > ib;
+        return a < b;
+    });
+    if (ids.size() > limit) ids.resize(limit);
+
+    std::vector<std::string> names;
+    for (int k : ids) names.push_back(g_knowledgeNames[k]);
+    return names;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file KnowledgeMastery.h
+ * @brief 知识点掌握度传播模块 - 把后续知识点的薄弱程度沿依赖图传给前置知识点
+ *
+ * 【模块职责】
+ * 逐题评分只看题目自身的作答情况。而"二叉树"总是做错的同学，往往真正欠缺的是
+ * 前置的"线性表"或"栈"。本模块在编译后的知识点依赖图（g_knowledgeGraph）上：
+ * - 为每个知识点维护作答次数与答对次数，得到自身薄弱度 own
+ * - 沿依赖边把薄弱度从后续知识点传给前置知识点，每经过一条边衰减一次，得到继承薄弱度 inherited
+ * 推荐流程把 inherited 乘以评分配置的前置补强权重，加到该知识点下每道题的评分上（见 Recommender.h）。
+ *
+ * 【计算规则】
+ * - own[k] = 答错次数 / (作答次数 + kMasteryPriorAttempts)：作答少时向 0 收缩，避免一次失误就大幅传播
+ * - inherited[p] = kPrereqDecay × max{ max(own[d], inherited[d]) : d 以 p 为前置 }
+ * - 没有后续知识点的节点 inherited = 0
+ *
+ * 【拓扑传播】
+ * - 构建时按"后续知识点在前"的拓扑序（Kahn 算法）一遍算出全部 inherited
+ * - 依赖图中若有环（由 findKnowledgeCycles() 给出），同一环内部的边不参与传播，其余边照常传播
+ * - 作答后只把该知识点标记为脏；下次查询时从脏节点出发按拓扑序向前置方向重算，
+ *   值不变的节点不再继续传播，只有真正受影响的下游节点被重算
+ *
+ * 【复杂度】
+ * - 作答后更新：O(1)
+ * - 查询前刷新：O(R log R + R 的入边数)，R 为被重算的节点数（通常远小于知识点总数）
+ * - 重建：O(M + V + E)，M 为记录数，V / E 为依赖图的节点 / 边数
+ *
+ * 【与其他模块依赖】
+ * - KnowledgeGraph.cpp：loadKnowledgeGraphFromFile() 重新加载后调用 invalidate()
+ * - Record.cpp：doQuestion() 作答后调用 applyRecordToMastery()
+ * - Stats.h：QuestionStatTable::epoch 变化（统计整体重建、切换用户）时从 g_recordColumns 重建
+ * - Recommender.cpp：全量评分与增量推荐索引读取 inherited()
+ * - BatchRecommend.cpp：批量推荐按各用户自己的作答次数调用 propagate()，与交互式推荐结果一致
+ */
+
+#pragma once
+
+#include "Record.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// 每经过一条依赖边，薄弱度乘以该系数
+constexpr double kPrereqDecay = 0.5;
+
+/// 自身薄弱度的收缩先验（相当于额外计入几次"答对"）
+constexpr int kMasteryPriorAttempts = 3;
+
+/**
+ * @class KnowledgeMastery
+ * @brief 知识点自身薄弱度 + 沿依赖图传播的继承薄弱度（增量维护）
+ *
+ * 节点编号：题库中出现过的知识点沿用 g_knowledgeNames 的 ID（0 ~ K-1）；
+ * 只在依赖图中出现的知识点在此之后编号（K ~ V-1），它们没有题目，但仍把薄弱度继续传给自己的前置。
+ */
+class KnowledgeMastery {
+public:
+    /**
+     * @brief 使 inherited() 反映全部已作答记录（必要时重建，否则只重算脏节点的下游）
+     * @complexity 见文件说明
+     */
+    void refresh();
+
+    /**
+     * @brief 知识点的继承薄弱度（调用前需 refresh()）
+     * @param knowledgeId 知识点 ID（g_knowledgeNames 下标）
+     * @return [0, kPrereqDecay)；ID 越界或依赖图未加载时为 0
+     */
+    double inherited(int knowledgeId) const;
+
+    /**
+     * @brief 知识点自身的薄弱度
+     * @param knowledgeId 知识点 ID
+     * @return [0, 1)；从未作答为 0
+     */
+    double ownDeficit(int knowledgeId) const;
+
+    /**
+     * @brief 计入一次作答（更新作答次数并把该知识点标记为脏）
+     *
+     * 尚未构建或已过期（epoch 变化）时忽略：下次查询会从 g_recordColumns 重建，其中已包含这条记录。
+     *
+     * @param knowledgeId 知识点 ID（-1 或越界时忽略）
+     * @param correct 是否答对
+     * @complexity O(1)
+     */
+    void apply(int knowledgeId, bool correct);
+
+    /**
+     * @brief 按给定的各知识点作答 / 答对次数计算继承薄弱度，不修改内部状态
+     *
+     * 使用当前依赖图与拓扑序（调用前需 refresh()），计算方式与构建时完全相同，
+     * 只读访问内部状态，可在多个线程中同时调用（批量推荐为每个用户各算一遍）。
+     *
+     * @param attempts 各知识点作答次数（长度为 g_knowledgeNames.size()）
+     * @param correct 各知识点答对次数（同上）
+     * @param own 输出：各节点自身薄弱度（调用方提供的缓冲区，会被重置）
+     * @param inherited 输出：各节点继承薄弱度（同上，下标 0 ~ K-1 为题库知识点）
+     * @complexity O(V + E)
+     */
+    void propagate(const std::vector<int64_t>& attempts, const std::vector<int64_t>& correct,
+                   std::vector<double>& own, std::vector<double>& inherited) const;
+
+    /// 丢弃全部状态，下次查询时重建（依赖图重新加载后调用）
+    void invalidate() { built_ = false; }
+
+    /// 依赖图节点数（含只在依赖图中出现的知识点）
+    size_t nodeCount() const { return own_.size(); }
+
+    /// 最近一次 refresh() 重算的节点数（重建时为全部节点）
+    size_t lastRecomputed() const { return lastRecomputed_; }
+
+private:
+    bool current() const;
+    void rebuild();
+    double compute(int node, const std::vector<double>& own, const std::vector<double>& inherited) const;
+    void ownFromCounts(int node);
+
+    bool built_ = false;
+    uint64_t epoch_ = 0;                      ///< 构建时 g_questionStats.epoch
+    size_t knowledgeCount_ = 0;               ///< 构建时 g_knowledgeNames.size()
+
+    // ---- 依赖图（CSR，已去掉环内部的边） ----
+    std::vector<uint32_t> prereqOffset_;        ///< 节点 v 的前置节点位于 prereqs_[prereqOffset_[v], prereqOffset_[v+1])
+    std::vector<int> prereqs_;                  ///< 前置节点（传播的去向）
+    std::vector<uint32_t> dependentOffset_;     ///< 同上，对应 dependents_
+    std::vector<int> dependents_;               ///< 以该节点为前置的节点（传播的来源）
+    std::vector<int> rank_;                     ///< 节点 -> 拓扑序位置（后续知识点在前）
+    std::vector<int> order_;                    ///< 拓扑序（rank_ 的逆）
+
+    // ---- 掌握度 ----
+    std::vector<int64_t> attempts_;            ///< 作答次数
+    std::vector<int64_t> correct_;             ///< 答对次数
+    std::vector<double> own_;                  ///< 自身薄弱度
+    std::vector<double> inherited_;            ///< 继承薄弱度
+
+    // ---- 增量刷新 ----
+    std::vector<int> dirty_;                   ///< 自身薄弱度已变化、尚未传播的节点
+    std::vector<uint8_t> queued_;              ///< 节点是否已在 dirty_ / 待重算队列中
+    size_t lastRecomputed_ = 0;
+};
+
+/**
+ * @brief 全局知识点掌握度（当前用户，首次查询时构建）
+ */
+extern KnowledgeMastery g_knowledgeMastery;
+
+/**
+ * @brief 把一条新作答记录计入知识点掌握度
+ *
+ * doQuestion() 在 applyRecordToStats() 之后调用。
+ *
+ * @param r 作答记录（题号不在题库中时忽略）
+ * @complexity O(1)
+ */
+void applyRecordToMastery(const Record& r);
+
+/**
+ * @brief 继承薄弱度最高的若干知识点（用于推荐时提示"建议先巩固的前置知识点"）
+ * @param limit 最多返回的个数
+ * @param minInherited 只返回继承薄弱度不低于该值的知识点
+ * @return 知识点名称，继承薄弱度从高到低
+ * @complexity O(K log K)，K 为题库知识点数
+ */
+std::vector<std::string> weakPrerequisites(size_t limit, double minInherited);
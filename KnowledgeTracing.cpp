@@ -0,0 +1,400 @@
+/**
+ * @file KnowledgeTracing.cpp
+ * @brief 知识追踪模块实现
+ *
+ * 实现要点：
+ * 1. **在线更新**：答对时 P(L|对) = P(L)(1-S) / [P(L)(1-S) + (1-P(L))G]，答错同理，
+ *    再计入学习转移 P(L) ← P(L|obs) + (1 - P(L|obs)) T
+ * 2. **重建**：各知识点从 prior 出发，按时间顺序逐条计入 g_recordColumns（已按时间排列时不再排序）
+ * 3. **EM 读取**：每个用户的记录按时间戳稳定排序后再按知识点稳定排序，同一知识点的作答连续存放，
+ *    编码为 知识点 × 2 + 是否答对
+ * 4. **前向-后向**：两状态、只能从"未掌握"转到"已掌握"，每步按归一化常数缩放，
+ *    对数似然为各步归一化常数的对数之和；状态后验与转移期望直接由缩放后的前向 / 后向量相乘得到
+ * 5. **M 步**：prior = E[初始已掌握] / 序列数，learn = E[未掌握→已掌握] / E[未掌握（非末步）]，
+ *    guess = E[未掌握且答对] / E[未掌握]，slip = E[已掌握且答错] / E[已掌握]；分母为 0 时保留原值，
+ *    结果截断到 [kProbFloor, 1 - kProbFloor]，guess / slip 另有上限；作答过少的知识点不更新
+ */
+
+#include "KnowledgeTracing.h"
+#include "Question.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+KnowledgeTracing g_knowledgeTracing;
+std::unordered_map<std::string, BktParams> g_tracingParams;
+
+namespace {
+
+/// 拟合参数的下限（上限为 1 - kProbFloor），避免概率为 0 或 1 后无法再更新
+const double kProbFloor = 1e-3;
+
+/// 收敛阈值：平均每条记录的对数似然增量
+const double kFitTolerance = 1e-7;
+
+const BktParams kDefaultParams;
+
+double clampProb(double v, double hi) {
+    return std::min(std::max(v, kProbFloor), hi);
+}
+
+/// g_tracingParams 中的参数（缺失时为默认值）
+BktParams paramsForName(const std::string& name) {
+    auto it = g_tracingParams.find(name);
+    return it == g_tracingParams.end() ? kDefaultParams : it->second;
+}
+
+} // namespace
+
+double bktPredictCorrect(const BktParams& p, double mastery) {
+    return mastery * (1.0 - p.slip) + (1.0 - mastery) * p.guess;
+}
+
+double bktUpdate(const BktParams& p, double mastery, bool correct) {
+    double learned = correct ? mastery * (1.0 - p.slip) : mastery * p.slip;
+    double unlearned = correct ? (1.0 - mastery) * p.guess : (1.0 - mastery) * (1.0 - p.guess);
+    double posterior = learned / (learned + unlearned);
+    return posterior + (1.0 - posterior) * p.learn;
+}
+
+// ============================================================
+// KnowledgeTracing
+// ============================================================
+
+bool KnowledgeTracing::current() const {
+    return built_ && epoch_ == g_questionStats.epoch && knowledgeCount_ == g_knowledgeNames.size();
+}
+
+void KnowledgeTracing::rebuild() {
+    size_t K = g_knowledgeNames.size();
+    params_.resize(K);
+    mastery_.resize(K);
+    for (size_t k = 0; k < K; ++k) {
+        params_[k] = paramsForName(g_knowledgeNames[k]);
+        mastery_[k] = params_[k].prior;
+    }
+
+    // 按时间顺序计入全部记录（通常加载顺序即时间顺序）
+    const RecordColumns& cols = g_recordColumns;
+    std::vector<size_t> order(cols.size());
+    std::iota(order.begin(), order.end(), (size_t)0);
+    if (!std::is_sorted(cols.timestamp.begin(), cols.timestamp.end())) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return cols.timestamp[a] < cols.timestamp[b]; });
+    }
+    for (size_t i : order) {
+        int kid = cols.knowledgeId[i];
+        if (kid < 0 || (size_t)kid >= K) continue;
+        mastery_[kid] = bktUpdate(params_[kid], mastery_[kid], cols.correct[i] != 0);
+    }
+
+    epoch_ = g_questionStats.epoch;
+    knowledgeCount_ = K;
+    built_ = true;
+}
+
+void KnowledgeTracing::refresh() {
+    if (!current()) rebuild();
+}
+
+double KnowledgeTracing::mastery(int knowledgeId) const {
+    if (knowledgeId < 0 || (size_t)knowledgeId >= mastery_.size()) return 0.0;
+    return mastery_[knowledgeId];
+}
+
+const BktParams& KnowledgeTracing::params(int knowledgeId) const {
+    if (knowledgeId < 0 || (size_t)knowledgeId >= params_.size()) return kDefaultParams;
+    return params_[knowledgeId];
+}
+
+void KnowledgeTracing::apply(int knowledgeId, bool correct) {
+    if (!current() || knowledgeId < 0 || (size_t)knowledgeId >= knowledgeCount_) return;
+    mastery_[knowledgeId] = bktUpdate(params_[knowledgeId], mastery_[knowledgeId], correct);
+}
+
+void applyRecordToTracing(const Record& r) {
+    auto itQ = g_questionById.find(r.questionId);
+    if (itQ == g_questionById.end()) return;
+    g_knowledgeTracing.apply(g_questions[itQ->second].knowledgeId, r.correct);
+}
+
+double knowledgeMasteryProbability(int knowledgeId) {
+    g_knowledgeTracing.refresh();
+    return g_knowledgeTracing.mastery(knowledgeId);
+}
+
+// ============================================================
+// 参数文件
+// ============================================================
+
+bool loadTracingParamsFromFile(const std::string& filename) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    std::unordered_map<std::string, BktParams> loaded;
+    std::string line;
+    while (std::getline(fin, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::string name;
+        std::string field;
+        double v[4];
+        bool ok = (bool)std::getline(ss, name, ',') && !name.empty();
+        for (int i = 0; ok && i < 4; ++i) {
+            ok = (bool)std::getline(ss, field, ',');
+            if (!ok) break;
+            try {
+                v[i] = std::stod(field);
+            } catch (...) {
+                ok = false;
+                break;
+            }
+            ok = v[i] > 0.0 && v[i] < 1.0;
+        }
+        if (!ok) continue;
+        loaded[name] = BktParams{v[0], v[1], v[2], v[3]};
+    }
+    g_tracingParams.swap(loaded);
+    g_knowledgeTracing.invalidate();
+    return true;
+}
+
+bool saveTracingParamsToFile(const std::string& filename, const std::vector<BktParams>& params) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入参数文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz BKT parameters v1\n";
+    fout << "# 知识点,prior,learn,guess,slip\n";
+    fout << std::setprecision(6);
+    for (size_t k = 0; k < params.size() && k < g_knowledgeNames.size(); ++k) {
+        const BktParams& p = params[k];
+        fout << g_knowledgeNames[k] << ',' << p.prior << ',' << p.learn << ',' << p.guess << ',' << p.slip << '\n';
+    }
+    return (bool)fout;
+}
+
+// ============================================================
+// EM 拟合
+// ============================================================
+
+namespace {
+
+/**
+ * @brief 一个用户的观测：同一知识点的作答连续存放、各自按时间排列，编码为 知识点 × 2 + 是否答对
+ */
+struct UserObservations {
+    bool ok = false;
+    std::vector<uint32_t> codes;
+};
+
+/**
+ * @brief 一个知识点的期望计数（E 步输出）
+ */
+struct ExpectedCounts {
+    double sequences = 0.0;       ///< 序列数
+    double initialLearned = 0.0;  ///< Σ P(L1)
+    double transitions = 0.0;     ///< Σ P(未掌握 -> 已掌握)
+    double leaveable = 0.0;       ///< Σ P(未掌握)（不含各序列最后一步）
+    double unlearned = 0.0;       ///< Σ P(未掌握)
+    double guessed = 0.0;         ///< Σ P(未掌握) [答对]
+    double learned = 0.0;         ///< Σ P(已掌握)
+    double slipped = 0.0;         ///< Σ P(已掌握) [答错]
+    double logLikelihood = 0.0;
+
+    void add(const ExpectedCounts& o) {
+        sequences += o.sequences;
+        initialLearned += o.initialLearned;
+        transitions += o.transitions;
+        leaveable += o.leaveable;
+        unlearned += o.unlearned;
+        guessed += o.guessed;
+        learned += o.learned;
+        slipped += o.slipped;
+        logLikelihood += o.logLikelihood;
+    }
+};
+
+/**
+ * @brief 线程私有的前向-后向缓冲区
+ */
+struct ForwardBackwardScratch {
+    std::vector<double> f0;      ///< 缩放后的前向量：未掌握
+    std::vector<double> f1;      ///< 缩放后的前向量：已掌握
+    std::vector<double> scale;   ///< 各步归一化常数
+};
+
+/**
+ * @brief 读取一个用户的记录并整理为按知识点分组的观测
+ */
+void readObservations(const std::filesystem::path& file, UserObservations& out) {
+    std::ifstream fin(file);
+    out.ok = fin.is_open();
+    if (!out.ok) return;
+
+    std::vector<std::pair<long long, uint32_t>> rows;   // (时间戳, 编码)
+    std::string line;
+    Record r;
+    size_t K = g_knowledgeNames.size();
+    while (std::getline(fin, line)) {
+        if (line.empty() || !parseRecordLine(line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end()) continue;
+        int kid = g_questions[itQ->second].knowledgeId;
+        if (kid < 0 || (size_t)kid >= K) continue;
+        rows.push_back({r.timestamp, (uint32_t)kid * 2 + (r.correct ? 1 : 0)});
+    }
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const std::pair<long long, uint32_t>& a, const std::pair<long long, uint32_t>& b) {
+                         return a.first < b.first;
+                     });
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const std::pair<long long, uint32_t>& a, const std::pair<long long, uint32_t>& b) {
+                         return (a.second >> 1) < (b.second >> 1);
+                     });
+    out.codes.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) out.codes[i] = rows[i].second;
+}
+
+/**
+ * @brief 一条序列的前向-后向，把期望计数累加到 acc
+ * @param codes 序列（同一知识点，按时间排列）
+ * @param n 序列长度（>= 1）
+ */
+void forwardBackward(const BktParams& p, const uint32_t* codes, size_t n, ForwardBackwardScratch& s,
+                     ExpectedCounts& acc) {
+    auto emit0 = [&](size_t t) { return (codes[t] & 1) ? p.guess : 1.0 - p.guess; };
+    auto emit1 = [&](size_t t) { return (codes[t] & 1) ? 1.0 - p.slip : p.slip; };
+    s.f0.resize(n);
+    s.f1.resize(n);
+    s.scale.resize(n);
+
+    // 前向
+    double a0 = 1.0 - p.prior;
+    double a1 = p.prior;
+    for (size_t t = 0; t < n; ++t) {
+        double f0 = a0 * emit0(t);
+        double f1 = a1 * emit1(t);
+        double c = f0 + f1;
+        s.f0[t] = f0 / c;
+        s.f1[t] = f1 / c;
+        s.scale[t] = c;
+        acc.logLikelihood += std::log(c);
+        a0 = s.f0[t] * (1.0 - p.learn);
+        a1 = s.f1[t] + s.f0[t] * p.learn;
+    }
+
+    // 后向（b 为缩放后的后向量），同时累加期望计数
+    double b0 = 1.0;
+    double b1 = 1.0;
+    for (size_t t = n; t-- > 0;) {
+        double g0 = s.f0[t] * b0;
+        double g1 = s.f1[t] * b1;
+        double correct = (codes[t] & 1) ? 1.0 : 0.0;
+        acc.unlearned += g0;
+        acc.guessed += g0 * correct;
+        acc.learned += g1;
+        acc.slipped += g1 * (1.0 - correct);
+        if (t == 0) {
+            acc.initialLearned += g1;
+            break;
+        }
+        // t-1 -> t 的转移期望与 t-1 的后向量
+        double e0 = emit0(t);
+        double e1 = emit1(t);
+        double c = s.scale[t];
+        double nb0 = ((1.0 - p.learn) * e0 * b0 + p.learn * e1 * b1) / c;
+        double nb1 = e1 * b1 / c;
+        acc.transitions += s.f0[t - 1] * p.learn * e1 * b1 / c;
+        acc.leaveable += s.f0[t - 1] * nb0;
+        b0 = nb0;
+        b1 = nb1;
+    }
+    acc.sequences += 1.0;
+}
+
+/**
+ * @brief 一块用户的 E 步
+ */
+void expectBlock(const std::vector<UserObservations>& users, size_t begin, size_t end,
+                 const std::vector<BktParams>& params, std::vector<ExpectedCounts>& acc) {
+    thread_local ForwardBackwardScratch s;
+    acc.assign(params.size(), ExpectedCounts());
+    for (size_t u = begin; u < end; ++u) {
+        const std::vector<uint32_t>& codes = users[u].codes;
+        for (size_t i = 0; i < codes.size();) {
+            uint32_t kid = codes[i] >> 1;
+            size_t j = i;
+            while (j < codes.size() && (codes[j] >> 1) == kid) ++j;
+            forwardBackward(params[kid], codes.data() + i, j - i, s, acc[kid]);
+            i = j;
+        }
+    }
+}
+
+/// M 步：由期望计数重新估计参数（分母为 0 的项保留原值）
+BktParams maximize(const ExpectedCounts& e, const BktParams& old) {
+    BktParams p = old;
+    if (e.sequences > 0) p.prior = clampProb(e.initialLearned / e.sequences, 1.0 - kProbFloor);
+    if (e.leaveable > 0) p.learn = clampProb(e.transitions / e.leaveable, 1.0 - kProbFloor);
+    if (e.unlearned > 0) p.guess = clampProb(e.guessed / e.unlearned, kBktMaxGuess);
+    if (e.learned > 0) p.slip = clampProb(e.slipped / e.learned, kBktMaxSlip);
+    return p;
+}
+
+} // namespace
+
+TracingFit fitTracingParams(const std::vector<std::filesystem::path>& files, size_t maxIterations, ThreadPool& pool) {
+    size_t K = g_knowledgeNames.size();
+    TracingFit fit;
+    fit.params.resize(K);
+    fit.observations.assign(K, 0);
+    for (size_t k = 0; k < K; ++k) fit.params[k] = paramsForName(g_knowledgeNames[k]);
+    if (files.empty() || K == 0) return fit;
+
+    // 1. 读取（每个用户一个任务）
+    std::vector<UserObservations> users(files.size());
+    pool.parallelFor(files.size(), [&](size_t u) { readObservations(files[u], users[u]); });
+    for (const UserObservations& u : users) {
+        if (!u.ok) continue;
+        ++fit.users;
+        fit.records += u.codes.size();
+        for (uint32_t code : u.codes) ++fit.observations[code >> 1];
+    }
+    if (fit.records == 0) return fit;
+
+    // 2. EM（分块方式与线程数无关，块结果按编号顺序合并）
+    size_t blocks = (users.size() + kFitBlockUsers - 1) / kFitBlockUsers;
+    std::vector<std::vector<ExpectedCounts>> partial(blocks);
+    double previous = 0.0;
+    for (size_t iter = 0; iter < maxIterations; ++iter) {
+        pool.parallelFor(blocks, [&](size_t b) {
+            expectBlock(users, b * kFitBlockUsers, std::min(users.size(), (b + 1) * kFitBlockUsers), fit.params,
+                        partial[b]);
+        });
+        std::vector<ExpectedCounts> total(K);
+        for (const std::vector<ExpectedCounts>& block : partial) {
+            for (size_t k = 0; k < K; ++k) total[k].add(block[k]);
+        }
+        double logLikelihood = 0.0;
+        for (size_t k = 0; k < K; ++k) {
+            logLikelihood += total[k].logLikelihood;
+            if (fit.observations[k] >= kBktMinObservations) fit.params[k] = maximize(total[k], fit.params[k]);
+        }
+        fit.iterations = iter + 1;
+        fit.logLikelihood = logLikelihood;
+        if (iter > 0 && (logLikelihood - previous) / (double)fit.records < kFitTolerance) {
+            fit.converged = true;
+            break;
+        }
+        previous = logLikelihood;
+    }
+    return fit;
+}
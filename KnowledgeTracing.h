@@ -0,0 +1,219 @@
+/**
+ * @file KnowledgeTracing.h
+ * @brief 知识追踪模块 - 贝叶斯知识追踪（BKT）估计每个知识点的掌握概率
+ *
+ * 【模块职责】
+ * KnowledgeStat::accuracy 是全部历史的答对比例：前 20 次全错、最近 10 次全对的学生仍显示 33%，
+ * 只做过 1 题的知识点则不是 0% 就是 100%。BKT 把"是否已掌握"看作一个隐藏状态：
+ * - P(L0) prior：开始练习前已掌握的概率
+ * - P(T) learn：每次练习后从"未掌握"变为"已掌握"的概率（不考虑遗忘）
+ * - P(G) guess：未掌握时答对的概率（四选一约 0.25）
+ * - P(S) slip：已掌握时答错的概率
+ * 每次作答先按结果用贝叶斯公式求后验，再计入一次学习转移，得到新的掌握概率 P(L)。
+ * 近期的作答影响更大，作答少时停留在先验附近，不会因一次对错大起大落。
+ *
+ * 【参数】
+ * 四个参数按知识点各一组，保存在 data/bkt_params.txt（每行"知识点,prior,learn,guess,slip"），
+ * 启动时加载；缺失的知识点使用 BktParams 的默认值。参数由 fitTracingParams() 从全部用户的记录中
+ * 以 EM（Baum-Welch）估计：每个用户在每个知识点上的作答序列是一条隐马尔可夫链，
+ * E 步前向-后向求各时刻的状态后验，M 步按期望计数重新估计四个参数。
+ * guess / slip 上限为 kBktMaxGuess / kBktMaxSlip，避免"已掌握"与"未掌握"两个状态对调的退化解。
+ *
+ * 【并行 EM】
+ * 用户按编号每 kFitBlockUsers 个分为一块，每块一个任务累加期望计数，块结果按编号顺序合并：
+ * 分块方式与线程数无关，因此拟合结果与线程数无关。
+ *
+ * 【复杂度】
+ * - 作答后更新：O(1)
+ * - 重建（切换用户）：O(M)，M 为记录数（记录未按时间排列时另加 O(M log M)）
+ * - 拟合：每轮 O(A)，A 为全部用户的记录总数
+ *
+ * 【与其他模块依赖】
+ * - Record.cpp：doQuestion() 作答后调用 applyRecordToTracing()
+ * - Stats.h：QuestionStatTable::epoch 变化（统计整体重建、切换用户）时从 g_recordColumns 重建
+ * - KnowledgeGraph.cpp：复习路径推荐按掌握概率排序并标注薄弱环节
+ * - Report.cpp：学习报告输出各知识点的掌握概率
+ * - Recommender.cpp：AI 推荐展示每道推荐题所属知识点的掌握概率
+ * - Cli.cpp：--fit-bkt 拟合参数并写入 data/bkt_params.txt；Bench.cpp：--bench-bkt 核对合成数据上的参数恢复
+ */
+
+#pragma once
+
+#include "Record.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+/// 掌握概率不低于该值视为已掌握（BKT 的常用阈值）
+constexpr double kMasteredProbability = 0.95;
+
+/// 掌握概率低于该值视为薄弱环节
+constexpr double kWeakMasteryProbability = 0.5;
+
+/// 拟合时 guess 的上限
+constexpr double kBktMaxGuess = 0.3;
+
+/// 拟合时 slip 的上限
+constexpr double kBktMaxSlip = 0.3;
+
+/// 作答数少于该值的知识点不参与拟合，保留初始参数（样本太少时 EM 会收敛到 0 / 1 的退化解）
+constexpr size_t kBktMinObservations = 100;
+
+/// 并行 EM 每个任务处理的用户数
+constexpr size_t kFitBlockUsers = 64;
+
+/**
+ * @struct BktParams
+ * @brief 一个知识点的 BKT 参数
+ */
+struct BktParams {
+    double prior = 0.3;   ///< P(L0)：开始练习前已掌握的概率
+    double learn = 0.1;   ///< P(T)：每次练习后学会的概率
+    double guess = 0.2;   ///< P(G)：未掌握时答对的概率
+    double slip = 0.1;    ///< P(S)：已掌握时答错的概率
+};
+
+/**
+ * @brief 预测下一次作答答对的概率
+ * @param p 参数
+ * @param mastery 当前掌握概率 P(L)
+ * @return P(L)(1 - slip) + (1 - P(L)) guess
+ */
+double bktPredictCorrect(const BktParams& p, double mastery);
+
+/**
+ * @brief 计入一次作答后的掌握概率（先求后验，再计入学习转移）
+ * @param p 参数
+ * @param mastery 作答前的掌握概率
+ * @param correct 是否答对
+ * @return 作答后的掌握概率
+ * @complexity O(1)
+ */
+double bktUpdate(const BktParams& p, double mastery, bool correct);
+
+/**
+ * @class KnowledgeTracing
+ * @brief 当前用户各知识点的掌握概率（增量维护）
+ */
+class KnowledgeTracing {
+public:
+    /**
+     * @brief 使 mastery() 反映全部已作答记录（统计表已整体重建或参数变化时重建）
+     * @complexity 已是最新时 O(1)；否则 O(M)
+     */
+    void refresh();
+
+    /**
+     * @brief 知识点的掌握概率（调用前需 refresh()）
+     * @param knowledgeId 知识点 ID（g_knowledgeNames 下标）
+     * @return [0, 1]；从未作答为该知识点的 prior；ID 越界为 0
+     */
+    double mastery(int knowledgeId) const;
+
+    /**
+     * @brief 知识点当前使用的参数（调用前需 refresh()；ID 越界时为默认参数）
+     */
+    const BktParams& params(int knowledgeId) const;
+
+    /**
+     * @brief 计入一次作答
+     *
+     * 尚未构建或已过期时忽略：下次查询会从 g_recordColumns 重建，其中已包含这条记录。
+     *
+     * @param knowledgeId 知识点 ID（-1 或越界时忽略）
+     * @param correct 是否答对
+     * @complexity O(1)
+     */
+    void apply(int knowledgeId, bool correct);
+
+    /// 丢弃全部状态，下次查询时重建（参数重新加载后调用）
+    void invalidate() { built_ = false; }
+
+private:
+    bool current() const;
+    void rebuild();
+
+    bool built_ = false;
+    uint64_t epoch_ = 0;                 ///< 构建时 g_questionStats.epoch
+    size_t knowledgeCount_ = 0;          ///< 构建时 g_knowledgeNames.size()
+    std::vector<BktParams> params_;      ///< 知识点 -> 参数
+    std::vector<double> mastery_;        ///< 知识点 -> 掌握概率
+};
+
+/**
+ * @brief 全局知识追踪状态（当前用户，首次查询时构建）
+ */
+extern KnowledgeTracing g_knowledgeTracing;
+
+/**
+ * @brief 已加载的 BKT 参数（知识点名称 -> 参数；不含的知识点使用默认值）
+ */
+extern std::unordered_map<std::string, BktParams> g_tracingParams;
+
+/**
+ * @brief 把一条新作答记录计入知识追踪
+ *
+ * doQuestion() 在 applyRecordToMastery() 之后调用。
+ *
+ * @param r 作答记录（题号不在题库中时忽略）
+ * @complexity O(1)
+ */
+void applyRecordToTracing(const Record& r);
+
+/**
+ * @brief 知识点的掌握概率（先 refresh()，供展示使用）
+ * @param knowledgeId 知识点 ID
+ */
+double knowledgeMasteryProbability(int knowledgeId);
+
+/**
+ * @brief 从文件加载 BKT 参数（替换 g_tracingParams）
+ *
+ * 每行"知识点,prior,learn,guess,slip"，# 开头的行为注释；数值不在 (0, 1) 内或格式错误的行跳过。
+ *
+ * @param filename 参数文件路径（通常为 data/bkt_params.txt）
+ * @return true 加载成功；false 文件无法打开（g_tracingParams 不变）
+ */
+bool loadTracingParamsFromFile(const std::string& filename);
+
+/**
+ * @brief 把参数写入文件（格式见 loadTracingParamsFromFile）
+ * @param filename 输出文件路径
+ * @param params 按 g_knowledgeNames 下标排列的参数
+ * @return true 写出成功；false 文件无法打开
+ */
+bool saveTracingParamsToFile(const std::string& filename, const std::vector<BktParams>& params);
+
+/**
+ * @struct TracingFit
+ * @brief EM 拟合结果
+ */
+struct TracingFit {
+    std::vector<BktParams> params;       ///< 按 g_knowledgeNames 下标排列（作答过少的知识点为初值）
+    std::vector<size_t> observations;    ///< 各知识点的作答数
+    size_t users = 0;                    ///< 成功读取的用户数
+    size_t records = 0;                  ///< 参与拟合的记录数
+    size_t iterations = 0;               ///< 实际迭代轮数
+    double logLikelihood = 0.0;          ///< 最后一轮 E 步的对数似然
+    bool converged = false;              ///< 是否在达到最大轮数前收敛
+};
+
+/**
+ * @brief 以 EM 从一组用户的记录估计各知识点的 BKT 参数
+ *
+ * 每个用户的记录按时间戳稳定排序后按知识点拆成序列；初值为 g_tracingParams（缺失时为默认值）。
+ * 作答数少于 kBktMinObservations 的知识点保留初值。
+ * 平均每条记录的对数似然增量小于 1e-7 时视为收敛。
+ *
+ * @param files 用户记录文件（每个文件一个用户）
+ * @param maxIterations 最大迭代轮数
+ * @param pool 执行并行任务的线程池
+ * @return 拟合结果（与线程数无关）
+ * @complexity 读取 O(A log A)；每轮 O(A)
+ */
+TracingFit fitTracingParams(const std::vector<std::filesystem::path>& files, size_t maxIterations, ThreadPool& pool);
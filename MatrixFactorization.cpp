@@ -0,0 +1,342 @@
+/**
+ * @file MatrixFactorization.cpp
+ * @brief 潜因子模块实现
+ *
+ * 实现要点：
+ * 1. **一行的求解**：用户步与题目步是同一个加权岭回归。设本行的偏置位为 s、常数位为 c（对方行的
+ *    s 位恰为常数 1、c 位为对方的偏置），未知量为本行的 0..kMfFactors-1 与 s 位，特征取对方行的同样位置，
+ *    目标为 k / n - μ - 对方偏置，权重 n。正规方程 Σ n z zᵀ 与 Σ n t z 由 kernelGramAccumulateF32
+ *    一次累加完整的 16 × 16 矩阵（多出的常数位一行一列不用），取出 15 × 15 子矩阵后加 kMfLambda × Σ n 的对角正则，以双精度 Cholesky 求解
+ * 2. **初值**：题目潜因子取由 (题目下标, 维) 哈希出的 [-0.1, 0.1) 均匀值，偏置为 0，与线程数无关；
+ *    第一轮先解用户行
+ * 3. **分块**：用户与题目各按 kMfBlock 行一块，每块一个任务；每行只由一个任务写入、只读对方的上一步结果，
+ *    加权平方误差按块编号合并，结果与线程数无关
+ * 4. **当前用户**：LatentFactorModel::predictions() 以 g_questionStats 的 (作答次数, 答对次数) 调用 predictUser()，
+ *    由同一个 solveMfUserRow() 折叠出用户行，再用 kernelDotRowsF32 一次为全部题目打分，按统计表 epoch 缓存；
+ *    批量推荐以各用户自己的统计调用 predictUser()，结果与该用户登录后的 predictions() 逐位相同
+ */
+
+#include "MatrixFactorization.h"
+#include "IrtCalibration.h"
+#include "Kernels.h"
+#include "Question.h"
+#include "Recommender.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+LatentFactorModel g_latentFactors;
+
+namespace {
+
+/// 每个并行任务处理的用户数 / 题目数
+const size_t kMfBlock = 256;
+
+/// 每行的未知量个数：潜因子 + 本行偏置
+const size_t kMfUnknowns = kMfFactors + 1;
+
+/// 题目潜因子初值的幅度
+const float kMfInitScale = 0.1f;
+
+/// 题目 j 第 f 维的初值：由 (j, f) 哈希得到的 [-kMfInitScale, kMfInitScale) 均匀值（splitmix64）
+float initialFactor(size_t j, size_t f) {
+    uint64_t x = (uint64_t)j * kMfDim + f + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    double u = (double)(x >> 11) / 9007199254740992.0;   // [0, 1)
+    return (float)((2.0 * u - 1.0) * kMfInitScale);
+}
+
+/**
+ * @brief 固定对方的行，解本行（见实现要点 1）
+ * @param biasSlot 本行偏置的位置（对方行该位置为常数 1）
+ * @param constSlot 本行常数 1 的位置（对方行该位置为对方的偏置）
+ */
+void solveRow(float mean, const float* other, const int32_t* index, const uint32_t* attempts,
+              const uint32_t* correct, size_t count, size_t biasSlot, size_t constSlot, float* row) {
+    // 各观测的权重 n 与加权目标 n × (k / n - μ - 对方偏置)，线程私有、在多行之间复用
+    thread_local std::vector<float> weight;
+    thread_local std::vector<float> target;
+    weight.resize(count);
+    target.resize(count);
+    double totalWeight = 0.0;
+    for (size_t e = 0; e < count; ++e) {
+        float w = (float)attempts[e];
+        weight[e] = w;
+        target[e] = (float)correct[e] - w * (mean + other[(size_t)index[e] * kMfDim + constSlot]);
+        totalWeight += attempts[e];
+    }
+    alignas(64) float gram[kMfDim * kMfDim] = {};
+    alignas(64) float rhs[kMfDim] = {};
+    kernelGramAccumulateF32(other, kMfDim, index, weight.data(), target.data(), count, gram, rhs);
+
+    // 未知量对应的子矩阵 + ALS-WR 正则
+    size_t slot[kMfUnknowns];
+    for (size_t f = 0; f < kMfFactors; ++f) slot[f] = f;
+    slot[kMfFactors] = biasSlot;
+    double reg = kMfLambda * std::max(totalWeight, 1.0);
+    double A[kMfUnknowns][kMfUnknowns];
+    double x[kMfUnknowns];
+    for (size_t r = 0; r < kMfUnknowns; ++r) {
+        for (size_t c = 0; c < kMfUnknowns; ++c) A[r][c] = gram[slot[r] * kMfDim + slot[c]];
+        A[r][r] += reg;
+        x[r] = rhs[slot[r]];
+    }
+
+    // Cholesky：A = L Lᵀ（L 存于下三角），再前代、回代
+    for (size_t r = 0; r < kMfUnknowns; ++r) {
+        for (size_t c = 0; c <= r; ++c) {
+            double sum = A[r][c];
+            for (size_t k = 0; k < c; ++k) sum -= A[r][k] * A[c][k];
+            if (r == c) {
+                A[r][r] = std::sqrt(std::max(sum, 1e-12));
+            } else {
+                A[r][c] = sum / A[c][c];
+            }
+        }
+    }
+    for (size_t r = 0; r < kMfUnknowns; ++r) {
+        for (size_t k = 0; k < r; ++k) x[r] -= A[r][k] * x[k];
+        x[r] /= A[r][r];
+    }
+    for (size_t r = kMfUnknowns; r-- > 0;) {
+        for (size_t k = r + 1; k < kMfUnknowns; ++k) x[r] -= A[k][r] * x[k];
+        x[r] /= A[r][r];
+    }
+
+    for (size_t r = 0; r < kMfUnknowns; ++r) row[slot[r]] = (float)x[r];
+    row[constSlot] = 1.0f;
+}
+
+} // namespace
+
+float mfPredict(float mean, const float* userRow, const float* itemRow) {
+    float p = mean + kernelDotF32(userRow, itemRow, kMfDim);
+    return std::min(1.0f, std::max(0.0f, p));
+}
+
+float MfFit::predict(size_t u, size_t j) const {
+    return mfPredict(mean, userFactors.data() + u * kMfDim, itemFactors.data() + j * kMfDim);
+}
+
+void solveMfUserRow(float mean, const float* itemFactors, const int32_t* items, const uint32_t* attempts,
+                    const uint32_t* correct, size_t count, float* userRow) {
+    solveRow(mean, itemFactors, items, attempts, correct, count, kMfUserBiasSlot, kMfItemBiasSlot, userRow);
+}
+
+MfFit fitMatrixFactorization(const IrtResponses& data, size_t iterations, ThreadPool& pool) {
+    size_t users = data.users();
+    size_t items = data.itemCount;
+    MfFit fit;
+    fit.responses.assign(items, 0);
+
+    // μ 与各题作答次数
+    uint64_t attempts = 0;
+    uint64_t correct = 0;
+    for (size_t j = 0; j < items; ++j) {
+        uint64_t n = 0;
+        for (size_t e = data.itemStart[j]; e < data.itemStart[j + 1]; ++e) {
+            n += data.itemAttempts[e];
+            correct += data.itemCorrect[e];
+        }
+        attempts += n;
+        fit.responses[j] = (uint32_t)std::min<uint64_t>(n, UINT32_MAX);
+    }
+    fit.mean = attempts > 0 ? (float)((double)correct / attempts) : 0.5f;
+
+    fit.userFactors.assign(users * kMfDim, 0.0f);
+    fit.itemFactors.assign(items * kMfDim, 0.0f);
+    for (size_t j = 0; j < items; ++j) {
+        float* row = fit.itemFactors.data() + j * kMfDim;
+        for (size_t f = 0; f < kMfFactors; ++f) row[f] = initialFactor(j, f);
+        row[kMfUserBiasSlot] = 1.0f;
+    }
+
+    size_t userBlocks = (users + kMfBlock - 1) / kMfBlock;
+    size_t itemBlocks = (items + kMfBlock - 1) / kMfBlock;
+    for (size_t iter = 0; iter < iterations; ++iter) {
+        // 用户步：只读上一轮的题目行
+        pool.parallelFor(userBlocks, [&](size_t b) {
+            for (size_t u = b * kMfBlock; u < std::min(users, (b + 1) * kMfBlock); ++u) {
+                size_t begin = data.userStart[u];
+                solveRow(fit.mean, fit.itemFactors.data(), data.userItem.data() + begin,
+                         data.userAttempts.data() + begin, data.userCorrect.data() + begin,
+                         data.userStart[u + 1] - begin, kMfUserBiasSlot, kMfItemBiasSlot,
+                         fit.userFactors.data() + u * kMfDim);
+            }
+        });
+        // 题目步：只读刚更新的用户行
+        pool.parallelFor(itemBlocks, [&](size_t b) {
+            for (size_t j = b * kMfBlock; j < std::min(items, (b + 1) * kMfBlock); ++j) {
+                size_t begin = data.itemStart[j];
+                solveRow(fit.mean, fit.userFactors.data(), data.itemUser.data() + begin,
+                         data.itemAttempts.data() + begin, data.itemCorrect.data() + begin,
+                         data.itemStart[j + 1] - begin, kMfItemBiasSlot, kMfUserBiasSlot,
+                         fit.itemFactors.data() + j * kMfDim);
+            }
+        });
+        fit.iterations = iter + 1;
+    }
+
+    // 训练误差：按用户块求和后按块编号合并
+    std::vector<double> blockError(userBlocks, 0.0);
+    pool.parallelFor(userBlocks, [&](size_t b) {
+        double sum = 0.0;
+        for (size_t u = b * kMfBlock; u < std::min(users, (b + 1) * kMfBlock); ++u) {
+            for (size_t e = data.userStart[u]; e < data.userStart[u + 1]; ++e) {
+                double n = data.userAttempts[e];
+                double diff = data.userCorrect[e] / n - fit.predict(u, (size_t)data.userItem[e]);
+                sum += n * diff * diff;
+            }
+        }
+        blockError[b] = sum;
+    });
+    double error = 0.0;
+    for (double v : blockError) error += v;
+    fit.rmse = attempts > 0 ? std::sqrt(error / attempts) : 0.0;
+    return fit;
+}
+
+bool saveLatentFactors(const std::string& filename, const MfFit& fit) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入潜因子文件：" << filename << "\n";
+        return false;
+    }
+    fout << "# DS_AI_Quiz latent factors v1\n";
+    fout << "# factors=" << kMfFactors << " mean=" << std::setprecision(9) << fit.mean << "\n";
+    fout << "# 题号,作答次数,偏置,因子1..因子" << kMfFactors << "\n";
+    fout << std::setprecision(6);
+    for (size_t j = 0; j < fit.responses.size() && j < g_questions.size(); ++j) {
+        if (fit.responses[j] == 0) continue;
+        const float* row = fit.itemFactors.data() + j * kMfDim;
+        fout << g_questions[j].id << ',' << fit.responses[j] << ',' << row[kMfItemBiasSlot];
+        for (size_t f = 0; f < kMfFactors; ++f) fout << ',' << row[f];
+        fout << '\n';
+    }
+    return (bool)fout;
+}
+
+bool loadLatentFactorsFromFile(const std::string& filename) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    size_t n = g_questions.size();
+    float mean = 0.5f;
+    std::vector<float> itemFactors(n * kMfDim, 0.0f);
+    std::vector<uint32_t> responses(n, 0);
+    for (size_t j = 0; j < n; ++j) itemFactors[j * kMfDim + kMfUserBiasSlot] = 1.0f;
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(fin, line)) {
+        if (line.empty()) continue;
+        if (line[0] == '#') {
+            // 注释行 "# factors=14 mean=0.61"
+            std::stringstream ss(line.substr(1));
+            std::string token;
+            while (ss >> token) {
+                try {
+                    if (token.rfind("factors=", 0) == 0 && std::stoul(token.substr(8)) != kMfFactors) {
+                        std::cout << "潜因子文件的因子数与程序不符（应为 " << kMfFactors << "），未加载：" << filename
+                                  << "\n";
+                        return false;
+                    }
+                    if (token.rfind("mean=", 0) == 0) mean = std::stof(token.substr(5));
+                } catch (...) {
+                    continue;
+                }
+            }
+            continue;
+        }
+
+        std::stringstream ss(line);
+        std::string field;
+        std::vector<std::string> fields;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() != kMfFactors + 3) continue;
+        int id;
+        unsigned long long count;
+        float row[kMfFactors + 1];
+        try {
+            id = std::stoi(fields[0]);
+            count = std::stoull(fields[1]);
+            for (size_t f = 0; f <= kMfFactors; ++f) row[f] = std::stof(fields[f + 2]);
+        } catch (...) {
+            continue;
+        }
+        bool finite = count > 0;
+        for (size_t f = 0; f <= kMfFactors; ++f) finite = finite && std::isfinite(row[f]);
+        if (!finite) continue;
+        auto itQ = g_questionById.find(id);
+        if (itQ == g_questionById.end() || itQ->second >= n) continue;
+        float* dst = itemFactors.data() + itQ->second * kMfDim;
+        dst[kMfItemBiasSlot] = row[0];
+        for (size_t f = 0; f < kMfFactors; ++f) dst[f] = row[f + 1];
+        responses[itQ->second] = (uint32_t)std::min<unsigned long long>(count, UINT32_MAX);
+        ++applied;
+    }
+
+    g_latentFactors.mean_ = std::isfinite(mean) ? mean : 0.5f;
+    g_latentFactors.itemFactors_.swap(itemFactors);
+    g_latentFactors.responses_.swap(responses);
+    g_latentFactors.built_ = false;
+
+    // 未作答题目的评分随之变化：推荐索引整体重建，缓存的推荐结果作废
+    g_recommendIndex.invalidate();
+    g_recommendCache.invalidate();
+    std::cout << "潜因子模型已加载，" << applied << " 道题有答对率预测。\n";
+    return true;
+}
+
+void LatentFactorModel::predictUser(const int32_t* items, const uint32_t* attempts, const uint32_t* correct,
+                                    size_t count, std::vector<float>& out) const {
+    size_t n = responses_.size();
+    if (n == 0 || n != g_questions.size()) {
+        out.clear();
+        return;
+    }
+    float userRow[kMfDim] = {};
+    solveMfUserRow(mean_, itemFactors_.data(), items, attempts, correct, count, userRow);
+
+    out.resize(n);
+    kernelDotRowsF32(itemFactors_.data(), n, kMfDim, userRow, out.data());
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = responses_[i] > 0 ? std::min(1.0f, std::max(0.0f, mean_ + out[i])) : -1.0f;
+    }
+}
+
+const std::vector<float>& LatentFactorModel::predictions() {
+    size_t n = responses_.size();
+    if (n == 0 || n != g_questions.size()) {
+        predictions_.clear();
+        return predictions_;
+    }
+    if (built_ && epoch_ == g_questionStats.epoch && predictions_.size() == n) return predictions_;
+
+    // 折叠当前用户：以全部作答过的题目解一次用户行
+    std::vector<int32_t> items;
+    std::vector<uint32_t> attempts;
+    std::vector<uint32_t> correct;
+    for (size_t i = 0; i < g_questionStats.size() && i < n; ++i) {
+        if (g_questionStats.totalAttempts[i] <= 0) continue;
+        items.push_back((int32_t)i);
+        attempts.push_back((uint32_t)g_questionStats.totalAttempts[i]);
+        correct.push_back((uint32_t)g_questionStats.correctAttempts[i]);
+    }
+    predictUser(items.data(), attempts.data(), correct.data(), items.size(), predictions_);
+    epoch_ = g_questionStats.epoch;
+    built_ = true;
+    return predictions_;
+}
+
+float LatentFactorModel::predict(size_t qIdx) {
+    const std::vector<float>& p = predictions();
+    return qIdx < p.size() ? p[qIdx] : -1.0f;
+}
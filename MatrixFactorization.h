@@ -0,0 +1,190 @@
+/**
+ * @file MatrixFactorization.h
+ * @brief 潜因子模块 - 在全体用户 × 题目的答对率矩阵上做矩阵分解，预测用户对未做过的题目的把握
+ *
+ * 【模块职责】
+ * 推荐评分里从未作答的题目一律按错误率 1.0 计算，再加固定的 unseenBonus：同一知识点、同一难度的
+ * 未做题目得分完全相同，与"这个学生大概能不能做对"无关。本模块从全部用户的记录学习
+ * 用户与题目的低维潜因子：
+ *   P(用户 u 答对题目 j) ≈ μ + b_u + b_j + p_u · q_j   （截断到 [0, 1]）
+ * μ 为全体答对率，b_u / b_j 为用户与题目偏置，p_u / q_j 为 kMfFactors 维潜因子。
+ * 做过相似题目、对错相似的用户，潜因子接近；因此能预测某个学生在从未做过的题目上的答对率。
+ * 推荐时未作答题目的错误率维度改用 1 - 预测答对率（见 Recommender.cpp 的 scoreAllQuestions）。
+ *
+ * 【行布局】
+ * 每行 kMfDim = 16 个单精度数（64 字节，两条 AVX2 向量），偏置与常数 1 交错放在末尾两格：
+ *   用户行 [p_u (14), b_u, 1]，题目行 [q_j (14), 1, b_j]
+ * 于是一次 16 维点积即得 p_u · q_j + b_u + b_j，预测与批量打分都只是 kernelDotF32 / kernelDotRowsF32。
+ *
+ * 【训练：交替最小二乘（ALS）】
+ * 同一用户同一题的多次作答合并为 (作答次数 n, 答对次数 k)，目标为答对率 k / n、权重为 n，
+ * 平方损失加 ALS-WR 正则（每行的正则系数为 kMfLambda × 该行的总权重）。交替进行：
+ * - 固定题目行，每个用户解一个 15 元加权岭回归（p_u 与 b_u）
+ * - 固定用户行，每道题解一个 15 元加权岭回归（q_j 与 b_j）
+ * 正规方程由每个观测的秩 1 更新累加（kernelGramAccumulateF32），再以双精度 Cholesky 求解。
+ * 各行互不依赖，按块交给线程池；没有 Hogwild 式的共享写，结果与线程数、指令集都无关。
+ * 每轮 O(nnz × kMfDim²)，nnz 为用户-题目对数。
+ *
+ * 【当前用户】
+ * 模型文件只保存题目行。当前用户的行在统计表整体重建（登录、切换用户，QuestionStatTable::epoch 变化）
+ * 时由该用户的全部统计做一次同样的岭回归求出（"折叠"），会话内保持不变：
+ * 未作答题目的评分因此在会话内是常数，推荐索引不需要额外维护。
+ *
+ * 【持久化】
+ * data/latent_factors.txt：每道有作答的题目一行"题号,作答次数,b_j,q_j[0],...,q_j[13]"，
+ * 注释行记录 μ 与因子数；题号不在当前题库中的行在加载时跳过。
+ *
+ * 【与其他模块依赖】
+ * - IrtCalibration.h：复用稀疏作答矩阵 IrtResponses（按用户 CSR + 按题目 CSC）与其读取函数
+ * - Kernels.h：单精度点积 / 多行点积 / 正规方程累加（各指令集逐位相同）
+ * - Stats.h：当前用户的统计表（折叠用户行）与 epoch
+ * - Recommender.cpp：未作答题目的错误率改用预测值；AI 推荐展示预测答对率
+ * - main.cpp：启动时加载 data/latent_factors.txt
+ * - Cli.cpp：--train-mf 训练并写出；Bench.cpp：--bench-mf 合成数据基准
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+struct IrtResponses;
+
+/// 潜因子维数
+constexpr size_t kMfFactors = 14;
+
+/// 每行的单精度数：潜因子 + 偏置 + 常数 1
+constexpr size_t kMfDim = kMfFactors + 2;
+
+/// 用户行中偏置 b_u 的位置（题目行该位置为常数 1）
+constexpr size_t kMfUserBiasSlot = kMfFactors;
+
+/// 题目行中偏置 b_j 的位置（用户行该位置为常数 1）
+constexpr size_t kMfItemBiasSlot = kMfFactors + 1;
+
+/// ALS-WR 正则系数（乘以该行的总作答次数）
+constexpr double kMfLambda = 0.05;
+
+/// 默认迭代轮数（每轮更新一次全部用户行与题目行）
+constexpr size_t kMfIterations = 10;
+
+/**
+ * @struct MfFit
+ * @brief 训练结果
+ */
+struct MfFit {
+    float mean = 0.0f;                   ///< 全体答对率 μ
+    std::vector<float> userFactors;      ///< 用户数 × kMfDim
+    std::vector<float> itemFactors;      ///< 题目数 × kMfDim
+    std::vector<uint32_t> responses;     ///< 题目 -> 作答次数
+    size_t iterations = 0;               ///< 迭代轮数
+    double rmse = 0.0;                   ///< 训练集上按作答次数加权的均方根误差
+
+    /// 用户 u 答对题目 j 的预测概率
+    float predict(size_t u, size_t j) const;
+};
+
+/**
+ * @brief 在稀疏作答矩阵上以 ALS 训练潜因子模型
+ * @param data 稀疏作答矩阵（需已 buildItemIndex()）
+ * @param iterations 迭代轮数
+ * @param pool 执行并行任务的线程池
+ * @return 训练结果（与线程数、指令集无关）
+ * @complexity 每轮 O(nnz × kMfDim² + (用户数 + 题目数) × kMfDim³)
+ */
+MfFit fitMatrixFactorization(const IrtResponses& data, size_t iterations, ThreadPool& pool);
+
+/**
+ * @brief 预测答对概率：μ + 用户行 · 题目行，截断到 [0, 1]
+ */
+float mfPredict(float mean, const float* userRow, const float* itemRow);
+
+/**
+ * @brief 固定题目行，为一个用户求解用户行（训练中的用户步与当前用户的折叠共用）
+ *
+ * @param mean 全体答对率 μ
+ * @param itemFactors 题目行（题目数 × kMfDim）
+ * @param items 该用户作答过的题目下标
+ * @param attempts 对应的作答次数
+ * @param correct 对应的答对次数
+ * @param count 题目数
+ * @param userRow 输出：用户行（kMfDim 个数）
+ * @complexity O(count × kMfDim² + kMfDim³)
+ */
+void solveMfUserRow(float mean, const float* itemFactors, const int32_t* items, const uint32_t* attempts,
+                    const uint32_t* correct, size_t count, float* userRow);
+
+/**
+ * @brief 把训练结果的题目行写入文件（只写有作答的题目，格式见文件头说明）
+ * @param filename 输出文件路径（通常为 data/latent_factors.txt）
+ * @param fit 训练结果（题目下标与当前 g_questions 对应）
+ * @return true 写出成功；false 文件无法打开
+ */
+bool saveLatentFactors(const std::string& filename, const MfFit& fit);
+
+/**
+ * @class LatentFactorModel
+ * @brief 已加载的题目行与当前用户的预测
+ */
+class LatentFactorModel {
+public:
+    /// 是否已加载模型
+    bool loaded() const { return !responses_.empty(); }
+
+    /// 参与训练的作答次数（下标越界为 0；为 0 的题目没有预测）
+    uint32_t responses(size_t qIdx) const { return qIdx < responses_.size() ? responses_[qIdx] : 0; }
+
+    /**
+     * @brief 当前用户在全部题目上的预测答对率（下标为题目下标，没有预测的题目为 -1）
+     *
+     * 统计表 epoch 或题库大小变化时先折叠当前用户行，再以 kernelDotRowsF32 为全部题目打分，O(N × kMfDim)；
+     * 其余时候直接返回缓存。未加载模型时返回空数组。
+     */
+    const std::vector<float>& predictions();
+
+    /// 当前用户答对某道题的预测概率（没有预测时为 -1）
+    float predict(size_t qIdx);
+
+    /**
+     * @brief 为任意一个用户折叠用户行并预测全部题目（不读写当前用户的缓存，可在多个线程中同时调用）
+     *
+     * predictions() 以当前用户的统计调用本函数；批量推荐以各用户自己的统计调用。
+     *
+     * @param items 该用户作答过的题目下标（升序，与 predictions() 的折叠顺序一致）
+     * @param attempts 对应的作答次数
+     * @param correct 对应的答对次数
+     * @param count 题目数
+     * @param out 输出：题目下标 -> 预测答对率（没有预测的题目为 -1）；未加载模型或题库大小不符时为空
+     * @complexity O(count × kMfDim² + N × kMfDim)
+     */
+    void predictUser(const int32_t* items, const uint32_t* attempts, const uint32_t* correct, size_t count,
+                     std::vector<float>& out) const;
+
+private:
+    friend bool loadLatentFactorsFromFile(const std::string& filename);
+
+    float mean_ = 0.0f;
+    std::vector<float> itemFactors_;          ///< 题目下标 -> 题目行（kMfDim 个数）
+    std::vector<uint32_t> responses_;         ///< 题目下标 -> 作答次数
+    bool built_ = false;
+    uint64_t epoch_ = 0;                      ///< 折叠时 g_questionStats.epoch
+    std::vector<float> predictions_;          ///< 题目下标 -> 预测答对率
+};
+
+/**
+ * @brief 全局潜因子模型（启动时从 data/latent_factors.txt 加载；文件不存在时未加载）
+ */
+extern LatentFactorModel g_latentFactors;
+
+/**
+ * @brief 从文件加载潜因子模型到 g_latentFactors（格式错误的行、题库中不存在的题号跳过）
+ *
+ * 加载后推荐索引整体重建、缓存的推荐结果作废。
+ *
+ * @param filename 文件路径
+ * @return true 加载成功；false 文件无法打开（g_latentFactors 不变）
+ */
+bool loadLatentFactorsFromFile(const std::string& filename);
@@ -0,0 +1,156 @@
+/**
+ * @file QuantileSketch.cpp
+ * @brief KLL 分位数草图实现
+ *
+ * 实现要点：
+ * 1. **层容量**：caps_[h] = max(2, ceil(k × (2/3)^(H-1-h)))，H 为当前层数，顶层容量为 k；
+ *    仅在层数变化时重算，追加样本只需比较 size_ 与 maxSize_
+ * 2. **压缩**：自底向上找到第一个超出容量的层，排序后隔一取一提升到上一层，
+ *    奇偶位由该层的 flip 标志交替决定；若元素个数为奇数，保留一个在本层
+ * 3. **查询**：把所有 (值, 权重 2^h) 排序后累加权重，找到第一个累计权重 >= q × n 的值
+ */
+
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+
+QuantileSketch::QuantileSketch(int k) : k_(k < 8 ? 8 : k) {
+    addLevel();
+}
+
+void QuantileSketch::addLevel() {
+    levels_.emplace_back();
+    flip_.push_back(0);
+
+    // 层数变化后各层距顶层的深度都加一，容量整体重算（层数为 O(log n)，开销可忽略）
+    size_t H = levels_.size();
+    caps_.assign(H, 0);
+    maxSize_ = 0;
+    for (size_t h = 0; h < H; ++h) {
+        double cap = std::ceil(k_ * std::pow(2.0 / 3.0, (double)(H - 1 - h)));
+        caps_[h] = cap < 2.0 ? 2 : (size_t)cap;
+        maxSize_ += caps_[h];
+    }
+}
+
+void QuantileSketch::add(int value) {
+    levels_[0].push_back(value);
+    ++n_;
+    ++size_;
+    if (size_ > maxSize_) compress();
+}
+
+void QuantileSketch::compress() {
+    while (size_ > maxSize_) {
+        for (size_t h = 0; h < levels_.size(); ++h) {
+            if (levels_[h].size() < caps_[h]) continue;
+
+            if (h + 1 == levels_.size()) addLevel();     // 需要新增顶层
+
+            std::vector<int>& cur = levels_[h];
+            std::sort(cur.begin(), cur.end());
+
+            // 元素个数为奇数时，保留最后一个在本层，其余成对压缩
+            bool hasOdd = (cur.size() % 2 == 1);
+            int keep = hasOdd ? cur.back() : 0;
+            size_t pairs = cur.size() / 2;
+
+            std::vector<int>& up = levels_[h + 1];
+            size_t offset = flip_[h];
+            flip_[h] ^= 1;                               // 奇偶位交替，避免系统偏差
+            for (size_t i = 0; i < pairs; ++i) {
+                up.push_back(cur[2 * i + offset]);
+            }
+
+            cur.clear();
+            if (hasOdd) cur.push_back(keep);
+            size_ -= pairs;                              // 每对压缩为一个元素
+            break;                                       // 一次只压缩一层，再重新检查
+        }
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.n_ == 0) return;
+    while (levels_.size() < other.levels_.size()) addLevel();
+    for (size_t h = 0; h < other.levels_.size(); ++h) {
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+        size_ += other.levels_[h].size();
+    }
+    n_ += other.n_;
+    compress();
+}
+
+int QuantileSketch::quantile(double q) const {
+    if (n_ == 0) return 0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+
+    // 收集 (值, 权重) 并按值排序
+    std::vector<std::pair<int, uint64_t>> items;
+    items.reserve(retained());
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        uint64_t w = (uint64_t)1 << h;
+        for (int v : levels_[h]) items.push_back({v, w});
+    }
+    std::sort(items.begin(), items.end());
+
+    uint64_t total = 0;
+    for (const auto& it : items) total += it.second;
+
+    // 累计权重首次达到 q × total 的元素即为所求分位数
+    double target = q * (double)total;
+    uint64_t acc = 0;
+    for (const auto& it : items) {
+        acc += it.second;
+        if ((double)acc >= target) return it.first;
+    }
+    return items.back().first;
+}
+
+std::string QuantileSketch::serialize() const {
+    std::ostringstream oss;
+    oss << k_ << ' ' << n_ << ' ' << levels_.size();
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        oss << " | " << (int)flip_[h] << ' ' << levels_[h].size();
+        for (int v : levels_[h]) oss << ' ' << v;
+    }
+    return oss.str();
+}
+
+bool QuantileSketch::deserialize(const std::string& text, QuantileSketch& out) {
+    std::istringstream iss(text);
+    int k = 0;
+    uint64_t n = 0;
+    size_t levelCount = 0;
+    if (!(iss >> k >> n >> levelCount) || levelCount == 0 || levelCount > 64) return false;
+    if (k > kMaxSketchK) return false;
+
+    QuantileSketch sk(k);
+    sk.n_ = n;
+    while (sk.levels_.size() < levelCount) sk.addLevel();
+    uint64_t weighted = 0;   // 各层元素个数 × 2^h 之和，必须恰为 n
+    for (size_t h = 0; h < levelCount; ++h) {
+        std::string bar;
+        int flip = 0;
+        size_t size = 0;
+        if (!(iss >> bar >> flip >> size) || bar != "|") return false;
+        // 先校验再分配：compress() 保证保留元素总数不超过全部层的容量之和
+        // （单层可以超出自身容量，例如顶层，但不会超出剩余的总容量）
+        if (size > sk.maxSize_ - sk.size_) return false;
+        if (size > (UINT64_MAX - weighted) >> h) return false;
+        weighted += (uint64_t)size << h;
+        sk.flip_[h] = (uint8_t)(flip & 1);
+        sk.levels_[h].resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            if (!(iss >> sk.levels_[h][i])) return false;
+        }
+        sk.size_ += size;
+    }
+    // 压缩把两个权重为 2^h 的元素合并为一个 2^(h+1) 的元素，总权重始终等于样本数
+    if (weighted != n) return false;
+    out = sk;
+    return true;
+}
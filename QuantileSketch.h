@@ -0,0 +1,105 @@
+/**
+ * @file QuantileSketch.h
+ * @brief 流式分位数草图（KLL Sketch）- 作答用时分布
+ *
+ * 【模块职责】
+ * QuestionStat 只保存 totalTime，只能算平均用时，无法得知中位数、P95 等分布信息，
+ * 而"中位用时明显偏长"正是识别题意含糊、易混淆题目的关键信号。
+ * 本模块实现 KLL 分位数草图：
+ * - 流式追加：每条记录摊还 O(log k)（k 为常数精度参数，实际可视为 O(1)）
+ * - 内存有界：约 3k 个元素 + O(log n) 级别的少量层，与历史长度基本无关
+ * - 可合并：多个用户的草图可直接合并，得到班级（cohort）维度的分布
+ * - 可序列化：以单行文本写入统计快照文件
+ *
+ * 【算法简述】
+ * 草图由若干"压缩层"组成，第 h 层每个元素代表 2^h 个原始样本。
+ * 某层超出容量时排序并"隔一取一"提升到上一层（取奇数位还是偶数位交替进行，
+ * 保证结果确定且无系统偏差）。层容量自顶向下按 2/3 几何递减，最小为 2。
+ *
+ * 【精度】
+ * 秩误差约为 O(1/k)：k = 32 时约 ±5%，k = 128 时约 ±1.5%。
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/// 反序列化时接受的最大精度参数（本项目使用 64 ~ 200；更大的值视为损坏的快照）
+constexpr int kMaxSketchK = 1 << 16;
+
+/**
+ * @class QuantileSketch
+ * @brief KLL 分位数草图（整数样本，单位：秒）
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief 构造草图
+     * @param k 精度参数（顶层容量），越大越精确、占用越多；最小取 8
+     */
+    explicit QuantileSketch(int k = 64);
+
+    /**
+     * @brief 追加一个样本
+     * @param value 样本值（作答用时，秒）
+     * @complexity 摊还 O(log k)
+     */
+    void add(int value);
+
+    /**
+     * @brief 合并另一个草图（结果近似于两组样本合并后的草图）
+     * @param other 另一个草图（k 可以不同，合并后保留本草图的 k）
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief 查询分位数
+     * @param q 分位点，范围 [0, 1]（0.5 为中位数，0.95 为 P95）
+     * @return 近似分位数；草图为空时返回 0
+     * @complexity O(s log s)，s 为草图中保留的元素数（有界）
+     */
+    int quantile(double q) const;
+
+    /// 已接收的样本总数
+    uint64_t count() const { return n_; }
+
+    /// 是否尚无样本
+    bool empty() const { return n_ == 0; }
+
+    /// 当前保留的元素个数（用于观察内存占用）
+    size_t retained() const { return size_; }
+
+    /**
+     * @brief 序列化为单行文本
+     *
+     * 格式：`k n 层数 | 层0奇偶标志 层0大小 v v v | 层1奇偶标志 层1大小 v v ...`
+     * （各字段以空格分隔，不含换行）
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief 从 serialize() 的输出恢复草图
+     * @param text 序列化文本
+     * @param out 输出草图
+     * @return true 解析成功；false 格式错误、k 超过 kMaxSketchK、保留元素数超过草图容量
+     *         或各层权重之和与样本数不符（out 保持不变，不会因损坏的层大小分配大块内存）
+     */
+    static bool deserialize(const std::string& text, QuantileSketch& out);
+
+private:
+    int k_;                                 ///< 精度参数
+    uint64_t n_ = 0;                        ///< 样本总数
+    std::vector<std::vector<int>> levels_;  ///< 各压缩层（第 h 层元素权重为 2^h）
+    std::vector<uint8_t> flip_;             ///< 各层下一次压缩取奇/偶位的交替标志
+    std::vector<size_t> caps_;              ///< 各层容量（层数变化时重算）
+    size_t size_ = 0;                       ///< 当前保留的元素总数
+    size_t maxSize_ = 0;                    ///< 全部层的容量之和
+
+    /// 追加一个空层并重算各层容量
+    void addLevel();
+
+    /// 压缩直到总元素数不超过总容量
+    void compress();
+};
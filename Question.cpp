@@ -16,6 +16,7 @@
  */
 
 #include "Question.h"
+#include "Recommender.h"
 #include "Utils.h"
 #include <iostream>
 #include <fstream>
@@ -24,6 +25,23 @@
 // 全局题库容器定义
 std::vector<Question> g_questions;
 std::unordered_map<int, size_t> g_questionById;
+std::vector<std::string> g_knowledgeNames;
+std::unordered_map<std::string, int> g_knowledgeIdByName;
+
+/**
+ * @brief 登记知识点名称（实现）
+ *
+ * 先查哈希表，命中则返回已有 ID；未命中则以当前名称数作为新 ID。
+ */
+int internKnowledge(const std::string& name) {
+    auto it = g_knowledgeIdByName.find(name);
+    if (it != g_knowledgeIdByName.end()) return it->second;
+
+    int id = (int)g_knowledgeNames.size();
+    g_knowledgeNames.push_back(name);
+    g_knowledgeIdByName[name] = id;
+    return id;
+}
 
 /**
  * @brief 从 CSV 文件加载题库（实现）
@@ -88,6 +106,8 @@ bool loadQuestionsFromFile(const std::string& filename) {
             q.answer = std::stoi(fields[6]);      // 正确答案下标（0~3）
             q.knowledge = fields[7];              // 知识点
             q.difficulty = std::stoi(fields[8]);  // 难度（1~5）
+            q.labeledDifficulty = q.difficulty;   // 保留标注值（校准可能覆盖 difficulty）
+            q.knowledgeId = internKnowledge(q.knowledge); // 知识点稠密 ID
         } catch (...) {
             // 捕获 std::stoi 抛出的异常（非法数值格式）
             std::cout << "第 " << lineNum << " 行解析出错，已跳过。\n";
@@ -104,6 +124,9 @@ bool loadQuestionsFromFile(const std::string& filename) {
         g_questionById[g_questions[i].id] = i;
     }
 
+    // 题库已变化：缓存的推荐结果作废
+    g_recommendCache.invalidate();
+
     // 输出加载结果
     std::cout << "题库加载完成，共读取到 " << g_questions.size() << " 道题。\n";
 
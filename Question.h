@@ -11,6 +11,7 @@
  * - Question 结构体：单道题目的完整信息
  * - std::vector<Question> g_questions：所有题目的顺序存储
  * - std::unordered_map<int, size_t> g_questionById：题号 -> 题目索引的哈希映射
+ * - g_knowledgeNames / g_knowledgeIdByName：知识点名称 <-> 稠密知识点 ID 的双向映射
  *
  * 【输入文件格式】
  * - 文件名：data/questions.csv
@@ -51,6 +52,11 @@ struct Question {
     int answer;                      ///< 正确答案的下标（0~3，对应 options[answer]）
     std::string knowledge;           ///< 所属知识点（如"栈与队列"、"二叉树"等）
     int difficulty;                  ///< 难度等级（1~5，1 最简单，5 最难）
+    int knowledgeId = -1;            ///< 知识点的稠密 ID（加载时由 internKnowledge 分配，下标访问 g_knowledgeNames）
+    int labeledDifficulty = 0;       ///< 题库文件标注的难度（difficulty 被 IRT 校准覆盖后仍保留原值）
+    bool calibrated = false;         ///< difficulty 是否已由 IRT 校准结果换算（见 IrtCalibration.h）
+    double irtDifficulty = 0.0;      ///< IRT 难度参数 b（calibrated 时有效）
+    double irtDiscrimination = 1.0;  ///< IRT 区分度参数 a（calibrated 时有效）
 };
 
 /**
@@ -72,6 +78,33 @@ extern std::vector<Question> g_questions;
  */
 extern std::unordered_map<int, size_t> g_questionById;
 
+/**
+ * @brief 知识点 ID -> 知识点名称
+ *
+ * 知识点 ID 从 0 开始连续分配，可直接作为数组下标使用，
+ * 便于按知识点维度维护稠密统计（如滚动窗口统计）而无需字符串哈希。
+ */
+extern std::vector<std::string> g_knowledgeNames;
+
+/**
+ * @brief 知识点名称 -> 知识点 ID
+ */
+extern std::unordered_map<std::string, int> g_knowledgeIdByName;
+
+/**
+ * @brief 登记知识点名称并返回其稠密 ID
+ *
+ * 名称已存在则直接返回已有 ID，否则追加到 g_knowledgeNames 末尾并分配新 ID。
+ * 只有题库加载（loadQuestionsFromFile）调用本函数，ID 一经分配不会改变。
+ * 知识点依赖图不登记名称：只在依赖图中出现、没有题目的知识点没有本 ID，
+ * 由 KnowledgeMastery::rebuild() 在其内部接续编号；编译后的依赖图 g_knowledgeGraph 另有按名称排序的编号。
+ *
+ * @param name 知识点名称
+ * @return int 知识点 ID（>= 0）
+ * @complexity O(1) 平均（一次哈希查找/插入）
+ */
+int internKnowledge(const std::string& name);
+
 /**
  * @brief 从 CSV 文件加载题库
  *
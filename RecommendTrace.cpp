@@ -0,0 +1,159 @@
+/**
+ * @file RecommendTrace.cpp
+ * @brief 推荐追踪模块实现
+ *
+ * 实现要点：
+ * 1. **一行一次推荐**：写出前在内存中拼好整行，写出后立即 flush，程序中途退出也不会留下半行
+ * 2. **字符串转义**：用户名与知识点名按 JSON 规则转义引号、反斜杠与控制字符，UTF-8 中文原样写出
+ * 3. **数值**：保留 10 位有效数字；非有限值写 null
+ * 4. **评分分项**：由 explainRecommendScore() 按评分配置重算，前置补强分取推荐项的总分与逐题评分之差
+ */
+
+#include "RecommendTrace.h"
+#include "Question.h"
+#include "Record.h"
+#include "Utils.h"
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+RecommendTrace g_recommendTrace;
+
+namespace {
+
+/// 追加一个 JSON 字符串（含引号）
+void appendJsonString(std::ostringstream& os, const std::string& s) {
+    os << '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    os << buf;
+                } else {
+                    os << (char)c;
+                }
+        }
+    }
+    os << '"';
+}
+
+/// 追加一个 JSON 数值（非有限值写 null）
+void appendJsonNumber(std::ostringstream& os, double x) {
+    if (!std::isfinite(x)) {
+        os << "null";
+        return;
+    }
+    os << std::setprecision(10) << x;
+}
+
+} // namespace
+
+bool RecommendTrace::open(const std::string& path) {
+    out_.close();
+    out_.clear();
+    out_.open(path, std::ios::app);
+    enabled_ = (bool)out_;
+    path_ = enabled_ ? path : std::string();
+    return enabled_;
+}
+
+void RecommendTrace::beginEvent() {
+    for (double& t : stageMicros_) t = 0.0;
+}
+
+void RecommendTrace::writeEvent(const std::vector<RecommendItem>& ranked, size_t K, bool diverse, bool cacheHit,
+                                long long now) {
+    if (!enabled_) return;
+    static const char* const kStageNames[] = {"stats", "score", "select"};
+    const ScoringProfile& profile = activeScoringProfile();
+
+    std::ostringstream os;
+    os << "{\"event\":\"recommend\",\"ts\":" << now << ",\"user\":";
+    appendJsonString(os, g_currentUserId);
+    os << ",\"seed\":\"" << formatSeed(sessionSeed()) << "\",\"profile\":\"" << profile.name
+       << "\",\"selection\":\"" << (diverse ? "mmr" : "heap") << "\",\"k\":" << K
+       << ",\"questions\":" << g_questions.size() << ",\"cache_hit\":" << (cacheHit ? "true" : "false");
+
+    os << ",\"stages_us\":{";
+    for (size_t s = 0; s < (size_t)TraceStage::Count; ++s) {
+        os << (s ? "," : "") << '"' << kStageNames[s] << "\":";
+        appendJsonNumber(os, stageMicros_[s]);
+    }
+    os << "},\"items\":[";
+
+    bool first = true;
+    for (size_t r = 0; r < ranked.size(); ++r) {
+        const RecommendItem& item = ranked[r];
+        auto itQ = g_questionById.find(item.questionId);
+        if (itQ == g_questionById.end() || itQ->second >= g_questions.size()) continue;
+        size_t qIdx = itQ->second;
+        const Question& q = g_questions[qIdx];
+        RecommendScoreBreakdown b = explainRecommendScore(profile, qIdx, now);
+
+        os << (first ? "" : ",") << "{\"rank\":" << (r + 1) << ",\"id\":" << q.id << ",\"knowledge\":";
+        first = false;
+        if (q.knowledgeId >= 0 && (size_t)q.knowledgeId < g_knowledgeNames.size()) {
+            appendJsonString(os, g_knowledgeNames[q.knowledgeId]);
+        } else {
+            os << "null";
+        }
+        int attempts = qIdx < g_questionStats.size() ? g_questionStats.totalAttempts[qIdx] : 0;
+        int correct = qIdx < g_questionStats.size() ? g_questionStats.correctAttempts[qIdx] : 0;
+        os << ",\"difficulty\":" << q.difficulty << ",\"attempts\":" << attempts << ",\"correct\":" << correct;
+        os << ",\"error_rate\":";
+        appendJsonNumber(os, b.errorRate);
+        os << ",\"time_gap_days\":";
+        appendJsonNumber(os, b.timeGapDays);
+        os << ",\"terms\":{\"error\":";
+        appendJsonNumber(os, b.errorTerm);
+        os << ",\"time\":";
+        appendJsonNumber(os, b.timeTerm);
+        os << ",\"difficulty\":";
+        appendJsonNumber(os, b.difficultyTerm);
+        os << ",\"unseen\":";
+        appendJsonNumber(os, b.unseenTerm);
+        os << ",\"prereq\":";
+        appendJsonNumber(os, item.score - item.baseScore);
+        os << "}";
+        if (b.predictedCorrect >= 0.0) {
+            os << ",\"predicted_correct\":";
+            appendJsonNumber(os, b.predictedCorrect);
+        }
+        if (b.halfLifeDays >= 0.0) {
+            os << ",\"half_life_days\":";
+            appendJsonNumber(os, b.halfLifeDays);
+        }
+        os << ",\"base\":";
+        appendJsonNumber(os, item.baseScore);
+        os << ",\"total\":";
+        appendJsonNumber(os, item.score);
+        os << "}";
+    }
+    os << "]}\n";
+
+    out_ << os.str();
+    out_.flush();
+    ++events_;
+}
+
+bool enableRecommendTrace(const std::string& path) {
+    if (!kRecommendTraceCompiled) {
+        std::cout << "本程序编译时未启用推荐追踪（CMake 选项 DS_AI_QUIZ_TRACE=OFF），--trace 不可用。\n";
+        return false;
+    }
+    std::string target = path.empty() ? (getDataDir() / "recommend_trace.jsonl").string() : path;
+    if (!g_recommendTrace.open(target)) {
+        std::cout << "无法打开追踪文件：" << target << "\n";
+        return false;
+    }
+    return true;
+}
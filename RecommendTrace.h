@@ -0,0 +1,141 @@
+/**
+ * @file RecommendTrace.h
+ * @brief 推荐追踪 - AI 推荐各阶段耗时与每道推荐题的评分分项（JSON Lines）
+ *
+ * 【模块职责】
+ * 学生反映"AI 推荐的题很奇怪"时，需要知道当时的评分是怎么来的。开启追踪后，每次进入 AI 推荐
+ * 向追踪文件追加一行 JSON：
+ * - 会话信息：时间戳、用户、会话随机种子、评分配置、选择方式、K、题库大小、是否命中结果缓存
+ * - 各阶段墙钟耗时（微秒）：stats（统计表重建）、score（推荐索引重建 / 活跃题目重新评分与补强分）、
+ *   select（段堆上的 Top-K 遍历与 MMR 挑选）
+ * - 每道推荐题：题号、知识点、难度、作答 / 答对次数，以及错误率、时间间隔、难度、未做奖励四个加权项、
+ *   前置补强分、逐题评分与总分（潜因子 / 遗忘模型修正时附预测答对率 / 半衰期）
+ *
+ * 【开销】
+ * - 编译期开关：CMake 选项 DS_AI_QUIZ_TRACE（默认 ON）；关闭时 recommendTraceOn() 为常量 false，
+ *   计时与记录代码全部被编译器删除，--trace 报错退出
+ * - 运行期开关：全局选项 --trace（或 --trace=<文件>）打开追踪文件；未打开时每个计时点只有一次布尔判断
+ *
+ * 【与其他模块依赖】
+ * - Recommender.cpp：aiRecommendMode() 记录一次推荐；RecommendIndex::topK() 计时 score / select 阶段；
+ *   explainRecommendScore() 提供评分分项
+ * - Utils.h：会话随机种子（与 data/session_log.csv 对应）
+ * - Cli.cpp：全局选项 --trace
+ */
+
+#pragma once
+
+#include "Recommender.h"
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef DS_AI_QUIZ_TRACE
+#define DS_AI_QUIZ_TRACE 1
+#endif
+
+/// 编译期开关：为 false 时追踪代码不参与编译
+constexpr bool kRecommendTraceCompiled = DS_AI_QUIZ_TRACE != 0;
+
+/**
+ * @enum TraceStage
+ * @brief 一次推荐中计时的阶段
+ */
+enum class TraceStage {
+    Stats = 0,   ///< 统计表重建（buildQuestionStats）
+    Score,       ///< 推荐索引刷新：整体重建或活跃题目重新评分、补强分更新
+    Select,      ///< 选择：段堆上的 Top-K 遍历与 MMR 挑选
+    Count        ///< 阶段数
+};
+
+/**
+ * @class RecommendTrace
+ * @brief 推荐追踪文件与当前一次推荐的阶段耗时
+ */
+class RecommendTrace {
+public:
+    /// 是否已打开追踪文件
+    bool enabled() const { return enabled_; }
+
+    /**
+     * @brief 打开追踪文件（追加模式）并开启追踪
+     * @param path 文件路径
+     * @return true 成功；false 文件无法打开（追踪保持关闭）
+     */
+    bool open(const std::string& path);
+
+    /// 追踪文件路径
+    const std::string& path() const { return path_; }
+
+    /// 开始记录一次推荐：清零各阶段耗时
+    void beginEvent();
+
+    /// 把一段耗时（微秒）计入当前推荐的某个阶段
+    void addStageTime(TraceStage stage, double micros) { stageMicros_[(size_t)stage] += micros; }
+
+    /**
+     * @brief 写出当前一次推荐（一行 JSON）
+     * @param ranked 推荐结果（按展示顺序）
+     * @param K 推荐数量
+     * @param diverse 是否为 MMR 选择
+     * @param cacheHit 是否命中结果缓存
+     * @param now 推荐时刻（秒）
+     * @complexity O(K)（每道题一次 explainRecommendScore）
+     */
+    void writeEvent(const std::vector<RecommendItem>& ranked, size_t K, bool diverse, bool cacheHit, long long now);
+
+    /// 已写出的推荐次数
+    size_t events() const { return events_; }
+
+private:
+    bool enabled_ = false;
+    std::string path_;
+    std::ofstream out_;
+    double stageMicros_[(size_t)TraceStage::Count] = {};
+    size_t events_ = 0;
+};
+
+/**
+ * @brief 全局推荐追踪（--trace 打开）
+ */
+extern RecommendTrace g_recommendTrace;
+
+/**
+ * @brief 追踪是否开启（编译期关闭时为常量 false）
+ */
+inline bool recommendTraceOn() {
+    return kRecommendTraceCompiled && g_recommendTrace.enabled();
+}
+
+/**
+ * @class TraceTimer
+ * @brief 作用域计时：构造到析构的墙钟时间计入一个阶段（追踪关闭时不读时钟）
+ */
+class TraceTimer {
+public:
+    explicit TraceTimer(TraceStage stage) : stage_(stage), on_(recommendTraceOn()) {
+        if (on_) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~TraceTimer() {
+        if (!on_) return;
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start_;
+        g_recommendTrace.addStageTime(stage_, elapsed.count());
+    }
+
+    TraceTimer(const TraceTimer&) = delete;
+    TraceTimer& operator=(const TraceTimer&) = delete;
+
+private:
+    TraceStage stage_;
+    bool on_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief 打开追踪文件（--trace；空路径表示 data/recommend_trace.jsonl）
+ * @return true 成功；false 编译时未启用追踪或文件无法打开（已输出原因）
+ */
+bool enableRecommendTrace(const std::string& path);
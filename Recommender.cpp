@@ -3,16 +3,49 @@
  * @brief AI 智能推荐系统实现文件
  *
  * 实现多维度加权评分算法，基于用户历史数据智能推荐最适合练习的题目。
+ *
+ * 实现要点：
+ * 1. **评分配置**：每个策略类型（ScoringPolicy.h）实例化出一组专门化的评分函数，
+ *    登记在 scoringProfiles() 注册表中；会话开始时按名称选定，之后每批评分只有一次函数指针调用
+ * 2. **全量评分**：scoreAllQuestions() 整理列后一次交给配置的 scoreBatch（向量化内核）
+ * 3. **增量索引**：RecommendIndex 中评分尚未稳定的活跃题目以评分上界（不随时间变化）入堆，
+ *    查询时只精确评分被 Top-K 遍历取到的活跃题目；到期题目每桶一次 scoreSubset 定为常数
+ * 4. **前置补强**：第二阶段按知识点加上 prereqWeight × 继承薄弱度（KnowledgeMastery.h）。
+ *    全量评分与推荐索引使用同一组按知识点计算的补强分（prereqBoosts），两者总分逐位相同；
+ *    推荐索引按知识点分段建堆，补强分变化只改段偏移
+ * 5. **结果缓存**：RecommendCache 以 (统计 epoch / version, 评分配置, K, 时间桶) 为键缓存最近一次结果，
+ *    作答、切换用户、重新加载题库或依赖图时显式清空
+ * 6. **多样化选择**：可选的 MMR 阶段在前 K × kDiversityPoolFactor 道候选中挑选，
+ *    每选一道只更新各候选与已选集合的最大相似度，O(M × K)
+ * 7. **潜因子预测**：加载了 data/latent_factors.txt 时，全量评分后未作答题目的错误率由 1.0 改为
+ *    1 - 预测答对率（MatrixFactorization.h）；预测在会话内不变，推荐索引只在整体重建时读取
+ * 8. **遗忘模型**：加载了 data/half_life.txt 时，已作答题目的时间间隔维度由 min(天数 / 时间基准, 1) 改为
+ *    半衰期回归的 min(2 × (1 - 回忆概率), 1)（HalfLifeRegression.h）。全量评分与推荐索引的活跃题目各自在
+ *    逐题评分之后加上同一个修正量；推荐索引中题目的评分稳定日不早于其预计到期日 + 2（HalfLifeModel::settleDay）
+ * 9. **推荐追踪**：explainRecommendScore() 按评分配置重算逐题评分的各加权项；RecommendIndex::topK() 与
+ *    aiRecommendMode() 以 TraceTimer 计时各阶段，开启 --trace 时写出（RecommendTrace.h）
  */
 
 #include "Recommender.h"
+#include "KnowledgeMastery.h"
+#include "CoError.h"
+#include "RecommendTrace.h"
+#include "HalfLifeRegression.h"
+#include "KnowledgeTracing.h"
+#include "MatrixFactorization.h"
 #include "Record.h"
+#include "RollingStats.h"
+#include "TopK.h"
+#include "Kernels.h"
 #include "Utils.h"
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <ctime>
 #include <cmath>
+#include <climits>
 
 /**
  * @brief 计算题目的推荐评分（实现）
@@ -25,6 +58,9 @@
  * - 特殊处理：
  *   * 若用户从未做过该题，则 errorRate = 1.0（最高值）
  *   * 确保新题目有机会被推荐
+ * - 近期修正：若 st.recentAttempts > 0（近 7 天有作答），
+ *   errorRate = 0.5 × 历史错误率 + 0.5 × 近 7 天错误率，
+ *   使上周已经补上的弱项能较快降低推荐优先级
  * - 意义：错误率越高 → 该题是弱项 → 越需要练习
  *
  * **【维度 2：时间间隔 - 权重 0.3】**
@@ -62,15 +98,17 @@
  * - 难度 0.1：调节因素，适度提升挑战性
  * - 未做奖励 0.2：探索激励，保证题库全覆盖
  *
- * **【权重可调性建议】**
- * 根据不同学习目标，可灵活调整权重配置：
+ * **【权重配置】**
+ * 根据不同学习目标，ScoringPolicy.h 提供以下策略类型（启动时 --profile <配置名> 选择）：
+ *
+ * | 配置名      | 学习目标     | 错误率 | 时间间隔 | 难度 | 时间基准 | 说明               |
+ * |-------------|-------------|--------|----------|------|----------|--------------------|
+ * | weakness    | 补弱项模式   | 0.7    | 0.2      | 0.1  | 7 天     | 强化错题练习       |
+ * | review      | 复习模式     | 0.4    | 0.5      | 0.1  | 14 天    | 注重遗忘曲线复习   |
+ * | challenge   | 挑战模式     | 0.3    | 0.2      | 0.5  | 7 天     | 攻克高难度题目     |
+ * | balanced    | 平衡模式     | 0.6    | 0.3      | 0.1  | 7 天     | 默认配置，均衡发展 |
  *
- * | 学习目标     | 错误率 | 时间间隔 | 难度 | 说明                     |
- * |-------------|--------|----------|------|--------------------------|
- * | 补弱项模式   | 0.7    | 0.2      | 0.1  | 强化错题练习             |
- * | 复习模式     | 0.4    | 0.5      | 0.1  | 注重遗忘曲线复习         |
- * | 挑战模式     | 0.3    | 0.2      | 0.5  | 攻克高难度题目           |
- * | 平衡模式     | 0.6    | 0.3      | 0.1  | 当前配置，均衡发展       |
+ * 本函数即平衡模式：scoreWithPolicy<BalancedPolicy>()，权重在编译期折叠为常量。
  *
  * @param q 题目对象，提供静态属性（难度、类型等）
  * @param st 题目统计信息，提供动态数据（做题次数、正确率、时间戳等）
@@ -85,156 +123,739 @@
  * @note 空间复杂度：O(1)，仅使用局部变量
  */
 double computeRecommendScore(const Question& q, const QuestionStat& st, long long now) {
-    // ============================================================
-    // 维度 1：错误率计算（权重 0.6）
-    // ============================================================
-    double errorRate = 1.0; // 初始化为最高值（假设未做过）
-    if (st.totalAttempts > 0) {
-        // 已做过的题：计算实际错误率
-        // errorRate = 错误次数 / 总次数
-        errorRate = (st.totalAttempts - st.correctAttempts) * 1.0 / st.totalAttempts;
+    return scoreWithPolicy<BalancedPolicy>(st.totalAttempts, st.correctAttempts, st.recentAttempts,
+                                           st.recentCorrect, st.lastTimestamp, q.difficulty, now);
+}
+
+namespace {
+
+/// liveDay_ 中表示"不在任何活跃桶中"
+constexpr long long kNotLive = LLONG_MIN;
+
+/// 活跃题目评分上界的余量：评分不超过 2，舍入差在 1e-15 量级
+constexpr double kLiveBoundSlack = 1e-9;
+
+/**
+ * @brief 第 i 道题在 today 当天的统计（含近 7 天窗口）
+ *
+ * g_questionStats 与 g_questions 按下标对齐，直接读取第 i 行，无需哈希查找；
+ * 近 7 天表现 O(1) 读取滚动窗口累加和。
+ */
+QuestionStat questionStatAt(size_t i, long long today) {
+    QuestionStat st; // 默认初始化（totalAttempts = 0, lastTimestamp = 0）
+    if (i < g_questionStats.size()) {
+        st = g_questionStats.at(i); // 稠密表第 i 行即该题统计（未做过则为默认值）
     }
-    // 未做过的题：保持 errorRate = 1.0，确保新题有较高优先级
+    if (RollingWindow* w = questionWindow(i)) {
+        const WindowTotals& recent = w->query(7, today);
+        st.recentAttempts = recent.attempts;
+        st.recentCorrect = recent.correct;
+    }
+    return st;
+}
 
-    // ============================================================
-    // 维度 2：时间间隔计算（权重 0.3）
-    // ============================================================
-    double timeGapDays = 1.0; // 默认 1 天（避免除零）
-    if (st.lastTimestamp > 0) {
-        // 有做题记录：计算距今天数
-        double seconds = difftime(now, (time_t)st.lastTimestamp);
-        if (seconds < 0) seconds = 0; // 防止时间戳异常（未来时间）
-        timeGapDays = seconds / 86400.0; // 转换为天数（86400 秒/天）
-    } else {
-        // 从未做过：给予 7 天的默认间隔，表示"该复习了"
-        timeGapDays = 7.0;
+// ------------------------------------------------------------
+// 按策略类型专门化的评分函数（登记到 ScoringProfile 的函数指针）
+// ------------------------------------------------------------
+
+template <class Policy>
+double scoreOneWith(const Question& q, const QuestionStat& st, long long now) {
+    return scoreWithPolicy<Policy>(st.totalAttempts, st.correctAttempts, st.recentAttempts, st.recentCorrect,
+                                   st.lastTimestamp, q.difficulty, now);
+}
+
+/**
+ * 批量评分：策略参数广播一次后交给当前指令集的内核。
+ * 实测标量级别下逐题内联 scoreWithPolicy<Policy>() 的循环反而较慢——常量折叠后
+ * 编译器把截断改写成"取常量 / 做乘法"的分支，遇到随机数据频繁预测失败——因此批量路径统一走内核。
+ */
+template <class Policy>
+void scoreBatchWith(const RecommendScoreColumns& c, long long now, double* out) {
+    kernelRecommendScores(c, policyWeights<Policy>(), now, out);
+}
+
+template <class Policy>
+void scoreSubsetWith(const int* qIdx, size_t count, long long now, double* out) {
+    long long today = dayIndexOf(now);
+    for (size_t k = 0; k < count; ++k) {
+        size_t i = (size_t)qIdx[k];
+        out[k] = scoreOneWith<Policy>(g_questions[i], questionStatAt(i, today), now);
     }
+}
 
-    // 归一化到 [0, 1]：以 7 天为基准，超过 7 天按满分计算
-    // 设计理念：7 天是记忆衰减的关键节点（艾宾浩斯遗忘曲线）
-    double timeScore = timeGapDays / 7.0;
-    if (timeScore > 1.0) timeScore = 1.0; // 上限截断
+template <class Policy>
+ScoringProfile makeScoringProfile() {
+    return ScoringProfile{Policy::kName, Policy::kLabel, policyWeights<Policy>(),
+                          scoreSettleDays(Policy::kHorizonDays),
+                          scoreOneWith<Policy>, scoreBatchWith<Policy>, scoreSubsetWith<Policy>};
+}
 
-    // ============================================================
-    // 维度 3：难度权重计算（权重 0.1）
-    // ============================================================
-    // 难度范围 [1, 5] 线性映射到 [0.2, 1.0]
-    // 公式：diffScore = 0.2 + (difficulty - 1) × 0.2
-    // 映射表：1→0.2, 2→0.4, 3→0.6, 4→0.8, 5→1.0
-    double diffScore = 0.2 + (q.difficulty - 1) * 0.2;
+/// 当前评分配置（nullptr 表示尚未选择，按默认配置处理）
+const ScoringProfile*& activeProfile() {
+    static const ScoringProfile* profile = nullptr;
+    return profile;
+}
 
-    // 边界保护：防止异常难度值导致越界
-    if (diffScore < 0.2) diffScore = 0.2; // 最低 0.2（难度1）
-    if (diffScore > 1.0) diffScore = 1.0; // 最高 1.0（难度5+）
+/**
+ * @brief 未作答题目的错误率维度改用潜因子模型的预测（未加载模型时不变）
+ *
+ * 逐题评分对未作答题目按错误率 1.0 计分；有预测答对率 p 的题目改为 1 - p，即减去 errorWeight × p。
+ * 未作答题目的评分不超过各维度权重与未做奖励之和（现有配置均为 1.2），不触及 [0, 2] 的截断，
+ * 因此先打分再修正与直接代入预测值相同。预测只随统计表整体重建而变（见 MatrixFactorization.h），
+ * 题目一经作答即不再修正，推荐索引对活跃题目的 scoreSubset 重新评分无需改动。
+ */
+void applyLatentFactors(const ScoringProfile& profile, std::vector<double>& scores) {
+    const std::vector<float>& predicted = g_latentFactors.predictions();
+    size_t n = std::min(scores.size(), predicted.size());
+    for (size_t i = 0; i < n; ++i) {
+        if (predicted[i] < 0.0f) continue;
+        if (i < g_questionStats.size() && g_questionStats.totalAttempts[i] > 0) continue;
+        scores[i] -= profile.weights.errorWeight * predicted[i];
+    }
+}
 
-    // ============================================================
-    // 维度 4：未做奖励（固定加分 +0.2）
-    // ============================================================
-    // 若从未尝试过该题，给予额外奖励，鼓励探索未知领域
-    double unseenBonus = (st.totalAttempts == 0 ? 0.2 : 0.0);
+/**
+ * @brief 已作答题目的时间间隔维度改用半衰期回归时，当前用户第 i 道题评分的修正量（见 halfLifeTimeAdjustment）
+ */
+double halfLifeAdjustment(const ScoringProfile& profile, size_t i, float halfLife, long long now) {
+    long long last = i < g_questionStats.size() ? g_questionStats.lastTimestamp[i] : 0;
+    return halfLifeTimeAdjustment(profile, last, halfLife, now);
+}
 
-    // ============================================================
-    // 综合评分：加权求和
-    // ============================================================
-    // 权重分配：
-    // - 0.6：错误率（主导）→ 攻克薄弱点
-    // - 0.3：时间间隔（辅助）→ 防止遗忘
-    // - 0.1：难度（调节）→ 梯度提升
-    // - +0.2：未做奖励（激励）→ 题库覆盖
-    double score = 0.6 * errorRate + 0.3 * timeScore + 0.1 * diffScore + unseenBonus;
+/**
+ * @brief 全部题目的时间间隔维度改用半衰期回归（未加载遗忘模型时不变）
+ *
+ * 半衰期由 HalfLifeModel::halfLives() 以 kernelDotRowsF32 一次算出，与推荐索引逐题计算的结果逐位相同。
+ */
+void applyHalfLife(const ScoringProfile& profile, long long now, std::vector<double>& scores) {
+    if (!g_halfLifeModel.loaded()) return;
+    const std::vector<float>& halfLives = g_halfLifeModel.halfLives();
+    size_t n = std::min(scores.size(), halfLives.size());
+    for (size_t i = 0; i < n; ++i) scores[i] += halfLifeAdjustment(profile, i, halfLives[i], now);
+}
 
-    // ============================================================
-    // 边界保护：限制评分范围
-    // ============================================================
-    // 理论最大值：0.6×1 + 0.3×1 + 0.1×1 + 0.2 = 1.2
-    // 但为防止异常，设置上限 2.0，下限 0.0
-    if (score < 0.0) score = 0.0;
-    if (score > 2.0) score = 2.0;
+/**
+ * @brief 按评分配置为全部题目评分（scores[i] 对应 g_questions[i]）
+ *
+ * 难度与近 7 天窗口整理成列后一次交给 profile.scoreBatch（AVX2 / AVX-512 内核），
+ * 统计列直接使用 g_questionStats 的存储；结果与逐题调用 profile.scoreOne 逐位相同。
+ * 加载了潜因子模型时，再以预测答对率修正未作答题目（见 applyLatentFactors）；
+ * 加载了遗忘模型时，再以回忆概率修正已作答题目（见 applyHalfLife）。
+ */
+void scoreAllQuestions(const ScoringProfile& profile, long long now, std::vector<double>& scores) {
+    size_t n = g_questions.size();
+    long long today = dayIndexOf(now);
+    scores.resize(n);
 
-    return score;
+    // 统计表尚未覆盖当前题库：逐题评分（缺失的行按默认值处理）
+    if (g_questionStats.size() != n) {
+        std::vector<int> all(n);
+        std::iota(all.begin(), all.end(), 0);
+        profile.scoreSubset(all.data(), n, now, scores.data());
+        applyLatentFactors(profile, scores);
+        applyHalfLife(profile, now, scores);
+        return;
+    }
+
+    // 整理列复用静态缓冲区，避免每次推荐都为百万级题库重新分配
+    static std::vector<int32_t> difficulty;
+    static std::vector<int32_t> recentAttempts;
+    static std::vector<int32_t> recentCorrect;
+    difficulty.resize(n);
+    recentAttempts.assign(n, 0);
+    recentCorrect.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        difficulty[i] = g_questions[i].difficulty;
+        if (RollingWindow* w = questionWindow(i)) {
+            const WindowTotals& recent = w->query(7, today);
+            recentAttempts[i] = recent.attempts;
+            recentCorrect[i] = recent.correct;
+        }
+    }
+
+    RecommendScoreColumns cols{g_questionStats.totalAttempts.data(), g_questionStats.correctAttempts.data(),
+                               recentAttempts.data(), recentCorrect.data(),
+                               g_questionStats.lastTimestamp.data(), difficulty.data(), n};
+    profile.scoreBatch(cols, now, scores.data());
+    applyLatentFactors(profile, scores);
+    applyHalfLife(profile, now, scores);
+}
+
+/// 题目所属的补强分组：知识点 ID + 1（无知识点或 ID 越界为 0）
+int boostGroup(const Question& q) {
+    return (q.knowledgeId >= 0 && (size_t)q.knowledgeId < g_knowledgeNames.size()) ? q.knowledgeId + 1 : 0;
+}
+
+/**
+ * @brief 第二阶段：按知识点计算前置补强分（boost[g] 对应 boostGroup() == g 的题目）
+ *
+ * 先刷新知识点掌握度（只重算作答后受影响的知识点），O(G)。
+ */
+void prereqBoosts(const ScoringProfile& profile, std::vector<double>& boost) {
+    g_knowledgeMastery.refresh();
+    size_t G = g_knowledgeNames.size() + 1;
+    boost.assign(G, 0.0);
+    for (size_t g = 1; g < G; ++g) {
+        boost[g] = profile.weights.prereqWeight * g_knowledgeMastery.inherited((int)g - 1);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 遗忘模型的修正量（时间间隔项由线性改为 hlrTimeScore）
+ *
+ * 已作答题目的评分不超过错误率、时间间隔、难度三项权重之和（现有配置均为 1.0），修正后仍在 [0, 2] 内，
+ * 因此先打分再修正与直接代入相同。从未作答的题目不修正。
+ */
+double halfLifeTimeAdjustment(const ScoringProfile& profile, long long lastTimestamp, float halfLife, long long now) {
+    if (lastTimestamp <= 0) return 0.0;
+    double seconds = (double)(now - lastTimestamp);
+    if (seconds < 0) seconds = 0;
+    double timeGapDays = seconds / 86400.0;
+    double linear = std::min(timeGapDays / (double)profile.weights.horizonDays, 1.0);
+    return profile.weights.timeWeight * (hlrTimeScore(timeGapDays, halfLife) - linear);
+}
+
+const std::vector<ScoringProfile>& scoringProfiles() {
+    static const std::vector<ScoringProfile> profiles = {
+        makeScoringProfile<BalancedPolicy>(),
+        makeScoringProfile<WeaknessPolicy>(),
+        makeScoringProfile<ReviewPolicy>(),
+        makeScoringProfile<ChallengePolicy>(),
+    };
+    return profiles;
+}
+
+bool selectScoringProfile(const std::string& name) {
+    for (const ScoringProfile& p : scoringProfiles()) {
+        if (name == p.name) {
+            activeProfile() = &p;
+            return true;
+        }
+    }
+    return false;
+}
+
+const ScoringProfile& activeScoringProfile() {
+    if (!activeProfile()) activeProfile() = &scoringProfiles().front();
+    return *activeProfile();
+}
+
+// ============================================================
+// 多样化选择（MMR）
+// ============================================================
+
+namespace {
+
+TopKSelection& activeSelection() {
+    static TopKSelection selection = TopKSelection::Heap;
+    return selection;
+}
+
+} // namespace
+
+bool selectTopKSelection(const std::string& name) {
+    if (name == "heap") {
+        activeSelection() = TopKSelection::Heap;
+    } else if (name == "mmr") {
+        activeSelection() = TopKSelection::Diverse;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+TopKSelection activeTopKSelection() {
+    return activeSelection();
+}
+
+double questionSimilarity(const Question& a, const Question& b) {
+    double sameKnowledge = (a.knowledgeId >= 0 && a.knowledgeId == b.knowledgeId) ? 1.0 : 0.0;
+    double closeDifficulty = 1.0 - std::min(std::abs(a.difficulty - b.difficulty), 4) / 4.0;
+    return kSameKnowledgeSimilarity * sameKnowledge + (1.0 - kSameKnowledgeSimilarity) * closeDifficulty;
 }
 
 /**
- * @brief 手写堆辅助函数：上浮调整（保持堆顶最大）
+ * @brief MMR 多样化选择（实现）
  *
- * 用于插入元素时，将新元素从底部向上调整到正确位置，维护大根堆性质。
+ * maxSim[c] 保存候选 c 与已选题目的最大相似度。每轮扫描一遍候选池取 MMR 值最大者，
+ * 再只用新选出的题目更新 maxSim，每轮 O(M)，共 O(M × K)。
+ */
+std::vector<RecommendItem> diversifyTopK(const std::vector<RecommendItem>& pool, size_t K, double lambda) {
+    size_t M = pool.size();
+    K = std::min(K, M);
+    std::vector<RecommendItem> out;
+    out.reserve(K);
+    if (K == 0) return out;
+
+    // 候选对应的题目与归一化相关性
+    std::vector<const Question*> question(M, nullptr);
+    double lo = pool[0].score;
+    double hi = pool[0].score;
+    for (size_t c = 0; c < M; ++c) {
+        auto itQ = g_questionById.find(pool[c].questionId);
+        if (itQ != g_questionById.end() && itQ->second < g_questions.size()) question[c] = &g_questions[itQ->second];
+        lo = std::min(lo, pool[c].score);
+        hi = std::max(hi, pool[c].score);
+    }
+    std::vector<double> relevance(M, 1.0);
+    if (hi > lo) {
+        for (size_t c = 0; c < M; ++c) relevance[c] = (pool[c].score - lo) / (hi - lo);
+    }
+
+    std::vector<double> maxSim(M, 0.0);
+    std::vector<char> taken(M, 0);
+    for (size_t step = 0; step < K; ++step) {
+        size_t best = M;
+        double bestValue = 0.0;
+        for (size_t c = 0; c < M; ++c) {
+            if (taken[c]) continue;
+            double value = lambda * relevance[c] - (1.0 - lambda) * maxSim[c];
+            if (best == M || value > bestValue) {
+                best = c;
+                bestValue = value;
+            }
+        }
+        taken[best] = 1;
+        out.push_back(pool[best]);
+
+        if (!question[best]) continue;
+        for (size_t c = 0; c < M; ++c) {
+            if (taken[c] || !question[c]) continue;
+            maxSim[c] = std::max(maxSim[c], questionSimilarity(*question[c], *question[best]));
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief 评分并选出 Top-K 推荐题目（实现）
  *
- * **【算法原理】**
- * 1. 从新插入的子节点开始（位于数组末尾）
- * 2. 计算父节点索引：parentIdx = (childIdx - 1) / 2
- * 3. 若父节点值 < 子节点值，则交换两者（大根堆要求父节点更大）
- * 4. 更新 childIdx = parentIdx，继续向上检查
- * 5. 重复直到满足堆性质或到达根节点
+ * **【为什么不用全量大根堆】**
+ * 早期实现把 N 道题全部插入手写大根堆（siftUp，O(N log N)，O(N) 空间），
+ * 再弹出 K 次。K = 5 而 N 可达百万时，绝大部分堆调整都花在永远不会被推荐的题目上。
  *
- * **【时间复杂度】** O(log N)，最多上浮 log N 层
- * **【空间复杂度】** O(1)，仅使用局部变量
+ * **【当前实现：大小为 K 的小根堆】**
+ * - 堆顶是已保留的 K 道题中分数最低的一道（"门槛"）
+ * - 新题分数不超过门槛时直接丢弃，O(1)；超过时替换堆顶并下沉，O(log K)
+ * - 扫描结束后 takeSorted() 按分数从高到低输出，O(K log K)
+ * - 比较器 RecommendItemBetter 带题号决胜，同分题目的推荐结果稳定
+ * - 评分按当前配置 activeScoringProfile() 由批量内核一次完成（见 scoreAllQuestions），
+ *   再加上所属知识点的前置补强分（见 prereqBoosts）
  *
- * @param heap 存储堆元素的 vector 容器（引用传递，原地修改）
- * @param childIdx 待调整元素的索引（通常是新插入的元素）
+ * 作为全量扫描的参照实现；交互式推荐使用增量索引 g_recommendIndex，结果与本函数一致。
+ */
+std::vector<RecommendItem> recommendTopK(size_t K, long long now) {
+    // 批量评分（O(N)，向量化），再流式插入 TopK（丢弃 O(1) / 保留 O(log K)）
+    std::vector<double> scores;
+    std::vector<double> boost;
+    scoreAllQuestions(activeScoringProfile(), now, scores);
+    prereqBoosts(activeScoringProfile(), boost);
+
+    TopK<RecommendItem, RecommendItemBetter> top(K);
+    for (size_t i = 0; i < g_questions.size(); ++i) {
+        double total = scores[i] + boost[boostGroup(g_questions[i])];
+        // 已满且分数严格低于门槛：必被丢弃
+        if (top.full() && !top.empty() && total < top.worst().score) continue;
+        top.push({g_questions[i].id, total, scores[i]});
+    }
+    return top.takeSorted();
+}
+
+/**
+ * @brief 逐题评分分项（实现）
  *
- * @note 使用 RecommendItem 的 operator< 进行比较（score 小的 < 返回 true）
- * @note 大根堆定义：父节点 >= 子节点，heap[parent] >= heap[child]
+ * 修正量与 applyLatentFactors / applyHalfLife 相同：潜因子只修正未作答题目，遗忘模型只修正作答过的题目。
  */
-void siftUp(std::vector<RecommendItem>& heap, int childIdx) {
-    while (childIdx > 0) {
-        int parentIdx = (childIdx - 1) / 2;
-        // 若父节点 < 子节点（operator< 返回 true），说明违反大根堆性质，需要交换
-        if (heap[parentIdx] < heap[childIdx]) {
-            std::swap(heap[parentIdx], heap[childIdx]);
-            childIdx = parentIdx; // 继续向上检查
-        } else {
-            break; // 满足堆性质，停止调整
+RecommendScoreBreakdown explainRecommendScore(const ScoringProfile& profile, size_t qIdx, long long now) {
+    RecommendScoreBreakdown b;
+    if (qIdx >= g_questions.size()) return b;
+    const ScoreWeights& w = profile.weights;
+    const Question& q = g_questions[qIdx];
+    QuestionStat st = questionStatAt(qIdx, dayIndexOf(now));
+
+    b.errorRate = 1.0;
+    if (st.totalAttempts > 0) b.errorRate = (st.totalAttempts - st.correctAttempts) * 1.0 / st.totalAttempts;
+    if (st.recentAttempts > 0) {
+        double recentErrorRate = (st.recentAttempts - st.recentCorrect) * 1.0 / st.recentAttempts;
+        b.errorRate = (1.0 - w.recentWeight) * b.errorRate + w.recentWeight * recentErrorRate;
+    }
+
+    b.timeGapDays = (double)w.horizonDays;
+    if (st.lastTimestamp > 0) {
+        double seconds = (double)(now - st.lastTimestamp);
+        if (seconds < 0) seconds = 0;
+        b.timeGapDays = seconds / 86400.0;
+    }
+    double timeScore = std::min(b.timeGapDays / (double)w.horizonDays, 1.0);
+    double diffScore = std::min(std::max(0.2 + (q.difficulty - 1) * 0.2, 0.2), 1.0);
+    b.unseenTerm = st.totalAttempts == 0 ? w.unseenBonus : 0.0;
+    b.score = profile.scoreOne(q, st, now);
+
+    if (st.totalAttempts == 0) {
+        float predicted = g_latentFactors.loaded() ? g_latentFactors.predict(qIdx) : -1.0f;
+        if (predicted >= 0.0f) {
+            b.predictedCorrect = predicted;
+            b.errorRate = 1.0 - predicted;
+            b.score -= w.errorWeight * predicted;
         }
+    } else if (g_halfLifeModel.loaded()) {
+        float halfLife = g_halfLifeModel.halfLifeDays(qIdx);
+        b.halfLifeDays = halfLife;
+        timeScore = hlrTimeScore(b.timeGapDays, halfLife);
+        b.score += halfLifeAdjustment(profile, qIdx, halfLife, now);
     }
+
+    b.errorTerm = w.errorWeight * b.errorRate;
+    b.timeTerm = w.timeWeight * timeScore;
+    b.difficultyTerm = w.difficultyWeight * diffScore;
+    return b;
 }
 
+// ============================================================
+// RecommendIndex：增量维护的推荐优先级索引
+// ============================================================
+
+RecommendIndex g_recommendIndex;
+
 /**
- * @brief 手写堆辅助函数：下沉调整（保持堆顶最大）
+ * @brief 整体重建：为全部题目评分并建堆
  *
- * 用于删除堆顶时，将新的根节点向下调整到正确位置，维护大根堆性质。
+ * 按当前评分配置批量评分 O(N)（向量化内核）；按知识点计数排序把题目分段放入 heap_，
+ * 每段 Floyd 自底向上建堆，合计 O(N)。评分尚未稳定（稳定日晚于今天，见 settleDayOf）的题目放入对应的活跃桶，
+ * 堆中的键改为其评分上界（upperBound）。
+ */
+void RecommendIndex::rebuild(long long now) {
+    size_t n = g_questions.size();
+    size_t G = g_knowledgeNames.size() + 1;
+    long long today = dayIndexOf(now);
+    profile_ = &activeScoringProfile();
+
+    heap_.resize(n);
+    pos_.resize(n);
+    group_.resize(n);
+    score_.resize(n);
+    id_.resize(n);
+    liveDay_.assign(n, kNotLive);
+    liveByDay_.clear();
+    liveCount_ = 0;
+
+    // 按段计数，得到各段起点
+    groupBegin_.assign(G + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        group_[i] = boostGroup(g_questions[i]);
+        ++groupBegin_[group_[i] + 1];
+    }
+    for (size_t g = 0; g < G; ++g) groupBegin_[g + 1] += groupBegin_[g];
+
+    scoreAllQuestions(*profile_, now, score_);
+    std::vector<size_t> next(groupBegin_.begin(), groupBegin_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        id_[i] = g_questions[i].id;
+        size_t p = next[group_[i]]++;
+        heap_[p] = (int)i;
+        pos_[i] = (int)p;
+
+        long long settle = settleDayOf(i);
+        if (settle > today) {
+            track(i, settle);
+            score_[i] = upperBound(i);   // 活跃题目在堆中以上界排序，精确评分推迟到 Top-K 遍历
+        }
+    }
+    pending_.clear();
+    for (size_t g = 0; g < G; ++g) {
+        size_t len = groupBegin_[g + 1] - groupBegin_[g];
+        for (size_t j = len / 2; j-- > 0;) siftDown(groupBegin_[g] + j);
+    }
+    offset_.assign(G, 0.0);
+
+    epoch_ = g_questionStats.epoch;
+    built_ = true;
+}
+
+/**
+ * @brief 刷新索引
+ *
+ * 1. 统计表已整体重建、题库大小或知识点数变化、评分配置已切换：整体重建
+ * 2. 到期的桶（评分稳定日 <= today）：题目按 now 最后精确评分一次并移出跟踪，此后堆中的键即其评分
+ * 3. 上次查询后作答过的题目：键改为新的评分上界
+ * 4. 各段的前置补强分按最新的知识点掌握度更新（只改偏移，不动堆）
+ * 其余活跃题目的上界不随时间变化，不需要任何处理。
+ */
+void RecommendIndex::refresh(long long now) {
+    if (!built_ || epoch_ != g_questionStats.epoch || id_.size() != g_questions.size() ||
+        groupBegin_.size() != g_knowledgeNames.size() + 2 || profile_ != &activeScoringProfile()) {
+        rebuild(now);
+        syncOffsets();
+        return;
+    }
+    long long today = dayIndexOf(now);
+
+    while (!liveByDay_.empty() && liveByDay_.begin()->first <= today) {
+        long long day = liveByDay_.begin()->first;
+        std::vector<int>& qs = liveByDay_.begin()->second;
+        size_t kept = 0;
+        for (int q : qs) {
+            if (liveDay_[q] != day) continue;   // 已迁往更晚的桶
+            liveDay_[q] = kNotLive;
+            --liveCount_;
+            qs[kept++] = q;
+        }
+        qs.resize(kept);
+        rescore(qs, now);
+        liveByDay_.erase(liveByDay_.begin());
+    }
+
+    for (int q : pending_) {
+        if (liveDay_[q] != kNotLive) update(q, upperBound(q));
+    }
+    pending_.clear();
+    syncOffsets();
+}
+
+void RecommendIndex::syncOffsets() {
+    prereqBoosts(*profile_, offset_);
+}
+
+/**
+ * @brief 按 now 为一组到期题目精确评分（一次 scoreSubset 调用）并逐题调整堆
  *
- * **【算法原理】**
- * 1. 从根节点开始（parentIdx = 0）
- * 2. 计算左右子节点索引：
- *    - left = 2 × parentIdx + 1
- *    - right = 2 × parentIdx + 2
- * 3. 找出父、左、右三者中的最大值
- * 4. 若最大值不是父节点，则交换父节点与最大值子节点
- * 5. 更新 parentIdx 为被交换的子节点索引，继续向下检查
- * 6. 重复直到满足堆性质或到达叶子节点
+ * 加载了遗忘模型时逐题加上与全量评分相同的半衰期修正（见 halfLifeAdjustment）。
+ */
+void RecommendIndex::rescore(const std::vector<int>& qs, long long now) {
+    if (qs.empty()) return;
+    scratch_.resize(qs.size());
+    profile_->scoreSubset(qs.data(), qs.size(), now, scratch_.data());
+    if (g_halfLifeModel.loaded()) {
+        for (size_t k = 0; k < qs.size(); ++k) {
+            scratch_[k] += halfLifeAdjustment(*profile_, qs[k], g_halfLifeModel.halfLifeDays(qs[k]), now);
+        }
+    }
+    for (size_t k = 0; k < qs.size(); ++k) update(qs[k], scratch_[k]);
+}
+
+/**
+ * @brief 题目评分不再随时间变化的日序号
  *
- * **【时间复杂度】** O(log N)，最多下沉 log N 层
- * **【空间复杂度】** O(1)，仅使用局部变量
+ * 评分配置的部分在最近作答日 + settleDays 起稳定（时间间隔封顶、近 7 天窗口清空）；
+ * 加载了遗忘模型时还需等到回忆概率确定低于一半（HalfLifeModel::settleDay），两者取较晚者。
+ * 从未作答的题目评分恒定，返回 kNotLive。
+ */
+long long RecommendIndex::settleDayOf(size_t qIdx) const {
+    long long last = qIdx < g_questionStats.size() ? g_questionStats.lastTimestamp[qIdx] : 0;
+    if (last <= 0) return kNotLive;
+    return std::max(dayIndexOf(last) + profile_->settleDays, g_halfLifeModel.settleDay(qIdx));
+}
+
+/**
+ * @brief 活跃题目的评分上界：此后任何时刻（直到再次作答）的逐题评分都不超过它
  *
- * @param heap 存储堆元素的 vector 容器（引用传递，原地修改）
- * @param parentIdx 待调整元素的索引（通常是根节点 0）
+ * 各权重非负，逐题评分对每个维度单调不减，因此分别取各维度可能的最大值：
+ * - 错误率：近 7 天窗口按"全部答错"计入，(1 - recentWeight) × 历史错误率 + recentWeight 不小于
+ *   任何近期窗口下的混合结果，也不小于窗口清空后的历史错误率
+ * - 时间间隔：按已封顶计（now = 最近作答 + horizonDays 天）；遗忘模型的时间间隔维度同样不超过 1
+ * - 难度、作答次数只在作答时变化，作答后由 markDirty 重新取上界
+ * 以 scoreOne 按相同的运算顺序计算，再加 kLiveBoundSlack 吸收与精确评分之间的舍入差，保证不小于精确评分。
+ */
+double RecommendIndex::upperBound(size_t qIdx) const {
+    QuestionStat st = g_questionStats.at(qIdx);
+    st.recentAttempts = 1;
+    st.recentCorrect = 0;
+    long long capped = st.lastTimestamp + (long long)profile_->weights.horizonDays * 86400;
+    double bound = profile_->scoreOne(g_questions[qIdx], st, capped);
+    // 遗忘模型的修正加在截断到 2.0 之后：上界已被截断时，精确评分最多再高出 timeWeight
+    if (g_halfLifeModel.loaded() && bound >= 2.0) bound += profile_->weights.timeWeight;
+    return bound + kLiveBoundSlack;
+}
+
+/**
+ * @brief 活跃题目在 now 的精确逐题评分（与 rescore / 全量评分逐位相同）
+ */
+double RecommendIndex::exactScore(int qIdx, long long now) const {
+    double score = 0.0;
+    profile_->scoreSubset(&qIdx, 1, now, &score);
+    if (g_halfLifeModel.loaded()) {
+        score += halfLifeAdjustment(*profile_, qIdx, g_halfLifeModel.halfLifeDays(qIdx), now);
+    }
+    return score;
+}
+
+/**
+ * @brief 把题目放入评分稳定日对应的桶
  *
- * @note 使用 RecommendItem 的 operator< 进行比较
- * @note 边界检查：left/right 必须 < size 才存在
+ * 再次作答后稳定日可能推后，也可能提前（遗忘模型下答错使半衰期变短），两种情况都迁往新桶。
  */
-void siftDown(std::vector<RecommendItem>& heap, int parentIdx) {
-    int size = heap.size();
+void RecommendIndex::track(size_t qIdx, long long day) {
+    long long& cur = liveDay_[qIdx];
+    if (cur == day) return;
+    if (cur == kNotLive) ++liveCount_;
+    cur = day;   // 旧桶中的条目变为过期，刷新时跳过
+    liveByDay_[day].push_back((int)qIdx);
+}
+
+/**
+ * @brief 修改一道题的评分并恢复堆性质（increase-key 上浮 / decrease-key 下沉）
+ */
+void RecommendIndex::update(size_t qIdx, double score) {
+    double old = score_[qIdx];
+    if (score == old) return;
+    score_[qIdx] = score;
+    if (score > old) {
+        siftUp(pos_[qIdx]);
+    } else {
+        siftDown(pos_[qIdx]);
+    }
+}
+
+/// 段内上浮：段起点 b 处为该段堆顶，下标 i 的父结点为 b + (i - b - 1) / 2
+void RecommendIndex::siftUp(size_t i) {
+    int q = heap_[i];
+    size_t b = groupBegin_[group_[q]];
+    while (i > b) {
+        size_t parent = b + (i - b - 1) / 2;
+        if (!better(q, heap_[parent])) break;
+        heap_[i] = heap_[parent];
+        pos_[heap_[i]] = (int)i;
+        i = parent;
+    }
+    heap_[i] = q;
+    pos_[q] = (int)i;
+}
+
+/// 段内下沉：下标 i 的孩子为 b + 2 (i - b) + 1 与其后一位，不越过段终点
+void RecommendIndex::siftDown(size_t i) {
+    int q = heap_[i];
+    size_t b = groupBegin_[group_[q]];
+    size_t n = groupBegin_[group_[q] + 1];
     while (true) {
-        int left = 2 * parentIdx + 1;
-        int right = 2 * parentIdx + 2;
-        int largest = parentIdx;
+        size_t child = b + 2 * (i - b) + 1;
+        if (child >= n) break;
+        if (child + 1 < n && better(heap_[child + 1], heap_[child])) ++child;
+        if (!better(heap_[child], q)) break;
+        heap_[i] = heap_[child];
+        pos_[heap_[i]] = (int)i;
+        i = child;
+    }
+    heap_[i] = q;
+    pos_[q] = (int)i;
+}
 
-        // 找出父、左、右三者中的最大值
-        if (left < size && heap[largest] < heap[left]) {
-            largest = left;
-        }
-        if (right < size && heap[largest] < heap[right]) {
-            largest = right;
+void RecommendIndex::markDirty(size_t qIdx) {
+    if (!built_ || qIdx >= liveDay_.size() || qIdx >= g_questionStats.size()) return;
+    long long settle = settleDayOf(qIdx);
+    if (settle == kNotLive) return;
+    track(qIdx, settle);
+    pending_.push_back((int)qIdx);
+}
+
+/**
+ * @brief 取 Top-K：各段堆上的有界最优优先遍历，活跃题目按需精确评分
+ *
+ * 堆中的键对已稳定的题目是精确评分，对活跃题目是评分上界；段内孩子的键不高于父结点。
+ * 维护一个候选小堆，候选按 (总分, 逐题评分, 题号) 的推荐顺序（同 ahead）比较，初始为各段堆顶：
+ * - 取出一个堆结点：把它在段内的两个孩子加入候选；已稳定的题目直接输出，
+ *   活跃题目按 now 精确评分后作为"已评分"候选重新放回
+ * - 取出一个已评分候选：直接输出
+ * 每个候选的键都不小于其真实的推荐顺序位置（上界 ≥ 精确评分），因此被取出的已确定项一定排在所有剩余题目之前，
+ * 结果与全量扫描逐项相同。只有上界进入前 K 附近的活跃题目会被精确评分。
+ */
+std::vector<RecommendItem> RecommendIndex::topK(size_t K, long long now) {
+    {
+        TraceTimer timer(TraceStage::Score);
+        refresh(now);
+    }
+    TraceTimer timer(TraceStage::Select);
+
+    std::vector<RecommendItem> out;
+    if (heap_.empty() || K == 0) return out;
+    out.reserve(K);
+
+    struct Candidate {
+        double total;     ///< 推荐总分（活跃题目未评分时为上界）
+        double base;      ///< 逐题评分（同上）
+        int q;            ///< 题目下标
+        size_t pos;       ///< heap_ 中的位置（已评分候选不再使用）
+        bool scored;      ///< 是否为已精确评分的活跃题目
+    };
+    auto worse = [this](const Candidate& a, const Candidate& b) {
+        if (a.total != b.total) return a.total < b.total;
+        if (a.base != b.base) return a.base < b.base;
+        return id_[a.q] > id_[b.q];
+    };
+    auto node = [this](size_t p) {
+        int q = heap_[p];
+        return Candidate{total(q), score_[q], q, p, false};
+    };
+
+    std::vector<Candidate> frontier;
+    for (size_t g = 0; g + 1 < groupBegin_.size(); ++g) {
+        if (groupBegin_[g] < groupBegin_[g + 1]) frontier.push_back(node(groupBegin_[g]));
+    }
+    std::make_heap(frontier.begin(), frontier.end(), worse);
+    while (!frontier.empty() && out.size() < K) {
+        std::pop_heap(frontier.begin(), frontier.end(), worse);
+        Candidate c = frontier.back();
+        frontier.pop_back();
+        if (c.scored) {
+            out.push_back({id_[c.q], c.total, c.base});
+            continue;
         }
 
-        // 若最大值不是当前父节点，则交换并继续下沉
-        if (largest != parentIdx) {
-            std::swap(heap[parentIdx], heap[largest]);
-            parentIdx = largest; // 继续向下检查
+        size_t b = groupBegin_[group_[c.q]];
+        size_t e = groupBegin_[group_[c.q] + 1];
+        for (size_t child = b + 2 * (c.pos - b) + 1; child <= b + 2 * (c.pos - b) + 2 && child < e; ++child) {
+            frontier.push_back(node(child));
+            std::push_heap(frontier.begin(), frontier.end(), worse);
+        }
+        if (liveDay_[c.q] == kNotLive) {
+            out.push_back({id_[c.q], c.total, c.base});
         } else {
-            break; // 满足堆性质，停止调整
+            double base = exactScore(c.q, now);
+            frontier.push_back({base + offset_[group_[c.q]], base, c.q, c.pos, true});
+            std::push_heap(frontier.begin(), frontier.end(), worse);
         }
     }
+    return out;
+}
+
+void markRecommendDirty(int questionId) {
+    g_recommendCache.invalidate();
+    auto itQ = g_questionById.find(questionId);
+    if (itQ == g_questionById.end()) return;
+    g_recommendIndex.markDirty(itQ->second);
+}
+
+// ============================================================
+// RecommendCache：带版本的推荐结果缓存
+// ============================================================
+
+RecommendCache g_recommendCache;
+
+std::vector<RecommendItem> RecommendCache::topK(size_t K, long long now) {
+    long long bucket = now / kRecommendCacheBucketSeconds;
+    const ScoringProfile* profile = &activeScoringProfile();
+    if (valid_ && epoch_ == g_questionStats.epoch && version_ == g_questionStats.version &&
+        profile_ == profile && K_ == K && bucket_ == bucket) {
+        ++hits_;
+        return items_;
+    }
+
+    ++misses_;
+    items_ = g_recommendIndex.topK(K, now);
+    valid_ = true;
+    epoch_ = g_questionStats.epoch;
+    version_ = g_questionStats.version;
+    profile_ = profile;
+    K_ = K;
+    bucket_ = bucket;
+    return items_;
+}
+
+void RecommendCache::invalidate() {
+    if (valid_) ++invalidations_;
+    valid_ = false;
+    items_.clear();
 }
 
 /**
@@ -248,43 +869,29 @@ void siftDown(std::vector<RecommendItem>& heap, int parentIdx) {
  * - 检查题库是否为空，空题库无法推荐
  * - 若为空，提示用户并返回
  *
- * **Step 2：更新统计信息**
- * - 调用 buildQuestionStats() 重新统计所有题目的做题记录
- * - 确保统计数据是最新的（用户可能刚做完题）
- * - 统计内容包括：每道题的总尝试次数、正确次数、最后做题时间戳
+ * **Step 2：确认统计信息可用**
+ * - 统计表在登录加载记录时构建，之后每次 doQuestion() 由 applyRecordToStats() 增量更新，
+ *   因此无需每次进入都重建；仅当统计表尚未覆盖当前题库时调用 buildQuestionStats()
  *
  * **Step 3：获取当前时间**
  * - 记录当前时间戳 now = time(nullptr)
  * - 用于计算距上次做题的时间间隔
  *
- * **Step 4：评分阶段（核心步骤）**
- * - 遍历所有题目，时间复杂度 O(N)，其中 N = 题库总数
- * - 对每道题：
- *   1. 从 g_questionStats 中查找该题的统计信息（O(log N)，map 查找）
- *   2. 若无统计信息，使用默认值（表示从未做过）
- *   3. 调用 computeRecommendScore() 计算推荐分数（O(1)）
- *   4. 将 {题目ID, 分数} 封装成 RecommendItem 插入优先队列（O(log N)）
- *
- * **Step 5：使用手写堆维护 Top-K**
- * - 数据结构：std::vector<RecommendItem> 模拟完全二叉树
- * - 堆性质：大根堆，父节点分数 >= 子节点分数
- * - 核心操作：
- *   * siftUp()：插入元素时上浮调整，时间复杂度 O(log N)
- *   * siftDown()：删除堆顶时下沉调整，时间复杂度 O(log N)
- * - 为什么是大根堆：
- *   * 需要推荐分数最高的 K 道题
- *   * 大根堆堆顶即为最大值，符合需求
- *   * 通过重载 operator< 实现（score 小的返回 true）
- *
- * **Step 6：提取 Top-K 题目**
- * - 从手写堆中依次取出前 K 个题目（O(K log N)）
- * - 删除堆顶操作：
- *   1. 取出堆顶元素（最大值）
- *   2. 将堆尾元素移到堆顶
- *   3. 删除堆尾
- *   4. 对新堆顶执行 siftDown() 下沉调整
+ * **Step 4~6：从增量索引 g_recommendIndex 取 Top-K**
+ * - 首次进入（或切换用户、统计重建后）：为全部题目评分并建堆，O(N)
+ * - 之后进入：只对最近 settleDays 天内作答过的题目按 now 重新评分并原地调整堆，
+ *   再在各知识点段的堆上做有界遍历取前 K 项，O(L log N + (K + G) log(K + G))，
+ *   L 为近期作答过的题目数，G 为知识点数
+ * - 前置补强：知识点掌握度只重算作答后受影响的知识点，各段偏移随之更新，不触及题目
+ * - doQuestion() 作答后调用 markRecommendDirty()，该题在下次查询时重新评分
+ * - 结果与全量扫描 recommendTopK() 完全一致（同分按题号决胜）
+ * - 外层是结果缓存 g_recommendCache：统计版本、评分配置与 10 分钟时间桶都未变时直接返回上次结果，
+ *   反复进出菜单不再触及索引
+ * - 以 --select mmr 启动时，取前 K × kDiversityPoolFactor 道作为候选池，再以 diversifyTopK() 挑选 K 道，
+ *   避免 5 道题都来自同一个薄弱知识点
  * - 若题库总数 < K，则推荐全部题目
- * - 存储到 selected 向量中，保持推荐顺序（分数从高到低）
+ * - 以 --trace 启动时，把各阶段耗时（统计重建、评分、选择）与每道推荐题的评分分项追加为一行 JSON
+ *   （见 RecommendTrace.h）；未开启时每个计时点只有一次布尔判断
  *
  * **Step 7：展示推荐列表并进入练习**
  * - 打印推荐说明，告知用户推荐依据（错误率、时间间隔、难度）
@@ -302,53 +909,24 @@ void siftDown(std::vector<RecommendItem>& heap, int parentIdx) {
  *
  * **【时间复杂度分析】**
  *
- * 设题库总数为 N，推荐数量为 K（通常 K = 5 << N）：
- *
- * 1. 统计更新：O(M log N)，M = 做题记录数，N = 题目数（map 插入）
- * 2. 遍历题目：O(N)
- * 3. 查找统计：O(log N) × N = O(N log N)（map 查找）
- * 4. 计算评分：O(1) × N = O(N)
- * 5. 插入堆：O(log N) × N = O(N log N)（手写 siftUp 调整）
- * 6. 取出 Top-K：O(log N) × K = O(K log N)（手写 siftDown 调整）
- * 7. 做题过程：O(K)（用户交互，与算法复杂度无关）
+ * 设题库总数为 N，推荐数量为 K（通常 K = 5 << N），最近作答过的题目数为 L：
  *
- * **总体时间复杂度：O(N log N)**
- * - 主要瓶颈在于 map 查找和堆插入调整
- * - 对于小规模题库（N < 10000），性能表现优秀
- * - 可进一步优化为 O(N log K)（使用小顶堆维护 Top-K）
+ * 1. 首次进入：O(N)（全部评分 + 自底向上建堆）
+ * 2. 之后进入：O(L log N + (K + G) log(K + G))，与题库大小基本无关，通常在亚毫秒级
+ *    （可用 `DS_AI_Quiz_Bench --bench-recommend` 对比全量评分与增量索引）
+ * 3. 做题过程：O(K)（用户交互，与算法复杂度无关）
  *
  * **【空间复杂度分析】**
  *
- * 1. 手写堆（vector）：O(N)，存储所有题目的推荐项
+ * 1. 推荐索引：O(N)（堆、位置表、评分与题号各一列，常驻内存）
  * 2. selected 向量：O(K)
- * 3. 统计信息 map：O(N)
- * 4. 局部变量：O(1)
- *
- * **总体空间复杂度：O(N)**
- *
- * **【优化建议】**
- *
- * 若题库规模较大（N > 100000），可采用以下优化：
- *
- * 1. **小顶堆优化（O(N log K)）**
- *    - 维护大小为 K 的小顶堆
- *    - 遇到更大分数时替换堆顶
- *    - 时间复杂度降为 O(N log K)
- *
- * 2. **缓存评分结果**
- *    - 若统计信息未变，无需重复计算
- *    - 可使用 memoization 技术
- *
- * 3. **并行计算**
- *    - 评分计算可并行化（各题目独立）
- *    - 使用 OpenMP 或线程池
  *
  * @note 当前配置：K = 5，可根据需求调整
  * @note 若用户中途退出做题，已做题目的记录会保存
  *
  * @see computeRecommendScore() 评分算法详解
  * @see RecommendItem 推荐项数据结构
- * @see buildQuestionStats() 统计信息构建
+ * @see RecommendIndex 增量推荐索引
  * @see doQuestion() 题目作答流程
  */
 void aiRecommendMode() {
@@ -362,11 +940,17 @@ void aiRecommendMode() {
     }
 
     // ============================================================
-    // Step 2：更新统计信息 - 确保数据是最新的
+    // Step 2：确认统计信息可用
     // ============================================================
-    // 重要：用户可能刚做完题，需要重新统计才能获取最新的错误率和时间戳
-    // buildQuestionStats() 会遍历 records.txt，重建 g_questionStats
-    buildQuestionStats();
+    // 统计表在加载记录时构建、答题后增量更新，只有尚未覆盖当前题库时才需要重建
+    // 开启 --trace 时记录各阶段耗时（关闭时 TraceTimer 不读时钟）
+    if (recommendTraceOn()) g_recommendTrace.beginEvent();
+    {
+        TraceTimer timer(TraceStage::Stats);
+        if (g_questionStats.size() != g_questions.size()) {
+            buildQuestionStats();
+        }
+    }
 
     // ============================================================
     // Step 3：获取当前时间戳
@@ -375,87 +959,43 @@ void aiRecommendMode() {
     long long now = (long long)std::time(nullptr);
 
     // ============================================================
-    // Step 4 & 5：评分 + 堆维护 - 核心算法
-    // ============================================================
-    // 【原始实现 - 使用 STL priority_queue（已注释保留）】
-    // std::priority_queue<RecommendItem> pq;  // STL 大顶堆，自动维护堆性质
-    // for (const auto& q : g_questions) {
-    //     QuestionStat st;
-    //     auto it = g_questionStats.find(q.id);
-    //     if (it != g_questionStats.end()) {
-    //         st = it->second;
-    //     }
-    //     double s = computeRecommendScore(q, st, now);
-    //     pq.push({q.id, s});  // STL 自动调用堆插入算法
-    // }
-    // ============================================================
-    // 【当前实现 - 手写堆算法】
-    // 使用 vector + 手写 siftUp/siftDown 维护分数最高的题目
-    // 1. 数组模拟完全二叉树
-    // 2. 手动实现堆的上浮和下沉操作
-    std::vector<RecommendItem> myHeap;
-
-    // 遍历所有题目，计算推荐分数并插入堆
-    // 时间复杂度：O(N log N)
-    for (const auto& q : g_questions) {
-        QuestionStat st; // 默认初始化（totalAttempts = 0, lastTimestamp = 0）
-
-        // 从统计 map 中查找该题的记录
-        auto it = g_questionStats.find(q.id);
-        if (it != g_questionStats.end()) {
-            st = it->second; // 找到记录，使用实际统计数据
-        }
-        // 未找到记录：使用默认值（视为从未做过）
-
-        // 计算推荐评分（O(1)）
-        double s = computeRecommendScore(q, st, now);
-
-        // 【手写堆插入操作】（O(log N)）
-        // 1. 先放到数组末尾
-        myHeap.push_back({q.id, s});
-        // 2. 执行上浮操作，维持大根堆性质
-        siftUp(myHeap, myHeap.size() - 1);
-    }
-
-    // ============================================================
-    // Step 6：确定推荐数量 K
+    // Step 4 & 5 & 6：从增量索引取 Top-K - 核心算法
     // ============================================================
+    // 只有近期作答过的题目需要按 now 重新评分，其余题目评分常驻索引
     int K = 5; // 默认推荐 5 道题（可根据需求调整）
     if ((int)g_questions.size() < K) {
         K = (int)g_questions.size(); // 题库不足 K 道，推荐全部
     }
+    // 两次进入之间没有作答时直接复用上次结果（见 RecommendCache）
+    // 多样化选择：先取前 K × kDiversityPoolFactor 道作为候选池，再以 MMR 挑选
+    bool diverse = activeTopKSelection() == TopKSelection::Diverse;
+    size_t cacheHits = g_recommendCache.hits();
+    std::vector<RecommendItem> ranked = g_recommendCache.topK(diverse ? (size_t)K * kDiversityPoolFactor : (size_t)K, now);
+    if (diverse) {
+        TraceTimer timer(TraceStage::Select);
+        ranked = diversifyTopK(ranked, (size_t)K, kDiversityLambda);
+    }
+    // 追踪：每道推荐题的评分分项与各阶段耗时写成一行 JSON（见 RecommendTrace.h）
+    if (recommendTraceOn()) {
+        g_recommendTrace.writeEvent(ranked, (size_t)K, diverse, g_recommendCache.hits() != cacheHits, now);
+    }
 
     // 打印推荐说明
-    std::cout << "【AI 智能推荐模式】本次为你推荐 " << K << " 道题。\n";
-    std::cout << "根据你的历史做题记录，优先推荐错误率高、长期未练习或难度较高的题目。\n\n";
+    std::cout << "【AI 智能推荐模式】本次为你推荐 " << K << " 道题（评分配置："
+              << activeScoringProfile().label << (diverse ? "，兼顾知识点与难度的多样性" : "") << "）。\n";
+    std::cout << "根据你的历史做题记录，优先推荐错误率高、长期未练习或难度较高的题目。\n";
+    std::vector<std::string> weak = weakPrerequisites(3, 0.1);
+    if (!weak.empty()) {
+        std::cout << "后续知识点掌握不牢，建议先巩固前置知识点：";
+        for (size_t i = 0; i < weak.size(); ++i) std::cout << (i ? "、" : "") << weak[i];
+        std::cout << "\n";
+    }
+    std::cout << "\n";
 
-    // ============================================================
-    // Step 6：提取 Top-K 题目 ID
-    // ============================================================
     std::vector<int> selected;
     selected.reserve(K); // 预分配空间，避免动态扩容
-
-    // 【原始实现 - 使用 STL priority_queue（已注释保留）】
-    // while (!pq.empty() && (int)selected.size() < K) {
-    //     selected.push_back(pq.top().questionId);  // STL 获取堆顶
-    //     pq.pop();                                 // STL 自动调用堆删除算法
-    // }
-    // ============================================================
-    // 【当前实现 - 手写堆删除操作】
-    // 从堆中依次取出前 K 个最高分题目
-    // 时间复杂度：O(K log N)
-    while (!myHeap.empty() && (int)selected.size() < K) {
-        // 【手写堆删除堆顶操作】
-        selected.push_back(myHeap[0].questionId); // 堆顶即最大值
-
-        // 1. 将堆顶与最后一个元素交换
-        std::swap(myHeap[0], myHeap.back());
-        // 2. 删除最后一个元素（原来的堆顶）
-        myHeap.pop_back();
-        // 3. 如果堆不为空，对新的堆顶执行下沉操作
-        if (!myHeap.empty()) {
-            siftDown(myHeap, 0);
-        }
+    for (const RecommendItem& item : ranked) {
+        selected.push_back(item.questionId); // 已按分数从高到低排列
     }
 
     // ============================================================
@@ -473,11 +1013,39 @@ void aiRecommendMode() {
 
         // 打印题目序号分隔线
         std::cout << "-----------------------------\n";
-        std::cout << "第 " << (i + 1) << " 道推荐题：\n";
+        std::cout << "第 " << (i + 1) << " 道推荐题";
+        int kid = g_questions[qIdx].knowledgeId;
+        if (kid >= 0 && (size_t)kid < g_knowledgeNames.size()) {
+            // 所属知识点的掌握概率（BKT），帮助理解为什么推荐这道题
+            std::cout << "（" << g_knowledgeNames[kid] << "，掌握概率 " << std::fixed << std::setprecision(0)
+                      << knowledgeMasteryProbability(kid) * 100.0 << "%）" << std::defaultfloat;
+        }
+        // 没做过的题：潜因子模型按做题情况相似的同学推算的答对率
+        float predicted = g_latentFactors.predict(qIdx);
+        if (predicted >= 0.0f && (qIdx >= g_questionStats.size() || g_questionStats.totalAttempts[qIdx] == 0)) {
+            std::cout << "（未做过，预测答对率 " << std::fixed << std::setprecision(0) << predicted * 100.0 << "%）"
+                      << std::defaultfloat;
+        }
+        // 做过的题：遗忘模型估计的此刻回忆概率与预计到期时间（回忆概率降到一半）
+        double recall = g_halfLifeModel.recall(qIdx, now);
+        if (recall >= 0.0) {
+            double dueDays = (g_halfLifeModel.dueTimestamp(qIdx) - now) / 86400.0;
+            std::cout << "（回忆概率 " << std::fixed << std::setprecision(0) << recall * 100.0 << "%，";
+            if (dueDays > 0) {
+                std::cout << "预计 " << std::setprecision(1) << dueDays << " 天后需要复习）";
+            } else {
+                std::cout << "已到预计复习时间）";
+            }
+            std::cout << std::defaultfloat;
+        }
+        std::cout << "：\n";
 
         // 调用做题函数（显示题目、接收答案、判断正误、记录结果）
         doQuestion(g_questions[qIdx]);
 
+        // 答错时列出共错题，提示可能牵连的同一误区
+        if (!g_records.empty() && !g_records.back().correct) printRelatedMisses(g_questions[qIdx], 3);
+
         std::cout << "\n";
     }
 
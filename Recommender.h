@@ -10,37 +10,57 @@
 
 #include "Question.h"
 #include "Stats.h"
+#include "ScoringPolicy.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct RecommendScoreColumns;
 
 /**
  * @struct RecommendItem
  * @brief 推荐项结构体
  *
  * 用于存储题目推荐信息，包含题目 ID 和对应的推荐评分。
- * 重载了 operator< 以支持优先队列的大顶堆排序。
+ * 重载了 operator< 以支持按分数比较；Top-K 选择使用 RecommendItemBetter（带题号决胜）。
  */
 struct RecommendItem {
     int questionId;    ///< 题目 ID
-    double score;      ///< 推荐评分（越高越值得推荐）
+    double score;      ///< 推荐评分（越高越值得推荐）：逐题评分 + 前置补强
+    double baseScore = 0.0;  ///< 逐题评分（第一阶段，不含前置补强）
 
     /**
-     * @brief 优先队列比较运算符重载
-     *
-     * priority_queue 默认是大顶堆，通过定义 operator< 实现按 score 从大到小排列。
-     * 这样可以高效地取出 Top-K 个最值得推荐的题目。
+     * @brief 按分数比较（score 小的 < 返回 true）
      *
      * @param other 另一个推荐项
-     * @return true 如果当前项的分数小于 other，用于构建大顶堆
+     * @return true 如果当前项的分数小于 other
      *
-     * @note 使用大顶堆的原因：
-     *       1. 自动维护分数最高的 K 个题目
-     *       2. 插入操作 O(log N)，取堆顶 O(1)
-     *       3. 整体时间复杂度 O(N log N)，空间复杂度 O(N)
+     * @note 分数相同时两项"相等"，不能单独用于需要确定顺序的场合，
+     *       推荐排序请使用 RecommendItemBetter
      */
     bool operator<(const RecommendItem& other) const {
         return score < other.score;
     }
 };
 
+/**
+ * @struct RecommendItemBetter
+ * @brief 推荐项的严格全序：分数高者优先，分数相同则逐题评分高者优先，再相同则题号小者优先
+ *
+ * 作为 TopK 的比较器，保证同分题目的推荐结果不随题库顺序或插入顺序变化。
+ * 第二关键字 baseScore 使顺序与推荐索引按知识点分段的堆一致：同一知识点内加上相同的补强分后，
+ * 逐题评分不同的两题可能舍入为同一总分，此时仍按逐题评分排序。
+ */
+struct RecommendItemBetter {
+    bool operator()(const RecommendItem& a, const RecommendItem& b) const {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.baseScore != b.baseScore) return a.baseScore > b.baseScore;
+        return a.questionId < b.questionId;
+    }
+};
+
 /**
  * @brief 计算题目的推荐评分
  *
@@ -50,6 +70,7 @@ struct RecommendItem {
  *    - 公式：errorRate = (总尝试次数 - 正确次数) / 总尝试次数
  *    - 未做过的题目错误率视为 1.0（最高优先级）
  *    - 错误率越高说明该题是薄弱点，越需要练习
+ *    - 若 st.recentAttempts > 0，与近 7 天错误率各占一半（反映近期是否已改善）
  *
  * 2. **时间间隔维度** (权重 0.3)
  *    - 公式：timeScore = min(距上次做题天数 / 7.0, 1.0)
@@ -76,16 +97,373 @@ struct RecommendItem {
  * @return 推荐评分，范围 [0.0, 2.0]，分数越高表示越值得推荐
  *
  * @note 权重可调性：
- *       - 当前权重配置：错误率 0.6 > 时间间隔 0.3 > 难度 0.1
- *       - 可根据实际需求调整权重，例如：
- *         * 强化复习：提高时间间隔权重
- *         * 攻克难题：提高难度权重
- *         * 补弱项：提高错误率权重
+ *       - 本函数固定使用平衡模式 BalancedPolicy：错误率 0.6 > 时间间隔 0.3 > 难度 0.1
+ *       - 其他权重配置见 ScoringPolicy.h（补弱项 / 复习 / 挑战），推荐流程按
+ *         activeScoringProfile() 选定的配置评分，启动时用 --profile <配置名> 选择
+ *
+ * @note 本函数只是第一阶段（逐题评分）。推荐流程随后加上第二阶段的前置补强分：
+ *       prereqWeight × 所属知识点的继承薄弱度（KnowledgeMastery.h）
+ *
+ * @note 加载了潜因子模型（MatrixFactorization.h）时，交互式推荐对未作答题目不再按错误率 1.0 计算，
+ *       而用 1 - 该用户的预测答对率；批量推荐以各用户折叠出的用户行同样修正，回放评估仍按本函数计算
+ *
+ * @note 加载了遗忘模型（HalfLifeRegression.h）时，交互式推荐对已作答题目的时间间隔维度不再以 7 天封顶，
+ *       而用半衰期回归的 min(2 × (1 - 回忆概率), 1)；批量推荐按各用户的统计同样修正（见 halfLifeTimeAdjustment），
+ *       回放评估仍按本函数计算
  *
  * @note 时间复杂度：O(1)，每道题的评分计算都是常数时间操作
  */
 double computeRecommendScore(const Question& q, const QuestionStat& st, long long now);
 
+/**
+ * @struct ScoringProfile
+ * @brief 评分配置注册表的一项：某个策略类型实例化出的评分函数
+ *
+ * scoreOne / scoreSubset 指向 scoreWithPolicy<Policy>() 的专门化版本（权重为编译期常量、完全内联）；
+ * scoreBatch 把 policyWeights<Policy>() 交给向量化内核。
+ * 推荐流程每批调用一次函数指针，批内逐题评分没有间接调用。
+ */
+struct ScoringProfile {
+    const char* name;        ///< 配置名（--profile 参数），如 "balanced"
+    const char* label;       ///< 中文名称，如 "平衡模式"
+    ScoreWeights weights;    ///< 策略参数（用于展示与向量化内核）
+    long long settleDays;    ///< 最近作答距今达到该天数后评分不再变化（scoreSettleDays）
+
+    /// 单题评分（参照实现，供基准核对）
+    double (*scoreOne)(const Question& q, const QuestionStat& st, long long now);
+
+    /// 为 cols 中全部题目评分（向量化内核，参数每批广播一次）
+    void (*scoreBatch)(const RecommendScoreColumns& cols, long long now, double* out);
+
+    /// 为题目下标列表 qIdx[0..count) 评分（读取 g_questionStats 与滚动窗口），结果写入 out
+    void (*scoreSubset)(const int* qIdx, size_t count, long long now, double* out);
+};
+
+/**
+ * @brief 遗忘模型对一道已作答题目评分的修正量
+ *
+ * 逐题评分的时间间隔项 timeWeight × min(天数 / horizonDays, 1) 改为 timeWeight × hlrTimeScore(天数, 半衰期)，
+ * 返回两者之差。交互式推荐（全量评分与推荐索引）与批量推荐共用，保证两者逐位相同。
+ *
+ * @param profile 评分配置
+ * @param lastTimestamp 最近一次作答时间（<= 0 表示从未作答，修正量为 0）
+ * @param halfLife 该用户该题的半衰期（天，见 HalfLifeModel::halfLifeDays）
+ * @param now 评估时间戳
+ * @complexity O(1)
+ */
+double halfLifeTimeAdjustment(const ScoringProfile& profile, long long lastTimestamp, float halfLife, long long now);
+
+/**
+ * @brief 全部已注册的评分配置（第一项 balanced 为默认配置）
+ */
+const std::vector<ScoringProfile>& scoringProfiles();
+
+/**
+ * @brief 按名称选择评分配置（会话开始时调用，之后推荐均使用该配置）
+ *
+ * @param name 配置名（见 scoringProfiles()）
+ * @return true 选择成功；false 名称不存在，当前配置不变
+ * @note 切换配置后推荐索引会在下次查询时整体重建
+ */
+bool selectScoringProfile(const std::string& name);
+
+/**
+ * @brief 当前使用的评分配置（未选择时为 balanced）
+ */
+const ScoringProfile& activeScoringProfile();
+
+// ============================================================
+// 多样化选择（MMR）
+// ============================================================
+
+/// 多样化选择的候选池大小 = K × 该倍数（从分数最高的若干道中挑选）
+constexpr size_t kDiversityPoolFactor = 10;
+
+/// MMR 中相关性（分数）的权重 λ，其余 1 - λ 为与已选题目相似度的惩罚
+constexpr double kDiversityLambda = 0.7;
+
+/// 题目相似度中"知识点相同"所占的权重，其余为难度接近程度
+constexpr double kSameKnowledgeSimilarity = 0.7;
+
+/**
+ * @enum TopKSelection
+ * @brief 推荐题目的选择方式
+ */
+enum class TopKSelection {
+    Heap,      ///< 按分数取前 K 道（TopK 小根堆 / 推荐索引），默认
+    Diverse    ///< 先取前 K × kDiversityPoolFactor 道作为候选池，再以 MMR 兼顾知识点与难度的多样性
+};
+
+/**
+ * @brief 按名称选择推荐题目的选择方式（会话开始时调用，--select <方式>）
+ * @param name "heap"（按分数）或 "mmr"（多样化）
+ * @return true 选择成功；false 名称不存在，当前方式不变
+ */
+bool selectTopKSelection(const std::string& name);
+
+/**
+ * @brief 当前的选择方式（未选择时为 Heap）
+ */
+TopKSelection activeTopKSelection();
+
+/**
+ * @brief 两道题目的相似度
+ *
+ * sim = kSameKnowledgeSimilarity × [知识点相同] + (1 - kSameKnowledgeSimilarity) × (1 - |难度差| / 4)，
+ * 取值 [0, 1]；无知识点的题目不与任何题目算作知识点相同。
+ */
+double questionSimilarity(const Question& a, const Question& b);
+
+/**
+ * @brief 以最大边际相关性（MMR）从候选池中选出 K 道题
+ *
+ * 逐个挑选使 λ × 相关性 - (1 - λ) × max(与已选题目的相似度) 最大的候选：
+ * - 相关性为候选分数在池内线性归一化到 [0, 1] 的值
+ * - 每选出一道题，只用它更新各候选"与已选题目的最大相似度"，不重算已选集合
+ * 同值时池中靠前（分数更高）的候选优先，结果确定。
+ *
+ * @param pool 候选池（按推荐顺序排列，如 g_recommendIndex.topK(M, now)）
+ * @param K 选出数量（候选不足 K 道时返回全部）
+ * @param lambda 相关性权重 λ ∈ [0, 1]，1 时等价于按分数取前 K
+ * @return 按选出顺序排列的推荐项
+ * @complexity O(M × K)，M = 候选池大小，与题库大小无关
+ */
+std::vector<RecommendItem> diversifyTopK(const std::vector<RecommendItem>& pool, size_t K, double lambda);
+
+/**
+ * @brief 为题库中全部题目评分，选出推荐分数最高的 K 道题
+ *
+ * 使用 g_questionStats（调用方需先 buildQuestionStats）与近 7 天滚动窗口，
+ * 按当前评分配置 activeScoringProfile() 批量评分，加上各知识点的前置补强分后，
+ * 以 TopK 小根堆流式保留最好的 K 项。
+ *
+ * @param K 推荐数量（题库不足 K 道时返回全部）
+ * @param now 当前时间戳（秒）
+ * @return 按推荐顺序（分数从高到低，同分题号小者在前）排列的推荐项
+ *
+ * @note 全量扫描的参照实现；交互式推荐使用 RecommendIndex，结果与之一致
+ * @complexity O(N log K) 时间，O(K) 额外空间；N = 题库总数
+ */
+std::vector<RecommendItem> recommendTopK(size_t K, long long now);
+
+/**
+ * @struct RecommendScoreBreakdown
+ * @brief 一道题逐题评分（第一阶段）的分项
+ *
+ * 四个加权项之和即逐题评分（未触及 [0, 2] 截断时）；潜因子与遗忘模型的修正已计入对应的项。
+ */
+struct RecommendScoreBreakdown {
+    double errorRate = 0.0;         ///< 错误率维度（含近 7 天混合；未作答且有预测时为 1 - 预测答对率）
+    double errorTerm = 0.0;         ///< errorWeight × errorRate
+    double timeGapDays = 0.0;       ///< 距上次作答的天数（从未作答为时间基准）
+    double timeTerm = 0.0;          ///< timeWeight × 时间间隔得分（线性或遗忘模型）
+    double difficultyTerm = 0.0;    ///< difficultyWeight × 难度得分
+    double unseenTerm = 0.0;        ///< 未做奖励
+    double predictedCorrect = -1.0; ///< 潜因子模型的预测答对率（未修正时为 -1）
+    double halfLifeDays = -1.0;     ///< 遗忘模型的半衰期（天；未修正时为 -1）
+    double score = 0.0;             ///< 逐题评分，与推荐索引 / 全量评分中的 baseScore 相同
+};
+
+/**
+ * @brief 按评分配置分解第 qIdx 道题的逐题评分（推荐追踪用，见 RecommendTrace.h）
+ *
+ * 分项按 scoreWithPolicy() 的公式以 profile.weights 重算；score 则由 profile.scoreOne 加上
+ * 与批量评分相同的潜因子 / 遗忘模型修正得到，与推荐结果中的 baseScore 一致。
+ *
+ * @param profile 评分配置
+ * @param qIdx 题目下标
+ * @param now 当前时间戳（秒）
+ * @complexity O(1)（遗忘模型为一次 kHlrDim 维点积）
+ */
+RecommendScoreBreakdown explainRecommendScore(const ScoringProfile& profile, size_t qIdx, long long now);
+
+/**
+ * @class RecommendIndex
+ * @brief 增量维护的推荐优先级索引（带位置表的大根堆）
+ *
+ * 【为什么需要】
+ * recommendTopK() 每次都为全部 N 道题重新评分。实际上两次推荐之间：
+ * - 只有刚作答过的题目统计发生变化
+ * - 评分中随 now 变化的只有时间间隔项与近 7 天窗口，而它们只对
+ *   最近 settleDays 天（见 ScoringProfile::settleDays，平衡模式为 8 天）内作答过的题目有影响；
+ *   加载了遗忘模型时，还要等回忆概率降到一半以下（每道题的预计到期日 + 2，见 HalfLifeModel::settleDay）。
+ *   评分已稳定或从未作答的题目，时间间隔已封顶、近 7 天窗口为空，评分是常数
+ *
+ * 【结构】
+ * - 堆中只存逐题评分（第一阶段）。heap_ 按知识点分段，每段是该知识点题目的一个大根堆，
+ *   按 (逐题评分降序, 题号升序) 排列；pos_ 记录每道题在 heap_ 中的位置，
+ *   分数变化时在所在段内原地上浮/下沉（increase/decrease-key），O(log N)
+ * - 前置补强分（第二阶段）是整个知识点共用的偏移 offset_，只保存在段上：
+ *   某个知识点的继承薄弱度变化时只改一个数，不必为该知识点的全部题目重新评分或调整堆。
+ *   同一段内加上相同的偏移不改变顺序，因此段内堆序仍然成立
+ * - 活跃题目按"评分稳定日"分桶（liveByDay_）：最近作答日 + settleDays 与遗忘模型预计到期日 + 2 的较晚者。
+ *   半衰期短的题目到期即移出，不会因半衰期上限（kHlrMaxHalfLifeDays）让几乎全部已作答题目长期活跃。
+ *   活跃题目在堆中的键是评分上界（upperBound：近 7 天窗口按全错、时间间隔按已封顶计算），
+ *   直到再次作答都不随时间变化，因此查询时不必为活跃题目重新评分或调整堆。每次查询时：
+ *   1. 稳定日不晚于今天的桶整体到期：其中题目按 now 最后精确评分一次（每桶一次 scoreSubset），此后不再跟踪
+ *   2. 上次查询后作答过的题目（pending_）把键改为新的上界
+ * - markDirty(qIdx)：作答后把该题放入新的稳定日对应的桶并记入 pending_，O(1)
+ * - 统计表整体重建（QuestionStatTable::epoch 变化）、题库大小变化或评分配置切换时整体重建，O(N)
+ *
+ * 【查询】
+ * topK() 先刷新知识点掌握度（只重算受影响的知识点）并更新各段偏移，O(G)，G 为知识点数；
+ * 再在各段堆上做有界的最优优先遍历：候选初始为各段堆顶，每次取出总分最好的一项并把它在段内的
+ * 两个孩子加入候选；取出的是活跃题目（键为上界）时按 now 精确评分后以精确分数放回候选，
+ * 再次取出时才输出。输出 K 项后结束，不修改堆。被精确评分的只有上界挤进前 K 附近的活跃题目，
+ * 数量 A 不超过活跃题目数 L，实测（--bench-recommend）通常只有数十道。
+ * 结果与 recommendTopK() 的全量扫描完全一致（比较规则见 RecommendItemBetter）。
+ */
+class RecommendIndex {
+public:
+    /**
+     * @brief 取推荐分数最高的 K 道题（必要时先刷新）
+     * @param K 推荐数量（题库不足 K 道时返回全部）
+     * @param now 当前时间戳（秒），需单调不减
+     * @return 按推荐顺序排列的推荐项
+     * @complexity 首次或统计重建后 O(N)；之后 O((E + D) log N + (K + A + G) log(K + A + G))，
+     *             E = 到期题目数，D = 上次查询后作答过的题目数，A = 遍历中精确评分的活跃题目数，G = 知识点数
+     */
+    std::vector<RecommendItem> topK(size_t K, long long now);
+
+    /**
+     * @brief 标记某道题刚被作答（统计已由 applyRecordToStats 更新）
+     * @param qIdx 题目下标
+     * @complexity 均摊 O(1)，重新取上界推迟到下次查询
+     */
+    void markDirty(size_t qIdx);
+
+    /// 丢弃索引，下次查询时整体重建
+    void invalidate() { built_ = false; }
+
+    /// 当前跟踪的活跃题目数（评分尚未稳定）
+    size_t liveCount() const { return liveCount_; }
+
+private:
+    void rebuild(long long now);
+    void refresh(long long now);
+    long long settleDayOf(size_t qIdx) const;
+    void track(size_t qIdx, long long day);
+    void update(size_t qIdx, double score);
+    double upperBound(size_t qIdx) const;
+    double exactScore(int qIdx, long long now) const;
+    void rescore(const std::vector<int>& qs, long long now);
+    void syncOffsets();
+
+    /// 段内顺序：题目 a 是否排在 b 之前（逐题评分高者优先，同分题号小者优先）
+    bool better(int a, int b) const {
+        if (score_[a] != score_[b]) return score_[a] > score_[b];
+        return id_[a] < id_[b];
+    }
+    /// 题目的推荐总分（逐题评分 + 所在段的前置补强分）
+    double total(int q) const { return score_[q] + offset_[group_[q]]; }
+    /// 跨段顺序：总分高者优先，其余同 better（与 RecommendItemBetter 一致）
+    bool ahead(int a, int b) const {
+        double ta = total(a);
+        double tb = total(b);
+        if (ta != tb) return ta > tb;
+        return better(a, b);
+    }
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+    bool built_ = false;
+    uint64_t epoch_ = 0;                       ///< 构建时 g_questionStats.epoch
+    const ScoringProfile* profile_ = nullptr;  ///< 构建时的评分配置
+    std::vector<int> heap_;                    ///< 按知识点分段的大根堆（题目下标）
+    std::vector<int> pos_;                     ///< 题目下标 -> heap_ 中位置
+    std::vector<int> group_;                   ///< 题目下标 -> 段号（知识点 ID + 1，0 为无知识点）
+    std::vector<size_t> groupBegin_;           ///< 段 g 占 heap_[groupBegin_[g], groupBegin_[g + 1])
+    std::vector<double> offset_;               ///< 段号 -> 前置补强分
+    std::vector<double> score_;                ///< 题目下标 -> 堆键：逐题评分（活跃题目为评分上界）
+    std::vector<int> id_;                      ///< 题目下标 -> 题号（决胜用）
+    std::vector<long long> liveDay_;           ///< 题目下标 -> 所在桶的日序号（kNotLive 表示不在桶中）
+    std::map<long long, std::vector<int>> liveByDay_;   ///< 评分稳定日 -> 该日稳定的题目
+    size_t liveCount_ = 0;
+    std::vector<int> pending_;                 ///< 上次查询后作答过、待重新取上界的题目
+    std::vector<double> scratch_;              ///< rescore 的评分缓冲区
+};
+
+/**
+ * @brief 全局推荐索引（当前用户，首次推荐时构建）
+ */
+extern RecommendIndex g_recommendIndex;
+
+/**
+ * @brief 通知推荐索引某道题刚被作答
+ *
+ * doQuestion() 在 applyRecordToStats() 之后调用。
+ *
+ * @param questionId 题号（不在题库中时忽略）
+ * @complexity O(1)
+ */
+void markRecommendDirty(int questionId);
+
+/// 推荐结果缓存的时间桶长度（秒）：同一桶内时间漂移带来的评分变化可忽略
+constexpr long long kRecommendCacheBucketSeconds = 600;
+
+/**
+ * @class RecommendCache
+ * @brief 带版本的推荐结果缓存（只缓存最近一次的结果）
+ *
+ * 【为什么需要】
+ * 两次进入 AI 推荐模式之间若没有作答，推荐结果除了微小的时间漂移外完全相同，
+ * 再次查询推荐索引（刷新活跃桶、重算段偏移、遍历各段堆）是多余的。
+ *
+ * 【键】
+ * (统计表 epoch, 统计表 version, 评分配置, K, 时间桶 now / kRecommendCacheBucketSeconds)
+ * 任一分量变化即未命中；此外以下事件显式清空缓存：
+ * - 作答：doQuestion() -> markRecommendDirty()
+ * - 切换用户：clearUserRecords()
+ * - 题库或知识点依赖图重新加载：loadQuestionsFromFile() / loadKnowledgeGraphFromFile()
+ *
+ * 【命中时的结果】
+ * 与该时间桶内首次查询的结果相同；与按当前 now 精确计算相比，只可能在评分极接近的题目间有差别。
+ * 需要精确结果的场合（如基准核对）直接调用 g_recommendIndex.topK() 或 recommendTopK()。
+ */
+class RecommendCache {
+public:
+    /**
+     * @brief 取推荐结果：命中时直接返回缓存，否则查询 g_recommendIndex 并缓存
+     * @param K 推荐数量
+     * @param now 当前时间戳（秒）
+     * @return 按推荐顺序排列的推荐项
+     * @complexity 命中 O(K)；未命中同 RecommendIndex::topK()
+     */
+    std::vector<RecommendItem> topK(size_t K, long long now);
+
+    /// 清空缓存（计入一次失效；计数器不清零）
+    void invalidate();
+
+    /// 命中次数
+    size_t hits() const { return hits_; }
+
+    /// 未命中次数
+    size_t misses() const { return misses_; }
+
+    /// 显式失效次数（清空时缓存中确有结果才计入）
+    size_t invalidations() const { return invalidations_; }
+
+    /// 计数器清零（不影响缓存内容）
+    void resetCounters() { hits_ = misses_ = invalidations_ = 0; }
+
+private:
+    bool valid_ = false;
+    uint64_t epoch_ = 0;                       ///< 缓存时 g_questionStats.epoch
+    uint64_t version_ = 0;                     ///< 缓存时 g_questionStats.version
+    const ScoringProfile* profile_ = nullptr;  ///< 缓存时的评分配置
+    size_t K_ = 0;
+    long long bucket_ = 0;                     ///< 缓存时的时间桶
+    std::vector<RecommendItem> items_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t invalidations_ = 0;
+};
+
+/**
+ * @brief 全局推荐结果缓存（当前用户）
+ */
+extern RecommendCache g_recommendCache;
+
 /**
  * @brief AI 智能推荐模式主函数
  *
@@ -93,25 +471,23 @@ double computeRecommendScore(const Question& q, const QuestionStat& st, long lon
  *
  * **算法流程：**
  * 1. 检查题库是否为空
- * 2. 更新所有题目的统计信息（buildQuestionStats）
+ * 2. 确认统计表已覆盖当前题库（答题后由 applyRecordToStats 增量维护，无需每次重建）
  * 3. 获取当前时间戳
- * 4. 遍历所有题目，计算每道题的推荐评分
- * 5. 使用优先队列（大顶堆）维护 Top-K 推荐题目
- * 6. 从堆中取出分数最高的 K 道题
- * 7. 按推荐顺序逐题展示并让用户作答
- * 8. 记录作答结果并更新统计信息
+ * 4. 从增量推荐索引 g_recommendIndex 取分数最高的 K 道题
+ *    （活跃题目以评分上界入堆，只精确评分进入前 K 附近的题目，只重算受影响知识点的前置补强分）；
+ *    两次进入之间没有作答时由 g_recommendCache 直接返回上次结果；
+ *    以 --select mmr 启动时从前 K × kDiversityPoolFactor 道中以 MMR 挑选（diversifyTopK）
+ *    并提示继承薄弱度最高的前置知识点
+ * 5. 按推荐顺序逐题展示并让用户作答
+ * 6. 记录作答结果，统计与推荐索引随之增量更新
  *
  * **时间复杂度分析：**
- * - 遍历所有题目：O(N)
- * - 每道题计算评分：O(1)
- * - 插入优先队列：O(log N)
- * - 总体复杂度：O(N log N)
- * - 取出 Top-K：O(K log N)，通常 K << N，因此接近 O(N log N)
+ * - 首次进入：O(N)，为全部题目评分并建堆
+ * - 之后进入：O((E + D) log N + (K + A + G) log(K + A + G))，E 为到期、D 为新作答、A 为遍历中精确评分的
+ *   活跃题目数（见 RecommendIndex::topK），G = 知识点数；与题库大小只有对数关系
  *
  * **空间复杂度：**
- * - 优先队列存储所有题目：O(N)
- * - 推荐列表：O(K)
- * - 总体：O(N)
+ * - 推荐索引常驻 O(N)，推荐列表 O(K)
  *
  * @note 推荐数量：
  *       - 默认推荐 K=5 道题
@@ -122,8 +498,11 @@ double computeRecommendScore(const Question& q, const QuestionStat& st, long lon
  *       - 自适应：根据用户历史表现动态调整推荐
  *       - 平衡性：兼顾错误率、遗忘曲线、难度梯度
  *       - 探索性：对未做题目给予适当倾斜
+ *       - 确定性：同分题目按题号升序，结果与题库顺序无关
  *
  * @see computeRecommendScore() 评分算法实现
+ * @see RecommendIndex 增量推荐索引
+ * @see recommendTopK() 全量扫描的参照实现
  * @see RecommendItem 推荐项数据结构
  */
 void aiRecommendMode();
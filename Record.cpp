@@ -60,11 +60,18 @@
 
 #include "Record.h"
 #include "Stats.h"
+#include "Recommender.h"
+#include "SpacedReview.h"
+#include "KnowledgeMastery.h"
+#include "KnowledgeTracing.h"
 #include "Utils.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cerrno>
 #include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <ctime>
 #include <filesystem>
 
@@ -81,6 +88,36 @@
  */
 std::vector<Record> g_records;
 
+/**
+ * @brief 列式做题记录（与 g_records 逐条对齐）
+ *
+ * 更新时机与 g_records 相同：加载时逐条追加、答题后追加、切换用户时清空。
+ */
+RecordColumns g_recordColumns;
+
+void RecordColumns::clear() {
+    questionIndex.clear();
+    knowledgeId.clear();
+    correct.clear();
+    usedSeconds.clear();
+    timestamp.clear();
+}
+
+void RecordColumns::append(const Record& r) {
+    int32_t qIdx = -1;
+    int32_t kid = -1;
+    auto it = g_questionById.find(r.questionId);
+    if (it != g_questionById.end() && it->second < g_questions.size()) {
+        qIdx = (int32_t)it->second;
+        kid = g_questions[it->second].knowledgeId;
+    }
+    questionIndex.push_back(qIdx);
+    knowledgeId.push_back(kid);
+    correct.push_back(r.correct ? 1 : 0);
+    usedSeconds.push_back(r.usedSeconds);
+    timestamp.push_back(r.timestamp);
+}
+
 /**
  * @brief 按题号分组的做题记录索引
  *
@@ -179,10 +216,17 @@ std::string getRecordFilePath() {
  *
  * @note 该函数仅设置 ID，不加载记录文件（需手动调用 loadRecordsFromFile）
  * @note 会在控制台输出"当前用户：<userId>"（用于调试和用户确认）
+ * @note 同时输出本次会话的随机种子并追加到 data/session_log.csv（appendSessionLog），
+ *       以 --seed <种子> 启动并重复同样的操作即可重放随机刷题、错题本、考试与探索推荐的抽取
  */
 void loginUser(const std::string& userId) {
     g_currentUserId = userId;
     std::cout << "当前用户：" << g_currentUserId << std::endl;
+    std::cout << "会话随机种子：" << formatSeed(sessionSeed()) << "（以 --seed " << formatSeed(sessionSeed())
+              << " 启动可重放本次抽题）" << std::endl;
+    if (!appendSessionLog(userId)) {
+        std::cout << "警告：无法写入会话日志 data/session_log.csv。\n";
+    }
 }
 
 /**
@@ -210,8 +254,10 @@ void loginUser(const std::string& userId) {
  */
 void clearUserRecords() {
     g_records.clear();              // 清空时间序列记录
+    g_recordColumns.clear();        // 清空列式副本
     g_recordsByQuestion.clear();    // 清空题号索引
     g_wrongQuestions.clear();       // 清空错题集
+    g_recommendCache.invalidate();  // 推荐结果属于上一个用户
 }
 
 // ============================================================
@@ -308,6 +354,7 @@ bool loadRecordsFromFile(const std::string& filename) {
 
         // 步骤 5：更新全局容器
         g_records.push_back(r);                         // 追加到时间序列
+        g_recordColumns.append(r);                      // 追加到列式副本
         g_recordsByQuestion[r.questionId].push_back(r); // 添加到题号索引
     }
 
@@ -336,6 +383,42 @@ bool loadRecordsFromFile(const std::string& filename) {
     return true;
 }
 
+namespace {
+
+/**
+ * @brief 解析一个整数字段（语义同 std::stoll：允许前导空白，忽略数字后的内容，无数字或越界视为失败）
+ */
+bool parseField(const char* begin, long long lo, long long hi, long long& value) {
+    char* end = nullptr;
+    errno = 0;
+    long long v = std::strtoll(begin, &end, 10);
+    if (end == begin || errno == ERANGE || v < lo || v > hi) return false;
+    value = v;
+    return true;
+}
+
+} // namespace
+
+bool parseRecordLine(const std::string& line, Record& r) {
+    size_t comma[3];
+    size_t from = 0;
+    for (size_t& c : comma) {
+        c = line.find(',', from);
+        if (c == std::string::npos) return false;   // 少于 4 列
+        from = c + 1;
+    }
+    const char* s = line.c_str();
+    long long qid = 0, secs = 0, ts = 0;
+    if (!parseField(s, INT_MIN, INT_MAX, qid)) return false;
+    if (!parseField(s + comma[1] + 1, INT_MIN, INT_MAX, secs)) return false;
+    if (!parseField(s + comma[2] + 1, LLONG_MIN, LLONG_MAX, ts)) return false;
+    r.questionId = (int)qid;
+    r.correct = line.compare(comma[0] + 1, comma[1] - comma[0] - 1, "1") == 0;
+    r.usedSeconds = (int)secs;
+    r.timestamp = ts;
+    return true;
+}
+
 /**
  * @brief 追加单条记录到 CSV 文件
  *
@@ -414,6 +497,9 @@ void appendRecordToFile(const Record& r, const std::string& filename) {
  *    - g_records：追加到时间序列
  *    - g_recordsByQuestion[qid]：追加到题号索引
  *    - g_wrongQuestions：动态维护错题集
+ *    并调用 applyRecordToStats() 增量更新统计与滚动窗口，markRecommendDirty() 通知推荐索引，
+ *    applyRecordToSchedule() 更新间隔复习排期，applyRecordToMastery() 更新知识点掌握度，
+ *    applyRecordToTracing() 更新知识点掌握概率（BKT）
  * 8. 持久化：调用 appendRecordToFile() 追加到 CSV
  *
  * 【计时机制】
@@ -553,7 +639,13 @@ void doQuestion(const Question& q) {
 
     // ======== 步骤 7：更新内存结构 ========
     g_records.push_back(r);                       // 追加到全局时间序列
+    g_recordColumns.append(r);                    // 追加到列式副本
     g_recordsByQuestion[q.id].push_back(r);       // 追加到题号索引
+    applyRecordToStats(r);                        // 增量更新题目统计与滚动窗口（O(1)）
+    markRecommendDirty(q.id);                     // 推荐索引下次查询时重新评分该题（O(1)）
+    applyRecordToSchedule(r);                     // 按 SM-2 更新记忆状态并重新排期（O(1)）
+    applyRecordToMastery(r);                      // 更新知识点掌握度，传播推迟到下次推荐（O(1)）
+    applyRecordToTracing(r);                      // 更新知识点掌握概率（BKT，O(1)）
 
     // 动态维护错题集：最后一次答对移除，答错加入
     if (correct) {
@@ -13,6 +13,7 @@
  * - std::vector<Record> g_records：所有做题记录的时间序列
  * - std::unordered_map<int, std::vector<Record>> g_recordsByQuestion：按题号分组的记录
  * - std::unordered_set<int> g_wrongQuestions：当前错题集合（最后一次答错的题号）
+ * - RecordColumns g_recordColumns：与 g_records 逐条对齐的列式副本（供 Kernels.h 向量化聚合）
  *
  * 【输入/输出文件格式】
  * - 文件名：data/records_<userId>.csv（多用户隔离）
@@ -37,6 +38,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <cstdint>
 #include "Question.h"
 
 /**
@@ -61,6 +63,39 @@ struct Record {
  */
 extern std::vector<Record> g_records;
 
+/**
+ * @struct RecordColumns
+ * @brief 列式做题记录（结构体数组 -> 数组结构体）
+ *
+ * 与 g_records 逐条对齐，每个字段一列连续存放，聚合时只需读取用到的列，
+ * 并可直接交给 SIMD 内核（见 Kernels.h）。题号在追加时即换算为题目下标和知识点 ID，
+ * 聚合过程不再做哈希查找。
+ */
+struct RecordColumns {
+    std::vector<int32_t> questionIndex;  ///< 题目下标（题库中不存在时为 -1）
+    std::vector<int32_t> knowledgeId;    ///< 知识点 ID（题目不存在时为 -1）
+    std::vector<uint8_t> correct;        ///< 是否答对（1/0）
+    std::vector<int32_t> usedSeconds;    ///< 作答用时（秒）
+    std::vector<int64_t> timestamp;      ///< 时间戳（秒）
+
+    /// 记录条数
+    size_t size() const { return correct.size(); }
+
+    /// 清空所有列
+    void clear();
+
+    /**
+     * @brief 追加一条记录（通过 g_questionById 换算题目下标与知识点 ID）
+     * @complexity O(1) 平均
+     */
+    void append(const Record& r);
+};
+
+/**
+ * @brief 列式做题记录（与 g_records 同步维护）
+ */
+extern RecordColumns g_recordColumns;
+
 /**
  * @brief 按题号分组的做题记录
  *
@@ -102,14 +137,14 @@ std::string getRecordFilePath();
  * @brief 用户登录：设置当前用户 ID
  *
  * @param userId 用户标识（学号或用户名）
- * @note 调用后会在控制台输出"当前用户：<userId>"
+ * @note 调用后会在控制台输出"当前用户：<userId>"与本次会话的随机种子，并把种子追加到 data/session_log.csv
  */
 void loginUser(const std::string& userId);
 
 /**
  * @brief 清空当前用户的所有记录数据（用于切换用户）
  *
- * 清空：g_records、g_recordsByQuestion、g_wrongQuestions
+ * 清空：g_records、g_recordColumns、g_recordsByQuestion、g_wrongQuestions
  * @note 调用时机：切换用户、重新加载记录前
  */
 void clearUserRecords();
@@ -142,6 +177,20 @@ void clearUserRecords();
  */
 bool loadRecordsFromFile(const std::string& filename);
 
+/**
+ * @brief 解析一行记录 "题号,正误,用时,时间戳[,...]"（不修改任何全局容器）
+ *
+ * 规则与 loadRecordsFromFile() 相同：少于 4 列或数值字段无法解析（无数字、越界）时失败；
+ * 数值字段允许前导空白、忽略数字之后的内容（同 std::stoi / std::stoll）；正误字段恰为 "1" 时为答对。
+ * 不使用异常与临时字符串，供批量处理（BatchRecommend、ReplayEval）逐行流式解析。
+ *
+ * @param line 一行文本（不含换行符）
+ * @param r 输出：解析成功时写入
+ * @return true 解析成功；false 格式错误（r 不变）
+ * @complexity O(行长度)
+ */
+bool parseRecordLine(const std::string& line, Record& r);
+
 /**
  * @brief 追加记录到文件
  *
@@ -168,7 +217,7 @@ void appendRecordToFile(const Record& r, const std::string& filename);
  * 5. 输出结果：正确或错误（显示正确答案）
  * 6. 记录：构造 Record 对象
  * 7. 更新内存结构：
- *    - g_records.push_back(r)
+ *    - g_records.push_back(r)、g_recordColumns.append(r)
  *    - g_recordsByQuestion[qid].push_back(r)
  *    - 更新 g_wrongQuestions（答对移除，答错加入）
  * 8. 持久化：调用 appendRecordToFile() 追加到 CSV
@@ -0,0 +1,266 @@
+/**
+ * @file ReplayEval.cpp
+ * @brief 离线回放评估模块实现
+ *
+ * 实现要点：
+ * 1. **读取**：逐行 parseRecordLine()，丢弃题号不在题库中的记录，按时间戳稳定排序
+ *    （同一时间戳保持文件中的顺序）
+ * 2. **稀疏状态**：与 BatchRecommend 相同，slotOf 把题目下标映射到本用户的槽位，
+ *    线程私有的工作区在同一线程的多个用户之间复用，任务结束时只复位被触及的项
+ * 3. **逐天回放**：当天的不同题目各取一个槽位（首次出现即建默认统计），先按日初状态为全部评分配置打分，
+ *    记下每条记录的评分与正误、当天前 K 道的命中数，再把当天记录计入统计与知识点计数
+ * 4. **汇总**：按用户编号顺序拼接各用户的 (评分, 是否答错)，每个评分配置排序后按平均秩计算
+ *    Mann-Whitney U，AUC = (正例秩和 - P(P+1)/2) / (P × N)
+ */
+
+#include "ReplayEval.h"
+#include "KnowledgeMastery.h"
+#include "Question.h"
+#include "Record.h"
+#include "RollingStats.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief 一个用户的回放结果
+ */
+struct UserReplay {
+    bool ok = false;
+    size_t days = 0;
+    size_t slots = 0;
+    double expectedHits = 0.0;
+    std::vector<unsigned char> wrong;             ///< 每条记录是否答错（回放顺序）
+    std::vector<std::vector<double>> scores;      ///< 评分配置 -> 每条记录所属题目的日初评分
+    std::vector<size_t> hits;                     ///< 评分配置 -> 前 K 道命中数
+};
+
+/**
+ * @brief 线程私有的单用户工作区（在同一线程的多个用户之间复用）
+ */
+struct ReplayScratch {
+    std::vector<int> slotOf;                   ///< 题目下标 -> 槽位（-1 表示本用户尚未出现）
+    std::vector<int> touched;                  ///< 槽位 -> 题目下标
+    std::vector<QuestionStat> stats;           ///< 槽位 -> 统计
+    std::vector<RollingWindow> windows;        ///< 槽位 -> 近 30 天窗口
+    std::vector<long long> listedDay;          ///< 槽位 -> 最近一次列入当天题目的天序号
+    std::vector<int64_t> attempts;             ///< 知识点 -> 作答次数
+    std::vector<int64_t> correct;              ///< 知识点 -> 答对次数
+    std::vector<double> own;
+    std::vector<double> inherited;
+    std::vector<std::pair<Record, int>> records;   ///< (记录, 题目下标)
+    std::vector<int> daySlots;                 ///< 当天的不同题目（槽位）
+    std::vector<int> dayIndex;                 ///< 槽位 -> 在 daySlots 中的位置
+    std::vector<unsigned char> dayWrong;       ///< 当天题目是否答错过
+    std::vector<double> dayScore;              ///< 当天题目的日初评分
+    std::vector<int> dayOrder;                 ///< 当天题目按评分排序后的位置
+    std::string line;
+};
+
+/// 取得题目的槽位，首次出现时分配并重置为默认统计
+int slotFor(ReplayScratch& s, int q) {
+    int slot = s.slotOf[q];
+    if (slot >= 0) return slot;
+    slot = (int)s.touched.size();
+    s.slotOf[q] = slot;
+    s.touched.push_back(q);
+    if (s.stats.size() <= (size_t)slot) {
+        s.stats.emplace_back();
+        s.windows.emplace_back();
+        s.listedDay.push_back(0);
+        s.dayIndex.push_back(0);
+    }
+    s.stats[slot] = QuestionStat();
+    s.windows[slot] = RollingWindow();
+    s.listedDay[slot] = -1;
+    return slot;
+}
+
+/**
+ * @brief 回放一个用户的记录
+ */
+void replayUser(const std::filesystem::path& file, size_t K, UserReplay& out) {
+    thread_local ReplayScratch s;
+    const std::vector<ScoringProfile>& profiles = scoringProfiles();
+    size_t n = g_questions.size();
+    size_t kCount = g_knowledgeNames.size();
+    if (s.slotOf.size() != n) s.slotOf.assign(n, -1);
+    s.attempts.assign(kCount, 0);
+    s.correct.assign(kCount, 0);
+    s.touched.clear();
+    s.records.clear();
+
+    out.scores.assign(profiles.size(), std::vector<double>());
+    out.hits.assign(profiles.size(), 0);
+
+    // 1. 读取并按时间排序
+    std::ifstream fin(file);
+    out.ok = fin.is_open();
+    if (!out.ok) return;
+    Record r;
+    while (std::getline(fin, s.line)) {
+        if (s.line.empty() || !parseRecordLine(s.line, r)) continue;
+        auto itQ = g_questionById.find(r.questionId);
+        if (itQ == g_questionById.end() || itQ->second >= n) continue;
+        s.records.emplace_back(r, (int)itQ->second);
+    }
+    std::stable_sort(s.records.begin(), s.records.end(),
+                     [](const std::pair<Record, int>& a, const std::pair<Record, int>& b) {
+                         return a.first.timestamp < b.first.timestamp;
+                     });
+    out.wrong.resize(s.records.size());
+    for (std::vector<double>& col : out.scores) col.resize(s.records.size());
+
+    // 2. 逐天回放
+    size_t begin = 0;
+    while (begin < s.records.size()) {
+        long long today = dayIndexOf(s.records[begin].first.timestamp);
+        long long now = s.records[begin].first.timestamp;
+        size_t end = begin;
+        while (end < s.records.size() && dayIndexOf(s.records[end].first.timestamp) == today) ++end;
+        ++out.days;
+
+        // 当天的不同题目（日初状态）
+        s.daySlots.clear();
+        s.dayWrong.clear();
+        for (size_t i = begin; i < end; ++i) {
+            int slot = slotFor(s, s.records[i].second);
+            if (s.listedDay[slot] != today) {
+                s.listedDay[slot] = today;
+                s.dayIndex[slot] = (int)s.daySlots.size();
+                s.daySlots.push_back(slot);
+                s.dayWrong.push_back(0);
+            }
+            if (!s.records[i].first.correct) s.dayWrong[s.dayIndex[slot]] = 1;
+        }
+        for (int slot : s.daySlots) {
+            const WindowTotals& recent = s.windows[slot].query(7, today);
+            s.stats[slot].recentAttempts = recent.attempts;
+            s.stats[slot].recentCorrect = recent.correct;
+        }
+        size_t distinct = s.daySlots.size();
+        size_t take = std::min(K, distinct);
+        size_t wrongDistinct = 0;
+        for (unsigned char w : s.dayWrong) wrongDistinct += w;
+        out.slots += take;
+        out.expectedHits += (double)wrongDistinct * take / distinct;
+
+        // 各评分配置：日初评分 -> 前 K 道命中数与每条记录的评分
+        g_knowledgeMastery.propagate(s.attempts, s.correct, s.own, s.inherited);
+        for (size_t p = 0; p < profiles.size(); ++p) {
+            const ScoringProfile& profile = profiles[p];
+            s.dayScore.resize(distinct);
+            for (size_t j = 0; j < distinct; ++j) {
+                int slot = s.daySlots[j];
+                const Question& q = g_questions[s.touched[slot]];
+                double score = profile.scoreOne(q, s.stats[slot], now);
+                if (q.knowledgeId >= 0 && (size_t)q.knowledgeId < kCount) {
+                    score += profile.weights.prereqWeight * s.inherited[q.knowledgeId];
+                }
+                s.dayScore[j] = score;
+            }
+            // 前 K 道：排序规则同 RecommendItemBetter（评分降序，同分题号升序）
+            s.dayOrder.resize(distinct);
+            std::iota(s.dayOrder.begin(), s.dayOrder.end(), 0);
+            std::partial_sort(s.dayOrder.begin(), s.dayOrder.begin() + take, s.dayOrder.end(), [&](int a, int b) {
+                if (s.dayScore[a] != s.dayScore[b]) return s.dayScore[a] > s.dayScore[b];
+                return g_questions[s.touched[s.daySlots[a]]].id < g_questions[s.touched[s.daySlots[b]]].id;
+            });
+            for (size_t j = 0; j < take; ++j) out.hits[p] += s.dayWrong[s.dayOrder[j]];
+            for (size_t i = begin; i < end; ++i) {
+                out.scores[p][i] = s.dayScore[s.dayIndex[s.slotOf[s.records[i].second]]];
+            }
+        }
+
+        // 计入当天记录
+        for (size_t i = begin; i < end; ++i) {
+            const Record& rec = s.records[i].first;
+            int q = s.records[i].second;
+            QuestionStat& st = s.stats[s.slotOf[q]];
+            st.totalAttempts++;
+            if (rec.correct) st.correctAttempts++;
+            st.totalTime += rec.usedSeconds;
+            if (rec.timestamp > st.lastTimestamp) st.lastTimestamp = rec.timestamp;
+            s.windows[s.slotOf[q]].add(today, rec.correct, rec.usedSeconds);
+            out.wrong[i] = rec.correct ? 0 : 1;
+
+            int kid = g_questions[q].knowledgeId;
+            if (kid >= 0 && (size_t)kid < kCount) {
+                ++s.attempts[kid];
+                if (rec.correct) ++s.correct[kid];
+            }
+        }
+        begin = end;
+    }
+
+    // 3. 只复位本用户触及的题目
+    for (int q : s.touched) s.slotOf[q] = -1;
+}
+
+/**
+ * @brief 由 (评分, 是否答错) 计算 AUC（并列按平均秩）
+ */
+double aucOf(const std::vector<double>& score, const std::vector<unsigned char>& positive) {
+    size_t total = score.size();
+    std::vector<size_t> order(total);
+    std::iota(order.begin(), order.end(), (size_t)0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return score[a] < score[b]; });
+
+    double positiveRankSum = 0.0;
+    size_t positives = 0;
+    for (size_t i = 0; i < total;) {
+        size_t j = i;
+        size_t tiedPositives = 0;
+        while (j < total && score[order[j]] == score[order[i]]) tiedPositives += positive[order[j++]];
+        double avgRank = (double)(i + 1 + j) / 2.0;   // 秩 i+1 .. j 的平均
+        positiveRankSum += avgRank * tiedPositives;
+        positives += tiedPositives;
+        i = j;
+    }
+    size_t negatives = total - positives;
+    if (positives == 0 || negatives == 0) return 0.5;
+    double u = positiveRankSum - (double)positives * (positives + 1) / 2.0;
+    return u / ((double)positives * negatives);
+}
+
+} // namespace
+
+ReplaySummary replayEvaluate(const std::vector<std::filesystem::path>& files, size_t K, ThreadPool& pool) {
+    const std::vector<ScoringProfile>& profiles = scoringProfiles();
+    ReplaySummary summary;
+    summary.policies.resize(profiles.size());
+    for (size_t p = 0; p < profiles.size(); ++p) summary.policies[p].profile = &profiles[p];
+    if (files.empty() || K == 0) return summary;
+
+    g_knowledgeMastery.refresh();
+    std::vector<UserReplay> users(files.size());
+    pool.parallelFor(files.size(), [&](size_t u) { replayUser(files[u], K, users[u]); });
+
+    // 按用户编号顺序合并
+    std::vector<unsigned char> wrong;
+    for (const UserReplay& u : users) {
+        if (!u.ok) continue;
+        ++summary.users;
+        summary.records += u.wrong.size();
+        summary.days += u.days;
+        summary.slots += u.slots;
+        summary.expectedHits += u.expectedHits;
+        wrong.insert(wrong.end(), u.wrong.begin(), u.wrong.end());
+        for (size_t p = 0; p < profiles.size(); ++p) summary.policies[p].hits += u.hits[p];
+    }
+    for (unsigned char w : wrong) summary.wrongAnswers += w;
+
+    pool.parallelFor(profiles.size(), [&](size_t p) {
+        std::vector<double> score;
+        score.reserve(wrong.size());
+        for (const UserReplay& u : users) {
+            if (u.ok) score.insert(score.end(), u.scores[p].begin(), u.scores[p].end());
+        }
+        summary.policies[p].auc = aucOf(score, wrong);
+    });
+    return summary;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file ReplayEval.h
+ * @brief 离线回放评估模块 - 用历史作答记录检验推荐评分的预测能力
+ *
+ * 【模块职责】
+ * 调整评分权重（ScoringPolicy.h）或新增评分配置后，需要知道新的排序是否更能"提前找出学生会做错的题"。
+ * 本模块按时间顺序回放 data 目录下每个用户的历史记录，模拟"每天开始练习前算一次推荐"：
+ * - 当天开始时，只用此前各天的记录构建统计（与交互式推荐相同的逐题评分 + 前置补强分）
+ * - 用当天实际作答的结果检验这份排序，再把当天记录计入统计，进入下一天
+ * 不修改当前登录用户的全局记录与统计。
+ *
+ * 【评估指标】
+ * - AUC：当天每次作答按其题目的日初评分排序，"答错"为正例；
+ *   随机抽一次答错与一次答对，答错那次评分更高的概率（并列计 1/2），0.5 相当于随机
+ * - Precision@K：当天作答过的不同题目中，按日初评分取前 K 道，其中当天答错过的比例；
+ *   随机基准为当天答错题目占比 × min(K, 当天题目数) 的累计值
+ * 只对实际作答过的题目评估：没有作答的题目不知道会不会做错。
+ *
+ * 【并行】
+ * - 各用户相互独立，每个用户一个任务，交给线程池的区间窃取调度
+ * - 同一用户的统计状态与评分配置无关，一次回放中同时为全部评分配置打分，统计只更新一遍
+ * - 汇总时各评分配置的 AUC 排序互不相关，再按配置并行
+ * 合并按用户编号顺序进行，结果与线程数无关。
+ *
+ * 【与其他模块依赖】
+ * - Record.h：parseRecordLine() 逐行解析记录文件
+ * - Recommender.h：scoringProfiles() 的逐题评分与前置补强权重
+ * - KnowledgeMastery.h：按用户截至当天的知识点作答次数计算继承薄弱度（propagate）
+ * - Cli.cpp：--replay-eval 评估 data 目录下的全部用户；Bench.cpp：--bench-replay 合成用户的吞吐量基准
+ */
+
+#pragma once
+
+#include "Recommender.h"
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @struct PolicyEvaluation
+ * @brief 一个评分配置的回放评估结果
+ */
+struct PolicyEvaluation {
+    const ScoringProfile* profile = nullptr;   ///< 评分配置
+    double auc = 0.5;                          ///< 作答级 AUC（没有正例或负例时为 0.5）
+    size_t hits = 0;                           ///< 各天前 K 道中当天答错的题目数之和
+};
+
+/**
+ * @struct ReplaySummary
+ * @brief 一次回放评估的汇总
+ */
+struct ReplaySummary {
+    size_t users = 0;                          ///< 成功读取的用户数
+    size_t records = 0;                        ///< 回放的记录数（题号在题库中）
+    size_t days = 0;                           ///< 回放的用户-天数
+    size_t wrongAnswers = 0;                   ///< 其中答错的记录数
+    size_t slots = 0;                          ///< 各天 min(K, 当天题目数) 之和（Precision@K 的分母）
+    double expectedHits = 0.0;                 ///< 随机排序时的期望命中数
+    std::vector<PolicyEvaluation> policies;    ///< 与 scoringProfiles() 一一对应
+
+    /// 某个评分配置的 Precision@K（无数据时为 0）
+    double precision(const PolicyEvaluation& p) const { return slots > 0 ? (double)p.hits / slots : 0.0; }
+
+    /// 随机排序的 Precision@K 基准
+    double baseline() const { return slots > 0 ? expectedHits / slots : 0.0; }
+};
+
+/**
+ * @brief 回放一组用户的历史记录，评估全部评分配置
+ *
+ * 使用当前题库与知识点依赖图。记录按时间戳稳定排序后逐天回放，
+ * 天的划分与近 7 天窗口相同（dayIndexOf），日初评分的评估时间为当天第一条记录的时间戳。
+ *
+ * @param files 用户记录文件（每个文件一个用户，格式同 records_<用户ID>.csv）
+ * @param K Precision@K 的 K
+ * @param pool 执行并行任务的线程池
+ * @return 汇总结果
+ * @complexity 每个用户 O(R log R + D × (V + E) + P × R log K)，R 为记录数，D 为天数，P 为评分配置数；
+ *             汇总 O(P × A log A)，A 为全部用户的记录总数
+ */
+ReplaySummary replayEvaluate(const std::vector<std::filesystem::path>& files, size_t K, ThreadPool& pool);
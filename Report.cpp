@@ -7,7 +7,11 @@
 #include "Report.h"
 #include "Record.h"
 #include "Question.h"
+#include "KnowledgeTracing.h"
 #include "Stats.h"
+#include "RollingStats.h"
+#include "Kernels.h"
+#include "TopK.h"
 #include "Utils.h"
 #include <iostream>
 #include <fstream>
@@ -17,6 +21,7 @@
 #include <ctime>
 #include <filesystem>
 #include <map>
+#include <algorithm>
 
 /**
  * @brief 获取当前时间字符串（用于文件名）
@@ -123,15 +128,16 @@ std::string getTimeStringForDisplay() {
  *
  *          3. 按知识点统计
  *             - 遍历所有做题记录，按知识点分类统计
- *             - 统计内容：作答次数、答对次数、正确率
+ *             - 统计内容：作答次数、答对次数、正确率、掌握概率（BKT，见 KnowledgeTracing.h）
  *             - 以表格形式展示各知识点的掌握情况
+ *             - 近期趋势：读取滚动窗口，给出总体与各知识点近 1/7/30 天的正确率与平均用时
  *
  *          4. 错题分布
  *             - 按知识点统计错题数：各知识点的错题数量分布
  *             - 按难度统计错题数：不同难度等级的错题数量分布
  *
  *          5. 复习建议
- *             - 薄弱知识点识别：标记正确率低于 60% 的知识点
+ *             - 薄弱知识点识别：标记掌握概率低于 kWeakMasteryProbability 的知识点
  *             - 错题本练习建议：提示使用错题本功能
  *             - 智能推荐功能介绍：AI推荐、知识点路径、模拟考试等
  *
@@ -150,7 +156,7 @@ std::string getTimeStringForDisplay() {
  *          - 显示时间：YYYY-MM-DD HH:MM:SS（易读格式）
  *
  * @complexity 时间复杂度 O(M)，其中 M 为做题记录数量
- *             - 第一次遍历 g_records：统计总体情况和按知识点统计（O(M)）
+ *             - 列式记录上的 SIMD 归约：总体情况与按知识点直方图（O(M)）
  *             - 遍历 g_wrongQuestions：统计错题分布（O(W)，W ≤ M）
  *             - 遍历 knowledgeStats：查找薄弱知识点（O(K)，K << M）
  *             - 总体复杂度由第一次遍历决定：O(M)
@@ -164,7 +170,7 @@ std::string getTimeStringForDisplay() {
  *
  * @note 依赖全局变量：
  *       - g_currentUserId：当前登录用户ID
- *       - g_records：所有做题记录
+ *       - g_recordColumns：列式做题记录（聚合内核的输入）
  *       - g_wrongQuestions：错题集合
  *       - g_questionById：题目ID到题目对象的映射
  *
@@ -172,6 +178,7 @@ std::string getTimeStringForDisplay() {
  *       - 使用 Markdown 格式，便于阅读和转换
  *       - 使用 std::ofstream 写入文件
  *       - 输出成功后显示文件路径和生成信息
+ *       - 同时写出统计快照 data/stats_<userId>.snapshot（见 saveStatsSnapshot）
  *
  * @see getTimeStringForFilename() 生成文件名用时间戳
  * @see getTimeStringForDisplay() 生成显示用时间字符串
@@ -194,12 +201,9 @@ void exportLearningReport() {
     // ========================================
     // 2. 总体统计
     // ========================================
-    // 遍历所有做题记录，统计总题数和正确题数
-    int totalRecords = (int)g_records.size();
-    int correctRecords = 0;
-    for (const auto& r : g_records) {
-        if (r.correct) correctRecords++;
-    }
+    // 在列式记录上统计总题数和正确题数（SIMD 内核，见 Kernels.h）
+    int totalRecords = (int)g_recordColumns.size();
+    int correctRecords = (int)kernelCountCorrect(g_recordColumns.correct.data(), g_recordColumns.size());
 
     report << "## 一、总体概览\n\n";
 
@@ -209,6 +213,7 @@ void exportLearningReport() {
     } else {
         // 计算总体正确率
         double accuracy = correctRecords * 100.0 / totalRecords;
+        long long totalSeconds = kernelSumSeconds(g_recordColumns.usedSeconds.data(), g_recordColumns.size());
 
         report << "| 统计项 | 数值 |\n";
         report << "|--------|------|\n";
@@ -216,6 +221,7 @@ void exportLearningReport() {
         report << "| 答对题数 | " << correctRecords << " |\n";
         report << "| 答错题数 | " << (totalRecords - correctRecords) << " |\n";
         report << "| 总体正确率 | " << std::fixed << std::setprecision(1) << accuracy << "% |\n";
+        report << "| 平均用时 | " << (double)totalSeconds / totalRecords << " 秒 |\n";
         report << "| 当前错题数 | " << g_wrongQuestions.size() << " |\n\n";
     }
 
@@ -225,40 +231,100 @@ void exportLearningReport() {
     if (totalRecords > 0) {
         report << "## 二、按知识点统计\n\n";
 
-        // 使用 map 统计每个知识点的作答情况
-        // key: 知识点名称, value: {总作答次数, 正确作答次数}
-        std::map<std::string, std::pair<int, int>> knowledgeStats;
-
-        // 遍历所有做题记录，按知识点累计统计
-        for (const auto& r : g_records) {
-            auto itQ = g_questionById.find(r.questionId);
-            if (itQ == g_questionById.end()) continue;  // 题目不存在，跳过
-
-            size_t qIdx = itQ->second;
-            if (qIdx >= g_questions.size()) continue;  // 索引异常，跳过
-
-            const std::string& knowledge = g_questions[qIdx].knowledge;
-            knowledgeStats[knowledge].first++;  // 该知识点总作答次数 +1
-            if (r.correct) {
-                knowledgeStats[knowledge].second++;  // 该知识点正确作答次数 +1
-            }
+        // 按知识点分组的直方图：作答次数、答对次数、用时一次求出
+        KnowledgeHistogram hist;
+        kernelKnowledgeHistogram(g_recordColumns.knowledgeId.data(), g_recordColumns.correct.data(),
+                                 g_recordColumns.usedSeconds.data(), g_recordColumns.size(),
+                                 g_knowledgeNames.size(), hist);
+
+        // 转为按名称排序的 map，保持报告中知识点的输出顺序
+        // key: 知识点名称, value: 知识点 ID
+        std::map<std::string, size_t> knowledgeStats;
+        for (size_t k = 0; k < g_knowledgeNames.size(); ++k) {
+            if (hist.total[k] > 0) knowledgeStats[g_knowledgeNames[k]] = k;
         }
 
         // 生成知识点统计表格
-        report << "| 知识点 | 作答次数 | 答对次数 | 正确率 |\n";
-        report << "|--------|----------|----------|--------|\n";
+        report << "| 知识点 | 作答次数 | 答对次数 | 正确率 | 平均用时 | 掌握概率 |\n";
+        report << "|--------|----------|----------|--------|----------|----------|\n";
 
         for (const auto& pair : knowledgeStats) {
             const std::string& knowledge = pair.first;
-            int total = pair.second.first;
-            int correct = pair.second.second;
-            double acc = (total > 0) ? (correct * 100.0 / total) : 0.0;
+            size_t k = pair.second;
+            long long total = hist.total[k];
+            long long correct = hist.correct[k];
+            double acc = correct * 100.0 / total;
 
             report << "| " << knowledge << " | " << total << " | " << correct
-                   << " | " << std::fixed << std::setprecision(1) << acc << "% |\n";
+                   << " | " << std::fixed << std::setprecision(1) << acc << "%"
+                   << " | " << (double)hist.seconds[k] / total << " 秒"
+                   << " | " << knowledgeMasteryProbability((int)k) * 100.0 << "% |\n";
+        }
+        report << "\n";
+        report << "> 掌握概率由贝叶斯知识追踪（BKT）按作答顺序估计：近期作答影响更大，作答较少时接近先验。\n\n";
+
+        // 近期趋势：直接读取滚动窗口累加和，不回扫历史记录
+        long long today = dayIndexOf((long long)std::time(nullptr));
+        report << "### 2.1 近期趋势（滚动窗口）\n\n";
+        report << "| 范围 | 近1天 | 近7天 | 近30天 | 近7天平均用时 |\n";
+        report << "|------|-------|-------|--------|---------------|\n";
+
+        // 每行：名称 + 三个窗口的"作答数 / 正确率" + 近 7 天平均用时
+        auto writeWindowRow = [&](const std::string& name, RollingWindow& w) {
+            const WindowTotals& t1 = w.query(1, today);
+            const WindowTotals& t7 = w.query(7, today);
+            const WindowTotals& t30 = w.query(30, today);
+            report << "| " << name << std::fixed << std::setprecision(1)
+                   << " | " << t1.attempts << " / " << t1.accuracy() << "%"
+                   << " | " << t7.attempts << " / " << t7.accuracy() << "%"
+                   << " | " << t30.attempts << " / " << t30.accuracy() << "%"
+                   << " | " << t7.avgSeconds() << " 秒 |\n";
+        };
+
+        writeWindowRow("总体", g_overallWindow);
+        for (size_t k = 0; k < g_knowledgeWindows.size() && k < g_knowledgeNames.size(); ++k) {
+            if (g_knowledgeWindows[k].query(30, today).attempts == 0) continue; // 近 30 天未练习
+            writeWindowRow(g_knowledgeNames[k], g_knowledgeWindows[k]);
+        }
+        report << "\n";
+
+        // 用时分布：读取用时草图，中位用时明显偏长的题目往往题意含糊或概念易混淆
+        report << "### 2.2 用时分布（分位数草图）\n\n";
+        report << "| 知识点 | 作答次数 | 中位用时 | P95 用时 |\n";
+        report << "|--------|----------|----------|----------|\n";
+        for (size_t k = 0; k < g_knowledgeTimeSketches.size() && k < g_knowledgeNames.size(); ++k) {
+            const QuantileSketch& sk = g_knowledgeTimeSketches[k];
+            if (sk.empty()) continue;
+            report << "| " << g_knowledgeNames[k] << " | " << sk.count()
+                   << " | " << sk.quantile(0.5) << " 秒 | " << sk.quantile(0.95) << " 秒 |\n";
         }
         report << "\n";
 
+        // 中位用时最长的题目（至少作答 3 次，避免单次偶然超时）
+        const int kMinAttemptsForSlow = 3;
+        const size_t kSlowTop = 5;
+        TopK<std::pair<int, size_t>, ScoreIdBetter> slowTop(kSlowTop);   // (中位用时, 题目下标)
+        for (size_t i = 0; i < g_questions.size(); ++i) {
+            const QuantileSketch* sk = questionTimeSketch(i);
+            if (!sk || sk->count() < (uint64_t)kMinAttemptsForSlow) continue;
+            slowTop.push({sk->quantile(0.5), i});
+        }
+        // 中位用时降序，相同则题目下标升序
+        std::vector<std::pair<int, size_t>> slowQuestions = slowTop.takeSorted();
+        if (!slowQuestions.empty()) {
+            size_t top = slowQuestions.size();
+            report << "中位用时最长的题目（至少作答 " << kMinAttemptsForSlow << " 次）：\n\n";
+            report << "| 题号 | 知识点 | 中位用时 | P95 用时 |\n";
+            report << "|------|--------|----------|----------|\n";
+            for (size_t j = 0; j < top; ++j) {
+                size_t qIdx = slowQuestions[j].second;
+                const QuantileSketch* sk = questionTimeSketch(qIdx);
+                report << "| " << g_questions[qIdx].id << " | " << g_questions[qIdx].knowledge
+                       << " | " << slowQuestions[j].first << " 秒 | " << sk->quantile(0.95) << " 秒 |\n";
+            }
+            report << "\n";
+        }
+
         // ========================================
         // 4. 错题分布统计
         // ========================================
@@ -308,31 +374,29 @@ void exportLearningReport() {
         // ========================================
         report << "## 四、复习建议（基于当前数据）\n\n";
 
-        // 识别薄弱知识点：找出正确率低于 60% 的知识点
-        std::vector<std::pair<std::string, double>> weakKnowledge;
+        // 识别薄弱知识点：找出掌握概率低于 kWeakMasteryProbability 的知识点
+        std::vector<std::pair<std::string, size_t>> weakKnowledge;
         for (const auto& pair : knowledgeStats) {
-            const std::string& knowledge = pair.first;
-            int total = pair.second.first;
-            int correct = pair.second.second;
-            double acc = (total > 0) ? (correct * 100.0 / total) : 0.0;
-
-            // 如果该知识点正确率低于 60%，加入薄弱知识点列表
-            if (total > 0 && acc < 60.0) {
-                weakKnowledge.push_back({knowledge, acc});
+            if (knowledgeMasteryProbability((int)pair.second) < kWeakMasteryProbability) {
+                weakKnowledge.push_back(pair);
             }
         }
 
         // 输出薄弱知识点列表
         if (!weakKnowledge.empty()) {
             report << "### 薄弱知识点\n\n";
-            report << "以下知识点正确率较低（< 60%），建议重点复习：\n\n";
+            report << "以下知识点的掌握概率较低（< " << std::fixed << std::setprecision(0)
+                   << kWeakMasteryProbability * 100.0 << "%），建议重点复习：\n\n";
             for (const auto& pair : weakKnowledge) {
-                report << "- **" << pair.first << "**：正确率 "
-                       << std::fixed << std::setprecision(1) << pair.second << "%\n";
+                size_t k = pair.second;
+                report << "- **" << pair.first << "**：掌握概率 " << std::setprecision(1)
+                       << knowledgeMasteryProbability((int)k) * 100.0 << "%，正确率 "
+                       << hist.correct[k] * 100.0 / hist.total[k] << "%\n";
             }
             report << "\n";
         } else {
-            report << "恭喜！所有已练习的知识点正确率均达到 60% 以上，继续保持！\n\n";
+            report << "恭喜！所有已练习的知识点掌握概率均达到 " << std::fixed << std::setprecision(0)
+                   << kWeakMasteryProbability * 100.0 << "% 以上，继续保持！\n\n";
         }
 
         // 错题本练习建议
@@ -389,6 +453,10 @@ void exportLearningReport() {
     fout << report.str();
     fout.close();
 
+    // 同时写出统计快照（汇总 + 用时草图），供班级视图合并（--cohort-times）
+    std::string snapshotPath = getStatsSnapshotPath();
+    bool snapshotOk = saveStatsSnapshot(snapshotPath);
+
     // ========================================
     // 8. 输出成功信息
     // ========================================
@@ -396,6 +464,7 @@ void exportLearningReport() {
     std::cout << "学习报告导出成功！\n";
     std::cout << "========================================\n";
     std::cout << "文件路径：" << filename << "\n";
+    if (snapshotOk) std::cout << "统计快照：" << snapshotPath << "\n";
     std::cout << "用户：" << g_currentUserId << "\n";
     std::cout << "生成时间：" << getTimeStringForDisplay() << "\n";
     std::cout << "========================================\n";
@@ -0,0 +1,196 @@
+/**
+ * @file RollingStats.cpp
+ * @brief 滚动窗口统计模块实现
+ *
+ * 实现要点：
+ * 1. **环形日桶**：ring[day % 30] 保存单日汇总，跨天时复用最旧的日桶
+ * 2. **增量累加和**：1/7/30 天三个窗口各维护一份累加和，
+ *    新的一天到来时只减去"刚离开窗口"的那个日桶，查询直接读取累加和
+ * 3. **题目窗口对象池**：g_questionWindowSlot 记录题目下标到池槽位的映射，
+ *    首次作答时才分配槽位
+ */
+
+#include "RollingStats.h"
+#include <ctime>
+
+std::vector<int> g_questionWindowSlot;
+std::vector<RollingWindow> g_questionWindowPool;
+std::vector<RollingWindow> g_knowledgeWindows;
+RollingWindow g_overallWindow;
+
+namespace {
+
+/// 从累加和中减去一个日桶
+void subtractBucket(WindowTotals& t, const DayBucket& b) {
+    t.attempts -= b.attempts;
+    t.correct -= b.correct;
+    t.seconds -= b.seconds;
+}
+
+/// 向累加和中加上一次作答
+void addOne(WindowTotals& t, bool correct, int seconds) {
+    t.attempts++;
+    if (correct) t.correct++;
+    t.seconds += seconds;
+}
+
+/// 环形缓冲区下标（天序号可能为负，取非负余数）
+int slotOf(long long day) {
+    long long m = day % RollingWindow::kRingDays;
+    return (int)(m < 0 ? m + RollingWindow::kRingDays : m);
+}
+
+/**
+ * @brief 计算本地时区相对 UTC 的偏移（秒）
+ *
+ * 用同一时刻的 localtime 与 gmtime 之差求得，夏令时变化不做处理。
+ */
+long long computeLocalUtcOffset() {
+    std::time_t now = std::time(nullptr);
+    std::tm localBuf;
+    std::tm utcBuf;
+#ifdef _WIN32
+    localtime_s(&localBuf, &now);
+    gmtime_s(&utcBuf, &now);
+#else
+    localtime_r(&now, &localBuf);
+    gmtime_r(&now, &utcBuf);
+#endif
+    utcBuf.tm_isdst = localBuf.tm_isdst;
+    return (long long)std::difftime(std::mktime(&localBuf), std::mktime(&utcBuf));
+}
+
+} // namespace
+
+/**
+ * @brief 滚动到指定天（实现）
+ *
+ * 对每个新到来的天 d：
+ * - 1 天窗口：d-1 离开
+ * - 7 天窗口：d-7 离开
+ * - 30 天窗口：d-30 离开，且 d-30 与 d 共用同一个环形槽位，清空后供 d 使用
+ */
+void RollingWindow::advanceTo(long long day) {
+    if (headDay == kNoDay) {
+        headDay = day;           // 首次使用：直接定位到该天
+        return;
+    }
+    if (day <= headDay) return;
+
+    if (day - headDay >= kRingDays) {
+        // 跨度超过整个缓冲区：所有日桶均已过期
+        for (DayBucket& b : ring) b = DayBucket();
+        sum1 = WindowTotals();
+        sum7 = WindowTotals();
+        sum30 = WindowTotals();
+        headDay = day;
+        return;
+    }
+
+    while (headDay < day) {
+        long long d = ++headDay;
+        subtractBucket(sum1, ring[slotOf(d - 1)]);
+        subtractBucket(sum7, ring[slotOf(d - 7)]);
+        DayBucket& reused = ring[slotOf(d)];      // 即 d-30 的日桶
+        subtractBucket(sum30, reused);
+        reused = DayBucket();
+    }
+}
+
+/**
+ * @brief 追加一次作答（实现）
+ */
+void RollingWindow::add(long long day, bool correct, int seconds) {
+    advanceTo(day);
+
+    long long age = headDay - day;                // 距最新一天的天数
+    if (age < 0 || age >= kRingDays) return;      // 超出 30 天的旧记录不计入
+
+    DayBucket& b = ring[slotOf(day)];
+    b.attempts++;
+    if (correct) b.correct++;
+    b.seconds += seconds;
+
+    if (age < 1) addOne(sum1, correct, seconds);
+    if (age < 7) addOne(sum7, correct, seconds);
+    addOne(sum30, correct, seconds);
+}
+
+/**
+ * @brief 查询窗口汇总（实现）
+ */
+const WindowTotals& RollingWindow::query(int days, long long today) {
+    advanceTo(today);
+    if (days >= 30) return sum30;
+    if (days >= 7) return sum7;
+    return sum1;
+}
+
+/**
+ * @brief 合并另一个窗口（实现）
+ */
+void RollingWindow::merge(const RollingWindow& other) {
+    if (other.headDay == kNoDay) return;
+
+    RollingWindow aligned = other;
+    long long head = headDay > aligned.headDay ? headDay : aligned.headDay;
+    advanceTo(head);
+    aligned.advanceTo(head);
+
+    for (int i = 0; i < kRingDays; ++i) {
+        ring[i].attempts += aligned.ring[i].attempts;
+        ring[i].correct += aligned.ring[i].correct;
+        ring[i].seconds += aligned.ring[i].seconds;
+    }
+    WindowTotals* mine[] = {&sum1, &sum7, &sum30};
+    const WindowTotals* theirs[] = {&aligned.sum1, &aligned.sum7, &aligned.sum30};
+    for (int w = 0; w < 3; ++w) {
+        mine[w]->attempts += theirs[w]->attempts;
+        mine[w]->correct += theirs[w]->correct;
+        mine[w]->seconds += theirs[w]->seconds;
+    }
+}
+
+long long dayIndexOf(long long timestamp) {
+    static const long long offset = computeLocalUtcOffset();
+    long long t = timestamp + offset;
+    // 向下取整除法，保证 1970 年以前的时间戳也能得到正确的天序号
+    return t >= 0 ? t / 86400 : -((-t + 86399) / 86400);
+}
+
+void resetRollingStats(size_t questionCount, size_t knowledgeCount) {
+    g_questionWindowSlot.assign(questionCount, -1);
+    g_questionWindowPool.clear();
+    g_knowledgeWindows.assign(knowledgeCount, RollingWindow());
+    g_overallWindow = RollingWindow();
+}
+
+void addToRollingStats(size_t qIdx, int knowledgeId, long long timestamp, bool correct, int seconds) {
+    long long day = dayIndexOf(timestamp);
+
+    // 题目窗口：首次作答时从对象池分配槽位
+    if (qIdx < g_questionWindowSlot.size()) {
+        int& slot = g_questionWindowSlot[qIdx];
+        if (slot < 0) {
+            slot = (int)g_questionWindowPool.size();
+            g_questionWindowPool.emplace_back();
+        }
+        g_questionWindowPool[slot].add(day, correct, seconds);
+    }
+
+    // 知识点窗口：知识点可能在统计重建之后才登记，按需扩容
+    if (knowledgeId >= 0) {
+        if ((size_t)knowledgeId >= g_knowledgeWindows.size()) {
+            g_knowledgeWindows.resize(knowledgeId + 1);
+        }
+        g_knowledgeWindows[knowledgeId].add(day, correct, seconds);
+    }
+
+    g_overallWindow.add(day, correct, seconds);
+}
+
+RollingWindow* questionWindow(size_t qIdx) {
+    if (qIdx >= g_questionWindowSlot.size()) return nullptr;
+    int slot = g_questionWindowSlot[qIdx];
+    return slot < 0 ? nullptr : &g_questionWindowPool[slot];
+}
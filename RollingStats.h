@@ -0,0 +1,186 @@
+/**
+ * @file RollingStats.h
+ * @brief 滚动窗口统计模块 - 近 1/7/30 天的作答表现
+ *
+ * 【模块职责】
+ * QuestionStat / KnowledgeStat 只反映"全部历史"，用户上周已经补上的弱项仍会显得很弱。
+ * 本模块为每道题、每个知识点以及总体维护按天分桶的环形缓冲区，
+ * 增量给出近 1 天、7 天、30 天的作答次数、正确率和平均用时。
+ *
+ * 【关键数据结构】
+ * - DayBucket：单日汇总（作答次数、答对次数、用时）
+ * - RollingWindow：30 个日桶组成的环形缓冲区 + 三个窗口的累加和
+ * - 题目窗口采用"槽位 + 对象池"：只有作答过的题目才占用一个 RollingWindow，
+ *   题库很大但作答覆盖率低时内存仍然可控
+ *
+ * 【复杂度】
+ * - 追加一条记录：O(1)
+ * - 跨天滚动：每跨过一天 O(1)（跨度超过 30 天时直接清空，同样 O(1) 量级）
+ * - 查询窗口汇总：O(1)，直接读取累加和，无需回扫历史记录
+ *
+ * 【与其他模块依赖】
+ * - Stats.cpp：buildQuestionStats() 重建（大量记录时各线程分别累加后 merge）、
+ *   applyRecordToStats() 增量更新
+ * - Recommender.cpp：近 7 天错误率参与推荐评分
+ * - Report.cpp：学习报告中的"近期趋势"
+ */
+
+#pragma once
+
+#include <vector>
+#include <climits>
+#include <cstddef>
+
+/**
+ * @struct DayBucket
+ * @brief 单日作答汇总
+ */
+struct DayBucket {
+    int attempts = 0;   ///< 当日作答次数
+    int correct = 0;    ///< 当日答对次数
+    int seconds = 0;    ///< 当日累计用时（秒）
+};
+
+/**
+ * @struct WindowTotals
+ * @brief 一个时间窗口内的汇总结果
+ */
+struct WindowTotals {
+    int attempts = 0;       ///< 窗口内作答次数
+    int correct = 0;        ///< 窗口内答对次数
+    long long seconds = 0;  ///< 窗口内累计用时（秒）
+
+    /// 正确率（百分比，0.0-100.0；无作答时为 0）
+    double accuracy() const { return attempts > 0 ? correct * 100.0 / attempts : 0.0; }
+
+    /// 平均用时（秒；无作答时为 0）
+    double avgSeconds() const { return attempts > 0 ? (double)seconds / attempts : 0.0; }
+};
+
+/**
+ * @struct RollingWindow
+ * @brief 按天分桶的滚动窗口（近 1/7/30 天）
+ *
+ * 环形缓冲区 ring[day % 30] 存放最近 30 天每天的汇总，headDay 为最新一天。
+ * 三个窗口的累加和随日桶增减同步维护：
+ * - 新的一天到来时，分别把离开 1/7/30 天窗口的那个日桶从对应累加和中减去
+ * - 追加记录时，把数据加到当天日桶及三个累加和
+ *
+ * 天序号由 dayIndexOf() 计算（按本地时区划分自然日）。
+ */
+struct RollingWindow {
+    static constexpr int kRingDays = 30;   ///< 环形缓冲区天数（最大窗口）
+    /// headDay 表示"尚无数据"（天序号可以为负：1970 年以前或负时区的纪元附近，不能用 -1 作标记）
+    static constexpr long long kNoDay = LLONG_MIN;
+
+    long long headDay = kNoDay;            ///< 最新日桶对应的天序号（kNoDay 表示尚无数据）
+    DayBucket ring[kRingDays];             ///< 日桶环形缓冲区
+    WindowTotals sum1;                     ///< 近 1 天（仅当天）累加和
+    WindowTotals sum7;                     ///< 近 7 天累加和
+    WindowTotals sum30;                    ///< 近 30 天累加和
+
+    /**
+     * @brief 将窗口滚动到指定天
+     *
+     * 每跨过一天，把离开各窗口的日桶从累加和中减去，并清空被复用的日桶。
+     * 跨度 >= 30 天时整个窗口清零。day 不晚于 headDay 时不做任何操作。
+     *
+     * @param day 目标天序号
+     * @complexity O(min(跨过的天数, 30))，即每天 O(1)
+     */
+    void advanceTo(long long day);
+
+    /**
+     * @brief 追加一次作答
+     *
+     * 若 day 晚于 headDay，先滚动到 day；若 day 早于 headDay 但仍在 30 天内
+     * （乱序记录），则加到对应日桶并只计入仍覆盖该天的窗口；更早的记录忽略。
+     *
+     * @param day 作答所在天序号
+     * @param correct 是否答对
+     * @param seconds 用时（秒）
+     * @complexity O(1)（不计跨天滚动）
+     */
+    void add(long long day, bool correct, int seconds);
+
+    /**
+     * @brief 查询截至 today 的窗口汇总
+     *
+     * 查询前会先滚动到 today，因此即使多天没有作答，结果也不会包含已过期的日桶。
+     *
+     * @param days 窗口天数，取值 1、7 或 30（其他值按不超过它的最大窗口处理）
+     * @param today 当前天序号（通常为 dayIndexOf(time(nullptr))）
+     * @return 窗口汇总结果
+     * @complexity O(1)（不计跨天滚动）
+     */
+    const WindowTotals& query(int days, long long today);
+
+    /**
+     * @brief 合并另一个窗口（用于并行统计重建后的归并）
+     *
+     * 两个窗口先滚动到二者中较晚的 headDay，此时日桶按槽位一一对应，逐桶、逐累加和相加即可。
+     * 由于过期判断只取决于最终的 headDay，合并结果与按任意顺序逐条 add() 完全一致。
+     *
+     * @param other 另一个窗口
+     * @complexity O(30)
+     */
+    void merge(const RollingWindow& other);
+};
+
+/**
+ * @brief 把 Unix 时间戳换算为本地自然日的天序号
+ *
+ * 天序号 = (timestamp + 本地时区偏移) / 86400，时区偏移在首次调用时计算一次。
+ *
+ * @param timestamp Unix 时间戳（秒）
+ * @return long long 天序号
+ */
+long long dayIndexOf(long long timestamp);
+
+/**
+ * @brief 题目下标 -> 题目窗口池槽位（-1 表示该题没有作答记录）
+ */
+extern std::vector<int> g_questionWindowSlot;
+
+/**
+ * @brief 题目滚动窗口对象池（仅包含作答过的题目）
+ */
+extern std::vector<RollingWindow> g_questionWindowPool;
+
+/**
+ * @brief 知识点滚动窗口（下标为知识点 ID，见 g_knowledgeNames）
+ */
+extern std::vector<RollingWindow> g_knowledgeWindows;
+
+/**
+ * @brief 总体滚动窗口（当前用户全部题目）
+ */
+extern RollingWindow g_overallWindow;
+
+/**
+ * @brief 清空所有滚动窗口，并按题库/知识点数量重新分配槽位
+ *
+ * @param questionCount 题目数（g_questions.size()）
+ * @param knowledgeCount 知识点数（g_knowledgeNames.size()）
+ */
+void resetRollingStats(size_t questionCount, size_t knowledgeCount);
+
+/**
+ * @brief 将一条作答记录计入题目、知识点和总体三级滚动窗口
+ *
+ * @param qIdx 题目下标
+ * @param knowledgeId 知识点 ID（< 0 时不计入知识点窗口）
+ * @param timestamp 作答时间戳
+ * @param correct 是否答对
+ * @param seconds 用时（秒）
+ * @complexity O(1)
+ */
+void addToRollingStats(size_t qIdx, int knowledgeId, long long timestamp, bool correct, int seconds);
+
+/**
+ * @brief 获取某道题的滚动窗口
+ *
+ * @param qIdx 题目下标
+ * @return 该题的窗口指针；该题没有作答记录时返回 nullptr
+ */
+RollingWindow* questionWindow(size_t qIdx);
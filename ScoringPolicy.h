@@ -0,0 +1,177 @@
+/**
+ * @file ScoringPolicy.h
+ * @brief 推荐评分策略 - 编译期参数化的评分公式
+ *
+ * 【模块职责】
+ * 推荐评分公式（见 computeRecommendScore）由四个加权维度组成：错误率、时间间隔、难度、未做奖励。
+ * 不同课程 / 学习目标需要不同的权重与时间基准。本模块把这些参数做成"策略类型"的
+ * constexpr 成员，评分函数 scoreWithPolicy<Policy>() 按策略类型实例化：
+ * - 每个策略得到一份常量完全折叠、可完全内联的逐题评分代码（推荐索引刷新、单题评分）
+ * - 批量评分交给向量化内核，策略参数每批广播一次（policyWeights<Policy>()）
+ * - 逐题评分时没有虚函数调用，也不查询任何配置
+ * - 运行时只在会话开始时按名称选定一个策略（见 Recommender.h 的 ScoringProfile 注册表），
+ *   之后每批评分只经过一次函数指针调用
+ *
+ * 【策略类型约定】
+ * 策略是只含 static constexpr 成员的结构体：
+ * - kName / kLabel：配置名（命令行 --profile 使用）与中文名称
+ * - kErrorWeight / kTimeWeight / kDifficultyWeight：三个维度的权重
+ * - kUnseenBonus：从未作答题目的固定加分
+ * - kRecentWeight：近 7 天错误率在错误率维度中的占比
+ * - kHorizonDays：时间间隔的归一化基准（整数天）：间隔达到该天数即得满分，从未作答视为该天数
+ * - kPrereqWeight：前置补强权重。逐题评分之后的第二阶段：题目评分加上
+ *   kPrereqWeight × 所属知识点的继承薄弱度（见 KnowledgeMastery.h），后续知识点越薄弱，前置题目越靠前
+ *
+ * 【新增策略】
+ * 定义新的策略结构体，并在 Recommender.cpp 的注册表中加入 makeScoringProfile<新策略>() 即可。
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @struct ScoreWeights
+ * @brief 策略参数的运行时副本
+ *
+ * 向量化批量评分内核（kernelRecommendScores）把这些参数广播到向量寄存器，
+ * 每批只读取一次；逐题评分使用 scoreWithPolicy<Policy>() 的编译期常量。
+ */
+struct ScoreWeights {
+    double errorWeight;       ///< 错误率权重
+    double timeWeight;        ///< 时间间隔权重
+    double difficultyWeight;  ///< 难度权重
+    double unseenBonus;       ///< 未做奖励
+    double recentWeight;      ///< 近 7 天错误率占比
+    int horizonDays;          ///< 时间间隔归一化基准（天）
+    double prereqWeight;      ///< 前置补强权重（第二阶段，不参与逐题评分内核）
+};
+
+/// 时间基准上限（天）：向量化内核把截断后的间隔秒数经 32 位整数转为双精度，需小于 2^31 秒
+constexpr int kMaxHorizonDays = 3650;
+
+/**
+ * @brief 题目评分随时间稳定所需的天数
+ *
+ * 最近作答日距今达到该天数后，时间间隔项已封顶（>= horizonDays 天）、近 7 天窗口也已清空，
+ * 评分不再随 now 变化。推荐索引据此决定题目何时移出活跃桶。
+ */
+constexpr long long scoreSettleDays(int horizonDays) {
+    return (horizonDays > 7 ? horizonDays : 7) + 1;
+}
+
+/// 平衡模式（默认）：错误率主导，兼顾遗忘与难度
+struct BalancedPolicy {
+    static constexpr const char* kName = "balanced";
+    static constexpr const char* kLabel = "平衡模式";
+    static constexpr double kErrorWeight = 0.6;
+    static constexpr double kTimeWeight = 0.3;
+    static constexpr double kDifficultyWeight = 0.1;
+    static constexpr double kUnseenBonus = 0.2;
+    static constexpr double kRecentWeight = 0.5;
+    static constexpr int kHorizonDays = 7;
+    static constexpr double kPrereqWeight = 0.2;
+};
+
+/// 补弱项模式：进一步提高错误率权重，集中练习错题
+struct WeaknessPolicy {
+    static constexpr const char* kName = "weakness";
+    static constexpr const char* kLabel = "补弱项模式";
+    static constexpr double kErrorWeight = 0.7;
+    static constexpr double kTimeWeight = 0.2;
+    static constexpr double kDifficultyWeight = 0.1;
+    static constexpr double kUnseenBonus = 0.2;
+    static constexpr double kRecentWeight = 0.5;
+    static constexpr int kHorizonDays = 7;
+    static constexpr double kPrereqWeight = 0.3;
+};
+
+/// 复习模式：时间间隔主导，以 14 天为遗忘基准，适合考前系统复习
+struct ReviewPolicy {
+    static constexpr const char* kName = "review";
+    static constexpr const char* kLabel = "复习模式";
+    static constexpr double kErrorWeight = 0.4;
+    static constexpr double kTimeWeight = 0.5;
+    static constexpr double kDifficultyWeight = 0.1;
+    static constexpr double kUnseenBonus = 0.2;
+    static constexpr double kRecentWeight = 0.5;
+    static constexpr int kHorizonDays = 14;
+    static constexpr double kPrereqWeight = 0.2;
+};
+
+/// 挑战模式：难度主导，适合已基本掌握、希望攻克难题的同学
+struct ChallengePolicy {
+    static constexpr const char* kName = "challenge";
+    static constexpr const char* kLabel = "挑战模式";
+    static constexpr double kErrorWeight = 0.3;
+    static constexpr double kTimeWeight = 0.2;
+    static constexpr double kDifficultyWeight = 0.5;
+    static constexpr double kUnseenBonus = 0.2;
+    static constexpr double kRecentWeight = 0.5;
+    static constexpr int kHorizonDays = 7;
+    static constexpr double kPrereqWeight = 0.1;
+};
+
+/**
+ * @brief 取策略参数的运行时副本（供向量化内核使用）
+ */
+template <class Policy>
+constexpr ScoreWeights policyWeights() {
+    return ScoreWeights{Policy::kErrorWeight, Policy::kTimeWeight, Policy::kDifficultyWeight,
+                        Policy::kUnseenBonus, Policy::kRecentWeight, Policy::kHorizonDays,
+                        Policy::kPrereqWeight};
+}
+
+/**
+ * @brief 按策略计算一道题的推荐评分（公式说明见 computeRecommendScore）
+ *
+ * 运算顺序与向量化内核逐项对应，两者结果逐位相同。
+ *
+ * @param attempts 总作答次数
+ * @param correct 答对次数
+ * @param recentAttempts 近 7 天作答次数
+ * @param recentCorrect 近 7 天答对次数
+ * @param lastTimestamp 最近作答时间戳（0 表示从未作答）
+ * @param difficulty 难度（1~5）
+ * @param now 当前时间戳（秒）
+ * @return 推荐评分，范围 [0.0, 2.0]
+ * @complexity O(1)
+ */
+template <class Policy>
+inline double scoreWithPolicy(int32_t attempts, int32_t correct, int32_t recentAttempts, int32_t recentCorrect,
+                              long long lastTimestamp, int32_t difficulty, long long now) {
+    static_assert(Policy::kHorizonDays > 0 && Policy::kHorizonDays <= kMaxHorizonDays,
+                  "kHorizonDays 必须在 1 ~ kMaxHorizonDays 之间");
+
+    // 维度 1：错误率（未做过为 1.0；近 7 天有作答时按 kRecentWeight 混入近期错误率）
+    double errorRate = 1.0;
+    if (attempts > 0) errorRate = (attempts - correct) * 1.0 / attempts;
+    if (recentAttempts > 0) {
+        double recentErrorRate = (recentAttempts - recentCorrect) * 1.0 / recentAttempts;
+        errorRate = (1.0 - Policy::kRecentWeight) * errorRate + Policy::kRecentWeight * recentErrorRate;
+    }
+
+    // 维度 2：时间间隔，以 kHorizonDays 归一化到 [0, 1]（未来时间视为 0，从未做过视为满分）
+    double timeGapDays = (double)Policy::kHorizonDays;
+    if (lastTimestamp > 0) {
+        double seconds = (double)(now - lastTimestamp);
+        if (seconds < 0) seconds = 0;
+        timeGapDays = seconds / 86400.0;
+    }
+    double timeScore = timeGapDays / (double)Policy::kHorizonDays;
+    if (timeScore > 1.0) timeScore = 1.0;
+
+    // 维度 3：难度 [1, 5] 线性映射到 [0.2, 1.0]
+    double diffScore = 0.2 + (difficulty - 1) * 0.2;
+    if (diffScore < 0.2) diffScore = 0.2;
+    if (diffScore > 1.0) diffScore = 1.0;
+
+    // 维度 4：未做奖励
+    double unseenBonus = (attempts == 0 ? Policy::kUnseenBonus : 0.0);
+
+    double score = Policy::kErrorWeight * errorRate + Policy::kTimeWeight * timeScore +
+                   Policy::kDifficultyWeight * diffScore + unseenBonus;
+    if (score < 0.0) score = 0.0;
+    if (score > 2.0) score = 2.0;
+    return score;
+}
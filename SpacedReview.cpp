@@ -0,0 +1,288 @@
+/**
+ * @file SpacedReview.cpp
+ * @brief 间隔复习调度模块实现
+ *
+ * 实现要点：
+ * 1. **重建**：按 g_recordColumns 的顺序（即作答时间顺序）逐条重放 SM-2 更新，
+ *    再把每道有计划的题目放入日历队列，O(M + N)
+ * 2. **排期**：到期日早于游标 -> 直接进入逾期集合；窗口内 -> 环形日桶；更远 -> 溢出表
+ * 3. **推进游标**：逐日倒出日桶；跨度超过整个窗口时一次倒出全部日桶和溢出表中已到期的日期，
+ *    再从溢出表补入新进入窗口的日期
+ * 4. **惰性删除**：重新排期不回头删除旧条目，倒出时 dueDay 不匹配或已在逾期集合中的条目直接跳过
+ */
+
+#include "SpacedReview.h"
+#include "Stats.h"
+#include "Question.h"
+#include "RollingStats.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+constexpr double kInitialEase = 2.5;   ///< 初始易度因子
+constexpr double kMinEase = 1.3;       ///< 易度因子下限
+
+/// 天序号 -> 环形日桶下标
+size_t wheelSlot(long long day) {
+    return (size_t)(day & (ReviewScheduler::kWheelDays - 1));
+}
+
+} // namespace
+
+int reviewQuality(bool correct, int usedSeconds) {
+    if (!correct) return 1;
+    return usedSeconds <= kFastAnswerSeconds ? 5 : 4;
+}
+
+ReviewScheduler g_reviewScheduler;
+
+bool ReviewScheduler::current() const {
+    return built_ && epoch_ == g_questionStats.epoch && dueDay_.size() == g_questions.size();
+}
+
+/**
+ * @brief SM-2 更新一道题的记忆状态（不涉及队列）
+ */
+void ReviewScheduler::update(size_t qIdx, bool correct, int usedSeconds, long long timestamp) {
+    int q = reviewQuality(correct, usedSeconds);
+    int32_t& reps = reps_[qIdx];
+    int32_t& interval = interval_[qIdx];
+    double& ease = ease_[qIdx];
+
+    if (q < 3) {
+        reps = 0;
+        interval = 1;
+    } else {
+        if (reps == 0) {
+            interval = 1;
+        } else if (reps == 1) {
+            interval = 6;
+        } else {
+            double next = std::round(interval * ease);
+            interval = next > kMaxReviewIntervalDays ? kMaxReviewIntervalDays : (int32_t)next;
+        }
+        ++reps;
+    }
+    ease += 0.1 - (5 - q) * (0.08 + (5 - q) * 0.02);
+    if (ease < kMinEase) ease = kMinEase;
+
+    if (dueDay_[qIdx] == kNotScheduled) ++scheduledCount_;
+    dueDay_[qIdx] = dayIndexOf(timestamp) + interval;
+}
+
+/**
+ * @brief 整体重建：重放全部记录，再按到期日放入日历队列
+ */
+void ReviewScheduler::rebuild(long long today) {
+    size_t n = g_questions.size();
+    reps_.assign(n, 0);
+    interval_.assign(n, 0);
+    ease_.assign(n, kInitialEase);
+    dueDay_.assign(n, kNotScheduled);
+    scheduledCount_ = 0;
+
+    const RecordColumns& cols = g_recordColumns;
+    for (size_t i = 0; i < cols.size(); ++i) {
+        int32_t q = cols.questionIndex[i];
+        if (q < 0 || (size_t)q >= n) continue;   // 题库中不存在的题目
+        update((size_t)q, cols.correct[i] != 0, cols.usedSeconds[i], cols.timestamp[i]);
+    }
+
+    ring_.assign(kWheelDays, std::vector<int>());
+    overflow_.clear();
+    overdue_.clear();
+    overduePos_.assign(n, -1);
+    baseDay_ = today + 1;
+    for (size_t q = 0; q < n; ++q) {
+        if (dueDay_[q] != kNotScheduled) schedule(q);
+    }
+
+    epoch_ = g_questionStats.epoch;
+    built_ = true;
+}
+
+void ReviewScheduler::refresh(long long today) {
+    if (!current()) {
+        rebuild(today);
+        return;
+    }
+    advanceTo(today);
+}
+
+/**
+ * @brief 按 dueDay_ 把题目放入逾期集合、环形日桶或溢出表
+ */
+void ReviewScheduler::schedule(size_t qIdx) {
+    long long day = dueDay_[qIdx];
+    if (day < baseDay_) {
+        addOverdue((int)qIdx);
+    } else if (day < baseDay_ + kWheelDays) {
+        ring_[wheelSlot(day)].push_back((int)qIdx);
+    } else {
+        overflow_[day].push_back((int)qIdx);
+    }
+}
+
+/**
+ * @brief 把游标推进到 today 之后，途经的日桶全部倒出到逾期集合
+ */
+void ReviewScheduler::advanceTo(long long today) {
+    if (today < baseDay_) return;
+
+    if (today - baseDay_ >= kWheelDays) {
+        // 跨过整个窗口：窗口内的日桶全部到期，溢出表中 <= today 的日期同样到期
+        for (long long d = baseDay_; d < baseDay_ + kWheelDays; ++d) drain(ring_[wheelSlot(d)], d);
+        while (!overflow_.empty() && overflow_.begin()->first <= today) {
+            drain(overflow_.begin()->second, overflow_.begin()->first);
+            overflow_.erase(overflow_.begin());
+        }
+    } else {
+        for (long long d = baseDay_; d <= today; ++d) drain(ring_[wheelSlot(d)], d);
+    }
+    baseDay_ = today + 1;
+
+    // 溢出表中进入新窗口的日期补入环形日桶
+    while (!overflow_.empty() && overflow_.begin()->first < baseDay_ + kWheelDays) {
+        long long day = overflow_.begin()->first;
+        std::vector<int>& bucket = ring_[wheelSlot(day)];
+        for (int q : overflow_.begin()->second) {
+            if (dueDay_[q] == day) bucket.push_back(q);
+        }
+        overflow_.erase(overflow_.begin());
+    }
+}
+
+void ReviewScheduler::drain(std::vector<int>& bucket, long long day) {
+    for (int q : bucket) {
+        if (dueDay_[q] == day) addOverdue(q);   // 已重新排期的旧条目跳过
+    }
+    bucket.clear();
+}
+
+void ReviewScheduler::addOverdue(int qIdx) {
+    if (overduePos_[qIdx] >= 0) return;   // 同一天重复排期产生的重复条目
+    overduePos_[qIdx] = (int)overdue_.size();
+    overdue_.push_back(qIdx);
+}
+
+void ReviewScheduler::removeOverdue(int qIdx) {
+    int pos = overduePos_[qIdx];
+    if (pos < 0) return;
+    int last = overdue_.back();
+    overdue_[pos] = last;
+    overduePos_[last] = pos;
+    overdue_.pop_back();
+    overduePos_[qIdx] = -1;
+}
+
+void ReviewScheduler::apply(size_t qIdx, bool correct, int usedSeconds, long long timestamp) {
+    if (!current() || qIdx >= dueDay_.size()) return;
+    removeOverdue((int)qIdx);
+    update(qIdx, correct, usedSeconds, timestamp);
+    schedule(qIdx);
+}
+
+std::vector<int> ReviewScheduler::dueNow(long long today, size_t limit) {
+    refresh(today);
+    std::vector<int> out(overdue_);
+    auto earlier = [this](int a, int b) {
+        if (dueDay_[a] != dueDay_[b]) return dueDay_[a] < dueDay_[b];
+        return a < b;
+    };
+    if (limit < out.size()) {
+        std::partial_sort(out.begin(), out.begin() + limit, out.end(), earlier);
+        out.resize(limit);
+    } else {
+        std::sort(out.begin(), out.end(), earlier);
+    }
+    return out;
+}
+
+size_t ReviewScheduler::dueCount(long long today) {
+    refresh(today);
+    return overdue_.size();
+}
+
+long long ReviewScheduler::nextDueDay(long long today) {
+    refresh(today);
+    for (long long d = baseDay_; d < baseDay_ + kWheelDays; ++d) {
+        for (int q : ring_[wheelSlot(d)]) {
+            if (dueDay_[q] == d) return d;
+        }
+    }
+    for (const auto& entry : overflow_) {
+        for (int q : entry.second) {
+            if (dueDay_[q] == entry.first) return entry.first;
+        }
+    }
+    return kNotScheduled;
+}
+
+void applyRecordToSchedule(const Record& r) {
+    auto itQ = g_questionById.find(r.questionId);
+    if (itQ == g_questionById.end()) return;
+    g_reviewScheduler.apply(itQ->second, r.correct, r.usedSeconds, r.timestamp);
+}
+
+/**
+ * @brief 间隔复习模式主函数（实现）
+ *
+ * **流程**
+ * 1. 题库为空时提示并返回；统计表未覆盖当前题库时重建（与 AI 推荐模式一致）
+ * 2. 从日历队列取出截至今天已到期的题目，逾期最久的在前，每轮最多 kSessionSize 道
+ * 3. 没有到期题目：提示已排期题数与下一批的到期时间
+ * 4. 逐题展示复习信息（逾期天数、上次间隔）并调用 doQuestion() 作答；
+ *    doQuestion() 内部调用 applyRecordToSchedule()，按作答结果重新排期
+ */
+void spacedReviewMode() {
+    if (g_questions.empty()) {
+        std::cout << "题库为空，无法复习。\n";
+        pauseForUser();
+        return;
+    }
+    if (g_questionStats.size() != g_questions.size()) {
+        buildQuestionStats();
+    }
+
+    const size_t kSessionSize = 10;   // 每轮最多复习的题数
+    long long today = dayIndexOf((long long)std::time(nullptr));
+    size_t dueTotal = g_reviewScheduler.dueCount(today);
+    std::vector<int> due = g_reviewScheduler.dueNow(today, kSessionSize);
+
+    std::cout << "【间隔复习模式】按 SM-2 记忆曲线安排复习，答得越顺，间隔越长。\n";
+    if (due.empty()) {
+        if (g_reviewScheduler.scheduledCount() == 0) {
+            std::cout << "还没有复习计划，先去做几道题吧。\n";
+        } else {
+            long long next = g_reviewScheduler.nextDueDay(today);
+            std::cout << "今天没有到期的题目（已排期 " << g_reviewScheduler.scheduledCount() << " 道）。\n";
+            if (next != ReviewScheduler::kNotScheduled) {
+                std::cout << "下一批复习将在 " << (next - today) << " 天后到期。\n";
+            }
+        }
+        pauseForUser();
+        return;
+    }
+
+    std::cout << "今天共有 " << dueTotal << " 道题到期，本轮复习其中 " << due.size() << " 道。\n\n";
+    for (size_t i = 0; i < due.size(); ++i) {
+        size_t qIdx = (size_t)due[i];
+        long long overdueDays = today - g_reviewScheduler.dueDay(qIdx);
+
+        std::cout << "-----------------------------\n";
+        std::cout << "第 " << (i + 1) << " 道复习题（上次间隔 " << g_reviewScheduler.intervalDays(qIdx) << " 天";
+        if (overdueDays > 0) std::cout << "，已逾期 " << overdueDays << " 天";
+        std::cout << "）：\n";
+
+        doQuestion(g_questions[qIdx]);
+
+        std::cout << "下次复习：" << (g_reviewScheduler.dueDay(qIdx) - today) << " 天后\n\n";
+    }
+
+    std::cout << "本轮间隔复习结束。\n";
+    pauseForUser();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file SpacedReview.h
+ * @brief 间隔复习调度模块 - SM-2 记忆状态 + 日历队列
+ *
+ * 【模块职责】
+ * 推荐评分只用线性的 7 天时间项近似遗忘。本模块为每道题维护真正的间隔重复（SM-2）记忆状态：
+ * - 每次作答（Record）按答题质量更新：连续答对次数、复习间隔（天）、易度因子 ease
+ * - 由此得到下次到期日 dueDay = 作答日 + 间隔
+ * 并用"日历队列"按到期日组织题目，"现在该复习哪些题"只需 O(到期题数)，无需扫描整个题库。
+ *
+ * 【SM-2 规则】
+ * - 答题质量 quality（0~5）：答错为 1；答对且用时不超过 kFastAnswerSeconds 为 5；其余答对为 4
+ * - quality < 3：连续答对次数清零，间隔重置为 1 天
+ * - quality >= 3：第 1 次间隔 1 天，第 2 次 6 天，之后为 round(上次间隔 × ease)，最长 kMaxReviewIntervalDays
+ * - ease += 0.1 - (5 - q) × (0.08 + (5 - q) × 0.02)，下限 1.3，初始 2.5
+ *
+ * 【日历队列】
+ * - 环形日桶 ring[day % kWheelDays] 存放未来 kWheelDays 天内到期的题目，更远的放入按日有序的溢出表
+ * - 游标 baseDay_ 之前的日桶已全部"倒出"到逾期集合 overdue_（带位置表，O(1) 增删）
+ * - 查询到期题目时把游标推进到今天：每跨过一天倒出一个日桶，并从溢出表补入进入窗口的日期
+ * - 题目重新排期时旧条目不删除，倒出时按 dueDay 是否匹配跳过（惰性删除）
+ *
+ * 【复杂度】
+ * - 作答后更新：O(1)（溢出表插入 O(log D)，D 为远期不同到期日数）
+ * - 取到期题目：O(跨过的天数 + 到期题数 + 过期条目数)，与题库大小无关
+ * - 重建：O(M + N)，M 为记录数，N 为题库大小
+ *
+ * 【与其他模块依赖】
+ * - Record.cpp：doQuestion() 作答后调用 applyRecordToSchedule()
+ * - Stats.h：QuestionStatTable::epoch 变化（统计整体重建、切换用户）时从 g_recordColumns 重放重建
+ * - App.cpp：主菜单"9. 间隔复习（到期题目）"调用 spacedReviewMode()
+ * - Bench.cpp：--bench-review 对比日历队列与全量扫描
+ */
+
+#pragma once
+
+#include "Record.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/// 答对且用时不超过该秒数视为"轻松答对"（质量 5）
+constexpr int kFastAnswerSeconds = 15;
+
+/// 复习间隔上限（天）
+constexpr int kMaxReviewIntervalDays = 3650;
+
+/**
+ * @brief 由一次作答得到 SM-2 答题质量
+ * @param correct 是否答对
+ * @param usedSeconds 用时（秒）
+ * @return 1（答错）、4（答对）或 5（快速答对）
+ */
+int reviewQuality(bool correct, int usedSeconds);
+
+/**
+ * @class ReviewScheduler
+ * @brief 每道题的 SM-2 记忆状态 + 按到期日组织的日历队列
+ *
+ * 状态按题目下标存放（与 g_questions 对齐）。首次查询时从 g_recordColumns 按时间顺序重放全部记录构建；
+ * 之后每次作答由 apply() 增量更新；统计表整体重建（epoch 变化）或题库大小变化时下次查询重新构建。
+ */
+class ReviewScheduler {
+public:
+    /// 日历队列环形窗口天数（2 的幂）
+    static constexpr int kWheelDays = 64;
+
+    /// dueDay 中表示"从未作答、尚无复习计划"
+    static constexpr long long kNotScheduled = LLONG_MIN;
+
+    /**
+     * @brief 取截至 today 已到期的题目（逾期最久的在前，同日按题目下标）
+     * @param today 当前天序号（dayIndexOf(now)），需单调不减
+     * @param limit 最多返回的题数
+     * @return 题目下标列表
+     * @complexity O(跨过的天数 + D + L log L)，D = 到期题数，L = min(limit, D)；首次或重建时 O(M + N)
+     */
+    std::vector<int> dueNow(long long today, size_t limit);
+
+    /**
+     * @brief 截至 today 已到期的题数
+     * @complexity 同 dueNow（不含排序）
+     */
+    size_t dueCount(long long today);
+
+    /**
+     * @brief 最早的未来到期日（today 之后）
+     * @return 天序号；没有任何未来复习计划时返回 kNotScheduled
+     * @complexity O(kWheelDays + 窗口内条目数)，窗口内没有时再查溢出表
+     */
+    long long nextDueDay(long long today);
+
+    /**
+     * @brief 按一次作答更新该题的记忆状态并重新排期
+     *
+     * 尚未构建或已过期（epoch 变化）时忽略：下次查询会从 g_recordColumns 重放，其中已包含这条记录。
+     *
+     * @param qIdx 题目下标
+     * @param correct 是否答对
+     * @param usedSeconds 用时（秒）
+     * @param timestamp 作答时间戳（秒）
+     * @complexity O(1)（远期排期 O(log D)）
+     */
+    void apply(size_t qIdx, bool correct, int usedSeconds, long long timestamp);
+
+    /// 丢弃全部状态，下次查询时重建
+    void invalidate() { built_ = false; }
+
+    /// 有复习计划（作答过）的题目数
+    size_t scheduledCount() const { return scheduledCount_; }
+
+    /// 第 qIdx 题的下次到期日（kNotScheduled 表示从未作答）
+    long long dueDay(size_t qIdx) const { return qIdx < dueDay_.size() ? dueDay_[qIdx] : kNotScheduled; }
+
+    /// 第 qIdx 题当前的复习间隔（天）
+    int intervalDays(size_t qIdx) const { return qIdx < interval_.size() ? interval_[qIdx] : 0; }
+
+    /// 第 qIdx 题当前的易度因子
+    double ease(size_t qIdx) const { return qIdx < ease_.size() ? ease_[qIdx] : 0.0; }
+
+private:
+    bool current() const;
+    void rebuild(long long today);
+    void refresh(long long today);
+    void update(size_t qIdx, bool correct, int usedSeconds, long long timestamp);
+    void schedule(size_t qIdx);
+    void advanceTo(long long today);
+    void drain(std::vector<int>& bucket, long long day);
+    void addOverdue(int qIdx);
+    void removeOverdue(int qIdx);
+
+    bool built_ = false;
+    uint64_t epoch_ = 0;                        ///< 构建时 g_questionStats.epoch
+
+    // ---- 记忆状态（按题目下标） ----
+    std::vector<int32_t> reps_;                 ///< 连续答对（质量 >= 3）次数
+    std::vector<int32_t> interval_;             ///< 当前复习间隔（天）
+    std::vector<double> ease_;                  ///< 易度因子
+    std::vector<long long> dueDay_;             ///< 下次到期日（kNotScheduled 表示从未作答）
+    size_t scheduledCount_ = 0;
+
+    // ---- 日历队列 ----
+    long long baseDay_ = 0;                     ///< 游标：早于该日的日桶已倒出到 overdue_
+    std::vector<std::vector<int>> ring_;        ///< 环形日桶（[baseDay_, baseDay_ + kWheelDays) 内到期）
+    std::map<long long, std::vector<int>> overflow_;   ///< 更远的到期日 -> 题目
+    std::vector<int> overdue_;                  ///< 已到期题目
+    std::vector<int> overduePos_;               ///< 题目下标 -> 在 overdue_ 中的位置（-1 表示不在）
+};
+
+/**
+ * @brief 全局间隔复习调度器（当前用户，首次查询时构建）
+ */
+extern ReviewScheduler g_reviewScheduler;
+
+/**
+ * @brief 把一条新作答记录计入间隔复习调度
+ *
+ * doQuestion() 在 applyRecordToStats() 之后调用。
+ *
+ * @param r 作答记录（题号不在题库中时忽略）
+ * @complexity O(1)
+ */
+void applyRecordToSchedule(const Record& r);
+
+/**
+ * @brief 间隔复习模式主函数
+ *
+ * 取出已到期的题目（逾期最久的在前，每轮最多 10 道）逐题作答；
+ * 作答结果按 SM-2 更新记忆状态并重新排期。没有到期题目时提示下一批的到期时间。
+ *
+ * @complexity 取题 O(到期题数)，与题库大小无关
+ */
+void spacedReviewMode();
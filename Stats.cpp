@@ -6,114 +6,477 @@
  * 1. **题目统计聚合**：遍历 g_recordsByQuestion，对每道题的所有记录进行累加统计
  *    - 累计作答次数、答对次数、总用时
  *    - 追踪最近作答时间戳（用于复习推荐）
+ *    - 结果写入与 g_questions 下标对齐的稠密列式表（每题一次哈希换算下标）
  *    - 时间复杂度：O(M)，其中 M 为总记录数
  *
- * 2. **知识点统计聚合**：遍历 g_records，根据题目 ID 查找所属知识点
- *    - 使用哈希表累加每个知识点的总题数和答对数
+ * 2. **知识点统计聚合**：在列式记录 g_recordColumns 上做分组直方图（Kernels.h）
+ *    - 知识点 ID 在追加记录时已换算，聚合时无哈希查找、无分支
  *    - 最终计算各知识点的正确率（correct / total * 100）
- *    - 时间复杂度：O(M)，查找题目为 O(1)
+ *    - 时间复杂度：O(M)
  *
- * 3. **统计展示**：分两部分展示
- *    - 总体统计：遍历所有记录计算总正确率
- *    - 知识点统计：实时构建知识点哈希表并展示
+ * 3. **统计展示**：分多部分展示
+ *    - 总体统计：在列式记录上调用答对计数 / 用时求和内核
+ *    - 知识点统计：调用按知识点分组的直方图内核
+ *    - 近期表现：直接读取滚动窗口累加和（O(K)，K 为知识点数）
  *    - 时间复杂度：O(M)
+ *
+ * 4. **滚动窗口维护**：buildQuestionStats() 重建时顺带重建，
+ *    applyRecordToStats() 在每次答题后 O(1) 增量更新
+ *
+ * 5. **用时草图**：与滚动窗口同样采用"槽位 + 对象池"，每条记录摊还 O(1) 追加；
+ *    统计快照只写出汇总与草图，合并多个快照即可得到班级用时分布
+ *
+ * 6. **并行重建**：记录数达到阈值时，在列式记录上按连续区间分区，
+ *    每个分区一份部分结果（StatsPartial），按分区编号存放、按分区编号归并，
+ *    结果与线程调度无关
  */
 
 #include "Stats.h"
 #include "Record.h"
 #include "Question.h"
+#include "RollingStats.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <ctime>
 
 // 全局统计信息定义
-std::unordered_map<int, QuestionStat> g_questionStats;
+QuestionStatTable g_questionStats;
+std::vector<int> g_questionTimeSketchSlot;
+std::vector<QuantileSketch> g_questionTimeSketchPool;
+std::vector<QuantileSketch> g_knowledgeTimeSketches;
+
+namespace {
+
+/// 清空用时草图并按题库/知识点数量重新分配槽位
+void resetTimeSketches(size_t questionCount, size_t knowledgeCount) {
+    g_questionTimeSketchSlot.assign(questionCount, -1);
+    g_questionTimeSketchPool.clear();
+    g_knowledgeTimeSketches.assign(knowledgeCount, QuantileSketch(kKnowledgeTimeSketchK));
+}
+
+/// 将一次作答用时计入题目与知识点草图
+void addToTimeSketches(size_t qIdx, int knowledgeId, int seconds) {
+    if (qIdx < g_questionTimeSketchSlot.size()) {
+        int& slot = g_questionTimeSketchSlot[qIdx];
+        if (slot < 0) {
+            slot = (int)g_questionTimeSketchPool.size();
+            g_questionTimeSketchPool.emplace_back(kQuestionTimeSketchK);
+        }
+        g_questionTimeSketchPool[slot].add(seconds);
+    }
+    if (knowledgeId >= 0) {
+        if ((size_t)knowledgeId >= g_knowledgeTimeSketches.size()) {
+            g_knowledgeTimeSketches.resize(knowledgeId + 1, QuantileSketch(kKnowledgeTimeSketchK));
+        }
+        g_knowledgeTimeSketches[knowledgeId].add(seconds);
+    }
+}
+
+} // namespace
+
+const QuantileSketch* questionTimeSketch(size_t qIdx) {
+    if (qIdx >= g_questionTimeSketchSlot.size()) return nullptr;
+    int slot = g_questionTimeSketchSlot[qIdx];
+    return slot < 0 ? nullptr : &g_questionTimeSketchPool[slot];
+}
+
+/**
+ * @brief 重置稠密统计表为 n 行默认值
+ *
+ * 使用 assign 整列覆盖，已有容量可复用，避免重复分配。
+ */
+void QuestionStatTable::reset(size_t n) {
+    totalAttempts.assign(n, 0);
+    correctAttempts.assign(n, 0);
+    totalTime.assign(n, 0);
+    lastTimestamp.assign(n, 0);
+    ++epoch;
+    ++version;
+}
+
+/**
+ * @brief 按下标读取一行统计并组装为 QuestionStat
+ */
+QuestionStat QuestionStatTable::at(size_t idx) const {
+    QuestionStat st;
+    st.totalAttempts = totalAttempts[idx];
+    st.correctAttempts = correctAttempts[idx];
+    st.totalTime = totalTime[idx];
+    st.lastTimestamp = lastTimestamp[idx];
+    return st;
+}
+
+/**
+ * @brief 按题号查询统计信息（兼容旧的按 ID 查找方式）
+ *
+ * 题号 -> 下标（g_questionById）-> 统计表对应行。
+ */
+bool findQuestionStat(int questionId, QuestionStat& out) {
+    auto it = g_questionById.find(questionId);
+    if (it == g_questionById.end()) return false;   // 题号不存在
+
+    size_t idx = it->second;
+    if (idx >= g_questionStats.size()) return false; // 统计表尚未覆盖该题
+
+    out = g_questionStats.at(idx);
+    return true;
+}
 
 /**
  * @brief 从做题记录构建题目统计信息
  *
  * 实现逻辑：
- * 1. 清空旧的统计数据
- * 2. 遍历 g_recordsByQuestion（按题目 ID 组织的记录）
- * 3. 对每道题目的所有记录进行聚合：
+ * 1. 按当前题库大小重置稠密统计表
+ * 2. 按记录顺序遍历列式记录 g_recordColumns（题目下标与知识点 ID 在追加时已换算，无需哈希查找）
+ * 3. 对每条记录聚合到 g_questionStats 的对应行：
  *    - 累加总作答次数
- *    - 累加答对次数（通过 r.correct 判断）
+ *    - 累加答对次数
  *    - 累加总用时
  *    - 更新最近作答时间（取最大时间戳）
- * 4. 将聚合结果存入 g_questionStats
+ * 4. 同一遍历中把每条记录计入题目/知识点/总体滚动窗口及用时草图
+ *
+ * 不遍历 g_recordsByQuestion：其迭代顺序取决于哈希表布局，会让分位数草图的内容无法复现，
+ * 也与按记录顺序累加的并行路径不一致。
+ *
+ * 记录数达到 kParallelStatsMinRecords 且有多个核心时，改由 buildQuestionStatsParallel() 完成。
  *
  * @complexity O(M)，其中 M 为总记录数
  */
 void buildQuestionStats() {
-    // 清空旧数据，准备重建
-    g_questionStats.clear();
+    // 记录量大且有多个核心时走并行路径
+    if (g_recordColumns.size() >= kParallelStatsMinRecords && globalThreadPool().size() > 1) {
+        buildQuestionStatsParallel(globalThreadPool());
+        return;
+    }
 
-    // 遍历按题目分组的记录
-    for (const auto& p : g_recordsByQuestion) {
-        int qid = p.first;                 // 题目 ID
-        const auto& vec = p.second;        // 该题的所有作答记录
+    // 清空旧数据，按题库大小重建稠密表
+    g_questionStats.reset(g_questions.size());
+    resetRollingStats(g_questions.size(), g_knowledgeNames.size());
+    resetTimeSketches(g_questions.size(), g_knowledgeNames.size());
 
-        QuestionStat st;                   // 初始化统计结构
+    // 按记录顺序遍历列式记录（与并行路径一致）：记录进入用时草图的顺序与哈希表布局无关，
+    // 草图内容、快照与分位数因此可复现
+    const RecordColumns& cols = g_recordColumns;
+    for (size_t i = 0; i < cols.size(); ++i) {
+        // 题库中不存在的题目在追加时已记为 -1，直接跳过
+        int32_t q = cols.questionIndex[i];
+        if (q < 0 || (size_t)q >= g_questionStats.size()) continue;
+        size_t qIdx = (size_t)q;
 
-        // 遍历该题的所有作答记录，进行聚合
-        for (const auto& r : vec) {
-            st.totalAttempts++;            // 累加作答次数
-            if (r.correct) st.correctAttempts++;  // 累加答对次数
-            st.totalTime += r.usedSeconds; // 累加总用时
+        bool correct = cols.correct[i] != 0;
+        int seconds = cols.usedSeconds[i];
+        long long ts = cols.timestamp[i];
+        g_questionStats.totalAttempts[qIdx]++;             // 累加作答次数
+        if (correct) g_questionStats.correctAttempts[qIdx]++;   // 累加答对次数
+        g_questionStats.totalTime[qIdx] += seconds;         // 累加总用时
+        // 更新最近作答时间（保留最大时间戳）
+        if (ts > g_questionStats.lastTimestamp[qIdx]) g_questionStats.lastTimestamp[qIdx] = ts;
+
+        // 计入滚动窗口（近 1/7/30 天）与用时草图
+        addToRollingStats(qIdx, cols.knowledgeId[i], ts, correct, seconds);
+        addToTimeSketches(qIdx, cols.knowledgeId[i], seconds);
+    }
+}
+
+/**
+ * @brief 增量计入一条新记录（实现）
+ *
+ * 与 buildQuestionStats() 对单条记录的处理完全一致，只是不做清空重建，
+ * 因此答题后无需回扫全部历史即可得到最新的统计与滚动窗口。
+ */
+void applyRecordToStats(const Record& r) {
+    auto itQ = g_questionById.find(r.questionId);
+    if (itQ == g_questionById.end() || itQ->second >= g_questionStats.size()) {
+        // 题目不在题库（或统计表尚未构建）：与全量重建一致，不计入任何统计与窗口
+        return;
+    }
 
-            // 更新最近作答时间（保留最大时间戳）
-            if (r.timestamp > st.lastTimestamp) {
-                st.lastTimestamp = r.timestamp;
+    size_t qIdx = itQ->second;
+    g_questionStats.totalAttempts[qIdx]++;
+    if (r.correct) g_questionStats.correctAttempts[qIdx]++;
+    g_questionStats.totalTime[qIdx] += r.usedSeconds;
+    if (r.timestamp > g_questionStats.lastTimestamp[qIdx]) {
+        g_questionStats.lastTimestamp[qIdx] = r.timestamp;
+    }
+    ++g_questionStats.version;
+
+    addToRollingStats(qIdx, g_questions[qIdx].knowledgeId, r.timestamp, r.correct, r.usedSeconds);
+    addToTimeSketches(qIdx, g_questions[qIdx].knowledgeId, r.usedSeconds);
+}
+
+std::string getStatsSnapshotPath() {
+    return (getDataDir() / ("stats_" + g_currentUserId + ".snapshot")).string();
+}
+
+namespace {
+
+/**
+ * @struct StatsPartial
+ * @brief 一个记录分区的部分统计结果（结构与全局统计一一对应）
+ */
+struct StatsPartial {
+    QuestionStatTable table;
+    std::vector<int> windowSlot;
+    std::vector<RollingWindow> windowPool;
+    std::vector<RollingWindow> knowledgeWindows;
+    RollingWindow overallWindow;
+    std::vector<int> sketchSlot;
+    std::vector<QuantileSketch> sketchPool;
+    std::vector<QuantileSketch> knowledgeSketches;
+};
+
+/// 在分区 [lo, hi) 的列式记录上累加部分结果（只写 part，无共享状态）
+void accumulatePartial(StatsPartial& part, size_t lo, size_t hi, size_t qCount, size_t kCount) {
+    part.table.reset(qCount);
+    part.windowSlot.assign(qCount, -1);
+    part.knowledgeWindows.assign(kCount, RollingWindow());
+    part.sketchSlot.assign(qCount, -1);
+    part.knowledgeSketches.assign(kCount, QuantileSketch(kKnowledgeTimeSketchK));
+
+    const RecordColumns& cols = g_recordColumns;
+    for (size_t i = lo; i < hi; ++i) {
+        int32_t q = cols.questionIndex[i];
+        if (q < 0 || (size_t)q >= qCount) continue;   // 题库中不存在的题目（与顺序路径一致）
+
+        bool correct = cols.correct[i] != 0;
+        int seconds = cols.usedSeconds[i];
+        long long ts = cols.timestamp[i];
+        part.table.totalAttempts[q]++;
+        if (correct) part.table.correctAttempts[q]++;
+        part.table.totalTime[q] += seconds;
+        if (ts > part.table.lastTimestamp[q]) part.table.lastTimestamp[q] = ts;
+
+        long long day = dayIndexOf(ts);
+        int& ws = part.windowSlot[q];
+        if (ws < 0) {
+            ws = (int)part.windowPool.size();
+            part.windowPool.emplace_back();
+        }
+        part.windowPool[ws].add(day, correct, seconds);
+        part.overallWindow.add(day, correct, seconds);
+
+        int& ss = part.sketchSlot[q];
+        if (ss < 0) {
+            ss = (int)part.sketchPool.size();
+            part.sketchPool.emplace_back(kQuestionTimeSketchK);
+        }
+        part.sketchPool[ss].add(seconds);
+
+        int32_t k = cols.knowledgeId[i];
+        if (k >= 0 && (size_t)k < kCount) {
+            part.knowledgeWindows[k].add(day, correct, seconds);
+            part.knowledgeSketches[k].add(seconds);
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 并行构建题目统计信息（实现）
+ */
+void buildQuestionStatsParallel(ThreadPool& pool) {
+    const size_t qCount = g_questions.size();
+    const size_t kCount = g_knowledgeNames.size();
+    const size_t m = g_recordColumns.size();
+    const size_t parts = pool.size();
+
+    // 第一步：各分区独立累加（分区 p 覆盖 [m*p/parts, m*(p+1)/parts)）
+    std::vector<StatsPartial> partials(parts);
+    pool.parallelFor(parts, [&](size_t p) {
+        accumulatePartial(partials[p], m * p / parts, m * (p + 1) / parts, qCount, kCount);
+    });
+
+    // 第二步：统计表按题目区间并行归并（各区间互不重叠，同样无锁）
+    g_questionStats.reset(qCount);
+    pool.parallelFor(parts, [&](size_t t) {
+        size_t lo = qCount * t / parts;
+        size_t hi = qCount * (t + 1) / parts;
+        for (const StatsPartial& part : partials) {
+            for (size_t q = lo; q < hi; ++q) {
+                g_questionStats.totalAttempts[q] += part.table.totalAttempts[q];
+                g_questionStats.correctAttempts[q] += part.table.correctAttempts[q];
+                g_questionStats.totalTime[q] += part.table.totalTime[q];
+                if (part.table.lastTimestamp[q] > g_questionStats.lastTimestamp[q]) {
+                    g_questionStats.lastTimestamp[q] = part.table.lastTimestamp[q];
+                }
             }
         }
+    });
+
+    // 第三步：滚动窗口与用时草图按分区编号顺序归并（对象池槽位分配顺序因此确定）
+    resetRollingStats(qCount, kCount);
+    resetTimeSketches(qCount, kCount);
+    for (const StatsPartial& part : partials) {
+        for (size_t q = 0; q < qCount; ++q) {
+            if (part.windowSlot[q] >= 0) {
+                const RollingWindow& w = part.windowPool[part.windowSlot[q]];
+                int& slot = g_questionWindowSlot[q];
+                if (slot < 0) {
+                    slot = (int)g_questionWindowPool.size();
+                    g_questionWindowPool.push_back(w);
+                } else {
+                    g_questionWindowPool[slot].merge(w);
+                }
+            }
+            if (part.sketchSlot[q] >= 0) {
+                const QuantileSketch& sk = part.sketchPool[part.sketchSlot[q]];
+                int& slot = g_questionTimeSketchSlot[q];
+                if (slot < 0) {
+                    slot = (int)g_questionTimeSketchPool.size();
+                    g_questionTimeSketchPool.push_back(sk);
+                } else {
+                    g_questionTimeSketchPool[slot].merge(sk);
+                }
+            }
+        }
+        for (size_t k = 0; k < kCount; ++k) {
+            g_knowledgeWindows[k].merge(part.knowledgeWindows[k]);
+            g_knowledgeTimeSketches[k].merge(part.knowledgeSketches[k]);
+        }
+        g_overallWindow.merge(part.overallWindow);
+    }
+}
+
+/**
+ * @brief 写出统计快照（实现）
+ *
+ * 只遍历有草图槽位的题目（即作答过的题目），未作答的题目不写出。
+ */
+bool saveStatsSnapshot(const std::string& filename) {
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "无法写入统计快照：" << filename << "\n";
+        return false;
+    }
+
+    fout << "# DS_AI_Quiz stats snapshot v1\n";
+    fout << "U," << g_currentUserId << "\n";
+
+    for (size_t i = 0; i < g_questionTimeSketchSlot.size() && i < g_questionStats.size(); ++i) {
+        const QuantileSketch* sk = questionTimeSketch(i);
+        if (!sk) continue;
+        fout << "Q," << g_questions[i].id
+             << "," << g_questionStats.totalAttempts[i]
+             << "," << g_questionStats.correctAttempts[i]
+             << "," << g_questionStats.totalTime[i]
+             << "," << g_questionStats.lastTimestamp[i]
+             << "," << sk->serialize() << "\n";
+    }
+
+    for (size_t k = 0; k < g_knowledgeTimeSketches.size() && k < g_knowledgeNames.size(); ++k) {
+        if (g_knowledgeTimeSketches[k].empty()) continue;
+        fout << "K," << g_knowledgeNames[k] << "," << g_knowledgeTimeSketches[k].serialize() << "\n";
+    }
+    return true;
+}
+
+/**
+ * @brief 合并统计快照（实现）
+ *
+ * 草图位于每行最后一个逗号之后；知识点名称中不含逗号（题库 CSV 同样以逗号分隔）。
+ */
+bool mergeStatsSnapshot(const std::string& filename, CohortTimeSketches& cohort) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+
+    std::string line;
+    while (std::getline(fin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.size() < 2 || line[1] != ',') continue;    // 注释或空行
 
-        // 将该题的统计信息存入全局映射表
-        g_questionStats[qid] = st;
+        size_t lastComma = line.rfind(',');
+        QuantileSketch sk;
+        if (!QuantileSketch::deserialize(line.substr(lastComma + 1), sk)) continue;
+
+        if (line[0] == 'Q') {
+            // Q,<题号>,... 只需要题号与草图
+            int qid = 0;
+            try {
+                qid = std::stoi(line.substr(2, line.find(',', 2) - 2));
+            } catch (...) {
+                continue;
+            }
+            auto it = cohort.byQuestion.find(qid);
+            if (it == cohort.byQuestion.end()) {
+                cohort.byQuestion.emplace(qid, sk);
+            } else {
+                it->second.merge(sk);
+            }
+        } else if (line[0] == 'K') {
+            std::string name = line.substr(2, lastComma - 2);
+            auto it = cohort.byKnowledge.find(name);
+            if (it == cohort.byKnowledge.end()) {
+                cohort.byKnowledge.emplace(name, sk);
+            } else {
+                it->second.merge(sk);
+            }
+        }
     }
+    cohort.users++;
+    return true;
 }
 
 /**
  * @brief 构建知识点统计信息
  *
  * 实现逻辑：
- * 1. 创建临时哈希表用于累加各知识点的统计数据
- * 2. 遍历所有做题记录 g_records：
- *    - 通过记录中的题目 ID 查找题目对象
- *    - 获取题目所属的知识点
- *    - 累加该知识点的总题数和答对题数
- * 3. 第二次遍历：计算每个知识点的正确率（百分比形式）
+ * 1. 在列式记录 g_recordColumns 上调用 kernelKnowledgeHistogram()，
+ *    一次得到各知识点的作答数与答对数（知识点 ID 在追加记录时已换算，无需哈希查找）；
+ *    记录量大时各线程分别统计一个分区，再按分区顺序相加
+ * 2. 按知识点 ID 转换为 名称 -> 统计信息，并计算正确率（百分比形式）
  *    - accuracy = correct / total * 100.0
- * 4. 返回构建好的知识点统计映射表
+ * 3. 返回构建好的知识点统计映射表
  *
  * @return 知识点统计映射表（知识点名称 -> 统计信息）
- * @complexity O(M)，其中 M 为总记录数，查找题目为 O(1) 哈希查找
+ * @complexity O(M + K)，其中 M 为总记录数，K 为知识点数
  */
 std::unordered_map<std::string, KnowledgeStat> buildKnowledgeStats() {
     // 初始化知识点统计哈希表
     std::unordered_map<std::string, KnowledgeStat> ks;
 
-    // 第一步：遍历所有记录，累加各知识点的题数和答对数
-    for (const auto& r : g_records) {
-        // 通过题目 ID 查找题目索引（O(1) 哈希查找）
-        auto itQ = g_questionById.find(r.questionId);
-        if (itQ == g_questionById.end()) continue; // 题目不存在则跳过
-
-        size_t qIdx = itQ->second;
-        if (qIdx >= g_questions.size()) continue; // 索引异常则跳过
-
-        // 获取题目所属的知识点
-        const std::string& kd = g_questions[qIdx].knowledge;
-
-        // 累加该知识点的统计数据
-        ks[kd].total++;                      // 总题数 +1
-        if (r.correct) ks[kd].correct++;     // 如果答对，答对数 +1
+    // 第一步：在列式记录上做按知识点分组的直方图（SIMD 内核，见 Kernels.h）
+    KnowledgeHistogram hist;
+    const size_t m = g_recordColumns.size();
+    const size_t kCount = g_knowledgeNames.size();
+    ThreadPool& pool = globalThreadPool();
+    if (m >= kParallelStatsMinRecords && pool.size() > 1) {
+        // 记录量大：每个分区一份直方图，再按分区编号顺序相加（整数求和，结果与顺序计算一致）
+        const size_t parts = pool.size();
+        std::vector<KnowledgeHistogram> partials(parts);
+        pool.parallelFor(parts, [&](size_t p) {
+            size_t lo = m * p / parts;
+            size_t hi = m * (p + 1) / parts;
+            kernelKnowledgeHistogram(g_recordColumns.knowledgeId.data() + lo, g_recordColumns.correct.data() + lo,
+                                     g_recordColumns.usedSeconds.data() + lo, hi - lo, kCount, partials[p]);
+        });
+        hist.total.assign(kCount, 0);
+        hist.correct.assign(kCount, 0);
+        hist.seconds.assign(kCount, 0);
+        for (const KnowledgeHistogram& part : partials) {
+            for (size_t k = 0; k < kCount; ++k) {
+                hist.total[k] += part.total[k];
+                hist.correct[k] += part.correct[k];
+                hist.seconds[k] += part.seconds[k];
+            }
+        }
+    } else {
+        kernelKnowledgeHistogram(g_recordColumns.knowledgeId.data(), g_recordColumns.correct.data(),
+                                 g_recordColumns.usedSeconds.data(), m, kCount, hist);
     }
 
-    // 第二步：计算各知识点的正确率
-    for (auto& p : ks) {
-        if (p.second.total > 0) {
-            // 正确率 = 答对数 / 总题数 * 100（转为百分比）
-            p.second.accuracy = p.second.correct * 100.0 / p.second.total;
-        }
+    // 第二步：转换为 名称 -> 统计信息，并计算正确率
+    for (size_t k = 0; k < g_knowledgeNames.size(); ++k) {
+        if (hist.total[k] == 0) continue;    // 未作答的知识点不出现在结果中
+        KnowledgeStat& st = ks[g_knowledgeNames[k]];
+        st.total = (int)hist.total[k];
+        st.correct = (int)hist.correct[k];
+        // 正确率 = 答对数 / 总题数 * 100（转为百分比）
+        st.accuracy = st.correct * 100.0 / st.total;
     }
 
     // 返回构建好的知识点统计映射表
@@ -126,15 +489,17 @@ std::unordered_map<std::string, KnowledgeStat> buildKnowledgeStats() {
  * 实现逻辑：
  * 1. 检查是否有做题记录，无记录则提示并返回
  * 2. 总体统计：
- *    - 遍历 g_records 计算总题数和答对题数
- *    - 计算总体正确率并输出
+ *    - 在列式记录上用 SIMD 内核求答对数与总用时
+ *    - 计算总体正确率、平均用时并输出
  * 3. 知识点统计：
- *    - 再次遍历 g_records，按知识点累加题数和答对数
- *    - 计算各知识点正确率并逐一输出
- * 4. 输出当前错题数量（从 g_wrongQuestions 获取）
- * 5. 调用 pauseForUser() 等待用户确认
+ *    - 用分组直方图内核一次求出各知识点的题数和答对数
+ *    - 计算各知识点正确率并按知识点 ID 顺序输出
+ * 4. 用时分布：读取各知识点用时草图的中位数与 P95
+ * 5. 近期表现：读取总体与各知识点滚动窗口的 1/7/30 天汇总
+ * 6. 输出当前错题数量（从 g_wrongQuestions 获取）
+ * 7. 调用 pauseForUser() 等待用户确认
  *
- * @complexity O(M)，其中 M 为总记录数（需要遍历两次记录）
+ * @complexity O(M)，其中 M 为总记录数（列式扫描，AVX2 下每条指令处理多条记录）
  * @note 该函数会阻塞等待用户按键
  */
 void showStatistics() {
@@ -146,13 +511,10 @@ void showStatistics() {
     }
 
     // ==================== 第一部分：总体统计 ====================
-    int total = (int)g_records.size();  // 总作答题数
-    int correct = 0;                     // 答对题数
-
-    // 遍历所有记录，统计答对题数
-    for (const auto& r : g_records) {
-        if (r.correct) correct++;
-    }
+    // 在列式记录上做归约（SIMD 内核，见 Kernels.h）
+    int total = (int)g_recordColumns.size();  // 总作答题数
+    int correct = (int)kernelCountCorrect(g_recordColumns.correct.data(), g_recordColumns.size());  // 答对题数
+    long long totalSeconds = kernelSumSeconds(g_recordColumns.usedSeconds.data(), g_recordColumns.size());
 
     // 计算总体正确率（百分比形式）
     double acc = correct * 1.0 / total * 100.0;
@@ -161,47 +523,67 @@ void showStatistics() {
     std::cout << "===== 总体统计 =====\n";
     std::cout << "总作答题数： " << total << "\n";
     std::cout << "答对题数：   " << correct << "\n";
-    std::cout << "总体正确率： " << acc << "%\n\n";
+    std::cout << "总体正确率： " << acc << "%\n";
+    std::cout << "平均用时：   " << (double)totalSeconds / total << " 秒\n\n";
 
     // ==================== 第二部分：知识点统计 ====================
     std::cout << "===== 按知识点统计 =====\n";
 
-    // 初始化知识点统计哈希表
-    std::unordered_map<std::string, KnowledgeStat> ks;
+    // 按知识点分组的直方图：作答数、答对数、用时一次求出
+    KnowledgeHistogram hist;
+    kernelKnowledgeHistogram(g_recordColumns.knowledgeId.data(), g_recordColumns.correct.data(),
+                             g_recordColumns.usedSeconds.data(), g_recordColumns.size(),
+                             g_knowledgeNames.size(), hist);
 
-    // 遍历所有记录，按知识点累加统计数据
-    for (const auto& r : g_records) {
-        // 通过题目 ID 查找题目索引
-        auto itQ = g_questionById.find(r.questionId);
-        if (itQ == g_questionById.end()) continue; // 题目不存在则跳过
+    // 按知识点 ID 顺序输出各知识点的详细信息
+    for (size_t k = 0; k < g_knowledgeNames.size(); ++k) {
+        if (hist.total[k] == 0) continue;  // 未作答的知识点不展示
 
-        size_t qIdx = itQ->second;
-        if (qIdx >= g_questions.size()) continue; // 索引异常则跳过
+        // 计算该知识点的正确率
+        double kacc = hist.correct[k] * 100.0 / hist.total[k];
 
-        // 获取题目所属的知识点
-        const std::string& kd = g_questions[qIdx].knowledge;
+        // 输出该知识点的统计信息
+        std::cout << "[知识点] " << g_knowledgeNames[k]
+             << "  总题数: " << hist.total[k]
+             << "  正确数: " << hist.correct[k]
+             << "  正确率: " << kacc << "%\n";
+    }
 
-        // 累加该知识点的统计数据
-        ks[kd].total++;                    // 总题数 +1
-        if (r.correct) ks[kd].correct++;   // 如果答对，答对数 +1
+    // ==================== 第三部分：用时分布（分位数草图） ====================
+    // 平均用时会被个别超长作答拉高，中位数与 P95 更能反映"普遍卡住"的知识点
+    std::cout << "\n===== 用时分布 =====\n";
+    for (size_t k = 0; k < g_knowledgeTimeSketches.size() && k < g_knowledgeNames.size(); ++k) {
+        const QuantileSketch& sk = g_knowledgeTimeSketches[k];
+        if (sk.empty()) continue;
+        std::cout << "[知识点] " << g_knowledgeNames[k]
+             << "  中位用时: " << sk.quantile(0.5) << " 秒"
+             << "  P95 用时: " << sk.quantile(0.95) << " 秒\n";
     }
 
-    // 遍历知识点统计表，输出各知识点的详细信息
-    for (const auto& p : ks) {
-        const std::string& kd = p.first;   // 知识点名称
-        const KnowledgeStat& s = p.second; // 知识点统计信息
+    // ==================== 第四部分：近期表现（滚动窗口） ====================
+    // 直接读取滚动窗口的累加和，不回扫历史记录
+    long long today = dayIndexOf((long long)std::time(nullptr));
+    const int windows[] = {1, 7, 30};
 
-        // 计算该知识点的正确率
-        double kacc = s.correct * 1.0 / s.total * 100.0;
+    std::cout << "\n===== 近期表现 =====\n";
+    for (int days : windows) {
+        const WindowTotals& t = g_overallWindow.query(days, today);
+        std::cout << "[近 " << days << " 天] 作答: " << t.attempts
+             << "  正确率: " << t.accuracy() << "%"
+             << "  平均用时: " << t.avgSeconds() << " 秒\n";
+    }
 
-        // 输出该知识点的统计信息
-        std::cout << "[知识点] " << kd
-             << "  总题数: " << s.total
-             << "  正确数: " << s.correct
-             << "  正确率: " << kacc << "%\n";
+    // 各知识点近 7 天 / 30 天正确率，与上面的全部历史正确率对照，可看出弱项是否已改善
+    for (size_t k = 0; k < g_knowledgeWindows.size() && k < g_knowledgeNames.size(); ++k) {
+        const WindowTotals& t30 = g_knowledgeWindows[k].query(30, today);
+        if (t30.attempts == 0) continue;   // 近 30 天未练习的知识点不展示
+        const WindowTotals& t7 = g_knowledgeWindows[k].query(7, today);
+        std::cout << "[知识点] " << g_knowledgeNames[k]
+             << "  近7天: " << t7.attempts << " 题 / " << t7.accuracy() << "%"
+             << "  近30天: " << t30.attempts << " 题 / " << t30.accuracy() << "%\n";
     }
 
-    // ==================== 第三部分：错题统计 ====================
+    // ==================== 第五部分：错题统计 ====================
     std::cout << "\n当前错题数： " << g_wrongQuestions.size() << " 道。\n";
 
     // 等待用户按键确认
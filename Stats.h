@@ -6,12 +6,23 @@
  * 1. 聚合用户做题记录，计算每道题目的统计数据（正确率、用时等）
  * 2. 按知识点维度统计正确率，帮助用户了解薄弱环节
  * 3. 提供统计信息的展示功能
+ * 4. 驱动滚动窗口统计（近 1/7/30 天，见 RollingStats.h）的重建与增量更新
+ * 5. 维护每题、每个知识点的作答用时分位数草图（见 QuantileSketch.h），
+ *    并支持写出/合并统计快照，用于班级维度的用时分布
+ * 6. 记录量大时并行重建：记录区间切分给线程池，各分区无锁累加部分结果，
+ *    再按分区编号顺序归并（见 buildQuestionStatsParallel）
  */
 
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include "QuantileSketch.h"
+
+struct Record;
+class ThreadPool;
 
 /**
  * @struct QuestionStat
@@ -26,6 +37,8 @@ struct QuestionStat {
     int correctAttempts = 0;     ///< 答对次数：该题被答对的次数
     int totalTime = 0;           ///< 累计作答时间：所有作答的总用时（秒）
     long long lastTimestamp = 0; ///< 最近一次作答时间：Unix 时间戳，用于判断题目是否长时间未复习
+    int recentAttempts = 0;      ///< 近 7 天作答次数（由调用方从滚动窗口填充，默认 0 表示不参与评分）
+    int recentCorrect = 0;       ///< 近 7 天答对次数（同上）
 };
 
 /**
@@ -41,37 +54,200 @@ struct KnowledgeStat {
     double accuracy = 0.0; ///< 该知识点的正确率（百分比形式，范围 0.0-100.0）
 };
 
+/**
+ * @struct QuestionStatTable
+ * @brief 按题目索引对齐的稠密统计表（列式存储）
+ *
+ * 第 i 行对应 g_questions[i]，每个统计字段单独存放为一列。
+ * 推荐评分时只需同时顺序扫描 g_questions 与各统计列，不再逐题做哈希查找，
+ * 访存模式连续，题库规模较大时评分耗时主要取决于内存带宽。
+ *
+ * 从未作答过的题目对应行保持默认值（次数为 0、时间戳为 0）。
+ */
+struct QuestionStatTable {
+    std::vector<int> totalAttempts;         ///< 总作答次数列
+    std::vector<int> correctAttempts;       ///< 答对次数列
+    std::vector<int> totalTime;             ///< 累计作答时间列（秒）
+    std::vector<long long> lastTimestamp;   ///< 最近一次作答时间戳列
+
+    /// 整表重建次数：每次 reset() 递增。增量维护的派生结构（如推荐索引）
+    /// 记录构建时的值，不一致即说明统计表已整体重建，需要随之重建
+    uint64_t epoch = 0;
+
+    /// 内容版本：reset() 与每次 applyRecordToStats() 计入一行时递增。
+    /// 版本不变即统计内容未变，依赖统计的缓存（如推荐结果缓存）可直接复用
+    uint64_t version = 0;
+
+    /// 表的行数（应与 g_questions.size() 一致）
+    size_t size() const { return totalAttempts.size(); }
+
+    /**
+     * @brief 清空并重置为 n 行默认值（epoch 与 version 递增）
+     * @param n 行数，通常为 g_questions.size()
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief 按题目索引取出一行，组装为 QuestionStat
+     * @param idx 题目在 g_questions 中的下标（调用方保证 idx < size()）
+     * @return 该题的统计信息（按值返回，便于传给 computeRecommendScore）
+     */
+    QuestionStat at(size_t idx) const;
+};
+
 /**
  * @brief 全局题目统计数据表
  *
- * 键为题目 ID，值为该题目的统计信息。
- * 该数据由 buildQuestionStats() 构建，用于快速查询单个题目的统计。
+ * 与 g_questions 按下标对齐的稠密列式表，由 buildQuestionStats() 构建。
+ * 热路径（如推荐评分）直接按题目下标访问；按题号查询请使用 findQuestionStat()。
+ *
+ * @warning 行号基于 g_questions 的当前状态，题库重新加载后需重新调用 buildQuestionStats()
+ */
+extern QuestionStatTable g_questionStats;
+
+/**
+ * @brief 按题号查询题目统计信息（兼容接口）
+ *
+ * 先通过 g_questionById 将题号转换为下标，再读取 g_questionStats 对应行。
+ *
+ * @param questionId 题号
+ * @param out 输出参数，查询成功时写入该题统计信息
+ * @return true 题号存在且统计表已覆盖该题
+ * @return false 题号不存在或统计表尚未构建
+ * @complexity O(1)（一次哈希查找）
+ */
+bool findQuestionStat(int questionId, QuestionStat& out);
+
+/// 单题用时草图的精度参数（单题样本通常较少，k = 64 时几百条以内为精确值）
+constexpr int kQuestionTimeSketchK = 64;
+
+/// 知识点用时草图的精度参数（秩误差约 ±1%）
+constexpr int kKnowledgeTimeSketchK = 200;
+
+/**
+ * @brief 题目下标 -> 用时草图池槽位（-1 表示该题没有作答记录）
+ */
+extern std::vector<int> g_questionTimeSketchSlot;
+
+/**
+ * @brief 题目用时草图对象池（仅包含作答过的题目，内存与题库大小无关）
+ */
+extern std::vector<QuantileSketch> g_questionTimeSketchPool;
+
+/**
+ * @brief 知识点用时草图（下标为知识点 ID，见 g_knowledgeNames）
+ */
+extern std::vector<QuantileSketch> g_knowledgeTimeSketches;
+
+/**
+ * @brief 获取某道题的用时草图
+ * @param qIdx 题目下标
+ * @return 草图指针；该题没有作答记录时返回 nullptr
  */
-extern std::unordered_map<int, QuestionStat> g_questionStats;
+const QuantileSketch* questionTimeSketch(size_t qIdx);
 
 /**
  * @brief 从做题记录构建题目统计信息
  *
  * 遍历全局记录数据 g_recordsByQuestion，对每道题目的所有作答记录进行聚合，
- * 计算总作答次数、答对次数、累计用时和最近作答时间，并更新到 g_questionStats 中。
+ * 计算总作答次数、答对次数、累计用时和最近作答时间，写入 g_questionStats 中该题下标对应的行。
  *
- * @note 每次调用会清空并重建 g_questionStats
+ * @note 每次调用会按当前题库大小清空并重建 g_questionStats
+ * @note 同时重建题目/知识点/总体三级滚动窗口（RollingStats.h）以及题目/知识点用时草图
+ * @note 题库中不存在的题号的记录会被忽略
+ * @note 记录数 >= kParallelStatsMinRecords 且有多个核心时，转为 buildQuestionStatsParallel(globalThreadPool())
  * @complexity 时间复杂度 O(M)，其中 M 为总记录数
  * @see g_recordsByQuestion (Record.h)
  * @see g_questionStats
  */
 void buildQuestionStats();
 
+/// 记录数达到该值时，统计重建走并行路径（更少时线程调度开销得不偿失）
+constexpr size_t kParallelStatsMinRecords = 200000;
+
+/**
+ * @brief 并行构建题目统计信息（结果与 buildQuestionStats() 一致）
+ *
+ * 1. 把列式记录 g_recordColumns 均分为 pool.size() 个连续分区
+ * 2. 每个分区在自己的部分结果中无锁累加：稠密统计表、滚动窗口、用时草图
+ * 3. 统计表按题目区间并行归并；滚动窗口与草图按分区编号顺序归并
+ *
+ * 次数、答对数、用时、最近时间戳与滚动窗口的结果与顺序重建完全相同；
+ * 用时草图为多个分区草图的合并，在 KLL 误差范围内与顺序重建一致，
+ * 且分区数相同时结果完全确定。
+ *
+ * @param pool 执行并行任务的线程池（分区数 = 线程数）
+ * @complexity O(M / T + T × Q)，T 为线程数，Q 为题目数
+ */
+void buildQuestionStatsParallel(ThreadPool& pool);
+
+/**
+ * @brief 将一条新的作答记录增量计入统计
+ *
+ * 在 doQuestion() 追加记录后调用，O(1) 更新：
+ * - g_questionStats 中该题对应行（次数、答对数、用时、最近时间戳）
+ * - 题目、知识点、总体三级滚动窗口
+ * - 题目、知识点用时草图（摊还 O(1)）
+ *
+ * @param r 新的作答记录
+ * @note 题号不在题库中（或统计表尚未构建）时直接返回，与 buildQuestionStats() 跳过这类记录一致
+ * @complexity O(1)
+ */
+void applyRecordToStats(const Record& r);
+
+/**
+ * @struct CohortTimeSketches
+ * @brief 多个用户统计快照合并后的用时草图（班级视图）
+ */
+struct CohortTimeSketches {
+    std::unordered_map<int, QuantileSketch> byQuestion;          ///< 题号 -> 合并后的用时草图
+    std::unordered_map<std::string, QuantileSketch> byKnowledge; ///< 知识点名称 -> 合并后的用时草图
+    int users = 0;                                               ///< 已合并的快照数
+};
+
+/**
+ * @brief 获取当前用户的统计快照路径（data/stats_<userId>.snapshot）
+ */
+std::string getStatsSnapshotPath();
+
+/**
+ * @brief 写出当前用户的统计快照
+ *
+ * 文件为 UTF-8 文本，每行一条，字段以逗号分隔：
+ * @code
+ * # DS_AI_Quiz stats snapshot v1
+ * U,<用户ID>
+ * Q,<题号>,<作答次数>,<答对次数>,<累计用时>,<最近时间戳>,<用时草图>
+ * K,<知识点名称>,<用时草图>
+ * @endcode
+ * 用时草图为 QuantileSketch::serialize() 的输出（内部不含逗号）。
+ *
+ * @param filename 快照文件路径（通常为 data/stats_<userId>.snapshot）
+ * @return true 写出成功；false 文件无法打开
+ * @complexity O(N + K)，N 为作答过的题目数，K 为知识点数（与历史长度无关）
+ */
+bool saveStatsSnapshot(const std::string& filename);
+
+/**
+ * @brief 读取一个统计快照并把其中的用时草图合并进 cohort
+ *
+ * @param filename 快照文件路径
+ * @param cohort 合并目标（可多次调用以合并多个用户）
+ * @return true 读取成功；false 文件无法打开
+ * @note 格式错误的行会被跳过
+ */
+bool mergeStatsSnapshot(const std::string& filename, CohortTimeSketches& cohort);
+
 /**
  * @brief 构建知识点统计信息
  *
- * 遍历全局记录数据 g_records，根据每条记录对应的题目查找其所属知识点，
- * 累加各知识点的总题数和答对题数，最后计算每个知识点的正确率。
+ * 在列式记录 g_recordColumns 上调用按知识点分组的直方图内核（Kernels.h），
+ * 得到各知识点的总题数和答对题数，最后计算每个知识点的正确率。
  *
  * @return 知识点统计映射表，键为知识点名称，值为该知识点的统计信息
  * @complexity 时间复杂度 O(M)，其中 M 为总记录数
- * @note 如果题目 ID 在题库中不存在，则跳过该记录
- * @see g_records (Record.h)
+ * @note 如果题目 ID 在题库中不存在，则跳过该记录（其知识点 ID 为 -1）
+ * @see g_recordColumns (Record.h)
  * @see g_questionById (Question.h)
  */
 std::unordered_map<std::string, KnowledgeStat> buildKnowledgeStats();
@@ -82,7 +258,9 @@ std::unordered_map<std::string, KnowledgeStat> buildKnowledgeStats();
  * 在控制台展示以下统计内容：
  * 1. 总体统计：总作答题数、答对题数、总体正确率
  * 2. 按知识点统计：每个知识点的题数、正确数、正确率
- * 3. 当前错题数量
+ * 3. 用时分布：各知识点的中位用时与 P95 用时（读取用时草图）
+ * 4. 近期表现：总体及各知识点近 1/7/30 天的作答数、正确率、平均用时（读取滚动窗口，不回扫历史）
+ * 5. 当前错题数量
  *
  * @complexity 时间复杂度 O(M)，其中 M 为总记录数
  * @note 如果没有做题记录，会提示用户
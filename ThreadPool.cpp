@@ -0,0 +1,153 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief 固定大小线程池实现
+ *
+ * 实现要点：
+ * 1. **批次**：parallelFor 为每个线程划分初始区间、递增 generation_ 并唤醒全部工作线程，
+ *    工作线程发现批次编号变化后开始领取任务
+ * 2. **领取任务**：从自己区间的前端 CAS 取一个编号；区间为空时扫描各线程区间，
+ *    从剩余最多的一个尾部 CAS 取走一半放入自己的区间，所有区间都为空即本批次领完
+ * 3. **完成**：调用线程自己领完任务后，等待所有工作线程报告完成（busyWorkers_ 归零）
+ */
+
+#include "ThreadPool.h"
+
+namespace {
+
+uint64_t packRange(uint64_t begin, uint64_t end) {
+    return (begin << 32) | end;
+}
+
+uint64_t rangeBegin(uint64_t packed) {
+    return packed >> 32;
+}
+
+uint64_t rangeEnd(uint64_t packed) {
+    return packed & 0xFFFFFFFFull;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount < 1) threadCount = 1;
+    ranges_.reset(new TaskRange[threadCount]);
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+bool ThreadPool::popFront(size_t self, size_t& task) {
+    std::atomic<uint64_t>& range = ranges_[self].packed;
+    uint64_t cur = range.load(std::memory_order_acquire);
+    while (rangeBegin(cur) < rangeEnd(cur)) {
+        if (range.compare_exchange_weak(cur, packRange(rangeBegin(cur) + 1, rangeEnd(cur)),
+                                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+            task = (size_t)rangeBegin(cur);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal(size_t self) {
+    size_t n = size();
+    while (true) {
+        // 选剩余任务最多的区间
+        size_t victim = n;
+        uint64_t victimRange = 0;
+        uint64_t most = 0;
+        for (size_t t = 0; t < n; ++t) {
+            if (t == self) continue;
+            uint64_t cur = ranges_[t].packed.load(std::memory_order_acquire);
+            uint64_t left = rangeEnd(cur) > rangeBegin(cur) ? rangeEnd(cur) - rangeBegin(cur) : 0;
+            if (left > most) {
+                most = left;
+                victim = t;
+                victimRange = cur;
+            }
+        }
+        if (victim == n) return false;   // 所有区间都已领完
+
+        // 从尾部取走一半（至少一个）；CAS 失败说明区间已变化，重新选择
+        uint64_t half = (most + 1) / 2;
+        uint64_t end = rangeEnd(victimRange);
+        if (ranges_[victim].packed.compare_exchange_strong(victimRange, packRange(rangeBegin(victimRange), end - half),
+                                                           std::memory_order_acq_rel, std::memory_order_acquire)) {
+            ranges_[self].packed.store(packRange(end - half, end), std::memory_order_release);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+void ThreadPool::drain(size_t self) {
+    size_t task = 0;
+    while (true) {
+        if (popFront(self, task)) {
+            (*job_)(task);
+        } else if (!steal(self)) {
+            break;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(size_t self) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        drain(self);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyWorkers_ == 0) done_.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) return;
+
+    // 单线程或单任务：直接在调用线程执行，省去唤醒开销
+    if (workers_.empty() || taskCount == 1) {
+        steals_.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < taskCount; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> callLock(callMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &task;
+        // 初始区间：任务编号按线程数均分为连续段
+        size_t n = size();
+        for (size_t t = 0; t < n; ++t) {
+            ranges_[t].packed.store(packRange(taskCount * t / n, taskCount * (t + 1) / n), std::memory_order_relaxed);
+        }
+        steals_.store(0, std::memory_order_relaxed);
+        busyWorkers_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);   // 调用线程同样参与
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return busyWorkers_ == 0; });
+    job_ = nullptr;
+}
+
+ThreadPool& globalThreadPool() {
+    static ThreadPool pool(std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency());
+    return pool;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file ThreadPool.h
+ * @brief 固定大小线程池 - 并行聚合的执行器
+ *
+ * 【模块职责】
+ * 统计重建等批量计算需要把记录区间切分给多个核心。本模块提供一个常驻线程池：
+ * - 线程在首次使用时创建，之后复用，避免每次聚合都创建/销毁线程
+ * - parallelFor(taskCount, fn)：把编号 0..taskCount-1 的任务分发给所有线程，
+ *   调用线程本身也参与执行，全部完成后才返回
+ * - 任务分配采用区间窃取（work stealing）：每个线程先拿到一段连续的任务编号，从前端逐个领取；
+ *   自己的区间领完后，从剩余任务最多的线程区间尾部窃取一半。
+ *   任务耗时差异很大时（如批量推荐中各用户记录数相差几个数量级）空闲线程自动分担，
+ *   而负载均衡时各线程只访问自己的区间，不争用同一个计数器
+ *
+ * 【确定性约定】
+ * 任务编号与执行它的线程无关：调用方应按"任务编号"而不是"线程"存放部分结果，
+ * 并在 parallelFor 返回后按任务编号顺序归并，结果即与线程调度无关。
+ *
+ * 【限制】
+ * - 不支持在任务内部再次调用同一个线程池的 parallelFor（会死锁）
+ * - 任务不应抛出异常
+ * - 单批任务数需小于 2^32（区间的起止编号各占 32 位）
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief 常驻线程池（调用线程 + threadCount-1 个工作线程）
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 创建线程池
+     * @param threadCount 参与计算的线程总数（含调用线程），最小为 1
+     */
+    explicit ThreadPool(size_t threadCount);
+
+    /// 通知所有工作线程退出并等待其结束
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// 参与计算的线程总数（含调用线程）
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief 并行执行 taskCount 个任务，全部完成后返回
+     *
+     * @param taskCount 任务数
+     * @param task 任务函数，参数为任务编号（0..taskCount-1）
+     * @note 同一时刻只允许一个调用方使用（内部加锁串行化）
+     */
+    void parallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+    /// 最近一次 parallelFor 中发生的窃取次数
+    size_t lastSteals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @struct TaskRange
+     * @brief 一个线程的待领取任务区间 [begin, end)，打包为一个 64 位原子量（高 32 位 begin，低 32 位 end）
+     *
+     * 所有者从前端 CAS 领取一个任务，窃取者从尾端 CAS 取走一半，两者针对同一个字，互不遗漏、互不重复。
+     * 独占缓存行，避免相邻线程的区间互相伪共享。
+     */
+    struct alignas(64) TaskRange {
+        std::atomic<uint64_t> packed{0};
+    };
+
+    /// 工作线程主循环：等待新任务批次，领取并执行任务
+    void workerLoop(size_t self);
+
+    /// 领取并执行当前批次的任务（先领自己的区间，再窃取），直到所有区间为空
+    void drain(size_t self);
+
+    /// 从自己的区间前端领取一个任务
+    bool popFront(size_t self, size_t& task);
+
+    /// 从剩余最多的区间尾部窃取一半到自己的区间
+    bool steal(size_t self);
+
+    std::vector<std::thread> workers_;
+    std::mutex callMutex_;                 ///< 串行化 parallelFor 调用
+    std::mutex mutex_;                     ///< 保护下面的批次状态
+    std::condition_variable wake_;         ///< 新批次到来
+    std::condition_variable done_;         ///< 批次完成
+    const std::function<void(size_t)>* job_ = nullptr;
+    std::unique_ptr<TaskRange[]> ranges_;  ///< 每个线程一个待领取区间（下标 0 为调用线程）
+    std::atomic<size_t> steals_{0};        ///< 当前批次的窃取次数
+    size_t busyWorkers_ = 0;               ///< 尚未完成当前批次的工作线程数
+    uint64_t generation_ = 0;              ///< 批次编号（工作线程据此判断是否有新批次）
+    bool stop_ = false;
+};
+
+/**
+ * @brief 全局线程池（线程数 = std::thread::hardware_concurrency()，首次调用时创建）
+ */
+ThreadPool& globalThreadPool();
@@ -0,0 +1,146 @@
+/**
+ * @file TopK.h
+ * @brief 有界 Top-K 选择器 - 流式插入，只保留最好的 K 项
+ *
+ * 【模块职责】
+ * 推荐、报告、命令行汇总中都有"从 N 项里挑出最好的 K 项"的需求（K 通常为 5~10，
+ * N 可达百万）。把全部 N 项建成大根堆再弹出 K 次需要 O(N log N) 时间和 O(N) 空间；
+ * 本模块只维护一个大小为 K 的小根堆（堆顶为当前保留项中"最差"的一项）：
+ * - 未满 K 项：直接插入，上浮调整 O(log K)
+ * - 已满 K 项：新项不优于堆顶时直接丢弃（O(1)，绝大多数项走这条路径），
+ *   否则替换堆顶并下沉调整 O(log K)
+ * 总体 O(N log K) 时间、O(K) 空间。
+ *
+ * 【确定性约定】
+ * 比较器 Better(a, b) 表示"a 比 b 更好"，必须是严格全序（分数相同时再比较编号），
+ * 这样选出的 K 项及其顺序只取决于数据本身，与插入顺序无关。
+ *
+ * 【使用示例】
+ * @code
+ * TopK<std::pair<int, int>, ScoreIdBetter> top(10);   // (分数, 编号)
+ * for (...) top.push({score, id});
+ * std::vector<std::pair<int, int>> best = top.takeSorted();   // 最好的在前
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct ScoreIdBetter
+ * @brief (分数, 编号) 对的默认比较器：分数高者更好，分数相同则编号小者更好
+ */
+struct ScoreIdBetter {
+    template <typename S, typename Id>
+    bool operator()(const std::pair<S, Id>& a, const std::pair<S, Id>& b) const {
+        if (a.first != b.first) return a.first > b.first;
+        return a.second < b.second;
+    }
+};
+
+/**
+ * @class TopK
+ * @brief 大小为 K 的小根堆（按 Better 的反序），流式保留最好的 K 项
+ *
+ * @tparam Item 元素类型（可复制）
+ * @tparam Better 比较器，Better()(a, b) 为 true 表示 a 比 b 更好（严格全序）
+ */
+template <typename Item, typename Better>
+class TopK {
+public:
+    /**
+     * @brief 创建选择器
+     * @param k 最多保留的项数（为 0 时 push 全部丢弃）
+     */
+    explicit TopK(size_t k, Better better = Better()) : k_(k), better_(better) {
+        heap_.reserve(k);
+    }
+
+    /// 当前保留的项数（不超过 K）
+    size_t size() const { return heap_.size(); }
+
+    /// 最多保留的项数 K
+    size_t capacity() const { return k_; }
+
+    bool empty() const { return heap_.empty(); }
+
+    /// 已保留满 K 项
+    bool full() const { return heap_.size() >= k_; }
+
+    /**
+     * @brief 当前保留项中最差的一项（堆顶）
+     * @note 仅在 !empty() 时调用；已满时，新项必须比它更好才会被保留
+     */
+    const Item& worst() const { return heap_[0]; }
+
+    /**
+     * @brief 流式插入一项
+     * @return true 该项被保留；false 该项被丢弃
+     * @complexity 丢弃 O(1)，保留 O(log K)
+     */
+    bool push(const Item& item) {
+        if (heap_.size() < k_) {
+            heap_.push_back(item);
+            siftUp(heap_.size() - 1);
+            return true;
+        }
+        if (k_ == 0 || !better_(item, heap_[0])) return false;
+        heap_[0] = item;
+        siftDown(0);
+        return true;
+    }
+
+    /**
+     * @brief 取出全部保留项，按从好到差排序，并清空选择器
+     * @complexity O(K log K)
+     */
+    std::vector<Item> takeSorted() {
+        // 反复把堆顶（最差项）换到末尾，最终数组即为从好到差
+        std::vector<Item> out;
+        out.swap(heap_);
+        for (size_t end = out.size(); end > 1; --end) {
+            std::swap(out[0], out[end - 1]);
+            siftDown(out, 0, end - 1);
+        }
+        heap_.reserve(k_);
+        return out;
+    }
+
+    /// 清空保留项（K 不变）
+    void clear() { heap_.clear(); }
+
+private:
+    /// a 应位于 b 的上方：a 比 b 更差（堆顶为最差项）
+    bool above(const Item& a, const Item& b) const { return better_(b, a); }
+
+    void siftUp(size_t child) {
+        while (child > 0) {
+            size_t parent = (child - 1) / 2;
+            if (!above(heap_[child], heap_[parent])) break;
+            std::swap(heap_[parent], heap_[child]);
+            child = parent;
+        }
+    }
+
+    void siftDown(size_t parent) { siftDown(heap_, parent, heap_.size()); }
+
+    void siftDown(std::vector<Item>& heap, size_t parent, size_t size) const {
+        while (true) {
+            size_t left = 2 * parent + 1;
+            size_t right = left + 1;
+            size_t top = parent;
+            if (left < size && above(heap[left], heap[top])) top = left;
+            if (right < size && above(heap[right], heap[top])) top = right;
+            if (top == parent) break;
+            std::swap(heap[parent], heap[top]);
+            parent = top;
+        }
+    }
+
+    size_t k_;
+    Better better_;
+    std::vector<Item> heap_;
+};
@@ -13,6 +13,11 @@
 #include <sstream>
 #include <limits>
 #include <cstdlib>
+#include <cctype>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <random>
 
 // 跨平台头文件处理
 #ifdef _WIN32
@@ -305,29 +310,142 @@ bool readIntSafely(const std::string& prompt, int& out, int minVal, int maxVal,
     }
 }
 
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
 /**
- * @brief 全局随机数生成器实现
+ * @brief 随机流构造
  *
- * 【单例模式】
- * 使用函数内静态变量实现：
- * - 首次调用时初始化（C++11 保证线程安全）
- * - 后续调用直接返回引用（无额外开销）
+ * key = splitmix64(seed ^ splitmix64(用途 + 1))：用途先混合一次，
+ * 使相邻种子、相邻用途的 key 也相差很远。
+ */
+RandomStream::RandomStream(uint64_t seed, RandomPurpose purpose)
+    : key_(splitmix64(seed ^ splitmix64((uint64_t)purpose + 1))) {}
+
+/**
+ * @brief [0, n) 上的均匀整数
  *
- * 【随机种子来源】
- * - 优先使用 std::random_device（真随机数，来自操作系统）
- * - Windows：CryptGenRandom API
- * - Linux：/dev/urandom
- * - 若 random_device 不可用，编译器会使用确定性种子（极少见）
+ * 只接受落在 n 的整数倍范围 [0, limit) 内的数再取模，拒绝概率小于 n / 2^64。
+ */
+uint64_t RandomStream::below(uint64_t n) {
+    if (n <= 1) return 0;
+    uint64_t limit = max() - max() % n;   // n 的整数倍（不超过 2^64 - 1）
+    while (true) {
+        uint64_t x = (*this)();
+        if (x < limit) return x % n;
+    }
+}
+
+namespace {
+
+/// 会话随机状态：种子与各用途的流（首次使用时创建）
+struct SessionRandom {
+    bool seeded = false;
+    uint64_t seed = 0;
+    std::vector<RandomStream> streams;
+};
+
+SessionRandom& sessionRandom() {
+    static SessionRandom state;
+    return state;
+}
+
+} // namespace
+
+/**
+ * @brief 会话种子实现
  *
- * 【mt19937 特性】
- * - Mersenne Twister 算法（周期 2^19937-1）
- * - 高质量伪随机数（通过多项统计测试）
- * - 状态大小 2.5KB（相比 rand() 的几字节）
+ * 【随机种子来源】
+ * - 未指定 --seed 时使用 std::random_device（Windows：CryptGenRandom；Linux：/dev/urandom）
+ * - random_device 每次只给出 32 位，抽取两次拼成 64 位种子
+ */
+uint64_t sessionSeed() {
+    SessionRandom& state = sessionRandom();
+    if (!state.seeded) {
+        std::random_device rd;
+        uint64_t hi = rd();
+        uint64_t lo = rd();
+        state.seed = (hi << 32) | lo;
+        state.seeded = true;
+    }
+    return state.seed;
+}
+
+void setSessionSeed(uint64_t seed) {
+    SessionRandom& state = sessionRandom();
+    state.seed = seed;
+    state.seeded = true;
+    state.streams.clear();
+}
+
+bool parseSeed(const std::string& text, uint64_t& out) {
+    if (text.empty() || text[0] == '-' || text[0] == '+') return false;
+    size_t pos = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text, &pos, 0);   // 基数 0：0x 开头按十六进制
+    } catch (...) {
+        return false;
+    }
+    if (pos != text.size()) return false;
+    out = (uint64_t)value;
+    return true;
+}
+
+bool parseCount(const std::string& text, size_t& out) {
+    // std::stoull 会接受前导空白与负号（"-1" 回绕为 2^64-1），这里逐字符检查
+    if (text.empty()) return false;
+    for (char c : text) {
+        if (!std::isdigit((unsigned char)c)) return false;
+    }
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text);
+    } catch (...) {
+        return false;
+    }
+    if (value > (unsigned long long)std::numeric_limits<size_t>::max()) return false;
+    out = (size_t)value;
+    return true;
+}
+
+std::string formatSeed(uint64_t seed) {
+    std::ostringstream oss;
+    oss << "0x" << std::hex << std::setw(16) << std::setfill('0') << seed;
+    return oss.str();
+}
+
+RandomStream& sessionStream(RandomPurpose purpose) {
+    SessionRandom& state = sessionRandom();
+    if (state.streams.empty()) {
+        uint64_t seed = sessionSeed();
+        state.streams.reserve((size_t)RandomPurpose::Count);
+        for (size_t i = 0; i < (size_t)RandomPurpose::Count; ++i) {
+            state.streams.emplace_back(seed, (RandomPurpose)i);
+        }
+    }
+    return state.streams[(size_t)purpose];
+}
+
+/**
+ * @brief 追加会话日志实现
  *
- * @complexity O(1) 首次初始化 O(K)，K 为 random_device 初始化开销
+ * 文件不存在时先写注释表头；追加模式打开，不影响已有内容。
  */
-std::mt19937& globalRng() {
-    static std::random_device rd;
-    static std::mt19937 rng(rd());
-    return rng;
+bool appendSessionLog(const std::string& userId) {
+    std::filesystem::path logPath = getDataDir() / "session_log.csv";
+    bool exists = std::filesystem::exists(logPath);
+    std::ofstream fout(logPath, std::ios::app);
+    if (!fout) {
+        return false;
+    }
+    if (!exists) {
+        fout << "# 会话日志：时间戳,用户,随机种子（以 --seed <种子> 启动可重放）\n";
+    }
+    fout << (long long)std::time(nullptr) << "," << userId << "," << formatSeed(sessionSeed()) << "\n";
+    return true;
 }
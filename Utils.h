@@ -2,7 +2,7 @@
  * @file Utils.h
  * @brief 通用工具函数模块
  *
- * 提供清屏、暂停、路径定位等跨平台实用功能。
+ * 提供清屏、暂停、路径定位等跨平台实用功能，以及可重放的会话随机流。
  *
  * @author Keleoz
  * @date 2025
@@ -12,7 +12,9 @@
 
 #include <string>
 #include <filesystem>
-#include <random>
+#include <cstdint>
+#include <vector>
+#include <utility>
 
 /**
  * @brief 清屏函数
@@ -167,31 +169,133 @@ std::filesystem::path getReportsDir();
 bool readIntSafely(const std::string& prompt, int& out, int minVal, int maxVal, bool allowEmpty = false);
 
 /**
- * @brief 获取全局随机数生成器（线程安全）
+ * @enum RandomPurpose
+ * @brief 会话随机流的用途（每种用途一条独立的流）
  *
- * 【功能】
- * 提供一个全局唯一的 std::mt19937 随机数生成器，用于所有随机数需求。
+ * 各用途的抽取次数互不影响：例如多做一道随机刷题，不会改变之后模拟考试抽到的试卷。
+ */
+enum class RandomPurpose {
+    Practice = 0,   ///< 随机刷题（randomPractice）
+    WrongBook,      ///< 错题本练习（wrongBookMode）
+    Exam,           ///< 模拟考试抽题（examMode）
+    Bandit,         ///< 探索推荐的采样器种子（banditRecommendMode）
+    Count           ///< 用途个数
+};
+
+/**
+ * @brief splitmix64 混合函数：64 位输入的双射，输出各位近似独立均匀
+ * @complexity O(1)
+ */
+uint64_t splitmix64(uint64_t x);
+
+/**
+ * @class RandomStream
+ * @brief 基于计数器的随机流：第 i 个数为 splitmix64(key ^ i)
  *
- * 【初始化策略】
- * - 使用静态局部变量（函数内 static）实现单例模式
- * - 首次调用时使用 std::random_device 初始化种子（高质量随机种子）
- * - 线程安全（C++11 保证静态局部变量初始化的线程安全性）
+ * 【为什么基于计数器】
+ * 状态只有 key 与计数器两个整数，同一种子、同一用途、同样的抽取次数一定得到同样的数，
+ * 与平台、标准库实现无关；满足 UniformRandomBitGenerator，也可以交给标准库算法使用。
+ *
+ * 【可重放】
+ * 标准库的分布（uniform_int_distribution）与 std::shuffle 的算法由实现决定，同一种子在
+ * MSVC 与 libstdc++ 上可能抽到不同结果；需要重放的抽取一律用 below() 与 shuffleFirst()。
+ */
+class RandomStream {
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief 由会话种子与用途构造
+     * @param seed 会话种子
+     * @param purpose 用途（不同用途的 key 互不相同）
+     */
+    RandomStream(uint64_t seed, RandomPurpose purpose);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~(result_type)0; }
+
+    /// 下一个 64 位随机数
+    result_type operator()() { return splitmix64(key_ ^ counter_++); }
+
+    /**
+     * @brief [0, n) 上的均匀整数（拒绝采样，无取模偏差；n 为 0 时返回 0）
+     * @complexity 期望 O(1)
+     */
+    uint64_t below(uint64_t n);
+
+    /**
+     * @brief 部分 Fisher-Yates：把 items 的前 k 个位置换成无放回均匀抽取的 k 个元素
+     * @param items 待抽取的元素（原地重排）
+     * @param k 抽取个数（超过 items.size() 时按 items.size()）
+     * @complexity O(k)
+     */
+    template <typename T>
+    void shuffleFirst(std::vector<T>& items, size_t k) {
+        size_t n = items.size();
+        if (k > n) k = n;
+        for (size_t i = 0; i < k && i + 1 < n; ++i) {
+            size_t j = i + (size_t)below(n - i);
+            std::swap(items[i], items[j]);
+        }
+    }
+
+    /// 已抽取的个数
+    uint64_t counter() const { return counter_; }
+
+private:
+    uint64_t key_;
+    uint64_t counter_ = 0;
+};
+
+/**
+ * @brief 本次会话的随机种子
  *
- * 【设计目的】
- * - 统一随机数风格：避免混用 rand()/mt19937/random_device
- * - 避免重复播种：不再每次调用 srand(time(nullptr))
- * - 提高随机质量：mt19937 优于传统 rand()
+ * 未调用 setSessionSeed() 时，首次调用以 std::random_device 生成（两次 32 位抽取拼成 64 位）。
+ * 会话中所有随机决定都由该种子派生（见 sessionStream()），记录下来即可重放。
+ */
+uint64_t sessionSeed();
+
+/**
+ * @brief 指定会话种子（命令行 --seed），全部随机流从头开始
+ */
+void setSessionSeed(uint64_t seed);
+
+/**
+ * @brief 解析种子：十进制或 0x 开头的十六进制，须为完整的 64 位无符号整数
+ * @return true 解析成功；false 格式错误或越界（out 不变）
+ */
+bool parseSeed(const std::string& text, uint64_t& out);
+
+/**
+ * @brief 解析命令行中的数量参数：只接受十进制数字（不含符号、空白与其他字符），且不超过 size_t 范围
+ * @return true 解析成功；false 格式错误或越界（out 不变）
+ */
+bool parseCount(const std::string& text, size_t& out);
+
+/**
+ * @brief 以 0x 开头的 16 位十六进制表示种子（parseSeed 可解析）
+ */
+std::string formatSeed(uint64_t seed);
+
+/**
+ * @brief 本次会话中某种用途的随机流（首次调用时由 sessionSeed() 派生）
  *
- * @return std::mt19937& 全局随机数生成器的引用
+ * 【用法】
+ * @code
+ * size_t idx = (size_t)sessionStream(RandomPurpose::Practice).below(g_questions.size());
+ * @endcode
  *
- * @note 返回引用避免拷贝（mt19937 状态较大）
- * @note 所有模块（App/Record/Recommender）应使用此函数获取 RNG
- * @note 配合 std::uniform_int_distribution 使用
+ * @note 非线程安全：只在交互线程中使用
+ * @complexity O(1)
+ */
+RandomStream& sessionStream(RandomPurpose purpose);
+
+/**
+ * @brief 把会话种子追加到 data/session_log.csv（每行"时间戳,用户,种子"）
  *
- * @example
- * std::uniform_int_distribution<int> dist(0, 9);
- * int randomNum = dist(globalRng());
+ * 登录与切换用户时调用；以 --seed <种子> 启动并重复同样的操作即可重放这次会话。
  *
- * @complexity O(1) 首次调用初始化，后续直接返回引用
+ * @param userId 当前用户
+ * @return true 写入成功；false 文件无法打开（不影响答题）
  */
-std::mt19937& globalRng();
+bool appendSessionLog(const std::string& userId);
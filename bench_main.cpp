@@ -0,0 +1,38 @@
+/**
+ * @file bench_main.cpp
+ * @brief 基准与一致性核对程序 DS_AI_Quiz_Bench - 程序入口
+ *
+ * 【模块职责】
+ * 与 main.cpp 共用全部业务模块，只负责：
+ * 1. Windows 平台 UTF-8 编码设置（保证控制台中文显示）
+ * 2. 取出全局选项（--profile 等，见 Cli.h）
+ * 3. 转交 Bench.cpp 的 runBenchCommand 执行基准子命令，返回值即进程退出码
+ *
+ * 不登录、不进入菜单；题库等资源由各子命令按需加载（数据目录同样为可执行文件旁的 data/）。
+ */
+
+#include "Bench.h"
+#include "Cli.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * @brief 主函数：基准程序入口
+ *
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数（argv[1] 为基准子命令，见 Bench.h）
+ * @return 0  成功且各项核对一致
+ * @return 1  参数错误、执行失败或核对不一致
+ */
+int main(int argc, char* argv[]) {
+    #ifdef _WIN32
+    SetConsoleOutputCP(65001);
+    #endif
+
+    if (!applyGlobalOptions(argc, argv)) {
+        return 1;
+    }
+    return runBenchCommand(argc, argv);
+}
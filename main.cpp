@@ -8,6 +8,7 @@
  * 2. 启动自检（检查 questions.csv、knowledge_graph.txt 等必要文件）
  * 3. 资源加载（题库、用户登录、做题记录、知识图）
  * 4. 进入主菜单循环（由 App.cpp 的 runMenuLoop 接管）
+ * 5. 带命令行参数启动时，转交 Cli.cpp 的 runCommandLine 执行非交互子命令
  *
  * 【设计原则】
  * - 不含业务逻辑，所有功能由各模块（Question/Record/Stats/KnowledgeGraph/App）实现
@@ -18,20 +19,27 @@
  * - Record.h/cpp：用户登录、做题记录管理
  * - KnowledgeGraph.h/cpp：知识点依赖图加载
  * - App.h/cpp：主菜单与各功能模式（刷题/推荐/统计等）
+ * - Cli.h/cpp：命令行子命令（班级用时分布等）
  * - Utils.h/cpp：路径工具（getDataDir）、清屏、暂停
  */
 
 #include "Question.h"
+#include "IrtCalibration.h"
 #include "Record.h"
 #include "Stats.h"
 #include "KnowledgeGraph.h"
+#include "CoError.h"
+#include "MatrixFactorization.h"
+#include "HalfLifeRegression.h"
+#include "KnowledgeTracing.h"
 #include "App.h"
+#include "Cli.h"
 #include "Utils.h"
 #include <filesystem>
+#include <iostream>
 
 #ifdef _WIN32
 #include <windows.h>
-#include <iostream>
 #endif
 
 /**
@@ -115,8 +123,11 @@ bool performStartupCheck() {
  *    - 检查 data/questions.csv（必需）
  *    - 检查 data/knowledge_graph.txt（可选）
  *    - 若必需文件缺失，输出错误信息并退出
+ *    - 自检前先由 applyGlobalOptions() 取出全局选项（--profile 选择推荐评分配置，--seed 指定会话随机种子）
+ *    - 若带有命令行参数，自检后交由 runCommandLine() 执行子命令并直接退出（见 Cli.h）
  * 3. 加载题库：loadQuestionsFromFile("data/questions.csv")
  *    - 解析 CSV 并填充全局容器 g_questions、g_questionById
+ *    - 存在 data/question_calibration.csv 时以 IRT 校准结果覆盖难度等级（见 IrtCalibration.h）
  * 4. 用户登录：输入学号/用户名
  *    - 调用 loginUser(userId) 设置 g_currentUserId
  *    - 多用户隔离：不同用户的做题记录存于不同文件
@@ -124,13 +135,23 @@ bool performStartupCheck() {
  *    - 重建 g_records、g_recordsByQuestion、g_wrongQuestions
  * 6. 加载知识点依赖图：loadKnowledgeGraphFromFile("data/knowledge_graph.txt")
  *    - 若文件不存在，仅输出警告，不影响其他功能
- * 7. 进入主菜单循环：runMenuLoop()
- *    - 由 App.cpp 接管用户交互
+ * 7. 加载知识追踪参数：loadTracingParamsFromFile("data/bkt_params.txt")
+ *    - 可选文件，缺失时各知识点使用默认 BKT 参数
+ * 8. 加载共错题表：loadCoErrorFromFile("data/co_error.txt")
+ *    - 可选文件，缺失时答错后不列出共错题
+ * 9. 加载潜因子模型：loadLatentFactorsFromFile("data/latent_factors.txt")
+ *    - 可选文件，缺失时未做过的题目按错误率 1.0 参与推荐
+ * 10. 加载遗忘模型：loadHalfLifeParamsFromFile("data/half_life.txt")
+ *     - 可选文件，缺失时时间间隔维度按 7 天线性封顶
+ * 11. 进入主菜单循环：runMenuLoop()
+ *     - 由 App.cpp 接管用户交互
  *
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数（见 Cli.h）
  * @return 0  正常退出
  * @return 1  启动自检失败或题库加载失败
  */
-int main() {
+int main(int argc, char* argv[]) {
     // ========== 1. Windows UTF-8 设置 ==========
     // Windows 平台：设置控制台输出代码页为 65001 (UTF-8)
     // 原因：Windows 默认使用本地代码页（如 GBK），不设置会导致中文乱码
@@ -139,16 +160,27 @@ int main() {
     SetConsoleOutputCP(65001);
     #endif
 
+    // 全局选项（--profile 等）对交互式菜单与子命令同样生效，先行取出
+    if (!applyGlobalOptions(argc, argv)) {
+        return 1;
+    }
+
     // ========== 2. 启动自检 ==========
     // 检查 data/questions.csv 和 data/knowledge_graph.txt
     // 若必需文件不存在，输出详细错误信息并退出
     if (!performStartupCheck()) {
         std::cerr << "程序因缺少必要文件而无法启动。\n";
+        if (argc > 1) return 1;            // 命令行模式不等待按键
         std::cerr << "按回车键退出...\n";
         std::cin.get();
         return 1;
     }
 
+    // 命令行模式：不登录、不进入菜单，执行子命令后直接退出
+    if (argc > 1) {
+        return runCommandLine(argc, argv);
+    }
+
     // ========== 3. 加载题库 ==========
     // 从 data/questions.csv 加载所有题目
     // 填充全局容器：g_questions（vector）、g_questionById（unordered_map）
@@ -156,6 +188,9 @@ int main() {
     if (!loadQuestionsFromFile(questionsPath.string())) {
         return 1;
     }
+    // data/question_calibration.csv 由 --calibrate-irt 从全部用户的作答拟合得到；
+    // 存在时作答足够多的题目改用校准后的难度等级，不存在时沿用题库标注
+    loadIrtCalibrationFromFile((getDataDir() / "question_calibration.csv").string());
 
     // ========== 4. 用户登录 ==========
     // 输入学号/用户名，设置 g_currentUserId
@@ -193,7 +228,23 @@ int main() {
     std::filesystem::path knowledgeGraphPath = getDataDir() / "knowledge_graph.txt";
     loadKnowledgeGraphFromFile(knowledgeGraphPath.string());
 
-    // ========== 7. 进入主菜单循环 ==========
+    // ========== 7. 加载知识追踪参数 ==========
+    // data/bkt_params.txt 由 --fit-bkt 从全部用户的记录拟合得到；不存在时各知识点使用默认参数
+    loadTracingParamsFromFile((getDataDir() / "bkt_params.txt").string());
+
+    // ========== 8. 加载共错题表 ==========
+    // data/co_error.txt 由 --build-co-error 从全部用户的错题本统计得到；不存在时答错后不列出共错题
+    loadCoErrorFromFile((getDataDir() / "co_error.txt").string());
+
+    // ========== 9. 加载潜因子模型 ==========
+    // data/latent_factors.txt 由 --train-mf 从全部用户的记录训练得到；不存在时未做过的题目按错误率 1.0 推荐
+    loadLatentFactorsFromFile((getDataDir() / "latent_factors.txt").string());
+
+    // ========== 10. 加载遗忘模型 ==========
+    // data/half_life.txt 由 --fit-hlr 从全部用户的记录拟合得到；不存在时时间间隔维度按 7 天线性封顶
+    loadHalfLifeParamsFromFile((getDataDir() / "half_life.txt").string());
+
+    // ========== 11. 进入主菜单循环 ==========
     // 交由 App.cpp 的 runMenuLoop() 接管用户交互
     // 菜单包括：随机刷题、错题本、AI 推荐、统计、考试、知识点路径、导出报告、切换用户
     runMenuLoop();